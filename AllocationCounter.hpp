@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+// ------------------------------------------------------------------
+// Heap allocation counter (test hook)
+//
+// When built with ESCAPEOREO_COUNT_ALLOCATIONS (CMake option of the
+// same name), AllocationCounter.cpp replaces the global operator new
+// and delete to count every allocation made by the program. Without
+// it nothing is replaced and count() always returns 0.
+// ------------------------------------------------------------------
+namespace AllocationCounter {
+    // True if the counting operator new is compiled in
+    bool enabled();
+
+    // Number of heap allocations since startup, all threads together
+    std::size_t count();
+}
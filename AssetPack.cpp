@@ -0,0 +1,267 @@
+#include "AssetPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::uint32_t readU32(const char* p) {
+        const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+        return static_cast<std::uint32_t>(b[0]) |
+            (static_cast<std::uint32_t>(b[1]) << 8) |
+            (static_cast<std::uint32_t>(b[2]) << 16) |
+            (static_cast<std::uint32_t>(b[3]) << 24);
+    }
+
+    std::uint64_t readU64(const char* p) {
+        return static_cast<std::uint64_t>(readU32(p)) |
+            (static_cast<std::uint64_t>(readU32(p + 4)) << 32);
+    }
+
+    void writeU32(std::ostream& out, std::uint32_t value) {
+        char b[4];
+        for (int i = 0; i < 4; ++i)
+            b[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        out.write(b, 4);
+    }
+
+    void writeU64(std::ostream& out, std::uint64_t value) {
+        writeU32(out, static_cast<std::uint32_t>(value & 0xFFFFFFFFu));
+        writeU32(out, static_cast<std::uint32_t>(value >> 32));
+    }
+
+    std::uint64_t alignUp(std::uint64_t value) {
+        const std::uint64_t a = AssetPackFormat::DataAlignment;
+        return (value + a - 1) / a * a;
+    }
+}
+
+
+AssetPack::AssetPack()
+    : base(nullptr), mappedSize(0), names(nullptr)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{
+}
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& filename) {
+    close();
+
+    // --- Map the whole file read-only ---
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = static_cast<const char*>(view);
+    mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // the mapping keeps the file alive
+    if (view == MAP_FAILED)
+        return false;
+
+    // Ask the kernel to read the whole archive ahead in one sequential pass
+    madvise(view, static_cast<std::size_t>(info.st_size), MADV_WILLNEED);
+
+    base = static_cast<const char*>(view);
+    mappedSize = static_cast<std::size_t>(info.st_size);
+#endif
+
+    // --- Validate header and index ---
+    if (mappedSize < AssetPackFormat::HeaderSize ||
+        std::memcmp(base, AssetPackFormat::Magic, sizeof(AssetPackFormat::Magic)) != 0 ||
+        readU32(base + 8) != AssetPackFormat::Version) {
+        std::cout << "Invalid asset pack " << filename << "\n";
+        close();
+        return false;
+    }
+
+    std::uint64_t count = readU32(base + 12);
+    std::uint64_t namesStart = AssetPackFormat::HeaderSize + count * AssetPackFormat::IndexEntrySize;
+    if (namesStart > mappedSize) {
+        std::cout << "Truncated asset pack index in " << filename << "\n";
+        close();
+        return false;
+    }
+
+    names = base + namesStart;
+    entries.resize(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const char* record = base + AssetPackFormat::HeaderSize + i * AssetPackFormat::IndexEntrySize;
+        Entry& e = entries[i];
+        e.offset = readU64(record);
+        e.size = readU64(record + 8);
+        e.nameOffset = readU32(record + 16);
+        e.nameSize = readU32(record + 20);
+
+        if (e.offset > mappedSize || e.size > mappedSize - e.offset ||
+            namesStart + e.nameOffset + e.nameSize > mappedSize) {
+            std::cout << "Corrupt asset pack entry in " << filename << "\n";
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AssetPack::close() {
+    if (!base)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<char*>(base), mappedSize);
+#endif
+
+    base = nullptr;
+    mappedSize = 0;
+    names = nullptr;
+    entries.clear();
+}
+
+AssetPack::View AssetPack::find(const std::string& name) const {
+    View result = { nullptr, 0 };
+    if (!base)
+        return result;
+
+    // Index is sorted by name (byte-wise), so a binary search is enough
+    std::size_t lo = 0, hi = entries.size();
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        const Entry& e = entries[mid];
+        int cmp = name.compare(0, std::string::npos, names + e.nameOffset, e.nameSize);
+        if (cmp == 0) {
+            result.data = base + e.offset;
+            result.size = static_cast<std::size_t>(e.size);
+            return result;
+        }
+        if (cmp < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return result;
+}
+
+
+bool writeAssetPack(const std::string& filename, const std::vector<std::string>& inputs) {
+    // Sort (and de-duplicate) names so the reader can binary search them
+    std::vector<std::string> sorted(inputs);
+    for (auto& name : sorted)
+        std::replace(name.begin(), name.end(), '\\', '/');
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    std::vector<std::vector<char>> contents(sorted.size());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        std::ifstream in(sorted[i].c_str(), std::ios::binary);
+        if (!in) {
+            std::cout << "Failed to open " << sorted[i] << "\n";
+            return false;
+        }
+        contents[i].assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // --- Lay out names and data ---
+    std::uint64_t namesStart = AssetPackFormat::HeaderSize + sorted.size() * AssetPackFormat::IndexEntrySize;
+    std::uint64_t namesSize = 0;
+    for (const auto& name : sorted)
+        namesSize += name.size();
+
+    std::vector<std::uint64_t> offsets(sorted.size());
+    std::uint64_t cursor = alignUp(namesStart + namesSize);
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        offsets[i] = cursor;
+        cursor = alignUp(cursor + contents[i].size());
+    }
+
+    // --- Write everything in one sequential pass ---
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (!out) {
+        std::cout << "Failed to create " << filename << "\n";
+        return false;
+    }
+
+    out.write(AssetPackFormat::Magic, sizeof(AssetPackFormat::Magic));
+    writeU32(out, AssetPackFormat::Version);
+    writeU32(out, static_cast<std::uint32_t>(sorted.size()));
+
+    std::uint32_t nameOffset = 0;
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        writeU64(out, offsets[i]);
+        writeU64(out, contents[i].size());
+        writeU32(out, nameOffset);
+        writeU32(out, static_cast<std::uint32_t>(sorted[i].size()));
+        nameOffset += static_cast<std::uint32_t>(sorted[i].size());
+    }
+
+    for (const auto& name : sorted)
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+
+    std::uint64_t written = namesStart + namesSize;
+    const char padding[AssetPackFormat::DataAlignment] = {};
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        out.write(padding, static_cast<std::streamsize>(offsets[i] - written));
+        if (!contents[i].empty())
+            out.write(&contents[i][0], static_cast<std::streamsize>(contents[i].size()));
+        written = offsets[i] + contents[i].size();
+    }
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Single-file asset archive ("assets.pak")
+//
+// Layout, all integers little-endian:
+//   Header : magic "OREOPAK\0", uint32 version, uint32 entry count
+//   Index  : one { uint64 offset, uint64 size, uint32 nameOffset,
+//            uint32 nameSize } record per entry, sorted by name
+//   Names  : entry names back to back (no terminator), offsets are
+//            relative to the start of this block
+//   Data   : entry contents, each starting on a 64-byte boundary
+//
+// Entry names are the paths the game asks for ("tiles/bat1.png"),
+// so a pack can replace the loose files one for one.
+// ------------------------------------------------------------------
+namespace AssetPackFormat {
+    const char          Magic[8] = { 'O', 'R', 'E', 'O', 'P', 'A', 'K', '\0' };
+    const std::uint32_t Version = 1;
+    const std::size_t   HeaderSize = 16;
+    const std::size_t   IndexEntrySize = 24;
+    const std::size_t   DataAlignment = 64;
+}
+
+// Read-only, memory-mapped view of an asset pack.
+// Views returned by find() point straight into the mapping and stay
+// valid until the pack is closed or destroyed, so resources loaded
+// from them without copying (sf::Font) must be destroyed first.
+class AssetPack {
+public:
+    struct View {
+        const char* data;
+        std::size_t size;
+    };
+
+    AssetPack();
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Map the archive and validate its index; returns false (and stays
+    // closed) if the file is missing or malformed
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+
+    // Look an entry up by name (binary search in the index);
+    // returns a null view if the pack is closed or has no such entry
+    View find(const std::string& name) const;
+
+private:
+    struct Entry {
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint32_t nameOffset;
+        std::uint32_t nameSize;
+    };
+
+    const char* base;
+    std::size_t mappedSize;
+    const char* names;
+    std::vector<Entry> entries;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+// Build an archive from a list of files; each entry is named after
+// the path it was read from. Used by the EscapeOreoPack tool.
+bool writeAssetPack(const std::string& filename, const std::vector<std::string>& inputs);
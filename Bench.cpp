@@ -0,0 +1,812 @@
+#include "AllocationCounter.hpp"
+#include "Netplay.hpp"
+#include "SplitScreen.hpp"
+#include "World.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// EscapeOreoBench: gameplay benchmarks, results as JSON.
+//
+//   EscapeOreoBench [--sizes 1,10,100,1000] [--ticks 600] [--level 1]
+//                   [--views 1] [--no-render] [--out results.json]
+//   EscapeOreoBench --net [--clients 2] [--ticks 600] [--loss 0.1]
+//                   [--latency 50] [--jitter 10] [--out results.json]
+//
+// Level build/reset and World::update run headless on synthetic levels,
+// the real layout repeated 1x to 1000x; "chase" times 500 bats
+// following the flow field towards the player, "edit" one level editor
+// stroke step (paint or clear a tile). The render pass draws the same
+// levels into an offscreen sf::RenderTexture and times the CPU side
+// (draw calls up to display()); it needs an OpenGL context and is
+// skipped, with the reason in the output, without one;
+// "render_deferred" draws the same frames through the deferred,
+// order-keeping draw queue of the render target. So are
+// "sprites_individual" and "sprites_batched", 10k sprites of one
+// texture drawn one by one, then through an sf::SpriteBatch, and
+// "instances_vertexarray" and "instances_instanced", 10k tinted quads
+// of a sprite sheet rebuilt into one sf::VertexArray every frame, then
+// drawn as instances of a single quad with RenderTarget::drawInstanced
+// (one instanced draw call with OpenGL 3.3, the CPU fallback without).
+// "text_layout" rebuilds the geometry of a 4000 character sf::Text
+// (glyph and kerning lookups for every character); it needs a font
+// (arial.ttf or DejaVu Sans) besides the OpenGL context.
+// "text_first_layout" times the first layout of a menu with a freshly
+// loaded font, rasterizing its glyphs, and "text_first_layout_preloaded"
+// the same after Font::preload was given a 100 ms head start.
+// --views 2..4 renders every frame through that many split-screen views.
+// Textures are not loaded: entities draw their fallback shapes.
+// Built with ESCAPEOREO_COUNT_ALLOCATIONS, "update", "chase" and "edit"
+// report their heap allocations, and the benchmark exits with status 2
+// if a steady-state World::update allocated (the pools are meant to
+// make gameplay allocation-free).
+//
+// --net is the multiplayer loopback test: a server and its clients in
+// this process, talking over UDP on 127.0.0.1 with the given loss rate
+// and one-way latency/jitter (ms) on every packet. It runs in real time
+// (ticks / 60 seconds) and reports the traffic per client and how often
+// reconciliation had to correct the clients' predictions. The clients
+// play level 1 through to the door; the run goes on past --ticks until
+// the server has completed the level (up to a minute) and exits with
+// status 2 if it never does.
+
+namespace {
+    typedef std::chrono::steady_clock BenchClock;
+
+    struct Options {
+        std::vector<int> sizes;
+        int ticks = 600;
+        int level = 1;
+        int views = 1;
+        bool render = true;
+        std::string output;
+
+        bool net = false;
+        int clients = 2;
+        float loss = 0.f;
+        int latency = 0;      // ms
+        int jitter = 0;       // ms
+    };
+
+    // Timings of one benchmark, in microseconds
+    struct Samples {
+        std::vector<double> values;
+
+        void add(BenchClock::duration d) {
+            values.push_back(std::chrono::duration<double, std::micro>(d).count());
+        }
+
+        double mean() const {
+            double sum = 0.0;
+            for (double v : values) sum += v;
+            return values.empty() ? 0.0 : sum / values.size();
+        }
+
+        // p in [0, 1]
+        double percentile(double p) const {
+            if (values.empty()) return 0.0;
+            std::vector<double> sorted(values);
+            std::sort(sorted.begin(), sorted.end());
+            std::size_t i = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+            return sorted[i];
+        }
+    };
+
+    struct Result {
+        std::string name;
+        int size;
+        std::size_t platforms;
+        Samples samples;
+        std::size_t allocations;
+        std::string note;
+    };
+
+    // Scripted player: run right, jump every second, turn back now and then,
+    // so that collisions, pickups and falls all get exercised
+    PlayerInput scriptedInput(int tick) {
+        PlayerInput input;
+        bool back = (tick / 240) % 4 == 3;
+        input.right = !back;
+        input.left = back;
+        input.jump = tick % 60 < 10;
+        return input;
+    }
+
+    // Scripted player finishing level 1: land first, then run right and
+    // jump every second (the hammer is on the way to the door). Players
+    // jump at different times.
+    PlayerInput levelRunInput(int tick, int player) {
+        PlayerInput input;
+        if (tick < 30)
+            return input;
+        input.right = true;
+        input.jump = (tick + player * 15) % 60 < 10;
+        return input;
+    }
+
+    // Enough iterations to be meaningful without taking forever at 1000x
+    int iterationsFor(int base, int size) {
+        return std::max(10, base / size);
+    }
+
+    bool glAvailable(std::string& reason) {
+#if defined(__unix__) && !defined(__APPLE__)
+        // SFML aborts when it cannot open the X display
+        if (!std::getenv("DISPLAY")) {
+            reason = "no X display (DISPLAY is not set)";
+            return false;
+        }
+#endif
+        reason.clear();
+        return true;
+    }
+
+    void benchLevelBuild(const Options& options, int size, std::vector<Result>& results) {
+        World world(static_cast<std::size_t>(size));
+        Result build = { "level_build", size, 0, Samples(), 0, "" };
+        Result reset = { "level_reset", size, 0, Samples(), 0, "" };
+
+        int iterations = iterationsFor(50, size);
+        for (int i = 0; i < iterations; ++i) {
+            BenchClock::time_point start = BenchClock::now();
+            world.buildSyntheticLevel(options.level, size);
+            build.samples.add(BenchClock::now() - start);
+            build.platforms = world.platforms.size();
+
+            start = BenchClock::now();
+            world.clearLevel();
+            reset.samples.add(BenchClock::now() - start);
+        }
+
+        reset.platforms = build.platforms;
+        results.push_back(build);
+        results.push_back(reset);
+    }
+
+    void benchUpdate(const Options& options, int size, std::vector<Result>& results) {
+        World world(static_cast<std::size_t>(size));
+        world.buildSyntheticLevel(options.level, size);
+
+        Result update = { "update", size, world.platforms.size(), Samples(), 0, "" };
+        int ticks = iterationsFor(options.ticks, size);
+        int reloads = 0;
+        update.samples.values.reserve(ticks);
+
+        for (int tick = 0; tick < ticks; ++tick) {
+            // Deaths rebuild the real (not synthetic) level; skip them
+            world.lives = 1000000;
+            int loadsBefore = world.levelLoads;
+            std::size_t allocationsBefore = AllocationCounter::count();
+
+            BenchClock::time_point start = BenchClock::now();
+            TickResult result = world.update(scriptedInput(tick));
+            BenchClock::duration elapsed = BenchClock::now() - start;
+
+            if (world.levelLoads != loadsBefore || result != TICK_RUNNING) {
+                reloads++;
+                world.buildSyntheticLevel(options.level, size);
+                continue;
+            }
+            update.samples.add(elapsed);
+            update.allocations += AllocationCounter::count() - allocationsBefore;
+        }
+
+        if (reloads > 0) {
+            std::ostringstream note;
+            note << "not counted: " << reloads << " tick(s) that ended the level";
+            update.note = note.str();
+        }
+        results.push_back(update);
+    }
+
+    // Chasing bats: ChaseBats of them around the scripted player, each
+    // tick one flow field update (when the player changed cell) plus a
+    // lookup and a move per bat
+    void benchChase(const Options& options, int size, std::vector<Result>& results) {
+        const int ChaseBats = 500;
+
+        World world(static_cast<std::size_t>(size));
+        world.buildSyntheticLevel(options.level, size);
+
+        std::mt19937 random(7);
+        std::vector<sf::Vector2f> bats(ChaseBats);
+        auto scatter = [&]() {
+            sf::Vector2f centre = world.players[0].position;
+            std::uniform_real_distribution<float> offset(-8.f * TileGrid::CellSize, 8.f * TileGrid::CellSize);
+            for (auto& bat : bats)
+                bat = centre + sf::Vector2f(offset(random), offset(random));
+        };
+        scatter();
+
+        FlowField field(BAT_CHASE_RADIUS);
+        Result chase = { "chase", size, world.platforms.size(), Samples(), 0, "" };
+        int ticks = iterationsFor(options.ticks, size);
+        chase.samples.values.reserve(ticks);
+
+        for (int tick = 0; tick < ticks; ++tick) {
+            world.lives = 1000000;
+            int loadsBefore = world.levelLoads;
+            world.update(scriptedInput(tick));
+            if (world.levelLoads != loadsBefore) {
+                world.buildSyntheticLevel(options.level, size);
+                scatter();
+            }
+
+            sf::FloatRect bounds = world.players[0].getBounds();
+            sf::Vector2f target(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f);
+            std::size_t allocationsBefore = AllocationCounter::count();
+
+            BenchClock::time_point start = BenchClock::now();
+            field.update(world.nav, &target, 1);
+            for (auto& bat : bats)
+                bat += field.direction(bat) * 1.5f;
+            chase.samples.add(BenchClock::now() - start);
+            chase.allocations += AllocationCounter::count() - allocationsBefore;
+        }
+
+        std::ostringstream note;
+        note << ChaseBats << " bats, " << field.recomputeCount() << " field update(s) in " << ticks << " ticks";
+        chase.note = note.str();
+        results.push_back(chase);
+    }
+
+    // Level editor: paint or clear one tile at a time, anywhere in the
+    // level (paintTile / clearTile, grid and nav updated in place)
+    void benchEdit(const Options& options, int size, std::vector<Result>& results) {
+        World world(static_cast<std::size_t>(size));
+        world.buildSyntheticLevel(options.level, size);
+
+        const int columns = static_cast<int>(WORLD_WIDTH / TileGrid::CellSize) * size;
+        const int rows = static_cast<int>(WORLD_HEIGHT / TileGrid::CellSize);
+        std::mt19937 random(11);
+        std::uniform_int_distribution<int> column(0, columns - 1), row(2, rows - 2);
+
+        Result edit = { "edit", size, world.platforms.size(), Samples(), 0, "" };
+        int edits = iterationsFor(options.ticks, size);
+        edit.samples.values.reserve(edits);
+        int navBuilds = world.nav.buildCount();
+
+        for (int i = 0; i < edits; ++i) {
+            sf::Vector2i tile(column(random), row(random));
+            std::size_t allocationsBefore = AllocationCounter::count();
+
+            BenchClock::time_point start = BenchClock::now();
+            if (i % 4 == 3)
+                world.clearTile(tile);
+            else
+                world.paintTile(tile, BLOCK_ROCK, sf::Color(60, 40, 40));
+            edit.samples.add(BenchClock::now() - start);
+            edit.allocations += AllocationCounter::count() - allocationsBefore;
+        }
+
+        std::ostringstream note;
+        note << world.nav.buildCount() - navBuilds << " full re-index(es) in " << edits << " edits";
+        edit.note = note.str();
+        results.push_back(edit);
+    }
+
+    void benchRender(const Options& options, int size, std::vector<Result>& results) {
+        World world(static_cast<std::size_t>(size));
+        world.buildSyntheticLevel(options.level, size);
+
+        sf::RenderTexture target;
+        if (!target.create(800, 600)) {
+            Result skipped = { "render", size, world.platforms.size(), Samples(), 0, "failed to create the render texture" };
+            results.push_back(skipped);
+            return;
+        }
+
+        // Cameras sweeping over the first copy of the layout, like in game
+        sf::View views[MAX_PLAYERS];
+        sf::Vector2f viewSize = SplitScreen::viewSize(options.views);
+        for (int i = 0; i < options.views; ++i) {
+            views[i].setSize(viewSize);
+            views[i].setViewport(SplitScreen::viewport(i, options.views));
+        }
+
+        // Immediate draws, then queued ones as the game draws the world
+        const char* names[] = { "render", "render_deferred" };
+        const sf::RenderTarget::DrawMode modes[] = { sf::RenderTarget::Immediate, sf::RenderTarget::DeferredStable };
+        for (int m = 0; m < 2; ++m) {
+            target.setDrawMode(modes[m]);
+
+            Result render = { names[m], size, world.platforms.size(), Samples(), 0, "" };
+            int frames = iterationsFor(options.ticks / 2, size);
+
+            for (int frame = 0; frame < frames; ++frame) {
+                BenchClock::time_point start = BenchClock::now();
+                target.clear();
+                for (int i = 0; i < options.views; ++i) {
+                    float sweep = static_cast<float>((frame * 8 + i * 300) % static_cast<int>(WORLD_WIDTH - viewSize.x));
+                    views[i].setCenter(viewSize.x / 2.f + sweep, 300.f);
+                    target.setView(views[i]);
+                    world.draw(target);
+                }
+                target.display();
+                render.samples.add(BenchClock::now() - start);
+            }
+
+            const sf::RenderTarget::DrawStats& stats = target.getDrawStats();
+            render.note = std::to_string(stats.draws) + " draws, " + std::to_string(stats.drawCalls) + " draw calls";
+            if (options.views > 1)
+                render.note += ", " + std::to_string(options.views) + " split-screen views";
+
+            // Wait for the GPU once so the last frames are not left in flight
+            target.getTexture().copyToImage();
+            results.push_back(render);
+        }
+    }
+
+    // 10k rotated sprites from one 2x2 sprite sheet: a draw call each,
+    // then one sf::SpriteBatch (size 1, once per run)
+    void benchSprites(const Options& options, std::vector<Result>& results) {
+        const int SpriteCount = 10000;
+
+        sf::RenderTexture target;
+        sf::Image sheet;
+        sheet.create(64, 64, sf::Color(200, 120, 60));
+        sf::Texture texture;
+        if (!target.create(800, 600) || !texture.loadFromImage(sheet)) {
+            Result skipped = { "sprites_individual", 1, 0, Samples(), 0, "failed to create the render texture" };
+            results.push_back(skipped);
+            return;
+        }
+
+        std::mt19937 random(3);
+        std::uniform_real_distribution<float> x(0.f, 800.f), y(0.f, 600.f), angle(0.f, 360.f);
+        std::vector<sf::Sprite> sprites;
+        for (int i = 0; i < SpriteCount; ++i) {
+            sf::Sprite sprite(texture, sf::IntRect((i % 2) * 32, (i / 2 % 2) * 32, 32, 32));
+            sprite.setOrigin(16.f, 16.f);
+            sprite.setPosition(x(random), y(random));
+            sprite.setRotation(angle(random));
+            sprites.push_back(sprite);
+        }
+
+        int frames = std::max(10, options.ticks / 10);
+        Result individual = { "sprites_individual", 1, 0, Samples(), 0, "" };
+        for (int frame = 0; frame < frames; ++frame) {
+            BenchClock::time_point start = BenchClock::now();
+            target.clear();
+            for (const sf::Sprite& sprite : sprites)
+                target.draw(sprite);
+            target.display();
+            individual.samples.add(BenchClock::now() - start);
+        }
+        individual.note = std::to_string(SpriteCount) + " sprites, " + std::to_string(SpriteCount) + " draw calls";
+        target.getTexture().copyToImage();
+        results.push_back(individual);
+
+        // Filled every frame, as a game would
+        sf::SpriteBatch batch;
+        Result batched = { "sprites_batched", 1, 0, Samples(), 0, "" };
+        for (int frame = 0; frame < frames; ++frame) {
+            BenchClock::time_point start = BenchClock::now();
+            target.clear();
+            batch.clear();
+            for (const sf::Sprite& sprite : sprites)
+                batch.add(sprite);
+            target.draw(batch);
+            target.display();
+            batched.samples.add(BenchClock::now() - start);
+        }
+        batched.note = std::to_string(SpriteCount) + " sprites, " + std::to_string(batch.getBatchCount()) + " draw call(s)";
+        target.getTexture().copyToImage();
+        results.push_back(batched);
+    }
+
+    void benchInstances(const Options& options, std::vector<Result>& results) {
+        const int InstanceCount = 10000;
+
+        sf::RenderTexture target;
+        sf::Image sheet;
+        sheet.create(64, 64, sf::Color(200, 120, 60));
+        sf::Texture texture;
+        if (!target.create(800, 600) || !texture.loadFromImage(sheet)) {
+            Result skipped = { "instances_instanced", 1, 0, Samples(), 0, "failed to create the render texture" };
+            results.push_back(skipped);
+            return;
+        }
+
+        // Bats: a position each, moving every frame, a frame of the sheet and a tint
+        std::mt19937 random(5);
+        std::uniform_real_distribution<float> x(0.f, 800.f), y(0.f, 600.f), speed(-2.f, 2.f);
+        std::uniform_int_distribution<int> shade(128, 255);
+        std::vector<sf::Vector2f> positions, velocities;
+        std::vector<sf::InstanceData> instances(InstanceCount);
+        for (int i = 0; i < InstanceCount; ++i) {
+            positions.push_back(sf::Vector2f(x(random), y(random)));
+            velocities.push_back(sf::Vector2f(speed(random), speed(random)));
+            instances[i].color = sf::Color(shade(random), shade(random), 255);
+            instances[i].textureRect = sf::FloatRect(static_cast<float>(i % 2) * 32.f, 0.f, 32.f, 32.f);
+        }
+
+        auto move = [&]() {
+            for (int i = 0; i < InstanceCount; ++i) {
+                positions[i] += velocities[i];
+                if (positions[i].x < 0.f || positions[i].x > 800.f) velocities[i].x = -velocities[i].x;
+                if (positions[i].y < 0.f || positions[i].y > 600.f) velocities[i].y = -velocities[i].y;
+            }
+        };
+
+        int frames = std::max(10, options.ticks / 10);
+        sf::VertexArray vertices(sf::Triangles);
+        Result batched = { "instances_vertexarray", 1, 0, Samples(), 0, "" };
+        for (int frame = 0; frame < frames; ++frame) {
+            BenchClock::time_point start = BenchClock::now();
+            move();
+            target.clear();
+            vertices.clear();
+            for (int i = 0; i < InstanceCount; ++i) {
+                const sf::FloatRect& rect = instances[i].textureRect;
+                sf::Vector2f p = positions[i];
+                sf::Color color = instances[i].color;
+                sf::Vertex topLeft(p, color, sf::Vector2f(rect.left, rect.top));
+                sf::Vertex topRight(p + sf::Vector2f(32.f, 0.f), color, sf::Vector2f(rect.left + 32.f, rect.top));
+                sf::Vertex bottomRight(p + sf::Vector2f(32.f, 32.f), color, sf::Vector2f(rect.left + 32.f, rect.top + 32.f));
+                sf::Vertex bottomLeft(p + sf::Vector2f(0.f, 32.f), color, sf::Vector2f(rect.left, rect.top + 32.f));
+                vertices.append(topLeft);
+                vertices.append(topRight);
+                vertices.append(bottomLeft);
+                vertices.append(bottomLeft);
+                vertices.append(topRight);
+                vertices.append(bottomRight);
+            }
+            target.draw(vertices, &texture);
+            target.display();
+            batched.samples.add(BenchClock::now() - start);
+        }
+        batched.note = std::to_string(InstanceCount) + " quads, " + std::to_string(target.getDrawStats().drawCalls) + " draw call(s)";
+        target.getTexture().copyToImage();
+        results.push_back(batched);
+
+        // One quad, texture coordinates relative to the instances' rects
+        sf::VertexArray quad(sf::Triangles, 6);
+        const sf::Vector2f corners[6] = { sf::Vector2f(0.f, 0.f), sf::Vector2f(1.f, 0.f), sf::Vector2f(0.f, 1.f),
+                                          sf::Vector2f(0.f, 1.f), sf::Vector2f(1.f, 0.f), sf::Vector2f(1.f, 1.f) };
+        for (std::size_t i = 0; i < 6; ++i)
+            quad[i] = sf::Vertex(corners[i] * 32.f, corners[i]);
+
+        Result instanced = { "instances_instanced", 1, 0, Samples(), 0, "" };
+        for (int frame = 0; frame < frames; ++frame) {
+            BenchClock::time_point start = BenchClock::now();
+            move();
+            target.clear();
+            for (int i = 0; i < InstanceCount; ++i)
+                instances[i].transform = sf::Transform().translate(positions[i]);
+            target.drawInstanced(quad, &instances[0], instances.size(), &texture);
+            target.display();
+            instanced.samples.add(BenchClock::now() - start);
+        }
+        instanced.note = std::to_string(InstanceCount) + " quads, " + std::to_string(target.getDrawStats().drawCalls) + " draw call(s)";
+        target.getTexture().copyToImage();
+        results.push_back(instanced);
+    }
+
+    // Layout of a long text: two strings of the same length swapped every
+    // iteration, so that each getLocalBounds() rebuilds the geometry
+    void benchText(const Options& options, std::vector<Result>& results) {
+        const char* fontFiles[] = { "arial.ttf", "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", "C:/Windows/Fonts/arial.ttf" };
+        std::string fontFile;
+        sf::Font font;
+        for (const char* file : fontFiles) {
+            if (font.loadFromFile(file)) {
+                fontFile = file;
+                break;
+            }
+        }
+        if (fontFile.empty()) {
+            Result skipped = { "text_layout", 1, 0, Samples(), 0, "no font found" };
+            results.push_back(skipped);
+            return;
+        }
+
+        const std::string sentence = "The bats AVOID Oreo; To WAVE at a Yeti, jump over the gap. ";
+        std::string first, second;
+        while (first.size() < 4000) {
+            first += sentence;
+            second += sentence;
+            std::rotate(second.begin(), second.begin() + 7, second.end());
+        }
+
+        sf::Text text(first, font, 24);
+        text.getLocalBounds();
+
+        int iterations = std::max(100, options.ticks);
+        Result layout = { "text_layout", 1, 0, Samples(), 0, "" };
+        for (int i = 0; i < iterations; ++i) {
+            BenchClock::time_point start = BenchClock::now();
+            text.setString(i % 2 ? first : second);
+            text.getLocalBounds();
+            layout.samples.add(BenchClock::now() - start);
+        }
+        layout.note = std::to_string(first.size()) + " characters";
+        results.push_back(layout);
+
+        // A menu opening: new text at new sizes, regular and outlined
+        const sf::String menu = "RESUME  Options  Level editor  Controls  Quit to title 0123456789";
+        const std::vector<unsigned int> sizes = { 28, 56 };
+        auto layOut = [&](const sf::Font& menuFont) {
+            for (unsigned int size : sizes) {
+                sf::Text item(menu, menuFont, size);
+                item.setOutlineThickness(2.f);
+                item.getLocalBounds();
+            }
+        };
+
+        Result cold = { "text_first_layout", 1, 0, Samples(), 0, "" };
+        Result preloaded = { "text_first_layout_preloaded", 1, 0, Samples(), 0, "" };
+        for (int i = 0; i < 10; ++i) {
+            sf::Font coldFont;
+            coldFont.loadFromFile(fontFile);
+            BenchClock::time_point start = BenchClock::now();
+            layOut(coldFont);
+            cold.samples.add(BenchClock::now() - start);
+
+            sf::Font warmFont;
+            warmFont.loadFromFile(fontFile);
+            warmFont.preload(menu, sizes);
+            warmFont.preload(menu, sizes, false, 2.f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            start = BenchClock::now();
+            layOut(warmFont);
+            preloaded.samples.add(BenchClock::now() - start);
+        }
+        cold.note = std::to_string(menu.getSize()) + " characters at " + std::to_string(sizes.size()) + " sizes, outlined";
+        preloaded.note = cold.note;
+        results.push_back(cold);
+        results.push_back(preloaded);
+    }
+
+    int benchNet(const Options& options, std::ostream& out) {
+        NetConditions conditions;
+        conditions.loss = options.loss;
+        conditions.latency = sf::milliseconds(options.latency);
+        conditions.jitter = sf::milliseconds(options.jitter);
+
+        World serverWorld;
+        NetServer server(serverWorld);
+        if (!server.start(0)) {
+            std::cerr << "Failed to bind the server socket\n";
+            return 1;
+        }
+        server.setConditions(conditions);
+
+        std::vector<std::unique_ptr<World>> worlds;
+        std::vector<std::unique_ptr<NetClient>> clients;
+        for (int i = 0; i < options.clients; ++i) {
+            worlds.emplace_back(new World());
+            clients.emplace_back(new NetClient(*worlds.back()));
+            clients.back()->setConditions(conditions);
+            if (!clients.back()->connect(sf::IpAddress::LocalHost, server.getPort())) {
+                std::cerr << "Failed to bind a client socket\n";
+                return 1;
+            }
+        }
+
+        // Fixed 60 Hz ticks in real time, clients first like separate machines would
+        const BenchClock::duration tickLength = std::chrono::microseconds(1000000 / NET_TICK_RATE);
+        const int maxTicks = std::max(options.ticks, 60 * NET_TICK_RATE);
+        BenchClock::time_point next = BenchClock::now();
+        int tick = 0;
+        int levelCompletedAt = -1;
+        while (tick < options.ticks || (levelCompletedAt < 0 && tick < maxTicks)) {
+            for (int i = 0; i < options.clients; ++i)
+                clients[i]->update(levelRunInput(tick, i));
+            if (server.update() == TICK_LEVEL_COMPLETE && levelCompletedAt < 0)
+                levelCompletedAt = tick;
+            ++tick;
+
+            next += tickLength;
+            std::this_thread::sleep_until(next);
+        }
+
+        double seconds = static_cast<double>(tick) / NET_TICK_RATE;
+        out << "{\n";
+        out << "  \"benchmark\": \"EscapeOreoBench\",\n";
+        out << "  \"mode\": \"net\",\n";
+        out << "  \"seconds\": " << seconds << ",\n";
+        out << "  \"loss\": " << options.loss << ", \"latencyMs\": " << options.latency
+            << ", \"jitterMs\": " << options.jitter << ",\n";
+        out << "  \"snapshotRate\": " << NET_TICK_RATE / NET_SNAPSHOT_INTERVAL << ",\n";
+        out << "  \"levelCompletedAtTick\": " << levelCompletedAt << ",\n";
+
+        // Server side: what it sent to each client (before simulated loss)
+        out << "  \"serverToClientBytesPerSecond\": [";
+        for (int i = 0; i < server.clientCount(); ++i)
+            out << (i ? ", " : "") << server.bytesSentTo(i) / seconds;
+        out << "],\n";
+
+        out << "  \"clients\": [\n";
+        for (int i = 0; i < options.clients; ++i) {
+            const NetClient& c = *clients[i];
+            const NetStats& stats = c.getStats();
+            out << "    { \"connected\": " << (c.isConnected() ? "true" : "false")
+                << ", \"player\": " << c.playerIndex()
+                << ", \"upBytesPerSecond\": " << stats.bytesSent / seconds
+                << ", \"downBytesPerSecond\": " << stats.bytesReceived / seconds
+                << ", \"snapshots\": " << c.snapshotsReceived()
+                << ", \"fullSnapshots\": " << c.fullSnapshotsReceived()
+                << ", \"meanSnapshotBytes\": " << (c.snapshotsReceived() ? stats.bytesReceived / c.snapshotsReceived() : 0)
+                << ", \"corrections\": " << c.corrections()
+                << ", \"largestCorrection\": " << c.largestCorrection()
+                << " }" << (i + 1 < options.clients ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+
+        if (levelCompletedAt < 0) {
+            std::cerr << "No level was completed in " << tick << " ticks\n";
+            return 2;
+        }
+        return 0;
+    }
+
+    void writeJson(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+        out << "{\n";
+        out << "  \"benchmark\": \"EscapeOreoBench\",\n";
+        out << "  \"level\": " << options.level << ",\n";
+        out << "  \"unit\": \"us\",\n";
+        out << "  \"allocationCounting\": " << (AllocationCounter::enabled() ? "true" : "false") << ",\n";
+        out << "  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << "    { \"name\": \"" << r.name << "\", \"size\": " << r.size
+                << ", \"platforms\": " << r.platforms
+                << ", \"iterations\": " << r.samples.values.size();
+            if (!r.samples.values.empty()) {
+                out << ", \"mean\": " << r.samples.mean()
+                    << ", \"median\": " << r.samples.percentile(0.5)
+                    << ", \"p99\": " << r.samples.percentile(0.99);
+            }
+            if ((r.name == "update" || r.name == "chase" || r.name == "edit") && AllocationCounter::enabled())
+                out << ", \"allocations\": " << r.allocations;
+            if (!r.note.empty())
+                out << ", \"note\": \"" << r.note << "\"";
+            out << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+    }
+
+    bool parseSizes(const std::string& list, std::vector<int>& sizes) {
+        sizes.clear();
+        std::istringstream in(list);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            int size = std::atoi(item.c_str());
+            if (size < 1)
+                return false;
+            sizes.push_back(size);
+        }
+        return !sizes.empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    options.sizes = { 1, 10, 100, 1000 };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--sizes" && hasValue && parseSizes(argv[i + 1], options.sizes)) {
+            ++i;
+        }
+        else if (arg == "--ticks" && hasValue && std::atoi(argv[i + 1]) > 0) {
+            options.ticks = std::atoi(argv[++i]);
+        }
+        else if (arg == "--level" && hasValue && std::atoi(argv[i + 1]) >= 1 && std::atoi(argv[i + 1]) <= 4) {
+            options.level = std::atoi(argv[++i]);
+        }
+        else if (arg == "--views" && hasValue && std::atoi(argv[i + 1]) >= 1 && std::atoi(argv[i + 1]) <= MAX_PLAYERS) {
+            options.views = std::atoi(argv[++i]);
+        }
+        else if (arg == "--net") {
+            options.net = true;
+        }
+        else if (arg == "--clients" && hasValue && std::atoi(argv[i + 1]) >= 1 && std::atoi(argv[i + 1]) <= MAX_PLAYERS) {
+            options.clients = std::atoi(argv[++i]);
+        }
+        else if (arg == "--loss" && hasValue && std::atof(argv[i + 1]) >= 0.0 && std::atof(argv[i + 1]) < 1.0) {
+            options.loss = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if (arg == "--latency" && hasValue && std::atoi(argv[i + 1]) >= 0) {
+            options.latency = std::atoi(argv[++i]);
+        }
+        else if (arg == "--jitter" && hasValue && std::atoi(argv[i + 1]) >= 0) {
+            options.jitter = std::atoi(argv[++i]);
+        }
+        else if (arg == "--no-render") {
+            options.render = false;
+        }
+        else if (arg == "--out" && hasValue) {
+            options.output = argv[++i];
+        }
+        else {
+            std::cout << "Usage: " << argv[0]
+                << " [--sizes 1,10,100,1000] [--ticks 600] [--level 1..4] [--views 1..4] [--no-render] [--out file.json]\n"
+                << "       " << argv[0]
+                << " --net [--clients 1..4] [--ticks 600] [--loss 0..1] [--latency ms] [--jitter ms] [--out file.json]\n";
+            return 1;
+        }
+    }
+
+    if (options.net) {
+        if (options.output.empty())
+            return benchNet(options, std::cout);
+
+        std::ofstream out(options.output.c_str());
+        if (!out) {
+            std::cerr << "Failed to open " << options.output << "\n";
+            return 1;
+        }
+        return benchNet(options, out);
+    }
+
+    std::string noRenderReason = "disabled with --no-render";
+    if (options.render)
+        options.render = glAvailable(noRenderReason);
+
+    std::vector<Result> results;
+    for (int size : options.sizes) {
+        std::cerr << "Running size " << size << "x...\n";
+        benchLevelBuild(options, size, results);
+        benchUpdate(options, size, results);
+        benchChase(options, size, results);
+        benchEdit(options, size, results);
+        if (options.render) {
+            benchRender(options, size, results);
+        }
+        else {
+            Result skipped = { "render", size, 0, Samples(), 0, "skipped: " + noRenderReason };
+            results.push_back(skipped);
+        }
+    }
+
+    if (options.render) {
+        benchSprites(options, results);
+        benchInstances(options, results);
+        benchText(options, results);
+    }
+    else {
+        Result skipped = { "sprites_batched", 1, 0, Samples(), 0, "skipped: " + noRenderReason };
+        results.push_back(skipped);
+        Result skippedInstances = { "instances_instanced", 1, 0, Samples(), 0, "skipped: " + noRenderReason };
+        results.push_back(skippedInstances);
+        Result skippedText = { "text_layout", 1, 0, Samples(), 0, "skipped: " + noRenderReason };
+        results.push_back(skippedText);
+    }
+
+    if (options.output.empty()) {
+        writeJson(std::cout, options, results);
+    }
+    else {
+        std::ofstream out(options.output.c_str());
+        if (!out) {
+            std::cerr << "Failed to open " << options.output << "\n";
+            return 1;
+        }
+        writeJson(out, options, results);
+    }
+
+    int status = 0;
+    for (const Result& r : results) {
+        if (r.name == "update" && r.allocations > 0) {
+            std::cerr << "World::update allocated " << r.allocations << " time(s) at size " << r.size << "x\n";
+            status = 2;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,79 @@
+#include "CollisionMask.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Bits [from, to) of a word, 0 <= from < to <= 64
+    std::uint64_t spanBits(unsigned int from, unsigned int to) {
+        std::uint64_t upper = (to >= 64) ? ~std::uint64_t(0) : ((std::uint64_t(1) << to) - 1);
+        std::uint64_t lower = (std::uint64_t(1) << from) - 1;
+        return upper & ~lower;
+    }
+}
+
+
+CollisionMask::CollisionMask()
+    : width(0), height(0), wordsPerRow(0)
+{
+}
+
+void CollisionMask::build(const sf::Image& image, sf::Uint8 alphaThreshold) {
+    sf::Vector2u size = image.getSize();
+    width = size.x;
+    height = size.y;
+    wordsPerRow = (width + 63) / 64;
+    bits.assign(static_cast<std::size_t>(wordsPerRow) * height, 0);
+
+    int left = static_cast<int>(width), top = static_cast<int>(height), right = -1, bottom = -1;
+    const sf::Uint8* pixels = image.getPixelsPtr();
+    for (unsigned int y = 0; y < height; ++y) {
+        std::uint64_t* row = &bits[static_cast<std::size_t>(y) * wordsPerRow];
+        for (unsigned int x = 0; x < width; ++x) {
+            if (pixels[(static_cast<std::size_t>(y) * width + x) * 4 + 3] < alphaThreshold)
+                continue;
+
+            row[x / 64] |= std::uint64_t(1) << (x % 64);
+            left = std::min(left, static_cast<int>(x));
+            right = std::max(right, static_cast<int>(x));
+            top = std::min(top, static_cast<int>(y));
+            bottom = std::max(bottom, static_cast<int>(y));
+        }
+    }
+
+    solid = (right < 0) ? sf::IntRect() : sf::IntRect(left, top, right - left + 1, bottom - top + 1);
+}
+
+bool CollisionMask::isSolid(unsigned int x, unsigned int y) const {
+    if (x >= width || y >= height)
+        return false;
+    return (bits[static_cast<std::size_t>(y) * wordsPerRow + x / 64] >> (x % 64)) & 1u;
+}
+
+bool CollisionMask::overlaps(const sf::FloatRect& area) const {
+    // Pixels the area touches, clipped to the solid part of the mask
+    int x0 = std::max(static_cast<int>(std::floor(area.left)), solid.left);
+    int y0 = std::max(static_cast<int>(std::floor(area.top)), solid.top);
+    int x1 = std::min(static_cast<int>(std::ceil(area.left + area.width)), solid.left + solid.width);
+    int y1 = std::min(static_cast<int>(std::ceil(area.top + area.height)), solid.top + solid.height);
+    if (x0 >= x1 || y0 >= y1)
+        return false;
+
+    unsigned int firstWord = static_cast<unsigned int>(x0) / 64;
+    unsigned int lastWord = static_cast<unsigned int>(x1 - 1) / 64;
+    std::uint64_t firstSpan = spanBits(x0 % 64, (firstWord == lastWord) ? (x1 - 1) % 64 + 1 : 64);
+    std::uint64_t lastSpan = spanBits(0, (x1 - 1) % 64 + 1);
+
+    for (int y = y0; y < y1; ++y) {
+        const std::uint64_t* row = &bits[static_cast<std::size_t>(y) * wordsPerRow];
+        if (row[firstWord] & firstSpan)
+            return true;
+        for (unsigned int w = firstWord + 1; w < lastWord; ++w) {
+            if (row[w])
+                return true;
+        }
+        if (lastWord > firstWord && (row[lastWord] & lastSpan))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Pixel collision mask of an image
+//
+// One bit per pixel, set where the pixel is opaque enough, packed in
+// 64-bit words row by row. Built once when the texture is loaded; a
+// test against a rectangle ANDs each row's words with the rectangle's
+// column span, so a 32 px wide box costs one or two words per row.
+//
+// Used as the narrow phase after the bounding boxes overlap: sprites
+// with wide transparent margins (the bats) only collide where they
+// are actually drawn.
+// ------------------------------------------------------------------
+class CollisionMask {
+public:
+    CollisionMask();
+
+    // Pixels with alpha >= alphaThreshold are solid
+    void build(const sf::Image& image, sf::Uint8 alphaThreshold = 128);
+
+    bool empty() const { return bits.empty(); }
+    unsigned int getWidth() const { return width; }
+    unsigned int getHeight() const { return height; }
+
+    bool isSolid(unsigned int x, unsigned int y) const;
+
+    // True if any solid pixel lies in `area`, in the image's pixel
+    // coordinates (a sprite's local coordinates); clipped to the image
+    bool overlaps(const sf::FloatRect& area) const;
+
+private:
+    unsigned int width;
+    unsigned int height;
+    unsigned int wordsPerRow;
+    sf::IntRect solid;                 // smallest rectangle holding every solid pixel
+    std::vector<std::uint64_t> bits;
+};
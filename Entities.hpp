@@ -0,0 +1,628 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cmath>
+#include <vector>
+
+#include "CollisionMask.hpp"
+
+// ------------------------------------------------------------------
+// Level entities and the player
+//
+// Plain data plus their own per-tick update and drawing; they only
+// point at textures, so a level can be built and simulated without
+// any loaded (headless benchmarks), falling back to plain shapes.
+// Sprites without a texture take the size of their collision mask
+// (same image) instead, so that a server, which has no textures,
+// collides them exactly like its clients do.
+// ------------------------------------------------------------------
+
+// Show a whole texture, or without one the area of its mask (nothing
+// without either); false if the sprite is left empty
+inline bool setSpriteImage(sf::Sprite& sprite, const sf::Texture* texture, const CollisionMask* mask) {
+    if (texture) {
+        sprite.setTexture(*texture, true);
+        return true;
+    }
+    if (mask && !mask->empty()) {
+        sprite.setTextureRect(sf::IntRect(0, 0, static_cast<int>(mask->getWidth()), static_cast<int>(mask->getHeight())));
+        return true;
+    }
+    return false;
+}
+
+struct Platform {
+    sf::RectangleShape shape;
+    const sf::Texture* texture;   // NEW
+    bool breakable;
+    float breakTimer;
+
+    // Colour-based platform (used for rock blocks etc.)
+    Platform(float x, float y, float w, float h, sf::Color color, bool canBreak = false)
+        : texture(nullptr), breakable(canBreak), breakTimer(0)
+    {
+        shape.setPosition(x, y);
+        shape.setSize(sf::Vector2f(w, h));
+
+        shape.setOutlineThickness(2);
+        shape.setOutlineColor(sf::Color(
+            0, 0, 0, 120  // or whatever looks good with your texture
+        ));
+
+        shape.setFillColor(color);
+    }
+
+    // Texture-based platform (used for iceBlock.png etc.)
+    Platform(float x, float y, float w, float h, const sf::Texture* tex, bool canBreak = false)
+        : texture(tex), breakable(canBreak), breakTimer(0)
+    {
+        shape.setPosition(x, y);
+        shape.setSize(sf::Vector2f(w, h));
+        if (texture) {
+            shape.setTexture(texture);
+        }
+    }
+};
+
+
+struct Diamond {
+    sf::Sprite sprite;
+    const sf::Texture* texture;
+    const CollisionMask* mask;    // of the texture; null = bounding box only
+    bool collected;
+    float animOffset;
+    sf::Vector2f basePos;
+
+    Diamond(float x, float y, const sf::Texture* tex, const CollisionMask* collisionMask = nullptr)
+        : texture(tex), mask(collisionMask), collected(false), animOffset(0.f), basePos(x, y)
+    {
+        if (setSpriteImage(sprite, texture, mask)) {
+
+            // Resize diamond to a nice size (similar to old height)
+            sf::FloatRect b = sprite.getLocalBounds();
+            float targetHeight = 26.f;        // tweak if you want bigger/smaller
+            float scale = targetHeight / b.height;
+            sprite.setScale(scale, scale);
+
+            sprite.setPosition(x, y);
+        }
+    }
+
+    void update() {
+        animOffset += 0.05f;
+        float yOffset = std::sin(animOffset) * 5;
+        sprite.setPosition(basePos.x, basePos.y + yOffset);
+    }
+
+    sf::FloatRect getBounds() const {
+        return sprite.getGlobalBounds();
+    }
+
+    // Bounding boxes first, then the opaque pixels of the diamond
+    bool hits(const sf::FloatRect& box) const {
+        if (!getBounds().intersects(box))
+            return false;
+        if (!mask || mask->empty())
+            return true;
+        return mask->overlaps(sprite.getInverseTransform().transformRect(box));
+    }
+
+    void draw(sf::RenderTarget& target) {
+        if (!collected)
+            target.draw(sprite);
+    }
+};
+
+
+
+
+struct Enemy {
+    sf::Sprite sprite;
+    sf::Vector2f position;
+    float speed;
+    int direction;
+    float minX, maxX;
+    sf::Vector2f home;        // spawn point; its height is returned to after a chase
+
+    // animation
+    const std::vector<sf::Texture>* textures;
+    const std::vector<CollisionMask>* masks;   // one per texture; null = bounding box only
+    int currentFrame;
+    float frameTimer;         // counts frames/time between swaps
+
+    Enemy(float x, float y, float spd, float min, float max,
+        const std::vector<sf::Texture>* texPtr, const std::vector<CollisionMask>* maskPtr = nullptr)
+        : position(x, y),
+        speed(spd),
+        direction(1),
+        minX(min),
+        maxX(max),
+        home(x, y),
+        textures(texPtr),
+        masks(maskPtr),
+        currentFrame(0),
+        frameTimer(0.f)
+    {
+        setFrame(0);
+        sprite.setPosition(position);
+    }
+
+    // Animation frames: the textures, or their masks without them
+    int frameCount() const {
+        if (textures && !textures->empty())
+            return static_cast<int>(textures->size());
+        return masks ? static_cast<int>(masks->size()) : 0;
+    }
+
+    void setFrame(int frame) {
+        if (frame >= frameCount())
+            return;
+        const sf::Texture* texture = (textures && !textures->empty()) ? &(*textures)[frame] : nullptr;
+        const CollisionMask* mask = (masks && frame < static_cast<int>(masks->size())) ? &(*masks)[frame] : nullptr;
+        setSpriteImage(sprite, texture, mask);
+    }
+
+    // steer: unit direction to chase in (see FlowField), zero to patrol
+    void update(sf::Vector2f steer = sf::Vector2f()) {
+        if (steer.x != 0.f || steer.y != 0.f) {
+            position += steer * speed;
+            if (steer.x != 0.f)
+                direction = (steer.x > 0.f) ? 1 : -1;
+        }
+        else {
+            // move horizontally like before (heading back in when a
+            // chase ended outside the patrol range)
+            position.x += direction * speed;
+            if (position.x <= minX) direction = 1;
+            else if (position.x >= maxX) direction = -1;
+
+            // small vertical bob
+            position.y += std::sin(position.x * 0.01f) * 0.2f;
+            if (std::abs(position.y - home.y) > 48.f)
+                position.y += (home.y > position.y ? 0.5f : -0.5f) * speed;
+        }
+        sprite.setPosition(position);
+
+        // flip sprite when changing direction
+        if (frameCount() > 0) {
+            float scaleX = (direction > 0) ? -1.f : 1.f;
+            sprite.setScale(scaleX, 1.f);
+        }
+
+        // animation: cycle through the 9 images
+        frameTimer += 0.15f;          // tweak speed if you want
+        if (frameTimer >= 1.f) {      // every ~1 frame here because we use arbitrary units
+            frameTimer = 0.f;
+            if (frameCount() > 0) {
+                currentFrame = (currentFrame + 1) % frameCount();
+                setFrame(currentFrame);
+            }
+        }
+    }
+
+    void draw(sf::RenderTarget& target) {
+        target.draw(sprite);
+    }
+
+    sf::FloatRect getBounds() const {
+        return sprite.getGlobalBounds();
+    }
+
+    // Bounding boxes first, then the opaque pixels of the current frame
+    // (the bat images are mostly transparent margin)
+    bool hits(const sf::FloatRect& box) const {
+        if (!getBounds().intersects(box))
+            return false;
+        if (!masks || currentFrame >= static_cast<int>(masks->size()) || (*masks)[currentFrame].empty())
+            return true;
+        return (*masks)[currentFrame].overlaps(sprite.getInverseTransform().transformRect(box));
+    }
+};
+
+
+struct Hammer {
+    // Size of tiles/axe.png: every level needs its hammer to be finished,
+    // so it keeps that size even without the image (headless worlds)
+    static const int ImageWidth = 599;
+    static const int ImageHeight = 628;
+
+    sf::Sprite sprite;
+    const sf::Texture* texture;
+    sf::Vector2f position;
+    bool collected;
+
+    Hammer(float x, float y, const sf::Texture* tex, const CollisionMask* mask = nullptr)
+        : texture(tex), position(x, y), collected(false)
+    {
+        if (!setSpriteImage(sprite, texture, mask))
+            sprite.setTextureRect(sf::IntRect(0, 0, ImageWidth, ImageHeight));
+
+        // --- Resize so the axe is only slightly bigger than before ---
+        sf::FloatRect bounds = sprite.getLocalBounds();
+        float targetHeight = 65.f;              // a bit bigger than old ~25px
+        float scale = targetHeight / bounds.height;
+        sprite.setScale(scale, scale);
+
+        // Position after scaling (x,y is top-left like before)
+        sprite.setPosition(position);
+    }
+
+
+    sf::FloatRect getBounds() const {
+        return sprite.getGlobalBounds();
+    }
+
+    void draw(sf::RenderTarget& target) {
+        target.draw(sprite);
+    }
+};
+
+
+struct Boulder {
+    sf::RectangleShape shape;
+    std::vector<sf::RectangleShape> cracks;
+    bool broken;
+
+    Boulder(float x, float y) : broken(false) {
+        shape.setSize(sf::Vector2f(50, 50));
+        shape.setPosition(x, y);
+        shape.setFillColor(sf::Color(85, 85, 85));
+        shape.setOutlineThickness(3);
+        shape.setOutlineColor(sf::Color(51, 51, 51));
+
+        for (int i = 0; i < 3; i++) {
+            sf::RectangleShape crack(sf::Vector2f(30, 2));
+            crack.setPosition(x + 10, y + 15 + i * 12);
+            crack.setFillColor(sf::Color(40, 40, 40));
+            cracks.push_back(crack);
+        }
+    }
+
+    void draw(sf::RenderTarget& target) {
+        target.draw(shape);
+        for (auto& crack : cracks) {
+            target.draw(crack);
+        }
+    }
+
+    sf::FloatRect getBounds() const {
+        return shape.getGlobalBounds();
+    }
+};
+
+// Kept for future hazards if you want them later
+struct FallingRock {
+    sf::CircleShape shape;
+    sf::Vector2f position;
+    sf::Vector2f velocity;
+    bool active;
+    bool triggered;
+    float resetTimer;
+    float startY;
+
+    FallingRock(float x, float y) : position(x, y), velocity(0, 0),
+        active(false), triggered(false), resetTimer(0), startY(y) {
+        shape.setRadius(12);
+        shape.setFillColor(sf::Color(100, 100, 100));
+        shape.setOutlineThickness(2);
+        shape.setOutlineColor(sf::Color(70, 70, 70));
+        shape.setPosition(position);
+    }
+
+    // canSee() tells whether nothing solid is in between; only asked
+    // once the player is in range
+    template <typename SightTest>
+    void update(const sf::FloatRect& playerBounds, SightTest canSee) {
+        if (!triggered && resetTimer <= 0) {
+            if (std::abs(playerBounds.left - position.x) < 40 && playerBounds.top > position.y && canSee()) {
+                triggered = true;
+                active = true;
+            }
+        }
+
+        if (active) {
+            velocity.y += 0.5f;
+            position.y += velocity.y;
+            shape.setPosition(position);
+
+            if (position.y > 650) {
+                active = false;
+                triggered = false;
+                resetTimer = 240;
+                position.y = startY;
+                velocity.y = 0;
+                shape.setPosition(position);
+            }
+        }
+
+        if (resetTimer > 0) resetTimer--;
+    }
+
+    sf::FloatRect getBounds() const {
+        return shape.getGlobalBounds();
+    }
+};
+
+struct Icicle {
+    sf::ConvexShape shape;
+    sf::Vector2f position;
+    sf::Vector2f velocity;
+    bool falling;
+    float fallTimer;
+    float resetTimer;
+    float startY;
+
+    Icicle(float x, float y) : position(x, y), velocity(0, 0), falling(false),
+        fallTimer(60), resetTimer(0), startY(y) {
+        shape.setPointCount(3);
+        shape.setPoint(0, sf::Vector2f(0, 0));
+        shape.setPoint(1, sf::Vector2f(8, 0));
+        shape.setPoint(2, sf::Vector2f(4, 30));
+        shape.setPosition(position);
+        shape.setFillColor(sf::Color(200, 230, 255));
+        shape.setOutlineThickness(1);
+        shape.setOutlineColor(sf::Color(150, 200, 255));
+    }
+
+    // Same as FallingRock::update
+    template <typename SightTest>
+    void update(const sf::FloatRect& playerBounds, SightTest canSee) {
+        if (!falling && resetTimer <= 0) {
+            if (std::abs(playerBounds.left - position.x) < 40 && playerBounds.top < position.y && canSee()) {
+                fallTimer--;
+                if (fallTimer <= 0) {
+                    falling = true;
+                }
+            }
+            else {
+                fallTimer = 60;
+            }
+        }
+
+        if (falling) {
+            velocity.y += 0.8f;
+            position.y += velocity.y;
+            shape.setPosition(position);
+
+            if (position.y > 650) {
+                falling = false;
+                resetTimer = 300;
+                position.y = startY;
+                velocity.y = 0;
+                fallTimer = 60;
+                shape.setPosition(position);
+            }
+        }
+
+        if (resetTimer > 0) resetTimer--;
+    }
+
+    sf::FloatRect getBounds() const {
+        return shape.getGlobalBounds();
+    }
+};
+
+struct LavaPool {
+    sf::RectangleShape shape;
+    sf::Vector2f position;
+    float animOffset;
+
+    LavaPool(float x, float y, float w) : position(x, y), animOffset(0) {
+        shape.setSize(sf::Vector2f(w, 30));
+        shape.setPosition(position);
+        shape.setFillColor(sf::Color(255, 100, 0));
+    }
+
+    void update() {
+        animOffset += 0.1f;
+        sf::Color lavaColor(255, static_cast<sf::Uint8>(100 + std::sin(animOffset) * 50), 0);
+        shape.setFillColor(lavaColor);
+    }
+
+    sf::FloatRect getBounds() const {
+        return shape.getGlobalBounds();
+    }
+};
+
+class Player {
+public:
+    // --- animation data ---
+    sf::Sprite sprite;
+    const std::vector<sf::Texture>* animTextures; // set in setAnimationTextures
+    int currentFrame;
+    float frameTimer;
+    int facingDir;   // 1 = right, -1 = left
+
+    enum AnimState { IDLE, RUNNING, JUMPING };
+    AnimState animState;
+
+    float spriteBaseScale; // controls how small the sprite is
+
+    // --- old shape pieces (used only as fallback) ---
+    sf::RectangleShape body;
+    sf::RectangleShape hat;
+    sf::CircleShape head;
+    sf::RectangleShape eyeLeft;
+    sf::RectangleShape eyeRight;
+    sf::RectangleShape mustacheLeft;
+    sf::RectangleShape mustacheRight;
+    sf::RectangleShape legLeft;
+    sf::RectangleShape legRight;
+
+    sf::Vector2f position;
+    sf::Vector2f velocity;
+    float speed;
+    float jumpPower;
+    bool grounded;
+    bool hasHammer;
+    float animTimer;
+
+    Player(float x, float y)
+        : animTextures(nullptr),
+        currentFrame(0),
+        frameTimer(0.f),
+        facingDir(1),
+        animState(IDLE),
+        spriteBaseScale(0.6f),
+        position(x, y),
+        velocity(0.f, 0.f),
+        speed(4.0f),
+        jumpPower(-12.0f),
+        grounded(false),
+        hasHammer(false),
+        animTimer(0.f)
+    {
+        body.setSize(sf::Vector2f(24, 28));
+        body.setFillColor(sf::Color::Red);
+
+        head.setRadius(14);
+        head.setFillColor(sf::Color(255, 220, 177));
+
+        hat.setSize(sf::Vector2f(28, 8));
+        hat.setFillColor(sf::Color::Red);
+
+        eyeLeft.setSize(sf::Vector2f(4, 4));
+        eyeLeft.setFillColor(sf::Color::Black);
+        eyeRight.setSize(sf::Vector2f(4, 4));
+        eyeRight.setFillColor(sf::Color::Black);
+
+        mustacheLeft.setSize(sf::Vector2f(8, 3));
+        mustacheLeft.setFillColor(sf::Color(101, 67, 33));
+        mustacheRight.setSize(sf::Vector2f(8, 3));
+        mustacheRight.setFillColor(sf::Color(101, 67, 33));
+
+        legLeft.setSize(sf::Vector2f(10, 6));
+        legLeft.setFillColor(sf::Color(50, 50, 200));
+        legRight.setSize(sf::Vector2f(10, 6));
+        legRight.setFillColor(sf::Color(50, 50, 200));
+
+        updatePosition();
+    }
+
+    void setAnimationTextures(const std::vector<sf::Texture>* texPtr) {
+        animTextures = texPtr;
+        currentFrame = 0;
+        frameTimer = 0.f;
+
+        if (animTextures && !animTextures->empty()) {
+            sprite.setTexture((*animTextures)[0]);
+
+            // origin at bottom centre so flipping works nicely
+            sf::FloatRect bounds = sprite.getLocalBounds();
+            sprite.setOrigin(bounds.width / 2.f, bounds.height);
+        }
+    }
+
+    void updatePosition() {
+        // existing leg wobble (used only in fallback draw)
+        animTimer += 0.15f;
+        float legOffset = grounded ? std::sin(animTimer) * 2 : 0;
+
+        body.setPosition(position.x + 8, position.y + 18);
+        head.setPosition(position.x + 4, position.y - 4);
+        hat.setPosition(position.x + 2, position.y - 10);
+        eyeLeft.setPosition(position.x + 10, position.y + 4);
+        eyeRight.setPosition(position.x + 18, position.y + 4);
+        mustacheLeft.setPosition(position.x + 6, position.y + 12);
+        mustacheRight.setPosition(position.x + 18, position.y + 12);
+        legLeft.setPosition(position.x + 8, position.y + 40 + legOffset);
+        legRight.setPosition(position.x + 22, position.y + 40 - legOffset);
+
+        // --- sprite animation ---
+        if (!animTextures || animTextures->empty())
+            return;
+
+        // Put sprite feet where the old body bottom was
+        sprite.setPosition(position.x + 16.f, position.y + 46.f);
+
+        // Decide animation state
+        if (!grounded) {
+            animState = JUMPING;
+        }
+        else if (std::fabs(velocity.x) > 0.1f) {
+            animState = RUNNING;
+        }
+        else {
+            animState = IDLE;
+        }
+
+        // Flip + scale
+        float sx = (facingDir > 0 ? 1.f : -1.f) * spriteBaseScale;
+        float sy = spriteBaseScale;
+        sprite.setScale(sx, sy);
+
+        // Frame ranges: 0 = idle, 1–4 = run, 5 = jump
+        int idleFrame = 0;
+        int runStart = 1;
+        int runEnd = 4;
+        int jumpFrame = 5;
+
+        switch (animState) {
+        case IDLE:
+            if (currentFrame != idleFrame) {
+                currentFrame = idleFrame;
+                sprite.setTexture((*animTextures)[currentFrame], true);
+            }
+            break;
+
+        case RUNNING:
+            frameTimer += 0.2f;   // animation speed
+            if (frameTimer >= 1.f) {
+                frameTimer = 0.f;
+                if (currentFrame < runStart || currentFrame > runEnd)
+                    currentFrame = runStart;
+                else
+                    currentFrame++;
+
+                if (currentFrame > runEnd)
+                    currentFrame = runStart;
+
+                sprite.setTexture((*animTextures)[currentFrame], true);
+            }
+            break;
+
+        case JUMPING:
+            if (currentFrame != jumpFrame) {
+                currentFrame = jumpFrame;
+                sprite.setTexture((*animTextures)[currentFrame], true);
+            }
+            break;
+        }
+    }
+
+    sf::FloatRect getBounds() const {
+        return sf::FloatRect(position.x, position.y, 32, 46);
+    }
+
+    void draw(sf::RenderTarget& target) {
+        if (animTextures && !animTextures->empty()) {
+            target.draw(sprite);
+        }
+        else {
+            // fallback if textures missing
+            target.draw(legLeft);
+            target.draw(legRight);
+            target.draw(body);
+            target.draw(head);
+            target.draw(hat);
+            target.draw(eyeLeft);
+            target.draw(eyeRight);
+            target.draw(mustacheLeft);
+            target.draw(mustacheRight);
+        }
+    }
+
+    void reset(float x, float y) {
+        position = sf::Vector2f(x, y);
+        velocity = sf::Vector2f(0, 0);
+        grounded = false;
+        hasHammer = false;
+
+        facingDir = 1;
+        animState = IDLE;
+        currentFrame = 0;
+        frameTimer = 0.f;
+
+        updatePosition();
+    }
+};
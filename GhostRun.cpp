@@ -0,0 +1,182 @@
+#include "GhostRun.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    const char Magic[8] = { 'O', 'R', 'E', 'O', 'G', 'H', 'S', 'T' };
+    const std::uint32_t Version = 1;
+    const float Subpixels = 8.f;        // position precision: 1/8 pixel
+    const std::size_t MaxFrameBytes = 5 + 5 + 1;
+
+    std::int32_t quantize(float v) {
+        return static_cast<std::int32_t>(std::lround(v * Subpixels));
+    }
+
+    // Small signed values -> small unsigned values (0, -1, 1, -2... -> 0, 1, 2, 3...)
+    std::uint32_t zigzag(std::int32_t v) {
+        return (static_cast<std::uint32_t>(v) << 1) ^ static_cast<std::uint32_t>(v >> 31);
+    }
+
+    std::int32_t unzigzag(std::uint32_t v) {
+        return static_cast<std::int32_t>(v >> 1) ^ -static_cast<std::int32_t>(v & 1);
+    }
+
+    void putVarint(std::vector<unsigned char>& out, std::uint32_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<unsigned char>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(v));
+    }
+
+    bool getVarint(const std::vector<unsigned char>& in, std::size_t& offset, std::uint32_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 35 && offset < in.size(); shift += 7) {
+            unsigned char b = in[offset++];
+            v |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    void writeU32(std::ostream& out, std::uint32_t value) {
+        char b[4];
+        for (int i = 0; i < 4; ++i)
+            b[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        out.write(b, 4);
+    }
+
+    bool readU32(std::istream& in, std::uint32_t& value) {
+        unsigned char b[4];
+        if (!in.read(reinterpret_cast<char*>(b), 4))
+            return false;
+        value = b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<std::uint32_t>(b[3]) << 24);
+        return true;
+    }
+}
+
+
+GhostRun::GhostRun()
+    : frames(0), lastX(0), lastY(0), full(false)
+{
+    bytes.reserve(MaxBytes);
+}
+
+void GhostRun::clear() {
+    bytes.clear();   // keeps the reserved capacity
+    frames = 0;
+    lastX = 0;
+    lastY = 0;
+    full = false;
+}
+
+bool GhostRun::append(const GhostFrame& frame) {
+    if (full || bytes.size() + MaxFrameBytes > MaxBytes) {
+        full = true;
+        return false;
+    }
+
+    // The first frame is a delta from (0, 0)
+    std::int32_t x = quantize(frame.x);
+    std::int32_t y = quantize(frame.y);
+    putVarint(bytes, zigzag(x - lastX));
+    putVarint(bytes, zigzag(y - lastY));
+    bytes.push_back(static_cast<unsigned char>((frame.facing < 0 ? 0x80 : 0) | (frame.animFrame & 0x7F)));
+
+    lastX = x;
+    lastY = y;
+    frames++;
+    return true;
+}
+
+void GhostRun::copyFrom(const GhostRun& other) {
+    bytes.assign(other.bytes.begin(), other.bytes.end());   // fits in the reserved capacity
+    frames = other.frames;
+    lastX = other.lastX;
+    lastY = other.lastY;
+    full = other.full;
+}
+
+bool GhostRun::saveToFile(const std::string& filename, int level) const {
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (!out)
+        return false;
+
+    out.write(Magic, sizeof(Magic));
+    writeU32(out, Version);
+    writeU32(out, static_cast<std::uint32_t>(level));
+    writeU32(out, static_cast<std::uint32_t>(frames));
+    writeU32(out, static_cast<std::uint32_t>(bytes.size()));
+    if (!bytes.empty())
+        out.write(reinterpret_cast<const char*>(&bytes[0]), static_cast<std::streamsize>(bytes.size()));
+
+    return static_cast<bool>(out);
+}
+
+bool GhostRun::loadFromFile(const std::string& filename, int level) {
+    clear();
+
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in)
+        return false;
+
+    char magic[8];
+    std::uint32_t version, fileLevel, frameCount, byteCount;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+        !readU32(in, version) || version != Version ||
+        !readU32(in, fileLevel) || fileLevel != static_cast<std::uint32_t>(level) ||
+        !readU32(in, frameCount) || !readU32(in, byteCount) || byteCount > MaxBytes)
+        return false;
+
+    bytes.resize(byteCount);
+    if (byteCount > 0 && !in.read(reinterpret_cast<char*>(&bytes[0]), byteCount)) {
+        clear();
+        return false;
+    }
+
+    // Decode once: checks the data and restores the last position
+    frames = frameCount;
+    Reader reader(this);
+    GhostFrame frame;
+    std::size_t decoded = 0;
+    while (reader.next(frame))
+        decoded++;
+    if (decoded != frameCount) {
+        clear();
+        return false;
+    }
+
+    lastX = quantize(frame.x);
+    lastY = quantize(frame.y);
+    return true;
+}
+
+
+GhostRun::Reader::Reader(const GhostRun* run)
+    : run(run), offset(0), frame(0), x(0), y(0)
+{
+}
+
+bool GhostRun::Reader::next(GhostFrame& out) {
+    if (!run || frame >= run->frames)
+        return false;
+
+    std::uint32_t dx, dy;
+    if (!getVarint(run->bytes, offset, dx) || !getVarint(run->bytes, offset, dy) ||
+        offset >= run->bytes.size())
+        return false;
+    unsigned char state = run->bytes[offset++];
+
+    x += unzigzag(dx);
+    y += unzigzag(dy);
+    frame++;
+
+    out.x = x / Subpixels;
+    out.y = y / Subpixels;
+    out.facing = (state & 0x80) ? -1 : 1;
+    out.animFrame = state & 0x7F;
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Ghost runs: the player's state recorded every tick, so that the best
+// run of a level can be raced against.
+//
+// Frames are stored as the difference from the previous frame:
+// position deltas in 1/8 pixel, zigzag + varint encoded (1 byte each
+// while running, 2 while jumping or falling fast), then one byte for
+// facing and animation frame. About 3 bytes per tick, ~11 KB a minute.
+//
+// The buffer is reserved once (MaxBytes); recording and playback never
+// allocate. A run that does not fit is cut (and reported as full).
+//
+// File layout, integers little-endian:
+//   magic "OREOGHST", uint32 version, uint32 level,
+//   uint32 frame count, uint32 byte count, bytes
+// ------------------------------------------------------------------
+struct GhostFrame {
+    float x = 0.f;
+    float y = 0.f;
+    int facing = 1;      // 1 = right, -1 = left
+    int animFrame = 0;   // index in the player's animation textures
+};
+
+class GhostRun {
+public:
+    static const std::size_t MaxBytes = 256 * 1024;   // ~20 minutes of play
+
+    // Sequential decoder, one frame per call to next()
+    class Reader {
+    public:
+        explicit Reader(const GhostRun* run = nullptr);
+
+        // Decode the next frame; false at the end of the run
+        bool next(GhostFrame& frame);
+
+    private:
+        const GhostRun* run;
+        std::size_t offset;
+        std::size_t frame;
+        std::int32_t x, y;
+    };
+
+    GhostRun();
+
+    void clear();
+
+    // Append a frame; false (frame dropped) once the buffer is full
+    bool append(const GhostFrame& frame);
+
+    std::size_t frameCount() const { return frames; }
+    std::size_t byteCount() const { return bytes.size(); }
+    bool isFull() const { return full; }
+    bool empty() const { return frames == 0; }
+
+    // Copy another run without reallocating
+    void copyFrom(const GhostRun& other);
+
+    bool saveToFile(const std::string& filename, int level) const;
+
+    // Load the run of `level`; on failure the run is left empty
+    bool loadFromFile(const std::string& filename, int level);
+
+private:
+    std::vector<unsigned char> bytes;
+    std::size_t frames;
+    std::int32_t lastX, lastY;   // position of the last frame, 1/8 pixel
+    bool full;
+};
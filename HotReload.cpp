@@ -0,0 +1,206 @@
+#include "HotReload.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define ESCAPEOREO_HAS_INOTIFY 1
+#endif
+
+
+HotReload::HotReload()
+    : inotifyFd(-1), busy(false), jobsDone(false), worker(&HotReload::decode, this), reloads(0)
+{
+}
+
+HotReload::~HotReload() {
+    worker.wait();
+#ifdef ESCAPEOREO_HAS_INOTIFY
+    if (inotifyFd >= 0)
+        close(inotifyFd);
+#endif
+}
+
+bool HotReload::start() {
+#ifdef ESCAPEOREO_HAS_INOTIFY
+    if (inotifyFd >= 0)
+        return true;
+
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+        return false;
+
+    for (const Entry& entry : entries)
+        watchDirectory(entry.directory);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void HotReload::addTexture(const std::string& filename, sf::Texture& texture, CollisionMask* mask,
+    std::function<void()> reloaded) {
+    Entry entry;
+    entry.filename = filename;
+    entry.texture = &texture;
+    entry.mask = mask;
+    entry.textureReloaded = reloaded;
+    addEntry(entry);
+}
+
+void HotReload::addLevelFile(const std::string& filename, std::function<void(const std::string& text)> reloaded) {
+    Entry entry;
+    entry.filename = filename;
+    entry.texture = nullptr;
+    entry.mask = nullptr;
+    entry.fileReloaded = reloaded;
+    addEntry(entry);
+}
+
+void HotReload::addEntry(const Entry& added) {
+    Entry entry = added;
+    std::size_t slash = entry.filename.find_last_of("/\\");
+    entry.directory = slash == std::string::npos ? "." : entry.filename.substr(0, slash);
+    entry.name = slash == std::string::npos ? entry.filename : entry.filename.substr(slash + 1);
+    entries.push_back(entry);
+
+    if (inotifyFd >= 0)
+        watchDirectory(entry.directory);
+}
+
+void HotReload::watchDirectory(const std::string& directory) {
+#ifdef ESCAPEOREO_HAS_INOTIFY
+    for (const auto& watch : watches) {
+        if (watch.second == directory)
+            return;
+    }
+
+    // Written in place, or saved to a temporary file and renamed
+    int watch = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0) {
+        std::cout << "Hot reload: cannot watch " << directory << "\n";
+        return;
+    }
+    watches.push_back(std::make_pair(watch, directory));
+#else
+    (void)directory;
+#endif
+}
+
+void HotReload::readEvents() {
+#ifdef ESCAPEOREO_HAS_INOTIFY
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            return;   // EAGAIN: nothing more this frame
+
+        for (char* p = buffer; p < buffer + length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+            if (event->len == 0)
+                continue;
+
+            const std::string* directory = nullptr;
+            for (const auto& watch : watches) {
+                if (watch.first == event->wd)
+                    directory = &watch.second;
+            }
+            if (!directory)
+                continue;
+
+            for (std::size_t i = 0; i < entries.size(); ++i) {
+                if (entries[i].directory == *directory && entries[i].name == event->name &&
+                    std::find(pending.begin(), pending.end(), i) == pending.end())
+                    pending.push_back(i);
+            }
+        }
+    }
+#endif
+}
+
+void HotReload::update() {
+    if (inotifyFd < 0)
+        return;
+
+    readEvents();
+
+    if (busy) {
+        {
+            sf::Lock lock(mutex);
+            if (!jobsDone)
+                return;
+            jobsDone = false;
+        }
+        busy = false;
+        apply();
+    }
+
+    if (pending.empty())
+        return;
+
+    // The worker gets the jobs to itself until it sets jobsDone
+    jobs.resize(pending.size());
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        jobs[i].entry = pending[i];
+        jobs[i].ok = false;
+    }
+    pending.clear();
+    busy = true;
+    worker.launch();
+}
+
+void HotReload::decode() {
+    SFML_TRACE_THREAD_NAME("Hot reload decoder");
+    SFML_TRACE_ZONE("HotReload::decode");
+
+    for (Job& job : jobs) {
+        const Entry& entry = entries[job.entry];
+        if (entry.texture) {
+            job.ok = job.image.loadFromFile(entry.filename);
+            if (job.ok && entry.mask)
+                job.mask.build(job.image);
+        }
+        else {
+            std::ifstream in(entry.filename.c_str(), std::ios::binary);
+            std::ostringstream text;
+            text << in.rdbuf();
+            job.ok = static_cast<bool>(in);
+            job.text = text.str();
+        }
+    }
+
+    sf::Lock lock(mutex);
+    jobsDone = true;
+}
+
+void HotReload::apply() {
+    for (Job& job : jobs) {
+        Entry& entry = entries[job.entry];
+        if (!job.ok) {
+            std::cout << "Hot reload: failed to read " << entry.filename << "\n";
+            continue;
+        }
+
+        if (entry.texture) {
+            // Same sf::Texture object: whatever points at it follows
+            if (!entry.texture->loadFromImage(job.image))
+                continue;
+            if (entry.mask)
+                std::swap(*entry.mask, job.mask);
+            if (entry.textureReloaded)
+                entry.textureReloaded();
+        }
+        else if (entry.fileReloaded) {
+            entry.fileReloaded(job.text);
+        }
+
+        reloads++;
+        std::cout << "Reloaded " << entry.filename << "\n";
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "CollisionMask.hpp"
+
+// ------------------------------------------------------------------
+// Hot reload of textures and level files while the game runs
+//
+// The directories of the registered files are watched with inotify
+// (Linux only; elsewhere start() fails and nothing is ever reloaded).
+// When a file is written, or moved into place, only that file is read
+// and decoded again, on a worker thread; update(), called once per
+// frame at the frame boundary, then swaps the result in:
+//  - a texture is reloaded in place, so every sprite and shape pointing
+//    at it shows the new image (its collision mask, if any, is rebuilt
+//    with it). A texture that changed size keeps the texture rects set
+//    before: `reloaded` is where to fix them;
+//  - a level file is handed as text to its callback.
+//
+// Files are read from disk, even those otherwise served by the asset
+// pack.
+// ------------------------------------------------------------------
+class HotReload {
+public:
+    HotReload();
+    ~HotReload();   // waits for a decode in progress
+
+    HotReload(const HotReload&) = delete;
+    HotReload& operator=(const HotReload&) = delete;
+
+    // Open the watcher; false where inotify is not available
+    bool start();
+
+    // Register a file; its directory is watched from start() on
+    void addTexture(const std::string& filename, sf::Texture& texture, CollisionMask* mask = nullptr,
+        std::function<void()> reloaded = nullptr);
+    void addLevelFile(const std::string& filename, std::function<void(const std::string& text)> reloaded);
+
+    // Once per frame: collect changed files, start decoding them, swap
+    // in what the worker has finished
+    void update();
+
+    std::size_t reloadCount() const { return reloads; }
+
+private:
+    struct Entry {
+        std::string filename;
+        std::string directory;                 // as watched ("." for the working directory)
+        std::string name;                      // inside the directory
+        sf::Texture* texture;                  // null = level file
+        CollisionMask* mask;
+        std::function<void()> textureReloaded;
+        std::function<void(const std::string&)> fileReloaded;
+    };
+
+    // One changed file, decoded by the worker
+    struct Job {
+        std::size_t entry;
+        bool ok;
+        sf::Image image;
+        CollisionMask mask;
+        std::string text;
+    };
+
+    void addEntry(const Entry& entry);
+    void watchDirectory(const std::string& directory);
+    void readEvents();
+    void apply();
+
+    // Worker thread entry point: decode every job
+    void decode();
+
+    std::vector<Entry> entries;
+    std::vector<std::pair<int, std::string> > watches;   // inotify watch -> directory
+    std::vector<std::size_t> pending;          // changed entries, waiting for the worker
+    int inotifyFd;                             // -1 = not started
+
+    std::vector<Job> jobs;                     // owned by the worker while busy
+    bool busy;
+    bool jobsDone;                             // protected by mutex
+    sf::Mutex mutex;
+    sf::Thread worker;
+    std::size_t reloads;
+};
@@ -0,0 +1,182 @@
+#include "LevelEditor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+    const char* const ToolNames[LevelEditor::TOOL_COUNT] = {
+        "Rock block", "Ice block", "Seaweed block", "Diamond", "Bat",
+        "Icicle", "Lava", "Hammer", "Exit door"
+    };
+
+    const sf::Color RockColor(60, 40, 40);
+    const sf::Color GridColor(255, 255, 255, 40);
+    const sf::Color CursorColor(255, 215, 0);
+}
+
+const float LevelEditor::ScrollSpeed = 12.f;
+
+
+LevelEditor::LevelEditor(World& editedWorld)
+    : world(editedWorld),
+    tool(ROCK_BLOCK),
+    lastPainted(-1, -1),
+    painting(false),
+    gridLines(sf::Lines)
+{
+}
+
+void LevelEditor::begin(const sf::View& view) {
+    // One camera over the whole window, whatever the split-screen layout
+    camera = sf::View(view.getCenter(), sf::Vector2f(WORLD_HEIGHT * 4.f / 3.f, WORLD_HEIGHT));
+    painting = false;
+    status.clear();
+}
+
+sf::Vector2f LevelEditor::mouseInWorld(const sf::RenderWindow& window) const {
+    return window.mapPixelToCoords(sf::Mouse::getPosition(window), camera);
+}
+
+sf::Vector2i LevelEditor::tileOf(sf::Vector2f point) {
+    return sf::Vector2i(static_cast<int>(std::floor(point.x / TileGrid::CellSize)),
+        static_cast<int>(std::floor(point.y / TileGrid::CellSize)));
+}
+
+void LevelEditor::handleEvent(const sf::Event& event, const sf::RenderWindow& window) {
+    if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code >= sf::Keyboard::Num1 && event.key.code < sf::Keyboard::Num1 + TOOL_COUNT)
+            tool = static_cast<Tool>(event.key.code - sf::Keyboard::Num1);
+        else if (event.key.code == sf::Keyboard::S)
+            save();
+    }
+    else if (event.type == sf::Event::MouseButtonPressed) {
+        sf::Vector2f point = mouseInWorld(window);
+        if (event.mouseButton.button == sf::Mouse::Left) {
+            apply(point);
+            painting = tool <= SEAWEED_BLOCK;
+            lastPainted = tileOf(point);
+        }
+        else if (event.mouseButton.button == sf::Mouse::Right) {
+            erase(point);
+        }
+    }
+    else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
+        painting = false;
+    }
+}
+
+void LevelEditor::update(const sf::RenderWindow& window) {
+    using K = sf::Keyboard;
+    float dx = 0.f;
+    if (K::isKeyPressed(K::Left) || K::isKeyPressed(K::A)) dx -= ScrollSpeed;
+    if (K::isKeyPressed(K::Right) || K::isKeyPressed(K::D)) dx += ScrollSpeed;
+
+    // Any width: a level may have been grown past WORLD_WIDTH
+    float half = camera.getSize().x / 2.f;
+    camera.setCenter(std::max(half, camera.getCenter().x + dx), WORLD_HEIGHT / 2.f);
+
+    cursor = mouseInWorld(window);
+
+    // Strokes paint each tile once, not every frame
+    if (painting && sf::Mouse::isButtonPressed(sf::Mouse::Left)) {
+        sf::Vector2i tile = tileOf(cursor);
+        if (tile != lastPainted) {
+            apply(cursor);
+            lastPainted = tile;
+        }
+    }
+}
+
+void LevelEditor::apply(sf::Vector2f point) {
+    sf::Vector2i tile = tileOf(point);
+    sf::Vector2f corner(static_cast<float>(tile.x * TileGrid::CellSize), static_cast<float>(tile.y * TileGrid::CellSize));
+
+    bool done = true;
+    switch (tool) {
+    case ROCK_BLOCK:    done = world.paintTile(tile, BLOCK_ROCK, RockColor); break;
+    case ICE_BLOCK:     done = world.paintTile(tile, BLOCK_ICE, RockColor); break;
+    case SEAWEED_BLOCK: done = world.paintTile(tile, BLOCK_SEAWEED, RockColor); break;
+
+    // Entities snap to the tile like the built-in levels place them
+    case DIAMOND:       done = world.placeEntity(ENTITY_DIAMOND, corner + sf::Vector2f(4.f, 0.f)); break;
+    case BAT:           done = world.placeEntity(ENTITY_BAT, corner); break;
+    case ICICLE:        done = world.placeEntity(ENTITY_ICICLE, corner + sf::Vector2f(12.f, 0.f)); break;
+    case LAVA:          done = world.placeEntity(ENTITY_LAVA, corner + sf::Vector2f(0.f, 2.f)); break;
+    case HAMMER:        done = world.placeEntity(ENTITY_HAMMER, corner); break;
+    case DOOR:          done = world.placeEntity(ENTITY_DOOR, corner); break;
+    default: break;
+    }
+
+    // The level's pools are fixed: say so rather than ignoring the click
+    if (!done)
+        status = std::string(ToolNames[tool]) + ": the level is full, erase some first";
+}
+
+void LevelEditor::erase(sf::Vector2f point) {
+    // Entities first: they sit in front of the blocks
+    if (!world.eraseEntity(point))
+        world.clearTile(tileOf(point));
+}
+
+void LevelEditor::save() {
+    std::string filename = World::levelFileName(world.currentLevel);
+    status = world.saveLevelFile(filename) ? "Saved " + filename : "Could not write " + filename;
+}
+
+void LevelEditor::draw(sf::RenderTarget& target) {
+    // Tile lines over the visible part of the level only
+    const sf::View& view = target.getView();
+    sf::FloatRect visible(view.getCenter() - view.getSize() / 2.f, view.getSize());
+    const float size = static_cast<float>(TileGrid::CellSize);
+
+    float left = std::floor(visible.left / size) * size;
+    float top = std::floor(visible.top / size) * size;
+    float right = visible.left + visible.width;
+    float bottom = visible.top + visible.height;
+
+    gridLines.clear();
+    for (float x = left; x <= right; x += size) {
+        gridLines.append(sf::Vertex(sf::Vector2f(x, top), GridColor));
+        gridLines.append(sf::Vertex(sf::Vector2f(x, bottom), GridColor));
+    }
+    for (float y = top; y <= bottom; y += size) {
+        gridLines.append(sf::Vertex(sf::Vector2f(left, y), GridColor));
+        gridLines.append(sf::Vertex(sf::Vector2f(right, y), GridColor));
+    }
+    target.draw(gridLines);
+
+    sf::Vector2i tile = tileOf(cursor);
+    sf::RectangleShape highlight(sf::Vector2f(size, size));
+    highlight.setPosition(tile.x * size, tile.y * size);
+    highlight.setFillColor(sf::Color::Transparent);
+    highlight.setOutlineThickness(2.f);
+    highlight.setOutlineColor(CursorColor);
+    target.draw(highlight);
+}
+
+void LevelEditor::drawHUD(sf::RenderTarget& target, const sf::Font* font) const {
+    sf::RectangleShape bar(sf::Vector2f(target.getView().getSize().x, 56.f));
+    bar.setPosition(0.f, target.getView().getSize().y - 56.f);
+    bar.setFillColor(sf::Color(25, 15, 25, 220));
+    target.draw(bar);
+
+    if (!font)
+        return;
+
+    sf::Vector2i tile = tileOf(cursor);
+    std::ostringstream line;
+    line << "EDITOR  Level " << world.currentLevel << "  Tool: " << ToolNames[tool]
+        << "  Tile " << tile.x << ", " << tile.y;
+    if (!status.empty())
+        line << "  (" << status << ")";
+    line << "\n1-9 Tool   LMB Paint/Place   RMB Erase   A/D Scroll   S Save   ESC Back";
+
+    sf::Text text;
+    text.setFont(*font);
+    text.setCharacterSize(16);
+    text.setFillColor(sf::Color(255, 245, 220));
+    text.setString(line.str());
+    text.setPosition(10.f, bar.getPosition().y + 6.f);
+    target.draw(text);
+}
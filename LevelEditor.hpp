@@ -0,0 +1,75 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+
+#include "World.hpp"
+
+// ------------------------------------------------------------------
+// In-game level editor, entered from the pause menu
+//
+// Edits the World in place: the left mouse button paints blocks (drag
+// for a stroke) or places an entity, the right one erases. Painting
+// goes through World::paintTile / clearTile, which only rebuild the
+// touched batch chunk and grid cells, so a stroke costs the same on a
+// huge level as on a small one. S writes the level to its level file
+// (World::levelFileName), which loadLevel then prefers to the built-in
+// layout.
+// ------------------------------------------------------------------
+class LevelEditor {
+public:
+    enum Tool {
+        ROCK_BLOCK,
+        ICE_BLOCK,
+        SEAWEED_BLOCK,
+        DIAMOND,
+        BAT,
+        ICICLE,
+        LAVA,
+        HAMMER,
+        DOOR,
+        TOOL_COUNT
+    };
+
+    explicit LevelEditor(World& world);
+
+    // Start editing, the camera where `view` looks
+    void begin(const sf::View& view);
+
+    // Keys and clicks; `window` maps the mouse to the world
+    void handleEvent(const sf::Event& event, const sf::RenderWindow& window);
+
+    // Once per frame: camera scrolling, and painting while the left
+    // button is held
+    void update(const sf::RenderWindow& window);
+
+    // Camera of the editor, over the whole window
+    const sf::View& view() const { return camera; }
+
+    // Tile grid and cursor, in the world view
+    void draw(sf::RenderTarget& target);
+
+    // Tool and help line, in screen space (no text without a font)
+    void drawHUD(sf::RenderTarget& target, const sf::Font* font) const;
+
+private:
+    static const float ScrollSpeed;      // world pixels per frame
+
+    sf::Vector2f mouseInWorld(const sf::RenderWindow& window) const;
+    static sf::Vector2i tileOf(sf::Vector2f point);
+
+    void apply(sf::Vector2f point);
+    void erase(sf::Vector2f point);
+    void save();
+
+    World& world;
+    sf::View camera;
+    Tool tool;
+
+    sf::Vector2f cursor;                 // world pixels
+    sf::Vector2i lastPainted;            // tile of the stroke in progress
+    bool painting;
+
+    sf::VertexArray gridLines;           // refilled every frame, storage kept
+    std::string status;                  // result of the last save, or the last refused edit
+};
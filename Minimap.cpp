@@ -0,0 +1,127 @@
+#include "Minimap.hpp"
+#include "SplitScreen.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const sf::Color MapBackground(10, 8, 20, 200);
+    const sf::Color TexturedBlock(170, 200, 220);   // ice / seaweed blocks have a white fill
+
+    // Small square marker centred on `centre`, written to quad[0..3]
+    void setMarker(sf::Vertex* quad, sf::Vector2f centre, float size, sf::Color color) {
+        float h = size / 2.f;
+        quad[0] = sf::Vertex(sf::Vector2f(centre.x - h, centre.y - h), color);
+        quad[1] = sf::Vertex(sf::Vector2f(centre.x + h, centre.y - h), color);
+        quad[2] = sf::Vertex(sf::Vector2f(centre.x + h, centre.y + h), color);
+        quad[3] = sf::Vertex(sf::Vector2f(centre.x - h, centre.y + h), color);
+    }
+
+    sf::Vector2f centreOf(const sf::FloatRect& rect) {
+        return sf::Vector2f(rect.left + rect.width / 2.f, rect.top + rect.height / 2.f);
+    }
+}
+
+
+Minimap::Minimap()
+    : imageDone(false), worker(&Minimap::rasterize, this), ready(false)
+{
+}
+
+Minimap::~Minimap() {
+    worker.wait();
+}
+
+void Minimap::bake(const World& world) {
+    // At most one bake at a time; a previous one is tiny, just let it finish
+    worker.wait();
+
+    {
+        sf::Lock lock(mutex);
+        imageDone = false;
+    }
+
+    blocks.clear();   // keeps its capacity from one level to the next
+    for (const Platform& platform : world.platforms) {
+        Block block;
+        block.rect = sf::FloatRect(platform.shape.getPosition(), platform.shape.getSize());   // without outline
+        block.color = platform.texture ? TexturedBlock : platform.shape.getFillColor();
+        block.color.a = 255;
+        blocks.push_back(block);
+    }
+
+    worker.launch();
+}
+
+void Minimap::rasterize() {
+    SFML_TRACE_THREAD_NAME("Minimap baker");
+    SFML_TRACE_ZONE("Minimap::rasterize");
+
+    unsigned int width = static_cast<unsigned int>(std::ceil(WORLD_WIDTH / TileSize));
+    unsigned int height = static_cast<unsigned int>(std::ceil(WORLD_HEIGHT / TileSize));
+    image.create(width, height, MapBackground);
+
+    // A block colours every tile it overlaps by more than a pixel
+    for (const Block& block : blocks) {
+        int left = static_cast<int>(std::floor((block.rect.left + 1.f) / TileSize));
+        int top = static_cast<int>(std::floor((block.rect.top + 1.f) / TileSize));
+        int right = static_cast<int>(std::ceil((block.rect.left + block.rect.width - 1.f) / TileSize));
+        int bottom = static_cast<int>(std::ceil((block.rect.top + block.rect.height - 1.f) / TileSize));
+
+        for (int y = std::max(top, 0); y < std::min(bottom, static_cast<int>(height)); ++y)
+            for (int x = std::max(left, 0); x < std::min(right, static_cast<int>(width)); ++x)
+                image.setPixel(x, y, block.color);
+    }
+
+    sf::Lock lock(mutex);
+    imageDone = true;
+}
+
+void Minimap::update() {
+    {
+        sf::Lock lock(mutex);
+        if (!imageDone)
+            return;
+        imageDone = false;
+    }
+
+    // The worker is finished with the image once imageDone is set
+    ready = texture.loadFromImage(image);
+}
+
+void Minimap::draw(sf::RenderTarget& target, const sf::FloatRect& area, const World& world) const {
+    if (!ready)
+        return;
+
+    sf::Sprite map(texture);
+    sf::Vector2u size = texture.getSize();
+    map.setPosition(area.left, area.top);
+    map.setScale(area.width / size.x, area.height / size.y);
+    target.draw(map);
+
+    // World position -> map position
+    float sx = area.width / WORLD_WIDTH;
+    float sy = area.height / WORLD_HEIGHT;
+    auto toMap = [&](sf::Vector2f p) { return sf::Vector2f(area.left + p.x * sx, area.top + p.y * sy); };
+
+    // Door, hammer and players: 2 + MAX_PLAYERS quads at most, kept on the stack
+    sf::Vertex markers[(2 + MAX_PLAYERS) * 4];
+    std::size_t count = 0;
+
+    setMarker(&markers[count], toMap(centreOf(world.exitDoor.getGlobalBounds())), 6.f, sf::Color(255, 215, 0));
+    count += 4;
+
+    const Hammer* hammer = world.hammers.get(world.hammer);
+    if (hammer && !hammer->collected) {
+        setMarker(&markers[count], toMap(centreOf(hammer->getBounds())), 5.f, sf::Color(255, 140, 40));
+        count += 4;
+    }
+
+    for (int i = 0; i < world.playerCount; ++i) {
+        setMarker(&markers[count], toMap(centreOf(world.players[i].getBounds())), 5.f, SplitScreen::playerColor(i));
+        count += 4;
+    }
+
+    target.draw(markers, count, sf::Quads);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+class World;
+
+// ------------------------------------------------------------------
+// Minimap of the current level
+//
+// Baked once per level, and again after editor changes: the level's blocks are rasterized into an
+// sf::Image, one pixel per 32x32 tile, on a worker thread, and the
+// image is uploaded to a texture on the next frame. Drawing it is then
+// one textured quad, plus one vertex array for the live markers
+// (players, hammer, door).
+// ------------------------------------------------------------------
+class Minimap {
+public:
+    static const unsigned int TileSize = 32;   // world pixels per map pixel
+
+    Minimap();
+    ~Minimap();   // waits for a bake in progress
+
+    Minimap(const Minimap&) = delete;
+    Minimap& operator=(const Minimap&) = delete;
+
+    // Start baking the map of the world's current level. The blocks are
+    // copied here (on the calling thread); the worker never reads the World.
+    void bake(const World& world);
+
+    // Upload a finished bake; call once per frame from the render thread
+    void update();
+
+    // True once a map has been uploaded
+    bool isReady() const { return ready; }
+
+    // Draw the map stretched over `area` (in the target's current view
+    // coordinates), with the markers on top
+    void draw(sf::RenderTarget& target, const sf::FloatRect& area, const World& world) const;
+
+private:
+    struct Block {
+        sf::FloatRect rect;
+        sf::Color color;
+    };
+
+    // Worker thread entry point: rasterize `blocks` into `image`
+    void rasterize();
+
+    std::vector<Block> blocks;   // snapshot of the level, read by the worker
+    sf::Image image;             // written by the worker
+    bool imageDone;              // protected by mutex
+    sf::Mutex mutex;
+    sf::Thread worker;
+
+    sf::Texture texture;
+    bool ready;
+};
@@ -0,0 +1,443 @@
+#include "NavGraph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+    const float Diagonal = 1.41421356f;
+
+    // The 8 neighbours, orthogonal ones first
+    const int NeighbourX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int NeighbourY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+}
+
+
+NavGraph::NavGraph()
+    : navColumns(0), navRows(0), builds(0), edits(0), walkStale(false), searchNumber(0), hits(0)
+{
+    for (auto& entry : cache)
+        entry.length = -1;
+}
+
+void NavGraph::build(const TileGrid& grid) {
+    navOrigin = grid.origin();
+    navColumns = grid.columns();
+    navRows = grid.rows();
+    builds++;
+
+    std::size_t cells = static_cast<std::size_t>(navColumns) * navRows;
+    open.resize(cells);
+    for (int y = 0; y < navRows; ++y)
+        for (int x = 0; x < navColumns; ++x)
+            open[y * navColumns + x] = !grid.isSolidCell(x, y);
+
+    buildWalkGraph();
+    walkStale = false;
+
+    // Search scratch covers the larger of the two graphs
+    std::size_t nodes = std::max(cells, walkSpans.size());
+    cost.resize(nodes);
+    cameFrom.resize(nodes);
+    visited.assign(nodes, 0);
+    searchNumber = 0;
+    frontier.reserve(nodes);
+    pathScratch.resize(nodes);
+
+    for (auto& entry : cache)
+        entry.length = -1;
+}
+
+void NavGraph::update(const TileGrid& grid, const sf::FloatRect& area) {
+    if (grid.columns() != navColumns || grid.rows() != navRows || grid.origin() != navOrigin) {
+        build(grid);   // the grid itself was rebuilt
+        return;
+    }
+
+    sf::Vector2i first = cellOf(sf::Vector2f(area.left, area.top));
+    sf::Vector2i last = cellOf(sf::Vector2f(area.left + area.width, area.top + area.height));
+    for (int y = std::max(0, first.y); y <= std::min(navRows - 1, last.y); ++y)
+        for (int x = std::max(0, first.x); x <= std::min(navColumns - 1, last.x); ++x)
+            open[y * navColumns + x] = !grid.isSolidCell(x, y);
+
+    // Re-linking the spans scans the whole level: leave it to the next
+    // walk query, so painting a stroke stays cheap on any level size
+    walkStale = true;
+    edits++;
+
+    for (auto& entry : cache)
+        entry.length = -1;
+}
+
+void NavGraph::refreshWalkGraph() {
+    if (!walkStale)
+        return;
+
+    buildWalkGraph();
+    walkStale = false;
+
+    // Spans may outnumber the cells' scratch now (never in practice)
+    if (walkSpans.size() > cost.size()) {
+        cost.resize(walkSpans.size());
+        cameFrom.resize(walkSpans.size());
+        visited.resize(walkSpans.size(), 0);
+        pathScratch.resize(walkSpans.size());
+    }
+}
+
+void NavGraph::buildWalkGraph() {
+    std::size_t cells = open.size();
+
+    // Walkable spans, row by row, left to right
+    walkSpans.clear();
+    cellSpan.assign(cells, -1);
+    for (int y = 0; y + 1 < navRows; ++y) {
+        for (int x = 0; x < navColumns; ++x) {
+            bool walkable = open[y * navColumns + x] && !open[(y + 1) * navColumns + x];
+            if (!walkable)
+                continue;
+
+            if (x > 0 && cellSpan[y * navColumns + x - 1] >= 0) {
+                walkSpans.back().last = x;
+            }
+            else {
+                Span span = { y, x, x };
+                walkSpans.push_back(span);
+            }
+            cellSpan[y * navColumns + x] = static_cast<int>(walkSpans.size()) - 1;
+        }
+    }
+
+    // Row -> first span of the row, for the link search below
+    rowStart.assign(navRows + 1, 0);
+    for (const auto& span : walkSpans)
+        rowStart[span.row + 1]++;
+    for (int y = 0; y < navRows; ++y)
+        rowStart[y + 1] += rowStart[y];
+
+    // Jump up to JumpHeight rows, drop down to MaxDrop rows, across gaps
+    // of up to JumpDistance cells; walking off an end to a neighbouring
+    // span of the same row counts too
+    links.clear();
+    linkStart.assign(walkSpans.size() + 1, 0);
+    for (std::size_t a = 0; a < walkSpans.size(); ++a) {
+        const Span& from = walkSpans[a];
+        linkStart[a] = static_cast<int>(links.size());
+
+        int lowestRow = std::min(navRows - 1, from.row + MaxDrop);
+        for (int row = std::max(0, from.row - JumpHeight); row <= lowestRow; ++row) {
+            const Span* rowBegin = walkSpans.data() + rowStart[row];
+            const Span* rowEnd = walkSpans.data() + rowStart[row + 1];
+
+            // Spans of the row are sorted by column: skip those too far left
+            const Span* to = std::lower_bound(rowBegin, rowEnd, from.first - JumpDistance,
+                [](const Span& span, int column) { return span.last < column; });
+
+            for (; to != rowEnd && to->first <= from.last + JumpDistance; ++to) {
+                int b = static_cast<int>(to - walkSpans.data());
+                if (b == static_cast<int>(a))
+                    continue;
+
+                int gap = std::max(0, std::max(to->first - from.last, from.first - to->last));
+                Link link = { b, static_cast<float>(gap + std::abs(to->row - from.row) + 1) };
+                links.push_back(link);
+            }
+        }
+    }
+    linkStart[walkSpans.size()] = static_cast<int>(links.size());
+}
+
+sf::Vector2i NavGraph::cellOf(sf::Vector2f point) const {
+    return sf::Vector2i(static_cast<int>(std::floor((point.x - navOrigin.x) / TileGrid::CellSize)),
+        static_cast<int>(std::floor((point.y - navOrigin.y) / TileGrid::CellSize)));
+}
+
+sf::Vector2f NavGraph::cellCentre(sf::Vector2i cell) const {
+    return sf::Vector2f(navOrigin.x + (cell.x + 0.5f) * TileGrid::CellSize,
+        navOrigin.y + (cell.y + 0.5f) * TileGrid::CellSize);
+}
+
+bool NavGraph::isOpen(int column, int row) const {
+    if (column < 0 || row < 0 || column >= navColumns || row >= navRows)
+        return false;
+    return open[row * navColumns + column] != 0;
+}
+
+int NavGraph::spanAt(sf::Vector2i cell) const {
+    if (cell.x < 0 || cell.y < 0 || cell.x >= navColumns || cell.y >= navRows)
+        return -1;
+    return cellSpan[cell.y * navColumns + cell.x];
+}
+
+std::size_t NavGraph::findFlightPath(sf::Vector2f from, sf::Vector2f to, sf::Vector2f* out, std::size_t capacity) {
+    sf::Vector2i start = cellOf(from);
+    sf::Vector2i goal = cellOf(to);
+    if (!isOpen(start.x, start.y) || !isOpen(goal.x, goal.y))
+        return 0;
+
+    // Cell indices first (a path never holds more cells than the grid)
+    int* nodes = pathScratch.data();
+    std::size_t count = findPath(Flight, start.y * navColumns + start.x, goal.y * navColumns + goal.x,
+        nodes, pathScratch.size());
+
+    std::size_t written = std::min(count, capacity);
+    for (std::size_t i = 0; i < written; ++i)
+        out[i] = cellCentre(sf::Vector2i(nodes[i] % navColumns, nodes[i] / navColumns));
+    return count;
+}
+
+std::size_t NavGraph::findWalkPath(sf::Vector2f from, sf::Vector2f to, int* out, std::size_t capacity) {
+    refreshWalkGraph();
+
+    // Standing on a span, or just above one (mid-jump)
+    auto spanNear = [this](sf::Vector2f point) {
+        sf::Vector2i cell = cellOf(point);
+        int span = spanAt(cell);
+        return span >= 0 ? span : spanAt(sf::Vector2i(cell.x, cell.y + 1));
+    };
+
+    int start = spanNear(from);
+    int goal = spanNear(to);
+    if (start < 0 || goal < 0)
+        return 0;
+    return findPath(Walk, start, goal, out, capacity);
+}
+
+std::size_t NavGraph::findPath(Mode mode, int start, int goal, int* out, std::size_t capacity) {
+    // Direct-mapped cache on (start, goal)
+    CachedPath& entry = cache[(static_cast<unsigned>(start) * 31u + static_cast<unsigned>(goal) * 17u + mode) % CacheSize];
+    if (entry.length >= 0 && entry.mode == mode && entry.start == start && entry.goal == goal) {
+        hits++;
+        std::size_t length = static_cast<std::size_t>(entry.length);
+        std::copy(entry.nodes, entry.nodes + std::min(length, capacity), out);
+        return length;
+    }
+
+    std::size_t count;
+    if (mode == Flight) {
+        const int columns = navColumns;
+        int goalX = goal % columns, goalY = goal / columns;
+
+        auto neighbours = [this, columns](int node, auto visit) {
+            int x = node % columns, y = node / columns;
+            for (int i = 0; i < 8; ++i) {
+                int nx = x + NeighbourX[i], ny = y + NeighbourY[i];
+                if (!isOpen(nx, ny))
+                    continue;
+                if (i >= 4 && (!isOpen(nx, y) || !isOpen(x, ny)))
+                    continue;   // no corner cutting
+                visit(ny * columns + nx, i >= 4 ? Diagonal : 1.f);
+            }
+        };
+        // Octile distance
+        auto heuristic = [columns, goalX, goalY](int node) {
+            float dx = static_cast<float>(std::abs(node % columns - goalX));
+            float dy = static_cast<float>(std::abs(node / columns - goalY));
+            return std::max(dx, dy) + (Diagonal - 1.f) * std::min(dx, dy);
+        };
+        count = search(start, goal, navColumns * navRows, neighbours, heuristic, out, capacity);
+    }
+    else {
+        int goalRow = walkSpans[goal].row;
+
+        auto neighbours = [this](int node, auto visit) {
+            for (const Link* link = linksBegin(node); link != linksEnd(node); ++link)
+                visit(link->to, link->cost);
+        };
+        // Every link costs at least the rows it climbs or drops
+        auto heuristic = [this, goalRow](int node) {
+            return static_cast<float>(std::abs(walkSpans[node].row - goalRow));
+        };
+        count = search(start, goal, static_cast<int>(walkSpans.size()), neighbours, heuristic, out, capacity);
+    }
+
+    if (count <= static_cast<std::size_t>(CachedPathLength) && count <= capacity) {
+        entry.mode = mode;
+        entry.start = start;
+        entry.goal = goal;
+        entry.length = static_cast<int>(count);
+        std::copy(out, out + count, entry.nodes);
+    }
+    return count;
+}
+
+template <typename Neighbours, typename Heuristic>
+std::size_t NavGraph::search(int start, int goal, int nodeCount, Neighbours neighbours, Heuristic heuristic, int* out, std::size_t capacity) {
+    if (start < 0 || goal < 0 || start >= nodeCount || goal >= nodeCount)
+        return 0;
+
+    if (++searchNumber == 0) {
+        // Wrapped around: forget every mark
+        std::fill(visited.begin(), visited.end(), 0);
+        searchNumber = 1;
+    }
+
+    typedef std::pair<float, int> Entry;      // (estimated total cost, node)
+    frontier.clear();
+    cost[start] = 0.f;
+    cameFrom[start] = -1;
+    visited[start] = searchNumber;
+    frontier.push_back(Entry(heuristic(start), start));
+
+    bool found = false;
+    while (!frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), std::greater<Entry>());
+        Entry current = frontier.back();
+        frontier.pop_back();
+
+        int node = current.second;
+        if (node == goal) {
+            found = true;
+            break;
+        }
+        if (current.first > cost[node] + heuristic(node) + 1e-4f)
+            continue;   // stale entry, the node was reached cheaper since
+
+        neighbours(node, [&](int next, float step) {
+            float nextCost = cost[node] + step;
+            if (visited[next] == searchNumber && nextCost >= cost[next])
+                return;
+            visited[next] = searchNumber;
+            cost[next] = nextCost;
+            cameFrom[next] = node;
+            frontier.push_back(Entry(nextCost + heuristic(next), next));
+            std::push_heap(frontier.begin(), frontier.end(), std::greater<Entry>());
+        });
+    }
+    if (!found)
+        return 0;
+
+    // Walk back from the goal, then write the path start first
+    std::size_t length = 0;
+    for (int node = goal; node >= 0; node = cameFrom[node])
+        length++;
+
+    std::size_t index = length;
+    for (int node = goal; node >= 0; node = cameFrom[node]) {
+        --index;
+        if (index < capacity)
+            out[index] = node;
+    }
+    return length;
+}
+
+
+const int FlowField::MaxTargets;
+const std::uint16_t FlowField::Unreached;
+
+FlowField::FlowField(int fieldRadius)
+    : nav(nullptr), radius(fieldRadius), navBuild(-1), navEdit(-1), targetCount(0), stale(true), recomputes(0)
+{
+}
+
+void FlowField::update(const NavGraph& navGraph, const sf::Vector2f* targets, int count) {
+    count = std::min(count, MaxTargets);
+
+    bool changed = (nav != &navGraph || navBuild != navGraph.buildCount() || navEdit != navGraph.editCount() ||
+        count != targetCount || stale);
+    for (int i = 0; i < count; ++i) {
+        sf::Vector2i cell = navGraph.cellOf(targets[i]);
+        if (i >= targetCount || cell != targetCells[i])
+            changed = true;
+        targetCells[i] = cell;
+    }
+    targetCount = count;
+
+    if (!changed)
+        return;
+
+    if (nav != &navGraph || navBuild != navGraph.buildCount())
+        attach(navGraph);
+    navEdit = navGraph.editCount();
+    recompute();
+}
+
+void FlowField::attach(const NavGraph& navGraph) {
+    nav = &navGraph;
+    navBuild = navGraph.buildCount();
+    steps.assign(static_cast<std::size_t>(nav->columns()) * nav->rows(), Unreached);
+    reached.clear();
+    reached.reserve(static_cast<std::size_t>((2 * radius + 1) * (2 * radius + 1)) * MaxTargets);
+    stale = true;
+}
+
+void FlowField::recompute() {
+    recomputes++;
+    stale = false;
+
+    // Forget the cells of the previous field only
+    for (int cell : reached)
+        steps[cell] = Unreached;
+    reached.clear();
+
+    const int columns = nav->columns();
+    for (int i = 0; i < targetCount; ++i) {
+        sf::Vector2i cell = targetCells[i];
+        if (cell.x < 0 || cell.y < 0 || cell.x >= columns || cell.y >= nav->rows())
+            continue;
+        int index = cell.y * columns + cell.x;
+        if (steps[index] != Unreached)
+            continue;
+        steps[index] = 0;
+        reached.push_back(index);
+    }
+
+    // Breadth-first over the open cells, `reached` doubling as the queue
+    for (std::size_t head = 0; head < reached.size(); ++head) {
+        int index = reached[head];
+        std::uint16_t next = static_cast<std::uint16_t>(steps[index] + 1);
+        if (next > radius)
+            break;
+
+        int x = index % columns, y = index / columns;
+        for (int i = 0; i < 4; ++i) {
+            int nx = x + NeighbourX[i], ny = y + NeighbourY[i];
+            if (!nav->isOpen(nx, ny))
+                continue;
+            int neighbour = ny * columns + nx;
+            if (steps[neighbour] != Unreached)
+                continue;
+            steps[neighbour] = next;
+            reached.push_back(neighbour);
+        }
+    }
+}
+
+int FlowField::distance(sf::Vector2f position) const {
+    if (!nav)
+        return -1;
+    sf::Vector2i cell = nav->cellOf(position);
+    if (cell.x < 0 || cell.y < 0 || cell.x >= nav->columns() || cell.y >= nav->rows())
+        return -1;
+    std::uint16_t value = steps[cell.y * nav->columns() + cell.x];
+    return value == Unreached ? -1 : value;
+}
+
+sf::Vector2f FlowField::direction(sf::Vector2f position) const {
+    int here = distance(position);
+    if (here <= 0)
+        return sf::Vector2f();
+
+    // Lowest neighbour; diagonals only between two open cells
+    sf::Vector2i cell = nav->cellOf(position);
+    int best = here;
+    sf::Vector2i bestCell = cell;
+    for (int i = 0; i < 8; ++i) {
+        int nx = cell.x + NeighbourX[i], ny = cell.y + NeighbourY[i];
+        if (!nav->isOpen(nx, ny))
+            continue;
+        if (i >= 4 && (!nav->isOpen(nx, cell.y) || !nav->isOpen(cell.x, ny)))
+            continue;
+        std::uint16_t value = steps[ny * nav->columns() + nx];
+        if (value < best) {
+            best = value;
+            bestCell = sf::Vector2i(nx, ny);
+        }
+    }
+    if (bestCell == cell)
+        return sf::Vector2f();
+
+    sf::Vector2f toward = nav->cellCentre(bestCell) - position;
+    float length = std::sqrt(toward.x * toward.x + toward.y * toward.y);
+    return length > 0.f ? toward / length : sf::Vector2f();
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "TileGrid.hpp"
+
+// ------------------------------------------------------------------
+// Navigation for enemies, built per level from the TileGrid
+//
+// Two graphs over the same 32 px cells:
+//  - flying: every cell without a platform, linked to its 8 neighbours
+//    (diagonals only when both sides are open, no corner cutting);
+//  - walking: walkable spans (runs of open cells with a solid cell
+//    under them), linked to the spans a walker can jump up to or drop
+//    down to. Ceilings on the way are not checked.
+//
+// findFlightPath and findWalkPath are A* searches; the last few
+// results are cached by start and goal node, so callers asking again
+// every tick get the same path back for free. Searches reuse scratch
+// storage sized when the level is built.
+// ------------------------------------------------------------------
+class NavGraph {
+public:
+    // What a walker can reach from the edge of a span, in cells
+    static const int JumpHeight = 4;       // jumpPower -12 at GRAVITY 0.5 climbs ~144 px
+    static const int JumpDistance = 4;
+    static const int MaxDrop = 8;
+
+    struct Span {
+        int row;
+        int first, last;                   // columns, inclusive
+    };
+
+    struct Link {
+        int to;                            // span index
+        float cost;
+    };
+
+    NavGraph();
+
+    void build(const TileGrid& grid);
+
+    // Platforms changed within `area` (level editor): refresh the open
+    // cells there. The walkable spans are re-linked (a scan of the cell
+    // flags, no platform is looked at again) by the next findWalkPath or
+    // refreshWalkGraph.
+    void update(const TileGrid& grid, const sf::FloatRect& area);
+    void refreshWalkGraph();
+
+    // Bumped by every build, and by every update (FlowField uses them to
+    // notice new levels and edits)
+    int buildCount() const { return builds; }
+    int editCount() const { return edits; }
+
+    int columns() const { return navColumns; }
+    int rows() const { return navRows; }
+    sf::Vector2i cellOf(sf::Vector2f point) const;
+    sf::Vector2f cellCentre(sf::Vector2i cell) const;
+
+    // Cell a flyer can be in (outside the grid counts as closed)
+    bool isOpen(int column, int row) const;
+
+    // Span standing on `cell`, -1 if none. Spans and links are those of
+    // the last build or refreshWalkGraph.
+    int spanAt(sf::Vector2i cell) const;
+    const std::vector<Span>& spans() const { return walkSpans; }
+    const Link* linksBegin(int span) const { return links.data() + linkStart[span]; }
+    const Link* linksEnd(int span) const { return links.data() + linkStart[span + 1]; }
+
+    // Waypoints (cell centres, from's cell first) of the shortest flight
+    // from -> to. Writes up to `capacity` of them and returns how many
+    // there are; 0 when there is no way.
+    std::size_t findFlightPath(sf::Vector2f from, sf::Vector2f to, sf::Vector2f* out, std::size_t capacity);
+
+    // Spans to walk and jump through, same conventions
+    std::size_t findWalkPath(sf::Vector2f from, sf::Vector2f to, int* out, std::size_t capacity);
+
+    std::size_t cacheHits() const { return hits; }
+
+private:
+    enum Mode { Flight, Walk };
+
+    static const int CacheSize = 16;
+    static const int CachedPathLength = 128;
+
+    struct CachedPath {
+        int mode;
+        int start;
+        int goal;
+        int length;                        // -1 = empty entry
+        int nodes[CachedPathLength];
+    };
+
+    // Path as node indices (cells or spans), cache first
+    std::size_t findPath(Mode mode, int start, int goal, int* out, std::size_t capacity);
+
+    // Spans and their links, from the open cells
+    void buildWalkGraph();
+
+    template <typename Neighbours, typename Heuristic>
+    std::size_t search(int start, int goal, int nodeCount, Neighbours neighbours, Heuristic heuristic, int* out, std::size_t capacity);
+
+    sf::Vector2f navOrigin;
+    int navColumns;
+    int navRows;
+    int builds;
+    int edits;
+    bool walkStale;                        // cells updated since the spans were linked
+
+    std::vector<char> open;                // per cell
+    std::vector<int> cellSpan;             // per cell, -1 = not walkable
+    std::vector<Span> walkSpans;
+    std::vector<int> rowStart;             // per row + 1, into walkSpans
+    std::vector<int> linkStart;            // per span + 1, into links
+    std::vector<Link> links;
+
+    // A* scratch, indexed by node; `visited` holds the search number
+    std::vector<float> cost;
+    std::vector<int> cameFrom;
+    std::vector<std::uint32_t> visited;
+    std::uint32_t searchNumber;
+    std::vector<std::pair<float, int> > frontier;
+    std::vector<int> pathScratch;
+
+    CachedPath cache[CacheSize];
+    std::size_t hits;
+};
+
+
+// ------------------------------------------------------------------
+// Flow field towards the nearest of a few targets (the players)
+//
+// Holds, for every open cell within `radius` steps of a target, its
+// distance in steps to the nearest one (breadth-first over the flying
+// graph). It is only recomputed when a target moves to another cell,
+// and then only over the cells it reached last time and reaches now,
+// so any number of chasers cost one field update per move plus an O(1)
+// lookup each.
+// ------------------------------------------------------------------
+class FlowField {
+public:
+    static const int MaxTargets = 8;
+    static const std::uint16_t Unreached = 0xFFFF;
+
+    explicit FlowField(int radius);
+
+    // Size the field for a (newly built) graph, clearing it; update()
+    // does it when needed, calling it at level load keeps that out of
+    // the first tick
+    void attach(const NavGraph& nav);
+
+    // Follow the targets; cheap when none of them changed cell
+    void update(const NavGraph& nav, const sf::Vector2f* targets, int count);
+
+    // Steps from `position` to the nearest target, -1 if out of reach
+    int distance(sf::Vector2f position) const;
+
+    // Unit vector from `position` towards the next cell on the way;
+    // zero when out of reach or already in a target's cell
+    sf::Vector2f direction(sf::Vector2f position) const;
+
+    std::size_t recomputeCount() const { return recomputes; }
+
+private:
+    void recompute();
+
+    const NavGraph* nav;
+    int radius;
+    int navBuild;                          // nav->buildCount() of the field
+    int navEdit;                           // nav->editCount() of the field
+
+    sf::Vector2i targetCells[MaxTargets];
+    int targetCount;
+    bool stale;                            // cleared since the last recompute
+
+    std::vector<std::uint16_t> steps;      // per cell
+    std::vector<int> reached;              // cells set in `steps`, in BFS order
+    std::size_t recomputes;
+};
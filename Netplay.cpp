@@ -0,0 +1,645 @@
+#include "Netplay.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const sf::Uint16 NET_MAGIC = 0x4F52;   // "OR"
+
+    enum NetMessage {
+        NET_CONNECT,
+        NET_ACCEPT,
+        NET_REJECT,
+        NET_INPUT,
+        NET_SNAPSHOT
+    };
+
+    const sf::Time ConnectRetry = sf::milliseconds(250);
+    const sf::Time ClientTimeout = sf::seconds(5.f);
+
+    // Positions and speeds travel in 1/8 pixel
+    const float Subpixels = 8.f;
+
+    std::int32_t quantize(float v) {
+        return static_cast<std::int32_t>(std::lround(v * Subpixels));
+    }
+
+    float dequantize(std::int32_t v) {
+        return v / Subpixels;
+    }
+
+    sf::Uint8 packInput(const PlayerInput& input) {
+        return static_cast<sf::Uint8>((input.left ? 1 : 0) | (input.right ? 2 : 0) | (input.jump ? 4 : 0));
+    }
+
+    PlayerInput unpackInput(sf::Uint8 bits) {
+        PlayerInput input;
+        input.left = (bits & 1) != 0;
+        input.right = (bits & 2) != 0;
+        input.jump = (bits & 4) != 0;
+        return input;
+    }
+
+    void writeVarint(sf::Packet& packet, std::uint32_t v) {
+        while (v >= 0x80) {
+            packet << static_cast<sf::Uint8>(v | 0x80);
+            v >>= 7;
+        }
+        packet << static_cast<sf::Uint8>(v);
+    }
+
+    bool readVarint(sf::Packet& packet, std::uint32_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            sf::Uint8 b;
+            if (!(packet >> b))
+                return false;
+            v |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    // Reads the fields of a snapshot in order; zeros past the end
+    struct FieldReader {
+        const SnapshotFields& fields;
+        std::size_t index;
+
+        std::int32_t next() { return index < fields.size() ? fields[index++] : 0; }
+    };
+
+    sf::Packet header(NetMessage type) {
+        sf::Packet packet;
+        packet << NET_MAGIC << static_cast<sf::Uint8>(type);
+        return packet;
+    }
+}
+
+
+NetSocket::NetSocket()
+    : random(12345)   // fixed seed: the same losses on every test run
+{
+    socket.setBlocking(false);
+}
+
+bool NetSocket::bind(unsigned short port) {
+    return socket.bind(port) == sf::Socket::Done;
+}
+
+void NetSocket::send(const sf::Packet& packet, const sf::IpAddress& address, unsigned short port) {
+    stats.bytesSent += packet.getDataSize();
+    stats.packetsSent++;
+
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    if (conditions.loss > 0.f && unit(random) < conditions.loss)
+        return;
+
+    sf::Time delay = conditions.latency;
+    if (conditions.jitter > sf::Time::Zero)
+        delay += conditions.jitter * (unit(random) * 2.f - 1.f);
+
+    if (delay <= sf::Time::Zero) {
+        socket.send(packet.getData(), packet.getDataSize(), address, port);
+        return;
+    }
+
+    Delayed later;
+    later.due = clock.getElapsedTime() + delay;
+    const char* data = static_cast<const char*>(packet.getData());
+    later.data.assign(data, data + packet.getDataSize());
+    later.address = address;
+    later.port = port;
+    delayed.push_back(later);
+}
+
+bool NetSocket::receive(sf::Packet& packet, sf::IpAddress& address, unsigned short& port) {
+    if (socket.receive(packet, address, port) != sf::Socket::Done)
+        return false;
+
+    stats.bytesReceived += packet.getDataSize();
+    stats.packetsReceived++;
+    return true;
+}
+
+void NetSocket::flush() {
+    sf::Time now = clock.getElapsedTime();
+    for (std::size_t i = 0; i < delayed.size();) {
+        if (delayed[i].due <= now) {
+            socket.send(&delayed[i].data[0], delayed[i].data.size(), delayed[i].address, delayed[i].port);
+            delayed[i] = delayed.back();
+            delayed.pop_back();
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+
+// Layout, all integers:
+//   level, level loads, lives, score, diamonds collected, player count
+//   per player:  x, y, vx, vy, flags (facing left, grounded, hammer)
+//   hammer collected
+//   per enemy:   x, y, flags (direction left, animation frame << 1)
+//   per rock:    y, flags (active, triggered, resetting)
+//   per icicle:  y, falling
+//   diamonds collected, one bit each, 32 per field
+// Entities come in pool order, the same on the server and the clients
+// as both build the level the same way.
+void captureSnapshot(const World& world, SnapshotFields& fields) {
+    fields.clear();
+    fields.push_back(world.currentLevel);
+    fields.push_back(world.levelLoads);
+    fields.push_back(world.lives);
+    fields.push_back(world.score);
+    fields.push_back(world.diamondsCollected);
+    fields.push_back(world.playerCount);
+
+    for (int i = 0; i < world.playerCount; ++i) {
+        const Player& p = world.players[i];
+        fields.push_back(quantize(p.position.x));
+        fields.push_back(quantize(p.position.y));
+        fields.push_back(quantize(p.velocity.x));
+        fields.push_back(quantize(p.velocity.y));
+        fields.push_back((p.facingDir < 0 ? 1 : 0) | (p.grounded ? 2 : 0) | (p.hasHammer ? 4 : 0));
+    }
+
+    const Hammer* hammer = world.hammers.get(world.hammer);
+    fields.push_back(hammer && hammer->collected ? 1 : 0);
+
+    for (const auto& enemy : world.enemies) {
+        fields.push_back(quantize(enemy.position.x));
+        fields.push_back(quantize(enemy.position.y));
+        fields.push_back((enemy.direction < 0 ? 1 : 0) | (enemy.currentFrame << 1));
+    }
+
+    for (const auto& rock : world.fallingRocks) {
+        fields.push_back(quantize(rock.position.y));
+        fields.push_back((rock.active ? 1 : 0) | (rock.triggered ? 2 : 0) | (rock.resetTimer > 0 ? 4 : 0));
+    }
+
+    for (const auto& icicle : world.icicles) {
+        fields.push_back(quantize(icicle.position.y));
+        fields.push_back(icicle.falling ? 1 : 0);
+    }
+
+    std::int32_t bits = 0;
+    int bit = 0;
+    for (const auto& diamond : world.diamonds) {
+        if (diamond.collected)
+            bits |= 1 << bit;
+        if (++bit == 32) {
+            fields.push_back(bits);
+            bits = 0;
+            bit = 0;
+        }
+    }
+    if (bit > 0)
+        fields.push_back(bits);
+}
+
+void applySnapshot(World& world, const SnapshotFields& fields, int& serverLevelLoads) {
+    FieldReader in = { fields, 0 };
+    int level = in.next();
+    int loads = in.next();
+    int lives = in.next();
+    int score = in.next();
+    int diamondsCollected = in.next();
+    int playerCount = in.next();
+    if (level < 1 || playerCount < 1 || playerCount > MAX_PLAYERS)
+        return;
+
+    if (loads != serverLevelLoads || level != world.currentLevel || playerCount != world.playerCount) {
+        world.setPlayerCount(playerCount);
+        world.loadLevel(level);
+        serverLevelLoads = loads;
+    }
+    world.lives = lives;
+    world.score = score;
+    world.diamondsCollected = diamondsCollected;
+
+    for (int i = 0; i < playerCount; ++i) {
+        Player& p = world.players[i];
+        p.position.x = dequantize(in.next());
+        p.position.y = dequantize(in.next());
+        p.velocity.x = dequantize(in.next());
+        p.velocity.y = dequantize(in.next());
+        int flags = in.next();
+        p.facingDir = (flags & 1) ? -1 : 1;
+        p.grounded = (flags & 2) != 0;
+        p.hasHammer = (flags & 4) != 0;
+        p.updatePosition();
+    }
+
+    Hammer* hammer = world.hammers.get(world.hammer);
+    bool hammerCollected = in.next() != 0;
+    if (hammer)
+        hammer->collected = hammerCollected;
+
+    for (auto& enemy : world.enemies) {
+        enemy.position.x = dequantize(in.next());
+        enemy.position.y = dequantize(in.next());
+        int flags = in.next();
+        enemy.direction = (flags & 1) ? -1 : 1;
+        enemy.sprite.setPosition(enemy.position);
+
+        // Same look as Enemy::update: flipped by direction, frame by frame
+        if (enemy.textures && !enemy.textures->empty()) {
+            enemy.sprite.setScale(enemy.direction > 0 ? -1.f : 1.f, 1.f);
+            int frame = (flags >> 1) % static_cast<int>(enemy.textures->size());
+            if (frame != enemy.currentFrame) {
+                enemy.currentFrame = frame;
+                enemy.sprite.setTexture((*enemy.textures)[frame], true);
+            }
+        }
+    }
+
+    for (auto& rock : world.fallingRocks) {
+        rock.position.y = dequantize(in.next());
+        int flags = in.next();
+        rock.active = (flags & 1) != 0;
+        rock.triggered = (flags & 2) != 0;
+        rock.resetTimer = (flags & 4) ? 1.f : 0.f;
+        rock.shape.setPosition(rock.position);
+    }
+
+    for (auto& icicle : world.icicles) {
+        icicle.position.y = dequantize(in.next());
+        icicle.falling = in.next() != 0;
+        icicle.shape.setPosition(icicle.position);
+    }
+
+    std::int32_t bits = 0;
+    int bit = 32;
+    for (auto& diamond : world.diamonds) {
+        if (bit == 32) {
+            bits = in.next();
+            bit = 0;
+        }
+        diamond.collected = (bits & (1 << bit)) != 0;
+        bit++;
+    }
+}
+
+void writeSnapshotDelta(sf::Packet& packet, const SnapshotFields& fields, const SnapshotFields* baseline) {
+    std::size_t count = fields.size();
+    packet << static_cast<sf::Uint16>(count);
+
+    auto base = [&](std::size_t i) { return (baseline && i < baseline->size()) ? (*baseline)[i] : 0; };
+
+    for (std::size_t start = 0; start < count; start += 8) {
+        sf::Uint8 mask = 0;
+        for (std::size_t i = start; i < std::min(start + 8, count); ++i) {
+            if (fields[i] != base(i))
+                mask |= static_cast<sf::Uint8>(1 << (i - start));
+        }
+        packet << mask;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (fields[i] == base(i))
+            continue;
+
+        // Difference, zigzag encoded so that small negatives stay small
+        std::int32_t d = static_cast<std::int32_t>(static_cast<std::uint32_t>(fields[i]) - static_cast<std::uint32_t>(base(i)));
+        writeVarint(packet, (static_cast<std::uint32_t>(d) << 1) ^ static_cast<std::uint32_t>(d >> 31));
+    }
+}
+
+bool readSnapshotDelta(sf::Packet& packet, const SnapshotFields* baseline, SnapshotFields& fields) {
+    sf::Uint16 count;
+    if (!(packet >> count))
+        return false;
+
+    // Masks first, then the values of the fields they flag
+    fields.resize(count);
+    for (std::size_t start = 0; start < count; start += 8) {
+        sf::Uint8 mask;
+        if (!(packet >> mask))
+            return false;
+        for (std::size_t i = start; i < std::min<std::size_t>(start + 8, count); ++i)
+            fields[i] = (mask & (1 << (i - start))) ? 1 : 0;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        std::int32_t base = (baseline && i < baseline->size()) ? (*baseline)[i] : 0;
+        if (!fields[i]) {
+            fields[i] = base;
+            continue;
+        }
+
+        std::uint32_t zigzag;
+        if (!readVarint(packet, zigzag))
+            return false;
+        std::uint32_t d = (zigzag >> 1) ^ (0u - (zigzag & 1u));
+        fields[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(base) + d);
+    }
+    return true;
+}
+
+
+NetServer::NetServer(World& world)
+    : world(world), tick(0), nextSnapshotId(1)
+{
+    for (int i = 0; i < SnapshotHistory; ++i)
+        historyId[i] = 0;
+}
+
+bool NetServer::start(unsigned short port) {
+    return socket.bind(port);
+}
+
+TickResult NetServer::update() {
+    receive();
+
+    // Forget clients gone silent; their player stays, standing still
+    sf::Time now = clock.getElapsedTime();
+    clients.erase(std::remove_if(clients.begin(), clients.end(),
+        [&](const Client& c) { return now - c.lastHeard > ClientTimeout; }), clients.end());
+
+    // Apply the next input of every client, in sequence. A missing one
+    // (late or lost) is replaced by the last input, until it arrives.
+    PlayerInput inputs[MAX_PLAYERS];
+    for (auto& client : clients) {
+        std::uint32_t next = client.lastInput + 1;
+        if (client.inputSequence[next % InputBuffer] == next) {
+            client.current = client.inputs[next % InputBuffer];
+            client.lastInput = next;
+        }
+        inputs[client.player] = client.current;
+    }
+
+    TickResult result = world.update(inputs, world.playerCount);
+    if (result == TICK_LEVEL_COMPLETE && world.currentLevel < 4) {
+        world.loadLevel(world.currentLevel + 1);
+    }
+    else if (result != TICK_RUNNING) {
+        world.newGame();
+    }
+
+    if (++tick % NET_SNAPSHOT_INTERVAL == 0)
+        sendSnapshots();
+
+    socket.flush();
+    return result;
+}
+
+void NetServer::receive() {
+    sf::Packet packet;
+    sf::IpAddress address;
+    unsigned short port;
+    while (socket.receive(packet, address, port)) {
+        sf::Uint16 magic;
+        sf::Uint8 type;
+        if (!(packet >> magic >> type) || magic != NET_MAGIC)
+            continue;
+
+        if (type == NET_CONNECT) {
+            handleConnect(address, port);
+        }
+        else if (type == NET_INPUT) {
+            Client* client = findClient(address, port);
+            if (client)
+                handleInput(*client, packet);
+        }
+    }
+}
+
+void NetServer::handleConnect(const sf::IpAddress& address, unsigned short port) {
+    // Already in: our ACCEPT was lost, send it again
+    Client* known = findClient(address, port);
+    if (known) {
+        known->lastHeard = clock.getElapsedTime();
+        sendMessage(NET_ACCEPT, address, port, static_cast<std::uint8_t>(known->player));
+        return;
+    }
+
+    // Lowest player slot no client is using
+    int player = 0;
+    while (player < MAX_PLAYERS &&
+        std::any_of(clients.begin(), clients.end(), [&](const Client& c) { return c.player == player; }))
+        player++;
+
+    if (player == MAX_PLAYERS) {
+        sendMessage(NET_REJECT, address, port, 0);
+        return;
+    }
+
+    Client client;
+    client.address = address;
+    client.port = port;
+    client.player = player;
+    client.lastInput = 0;
+    for (int i = 0; i < InputBuffer; ++i)
+        client.inputSequence[i] = 0;
+    client.ackedSnapshot = 0;
+    client.bytesSent = 0;
+    client.lastHeard = clock.getElapsedTime();
+    clients.push_back(client);
+
+    // A new player slot restarts the level with everyone in it
+    if (player >= world.playerCount) {
+        world.setPlayerCount(player + 1);
+        world.loadLevel(world.currentLevel);
+    }
+
+    sendMessage(NET_ACCEPT, address, port, static_cast<std::uint8_t>(player));
+}
+
+void NetServer::handleInput(Client& client, sf::Packet& packet) {
+    sf::Uint32 ack, newest;
+    sf::Uint8 count;
+    if (!(packet >> ack >> newest >> count))
+        return;
+
+    client.lastHeard = clock.getElapsedTime();
+    if (ack > client.ackedSnapshot && ack < nextSnapshotId)
+        client.ackedSnapshot = ack;
+
+    for (sf::Uint32 k = 0; k < count && k < newest; ++k) {
+        sf::Uint8 bits;
+        if (!(packet >> bits))
+            return;
+
+        std::uint32_t sequence = newest - k;
+        if (sequence <= client.lastInput)
+            break;
+        client.inputSequence[sequence % InputBuffer] = sequence;
+        client.inputs[sequence % InputBuffer] = unpackInput(bits);
+    }
+
+    // Far behind the client (it was stalled): skip ahead to recent inputs
+    if (newest > client.lastInput + InputBuffer / 2)
+        client.lastInput = newest - InputBuffer / 2;
+}
+
+void NetServer::sendSnapshots() {
+    std::uint32_t id = nextSnapshotId++;
+    std::size_t slot = id % SnapshotHistory;
+    captureSnapshot(world, history[slot]);
+    historyId[slot] = id;
+
+    for (auto& client : clients) {
+        // Delta against the newest snapshot the client has, if still kept
+        std::uint32_t baseId = client.ackedSnapshot;
+        const SnapshotFields* baseline = nullptr;
+        if (baseId != 0 && baseId != id && historyId[baseId % SnapshotHistory] == baseId)
+            baseline = &history[baseId % SnapshotHistory];
+        else
+            baseId = 0;
+
+        sf::Packet packet = header(NET_SNAPSHOT);
+        packet << static_cast<sf::Uint32>(id) << static_cast<sf::Uint32>(baseId) << static_cast<sf::Uint32>(client.lastInput);
+        writeSnapshotDelta(packet, history[slot], baseline);
+
+        socket.send(packet, client.address, client.port);
+        client.bytesSent += packet.getDataSize();
+    }
+}
+
+NetServer::Client* NetServer::findClient(const sf::IpAddress& address, unsigned short port) {
+    for (auto& client : clients) {
+        if (client.address == address && client.port == port)
+            return &client;
+    }
+    return nullptr;
+}
+
+void NetServer::sendMessage(std::uint8_t type, const sf::IpAddress& address, unsigned short port, std::uint8_t value) {
+    sf::Packet packet = header(static_cast<NetMessage>(type));
+    if (type == NET_ACCEPT)
+        packet << value;
+    socket.send(packet, address, port);
+}
+
+
+NetClient::NetClient(World& world)
+    : world(world),
+    serverPort(0),
+    player(-1),
+    rejected(false),
+    inputSequence(0),
+    latestSnapshot(0),
+    serverLevelLoads(-1),
+    snapshots(0),
+    fullSnapshots(0),
+    correctionCount(0),
+    maxCorrection(0.f)
+{
+    for (int i = 0; i < SnapshotHistory; ++i)
+        historyId[i] = 0;
+}
+
+bool NetClient::connect(const sf::IpAddress& address, unsigned short port) {
+    if (!socket.bind(0))
+        return false;
+
+    serverAddress = address;
+    serverPort = port;
+    socket.send(header(NET_CONNECT), serverAddress, serverPort);
+    connectClock.restart();
+    return true;
+}
+
+void NetClient::update(const PlayerInput& input) {
+    receive();
+
+    if (!isConnected()) {
+        if (!rejected && connectClock.getElapsedTime() > ConnectRetry) {
+            socket.send(header(NET_CONNECT), serverAddress, serverPort);
+            connectClock.restart();
+        }
+        socket.flush();
+        return;
+    }
+
+    inputSequence++;
+    inputs[inputSequence % InputHistory] = input;
+    sendInputs();
+
+    // Prediction: our move shows now, not a round trip later
+    if (latestSnapshot != 0 && player < world.playerCount)
+        world.movePlayer(player, input);
+    world.animate();
+
+    socket.flush();
+}
+
+void NetClient::receive() {
+    sf::Packet packet;
+    sf::IpAddress address;
+    unsigned short port;
+    while (socket.receive(packet, address, port)) {
+        sf::Uint16 magic;
+        sf::Uint8 type;
+        if (address != serverAddress || port != serverPort || !(packet >> magic >> type) || magic != NET_MAGIC)
+            continue;
+
+        if (type == NET_ACCEPT) {
+            sf::Uint8 index;
+            if (packet >> index && index < MAX_PLAYERS)
+                player = index;
+        }
+        else if (type == NET_REJECT) {
+            rejected = true;
+        }
+        else if (type == NET_SNAPSHOT && isConnected()) {
+            handleSnapshot(packet);
+        }
+    }
+}
+
+void NetClient::handleSnapshot(sf::Packet& packet) {
+    sf::Uint32 id, baseId, lastInput;
+    if (!(packet >> id >> baseId >> lastInput) || id <= latestSnapshot)
+        return;   // broken, or older than what we have (reordered)
+
+    const SnapshotFields* baseline = nullptr;
+    if (baseId != 0) {
+        if (historyId[baseId % SnapshotHistory] != baseId)
+            return;   // baseline no longer kept; the next ack sorts it out
+        baseline = &history[baseId % SnapshotHistory];
+    }
+    if (!readSnapshotDelta(packet, baseline, decoded))
+        return;
+
+    std::size_t slot = id % SnapshotHistory;
+    history[slot].swap(decoded);
+    historyId[slot] = id;
+    latestSnapshot = id;
+    snapshots++;
+    if (baseId == 0)
+        fullSnapshots++;
+
+    // Reconciliation: take the server's world, then replay the inputs it
+    // has not seen yet on our player
+    sf::Vector2f predicted = world.players[player].position;
+    int loadsBefore = serverLevelLoads;
+    applySnapshot(world, history[slot], serverLevelLoads);
+
+    if (player < world.playerCount && inputSequence - lastInput < static_cast<sf::Uint32>(InputHistory)) {
+        for (std::uint32_t sequence = lastInput + 1; sequence <= inputSequence; ++sequence)
+            world.movePlayer(player, inputs[sequence % InputHistory]);
+    }
+
+    if (serverLevelLoads == loadsBefore) {
+        sf::Vector2f diff = world.players[player].position - predicted;
+        float error = std::sqrt(diff.x * diff.x + diff.y * diff.y);
+        if (error > 0.5f) {
+            correctionCount++;
+            maxCorrection = std::max(maxCorrection, error);
+        }
+    }
+}
+
+void NetClient::sendInputs() {
+    sf::Uint8 count = static_cast<sf::Uint8>(std::min<std::uint32_t>(InputsPerPacket, inputSequence));
+
+    sf::Packet packet = header(NET_INPUT);
+    packet << static_cast<sf::Uint32>(latestSnapshot) << static_cast<sf::Uint32>(inputSequence) << count;
+    for (sf::Uint32 k = 0; k < count; ++k)
+        packet << packInput(inputs[(inputSequence - k) % InputHistory]);
+
+    socket.send(packet, serverAddress, serverPort);
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "World.hpp"
+
+// ------------------------------------------------------------------
+// LAN multiplayer over UDP
+//
+// The server runs the real simulation (a headless World) and is the
+// only authority. Clients send their inputs every tick and get back,
+// 30 times a second, a snapshot of the world: the state flattened into
+// a list of quantized integers, sent as a delta against the last
+// snapshot the client acknowledged (a full one when there is none).
+//
+// Clients predict their own player by running its movement locally as
+// soon as a key is pressed. When a snapshot arrives, the world is set
+// to the server's state and the inputs the server has not processed
+// yet are replayed on top of it (reconciliation).
+//
+// Every message is an sf::Packet:
+//   uint16 NET_MAGIC, uint8 NetMessage, then
+//   CONNECT  -
+//   ACCEPT   uint8 player index
+//   REJECT   -                          (server full)
+//   INPUT    uint32 acked snapshot, uint32 newest input sequence,
+//            uint8 count, count x uint8 inputs (newest first)
+//   SNAPSHOT uint32 id, uint32 baseline id (0 = full),
+//            uint32 last input processed for this client, delta
+// Inputs are repeated over several packets, so a lost one is recovered
+// from the next. NetSocket can simulate loss and latency for testing
+// (see the --net mode of EscapeOreoBench).
+// ------------------------------------------------------------------
+
+const unsigned short NET_DEFAULT_PORT = 53000;
+const int NET_TICK_RATE = 60;              // simulation ticks per second, both sides
+const int NET_SNAPSHOT_INTERVAL = 2;       // ticks between snapshots (30 Hz)
+
+// Simulated network trouble, applied to outgoing packets
+struct NetConditions {
+    float loss = 0.f;          // probability of dropping a packet, 0 to 1
+    sf::Time latency;          // one-way delay
+    sf::Time jitter;           // +/- random extra delay (reorders packets)
+};
+
+// Traffic counters (UDP payload bytes)
+struct NetStats {
+    std::size_t bytesSent = 0;
+    std::size_t bytesReceived = 0;
+    std::size_t packetsSent = 0;
+    std::size_t packetsReceived = 0;
+};
+
+// Non-blocking UDP socket with optional simulated loss and latency
+class NetSocket {
+public:
+    NetSocket();
+
+    // Bind to a port (0 = any free port)
+    bool bind(unsigned short port);
+    unsigned short getLocalPort() const { return socket.getLocalPort(); }
+
+    void setConditions(const NetConditions& netConditions) { conditions = netConditions; }
+
+    // Send now, later or never, depending on the conditions
+    void send(const sf::Packet& packet, const sf::IpAddress& address, unsigned short port);
+
+    // Next received packet, if any
+    bool receive(sf::Packet& packet, sf::IpAddress& address, unsigned short& port);
+
+    // Send the delayed packets that are due; call once per tick
+    void flush();
+
+    const NetStats& getStats() const { return stats; }
+
+private:
+    struct Delayed {
+        sf::Time due;
+        std::vector<char> data;
+        sf::IpAddress address;
+        unsigned short port;
+    };
+
+    sf::UdpSocket socket;
+    NetConditions conditions;
+    std::vector<Delayed> delayed;
+    sf::Clock clock;
+    std::mt19937 random;
+    NetStats stats;
+};
+
+// The world state as quantized integers, same layout on both sides for
+// a given level (see captureSnapshot in Netplay.cpp)
+typedef std::vector<std::int32_t> SnapshotFields;
+
+void captureSnapshot(const World& world, SnapshotFields& fields);
+
+// Set the world to a snapshot. serverLevelLoads is the server's level
+// count last seen: a different one in the snapshot rebuilds the level.
+void applySnapshot(World& world, const SnapshotFields& fields, int& serverLevelLoads);
+
+// Delta encoding: one bit per field (changed or not), then the changed
+// fields as zigzag varint differences. No baseline = against zeros.
+void writeSnapshotDelta(sf::Packet& packet, const SnapshotFields& fields, const SnapshotFields* baseline);
+bool readSnapshotDelta(sf::Packet& packet, const SnapshotFields* baseline, SnapshotFields& fields);
+
+
+class NetServer {
+public:
+    explicit NetServer(World& world);
+
+    bool start(unsigned short port = NET_DEFAULT_PORT);
+    unsigned short getPort() const { return socket.getLocalPort(); }
+
+    void setConditions(const NetConditions& conditions) { socket.setConditions(conditions); }
+
+    // One tick: read the clients' inputs, advance the world, send the
+    // snapshots when due. Finished levels and games restart by themselves.
+    TickResult update();
+
+    int clientCount() const { return static_cast<int>(clients.size()); }
+
+    // Bytes sent to one client so far
+    std::size_t bytesSentTo(int client) const { return clients[client].bytesSent; }
+
+    const NetStats& getStats() const { return socket.getStats(); }
+
+private:
+    static const int InputBuffer = 128;     // inputs kept per client, by sequence
+    static const int SnapshotHistory = 32;  // snapshots kept as baselines
+
+    struct Client {
+        sf::IpAddress address;
+        unsigned short port;
+        int player;
+        std::uint32_t lastInput;            // sequence of the last input applied
+        std::uint32_t inputSequence[InputBuffer];
+        PlayerInput inputs[InputBuffer];
+        PlayerInput current;                // input applied this tick
+        std::uint32_t ackedSnapshot;
+        std::size_t bytesSent;
+        sf::Time lastHeard;
+    };
+
+    void receive();
+    void handleConnect(const sf::IpAddress& address, unsigned short port);
+    void handleInput(Client& client, sf::Packet& packet);
+    void sendSnapshots();
+    Client* findClient(const sf::IpAddress& address, unsigned short port);
+    void sendMessage(std::uint8_t type, const sf::IpAddress& address, unsigned short port, std::uint8_t value);
+
+    World& world;
+    NetSocket socket;
+    std::vector<Client> clients;
+    sf::Clock clock;
+    int tick;
+
+    // Snapshots by id % SnapshotHistory
+    std::uint32_t nextSnapshotId;
+    std::uint32_t historyId[SnapshotHistory];
+    SnapshotFields history[SnapshotHistory];
+};
+
+
+class NetClient {
+public:
+    explicit NetClient(World& world);
+
+    // Bind a local port and start knocking at the server (non-blocking:
+    // the handshake goes on in update())
+    bool connect(const sf::IpAddress& address, unsigned short port = NET_DEFAULT_PORT);
+
+    void setConditions(const NetConditions& conditions) { socket.setConditions(conditions); }
+
+    // One tick: apply the snapshots received, send this tick's input and
+    // predict its effect on our player
+    void update(const PlayerInput& input);
+
+    bool isConnected() const { return player >= 0; }
+    bool wasRejected() const { return rejected; }
+    int playerIndex() const { return player < 0 ? 0 : player; }
+
+    const NetStats& getStats() const { return socket.getStats(); }
+    std::size_t snapshotsReceived() const { return snapshots; }
+    std::size_t fullSnapshotsReceived() const { return fullSnapshots; }
+
+    // Reconciliations that moved our player by more than half a pixel,
+    // and the largest such move
+    std::size_t corrections() const { return correctionCount; }
+    float largestCorrection() const { return maxCorrection; }
+
+private:
+    static const int InputHistory = 128;
+    static const int InputsPerPacket = 8;
+    static const int SnapshotHistory = 32;
+
+    void receive();
+    void handleSnapshot(sf::Packet& packet);
+    void sendInputs();
+
+    World& world;
+    NetSocket socket;
+    sf::IpAddress serverAddress;
+    unsigned short serverPort;
+    sf::Clock connectClock;
+    int player;                        // -1 until accepted
+    bool rejected;
+
+    std::uint32_t inputSequence;       // of the newest input
+    PlayerInput inputs[InputHistory];  // by sequence % InputHistory
+
+    std::uint32_t latestSnapshot;      // newest snapshot applied (0 = none)
+    std::uint32_t historyId[SnapshotHistory];
+    SnapshotFields history[SnapshotHistory];
+    SnapshotFields decoded;
+    int serverLevelLoads;
+
+    std::size_t snapshots;
+    std::size_t fullSnapshots;
+    std::size_t correctionCount;
+    float maxCorrection;
+};
@@ -0,0 +1,25 @@
+#include "AssetPack.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// EscapeOreoPack: bundle loose asset files into a single archive.
+//
+//   EscapeOreoPack assets.pak tiles/background1.png tiles/bat1.png ...
+//
+// Run it from the directory the game runs from, so that entry names
+// match the paths the game asks for.
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " <output.pak> <file> [file...]\n";
+        return 1;
+    }
+
+    std::vector<std::string> inputs(argv + 2, argv + argc);
+    if (!writeAssetPack(argv[1], inputs))
+        return 1;
+
+    std::cout << "Packed " << inputs.size() << " files into " << argv[1] << "\n";
+    return 0;
+}
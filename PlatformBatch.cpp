@@ -0,0 +1,196 @@
+#include "PlatformBatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    void appendQuad(sf::VertexArray& vertices, const sf::FloatRect& rect, const sf::Color& color,
+        const sf::FloatRect& texRect) {
+        float right = rect.left + rect.width;
+        float bottom = rect.top + rect.height;
+        float texRight = texRect.left + texRect.width;
+        float texBottom = texRect.top + texRect.height;
+
+        vertices.append(sf::Vertex(sf::Vector2f(rect.left, rect.top), color, sf::Vector2f(texRect.left, texRect.top)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, rect.top), color, sf::Vector2f(texRight, texRect.top)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(texRight, texBottom)));
+        vertices.append(sf::Vertex(sf::Vector2f(rect.left, bottom), color, sf::Vector2f(texRect.left, texBottom)));
+    }
+
+    // Platforms are only ever positioned: no origin, rotation or scale
+    sf::FloatRect fillRect(const Platform& platform) {
+        return sf::FloatRect(platform.shape.getPosition(), platform.shape.getSize());
+    }
+
+    sf::FloatRect unite(const sf::FloatRect& a, const sf::FloatRect& b) {
+        float left = std::min(a.left, b.left);
+        float top = std::min(a.top, b.top);
+        float right = std::max(a.left + a.width, b.left + b.width);
+        float bottom = std::max(a.top + a.height, b.top + b.height);
+        return sf::FloatRect(left, top, right - left, bottom - top);
+    }
+}
+
+
+PlatformBatch::PlatformBatch()
+    : originX(0.f), maxReach(0.f), anyDirty(false)
+{
+}
+
+void PlatformBatch::build(const Pool<Platform>& platforms) {
+    // Chunk 0 starts at the leftmost platform
+    originX = 0.f;
+    maxReach = 0.f;
+    bool first = true;
+    for (const auto& platform : platforms) {
+        sf::FloatRect bounds = platform.shape.getGlobalBounds();
+        originX = first ? bounds.left : std::min(originX, bounds.left);
+        maxReach = std::max(maxReach, bounds.width);
+        first = false;
+    }
+
+    int count = 0;
+    for (const auto& platform : platforms)
+        count = std::max(count, chunkIndex(platform) + 1);
+
+    chunks.resize(static_cast<std::size_t>(count));
+    for (auto& chunk : chunks)
+        clearChunk(chunk);
+
+    for (const auto& platform : platforms)
+        addPlatform(chunks[chunkIndex(platform)], platform);
+
+    anyDirty = false;
+}
+
+bool PlatformBatch::invalidate(const Platform& platform) {
+    int index = chunkIndex(platform);
+    if (index < 0 || index >= static_cast<int>(chunks.size()))
+        return false;   // not baked yet: build() will pick it up
+
+    chunks[index].dirty = true;
+    anyDirty = true;
+    return true;
+}
+
+void PlatformBatch::refresh(const Pool<Platform>& platforms, const TileGrid* grid) {
+    if (!anyDirty)
+        return;
+
+    if (grid) {
+        // Each dirty chunk from the platforms the grid finds in its column
+        sf::FloatRect column(0.f, grid->origin().y, static_cast<float>(ChunkWidth),
+            static_cast<float>(grid->rows() * TileGrid::CellSize));
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            if (!chunks[i].dirty)
+                continue;
+
+            column.left = originX + i * ChunkWidth;
+            chunkItems.clear();
+            grid->forEachInBox(column, [&](int item) {
+                if (chunkIndex(grid->platform(item)) == static_cast<int>(i))
+                    chunkItems.push_back(item);
+            });
+            std::sort(chunkItems.begin(), chunkItems.end());
+
+            clearChunk(chunks[i]);
+            for (int item : chunkItems)
+                addPlatform(chunks[i], grid->platform(item));
+        }
+        anyDirty = false;
+        return;
+    }
+
+    for (auto& chunk : chunks) {
+        if (chunk.dirty)
+            clearChunk(chunk);
+    }
+
+    // One pass over the platforms re-bakes every dirty chunk
+    for (const auto& platform : platforms) {
+        int index = chunkIndex(platform);
+        if (index >= 0 && index < static_cast<int>(chunks.size()) && chunks[index].dirty)
+            addPlatform(chunks[index], platform);
+    }
+
+    for (auto& chunk : chunks)
+        chunk.dirty = false;
+    anyDirty = false;
+}
+
+void PlatformBatch::draw(sf::RenderTarget& target, const sf::FloatRect& visible) const {
+    if (chunks.empty())
+        return;
+
+    // A platform may start up to maxReach left of the view and still show
+    int first = static_cast<int>(std::floor((visible.left - maxReach - originX) / ChunkWidth));
+    int last = static_cast<int>(std::floor((visible.left + visible.width - originX) / ChunkWidth));
+    first = std::max(first, 0);
+    last = std::min(last, static_cast<int>(chunks.size()) - 1);
+
+    for (int i = first; i <= last; ++i) {
+        const Chunk& chunk = chunks[i];
+        if (!chunk.bounds.intersects(visible))
+            continue;
+
+        for (const auto& layer : chunk.layers) {
+            if (layer.vertices.getVertexCount() == 0)
+                continue;
+            sf::RenderStates states;
+            states.texture = layer.texture;
+            target.draw(layer.vertices, states);
+        }
+    }
+}
+
+sf::VertexArray& PlatformBatch::layerFor(Chunk& chunk, const sf::Texture* texture) {
+    for (auto& layer : chunk.layers) {
+        if (layer.texture == texture)
+            return layer.vertices;
+    }
+
+    Layer added;
+    added.texture = texture;
+    added.vertices.setPrimitiveType(sf::Quads);
+    chunk.layers.push_back(added);
+    return chunk.layers.back().vertices;
+}
+
+int PlatformBatch::chunkIndex(const Platform& platform) const {
+    float left = platform.shape.getGlobalBounds().left;
+    return static_cast<int>(std::floor((left - originX) / ChunkWidth));
+}
+
+void PlatformBatch::clearChunk(Chunk& chunk) {
+    // Keep the layers and their vertex storage for the next bake
+    for (auto& layer : chunk.layers)
+        layer.vertices.clear();
+    chunk.bounds = sf::FloatRect();
+    chunk.dirty = false;
+}
+
+void PlatformBatch::addPlatform(Chunk& chunk, const Platform& platform) {
+    const sf::RectangleShape& shape = platform.shape;
+    const sf::Texture* texture = shape.getTexture();
+
+    // Fill, then the outline around it, like sf::Shape draws them
+    sf::FloatRect rect = fillRect(platform);
+    sf::FloatRect texRect = texture ? sf::FloatRect(shape.getTextureRect()) : sf::FloatRect();
+    appendQuad(layerFor(chunk, texture), rect, shape.getFillColor(), texRect);
+
+    float t = shape.getOutlineThickness();
+    if (t > 0.f) {
+        sf::VertexArray& outline = layerFor(chunk, nullptr);
+        const sf::Color& color = shape.getOutlineColor();
+        float right = rect.left + rect.width;
+        float bottom = rect.top + rect.height;
+        sf::FloatRect none;
+        appendQuad(outline, sf::FloatRect(rect.left - t, rect.top - t, rect.width + 2 * t, t), color, none);
+        appendQuad(outline, sf::FloatRect(rect.left - t, bottom, rect.width + 2 * t, t), color, none);
+        appendQuad(outline, sf::FloatRect(rect.left - t, rect.top, t, rect.height), color, none);
+        appendQuad(outline, sf::FloatRect(right, rect.top, t, rect.height), color, none);
+    }
+
+    sf::FloatRect bounds = shape.getGlobalBounds();
+    chunk.bounds = (chunk.bounds.width > 0.f || chunk.bounds.height > 0.f) ? unite(chunk.bounds, bounds) : bounds;
+}
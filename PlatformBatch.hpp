@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "Entities.hpp"
+#include "Pool.hpp"
+#include "TileGrid.hpp"
+
+// ------------------------------------------------------------------
+// The level's platforms baked into a few vertex arrays
+//
+// The level is cut in ChunkWidth wide columns. Each chunk holds one
+// vertex array per texture (plain-colour blocks and their outlines
+// share the untextured one), with the platforms whose left edge lies
+// in the column, in creation order.
+//
+// Baked once per level load, then drawing a view only walks the chunks
+// it overlaps: a few draw calls each, whatever the size of the level.
+// That is what keeps split-screen cheap, every view reuses the same
+// geometry and only the culling differs.
+// ------------------------------------------------------------------
+class PlatformBatch {
+public:
+    static const int ChunkWidth = 256;   // world pixels
+
+    PlatformBatch();
+
+    // Bake every platform (after a level load); storage is reused
+    void build(const Pool<Platform>& platforms);
+
+    // The look of a platform changed, or it was added or is about to be
+    // removed: re-bake its chunk before the next draw. Cheap, may be
+    // called from the simulation. False when the platform lies outside
+    // the baked chunks (build() again then).
+    bool invalidate(const Platform& platform);
+
+    // Re-bake the invalidated chunks, if any. With the level's grid only
+    // the platforms of those chunks are looked at, not every platform.
+    void refresh(const Pool<Platform>& platforms, const TileGrid* grid = nullptr);
+
+    // Draw the chunks overlapping `visible` (world coordinates)
+    void draw(sf::RenderTarget& target, const sf::FloatRect& visible) const;
+
+    std::size_t chunkCount() const { return chunks.size(); }
+
+private:
+    struct Layer {
+        const sf::Texture* texture;   // null = plain colours
+        sf::VertexArray vertices;
+    };
+
+    struct Chunk {
+        std::vector<Layer> layers;
+        sf::FloatRect bounds;         // of its platforms, outlines included
+        bool dirty;
+    };
+
+    int chunkIndex(const Platform& platform) const;
+    void clearChunk(Chunk& chunk);
+    void addPlatform(Chunk& chunk, const Platform& platform);
+    static sf::VertexArray& layerFor(Chunk& chunk, const sf::Texture* texture);
+
+    std::vector<Chunk> chunks;
+    std::vector<int> chunkItems;   // refresh() scratch: grid items of a chunk
+    float originX;     // left edge of chunk 0
+    float maxReach;    // widest platform: how far one spills into the next chunks
+    bool anyDirty;
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Fixed-capacity object pool
+//
+// Storage for all the objects is allocated once, by the constructor.
+// Free slots are chained in a free list, so create() and destroy()
+// never touch the heap themselves (T's constructor still may).
+//
+// Every slot has a generation counter: odd while it holds an object,
+// even while it is free. A Handle remembers the generation its object
+// was created with, so get() returns nullptr for a handle whose object
+// has been destroyed, even if the slot has been reused since.
+//
+// clear() is the per-level arena reset: every object is destroyed at
+// once, the storage is kept for the next level.
+// ------------------------------------------------------------------
+template <typename T>
+class Pool {
+private:
+    struct Slot {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::uint32_t generation;   // odd = alive
+        std::uint32_t nextFree;     // next slot of the free list (free slots only)
+    };
+
+    static const std::uint32_t NoSlot = 0xFFFFFFFFu;
+
+public:
+    struct Handle {
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0;   // 0 never matches a live object: null handle
+
+        bool isNull() const { return generation == 0; }
+    };
+
+    // Iterates over the live objects only, in slot order
+    template <typename PoolType, typename Value>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        Iterator(PoolType* pool, std::size_t index) : pool(pool), index(index) { skipFree(); }
+
+        reference operator*() const { return *pool->object(index); }
+        pointer operator->() const { return pool->object(index); }
+
+        Iterator& operator++() { ++index; skipFree(); return *this; }
+        Iterator operator++(int) { Iterator old(*this); ++*this; return old; }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        void skipFree() {
+            while (index < pool->slots.size() && !(pool->slots[index].generation & 1u))
+                ++index;
+        }
+
+        PoolType* pool;
+        std::size_t index;
+    };
+
+    using iterator = Iterator<Pool, T>;
+    using const_iterator = Iterator<const Pool, const T>;
+
+    explicit Pool(std::size_t capacity) : slots(capacity), freeHead(NoSlot), liveCount(0) {
+        for (std::size_t i = 0; i < slots.size(); ++i)
+            slots[i].generation = 0;
+        rebuildFreeList();
+    }
+
+    ~Pool() {
+        clear();
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // Construct an object in a free slot; returns a null handle if the
+    // pool is full
+    template <typename... Args>
+    Handle create(Args&&... args) {
+        Handle handle;
+        if (freeHead == NoSlot)
+            return handle;
+
+        std::uint32_t index = freeHead;
+        Slot& slot = slots[index];
+        new (&slot.storage) T(std::forward<Args>(args)...);
+        freeHead = slot.nextFree;
+        slot.generation++;
+        liveCount++;
+
+        handle.index = index;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    // Destroy the object of a handle; stale and null handles are ignored
+    void destroy(Handle handle) {
+        if (!get(handle))
+            return;
+
+        Slot& slot = slots[handle.index];
+        object(handle.index)->~T();
+        slot.generation++;
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+        liveCount--;
+    }
+
+    // Object of a handle, or nullptr if it has been destroyed
+    T* get(Handle handle) {
+        return isAlive(handle) ? object(handle.index) : nullptr;
+    }
+
+    const T* get(Handle handle) const {
+        return isAlive(handle) ? object(handle.index) : nullptr;
+    }
+
+    // Handle of a live object of this pool (e.g. one reached by
+    // iterating); a null handle for anything else
+    Handle handleOf(const T* object) const {
+        Handle handle;
+        const Slot* slot = reinterpret_cast<const Slot*>(object);   // storage comes first in Slot
+        if (slots.empty() || slot < slots.data() || slot >= slots.data() + slots.size())
+            return handle;
+
+        std::uint32_t index = static_cast<std::uint32_t>(slot - slots.data());
+        if (slots[index].generation & 1u) {
+            handle.index = index;
+            handle.generation = slots[index].generation;
+        }
+        return handle;
+    }
+
+    // Destroy every object; all existing handles become stale
+    void clear() {
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].generation & 1u) {
+                object(i)->~T();
+                slots[i].generation++;
+            }
+        }
+        liveCount = 0;
+        rebuildFreeList();
+    }
+
+    std::size_t size() const { return liveCount; }
+    std::size_t capacity() const { return slots.size(); }
+    bool empty() const { return liveCount == 0; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, slots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+
+private:
+    bool isAlive(Handle handle) const {
+        return handle.generation != 0 && handle.index < slots.size() &&
+            slots[handle.index].generation == handle.generation;
+    }
+
+    T* object(std::size_t index) {
+        return reinterpret_cast<T*>(&slots[index].storage);
+    }
+
+    const T* object(std::size_t index) const {
+        return reinterpret_cast<const T*>(&slots[index].storage);
+    }
+
+    // Chain the slots in index order, so that a level rebuilt after
+    // clear() is laid out (and iterated) in creation order
+    void rebuildFreeList() {
+        freeHead = slots.empty() ? NoSlot : 0;
+        for (std::size_t i = 0; i < slots.size(); ++i)
+            slots[i].nextFree = (i + 1 < slots.size()) ? static_cast<std::uint32_t>(i + 1) : NoSlot;
+    }
+
+    std::vector<Slot> slots;
+    std::uint32_t freeHead;
+    std::size_t liveCount;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// ------------------------------------------------------------------
+// Split-screen layout for local co-op
+//
+// 1 player: the whole window. 2 players: left and right halves, each
+// showing half the usual width of the level at full size. 3 or 4
+// players: quarters, each showing the usual 800x600 at half size.
+// ------------------------------------------------------------------
+namespace SplitScreen {
+    // Part of the window given to player `index`, as an sf::View viewport
+    inline sf::FloatRect viewport(int index, int count) {
+        if (count <= 1)
+            return sf::FloatRect(0.f, 0.f, 1.f, 1.f);
+        if (count == 2)
+            return sf::FloatRect(0.5f * index, 0.f, 0.5f, 1.f);
+        return sf::FloatRect(0.5f * (index % 2), 0.5f * (index / 2), 0.5f, 0.5f);
+    }
+
+    // Size of the part of the level each view shows
+    inline sf::Vector2f viewSize(int count) {
+        return count == 2 ? sf::Vector2f(400.f, 600.f) : sf::Vector2f(800.f, 600.f);
+    }
+
+    // Colour telling the players apart (minimap markers, sprite tint)
+    inline sf::Color playerColor(int index) {
+        static const sf::Color colors[4] = {
+            sf::Color(80, 255, 120),
+            sf::Color(90, 170, 255),
+            sf::Color(255, 110, 200),
+            sf::Color(255, 230, 80)
+        };
+        return colors[index & 3];
+    }
+}
@@ -0,0 +1,396 @@
+#include "TileGrid.hpp"
+
+#include <limits>
+
+namespace {
+    // Segment p + t * d, t in [0, 1], against a box (slab test).
+    // Entry fraction and the normal of the side entered.
+    bool segmentVsBox(sf::Vector2f p, sf::Vector2f d, const sf::FloatRect& box, float& fraction, sf::Vector2f& normal) {
+        float tEnter = 0.f, tExit = 1.f;
+        sf::Vector2f n;
+
+        const float start[2] = { p.x, p.y };
+        const float dir[2] = { d.x, d.y };
+        const float low[2] = { box.left, box.top };
+        const float high[2] = { box.left + box.width, box.top + box.height };
+
+        for (int axis = 0; axis < 2; ++axis) {
+            if (std::abs(dir[axis]) < 1e-8f) {
+                if (start[axis] <= low[axis] || start[axis] >= high[axis])
+                    return false;
+                continue;
+            }
+
+            float t0 = (low[axis] - start[axis]) / dir[axis];
+            float t1 = (high[axis] - start[axis]) / dir[axis];
+            float side = -1.f;              // entering through the low side
+            if (t0 > t1) {
+                std::swap(t0, t1);
+                side = 1.f;
+            }
+            if (t0 > tEnter) {
+                tEnter = t0;
+                n = (axis == 0) ? sf::Vector2f(side, 0.f) : sf::Vector2f(0.f, side);
+            }
+            tExit = std::min(tExit, t1);
+            if (tEnter >= tExit)
+                return false;
+        }
+
+        fraction = tEnter;
+        normal = n;
+        return true;
+    }
+
+    float distanceToBox(sf::Vector2f p, const sf::FloatRect& box, sf::Vector2f& closest) {
+        closest.x = std::max(box.left, std::min(p.x, box.left + box.width));
+        closest.y = std::max(box.top, std::min(p.y, box.top + box.height));
+        sf::Vector2f d = p - closest;
+        return std::sqrt(d.x * d.x + d.y * d.y);
+    }
+}
+
+
+TileGrid::TileGrid()
+    : gridColumns(0), gridRows(0)
+{
+}
+
+void TileGrid::build(Pool<Platform>& platforms) {
+    boxes.clear();
+    owners.clear();
+    freeItems.clear();
+    for (auto& platform : platforms) {
+        boxes.push_back(platform.shape.getGlobalBounds());
+        owners.push_back(&platform);
+    }
+
+    // Grid over the bounds of every box
+    float left = 0.f, top = 0.f, right = 0.f, bottom = 0.f;
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        const sf::FloatRect& b = boxes[i];
+        left = i ? std::min(left, b.left) : b.left;
+        top = i ? std::min(top, b.top) : b.top;
+        right = i ? std::max(right, b.left + b.width) : b.left + b.width;
+        bottom = i ? std::max(bottom, b.top + b.height) : b.top + b.height;
+    }
+    gridOrigin = sf::Vector2f(std::floor(left / CellSize) * CellSize, std::floor(top / CellSize) * CellSize);
+    gridColumns = std::max(1, static_cast<int>(std::ceil((right - gridOrigin.x) / CellSize)));
+    gridRows = std::max(1, static_cast<int>(std::ceil((bottom - gridOrigin.y) / CellSize)));
+
+    // Count per cell, prefix sums (counts plus the slack), then fill:
+    // items end up in index order in every cell
+    std::size_t cells = static_cast<std::size_t>(gridColumns) * gridRows;
+    cellCount.assign(cells, 0);
+    for (const auto& b : boxes) {
+        int x0, y0, x1, y1;
+        if (cellRange(b, x0, y0, x1, y1)) {
+            for (int y = y0; y < y1; ++y)
+                for (int x = x0; x < x1; ++x)
+                    cellCount[y * gridColumns + x]++;
+        }
+    }
+    cellStart.resize(cells + 1);
+    cellStart[0] = 0;
+    for (std::size_t c = 0; c < cells; ++c)
+        cellStart[c + 1] = cellStart[c] + cellCount[c] + Slack;
+
+    items.resize(cellStart[cells]);
+    std::fill(cellCount.begin(), cellCount.end(), 0);
+    for (std::size_t item = 0; item < boxes.size(); ++item) {
+        int x0, y0, x1, y1;
+        if (cellRange(boxes[item], x0, y0, x1, y1)) {
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    int cell = y * gridColumns + x;
+                    items[cellStart[cell] + cellCount[cell]++] = static_cast<int>(item);
+                }
+            }
+        }
+    }
+}
+
+bool TileGrid::insert(Platform& platform) {
+    sf::FloatRect box = platform.shape.getGlobalBounds();
+    sf::FloatRect area(gridOrigin, sf::Vector2f(static_cast<float>(gridColumns * CellSize), static_cast<float>(gridRows * CellSize)));
+    if (box.left < area.left || box.top < area.top ||
+        box.left + box.width > area.left + area.width || box.top + box.height > area.top + area.height)
+        return false;
+
+    int x0, y0, x1, y1;
+    if (!cellRange(box, x0, y0, x1, y1))
+        return false;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            int cell = y * gridColumns + x;
+            if (cellStart[cell] + cellCount[cell] >= cellStart[cell + 1])
+                return false;
+        }
+    }
+
+    int item;
+    if (!freeItems.empty()) {
+        item = freeItems.back();
+        freeItems.pop_back();
+        boxes[item] = box;
+        owners[item] = &platform;
+    }
+    else {
+        item = static_cast<int>(boxes.size());
+        boxes.push_back(box);
+        owners.push_back(&platform);
+    }
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            int cell = y * gridColumns + x;
+            items[cellStart[cell] + cellCount[cell]++] = item;
+        }
+    }
+    return true;
+}
+
+void TileGrid::remove(int item) {
+    int x0, y0, x1, y1;
+    if (cellRange(boxes[item], x0, y0, x1, y1)) {
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                // Swap with the cell's last item
+                int cell = y * gridColumns + x;
+                int* begin = items.data() + cellStart[cell];
+                int* end = begin + cellCount[cell];
+                int* found = std::find(begin, end, item);
+                if (found != end) {
+                    *found = *(end - 1);
+                    cellCount[cell]--;
+                }
+            }
+        }
+    }
+
+    boxes[item] = sf::FloatRect();   // intersects nothing
+    owners[item] = nullptr;
+    freeItems.push_back(item);
+}
+
+bool TileGrid::cellRange(const sf::FloatRect& area, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = std::max(0, static_cast<int>(std::floor((area.left - gridOrigin.x) / CellSize)));
+    y0 = std::max(0, static_cast<int>(std::floor((area.top - gridOrigin.y) / CellSize)));
+    // Right and bottom edges are exclusive: a block ending on a cell
+    // boundary does not reach into the next cell
+    x1 = std::min(gridColumns, std::max(x0 + 1, static_cast<int>(std::ceil((area.left + area.width - gridOrigin.x) / CellSize))));
+    y1 = std::min(gridRows, std::max(y0 + 1, static_cast<int>(std::ceil((area.top + area.height - gridOrigin.y) / CellSize))));
+    return x0 < x1 && y0 < y1;
+}
+
+bool TileGrid::raycast(sf::Vector2f from, sf::Vector2f to, RayHit* hit) const {
+    if (boxes.empty())
+        return false;
+
+    sf::Vector2f d = to - from;
+
+    // Clip the segment to the grid, then walk its cells in order (DDA)
+    sf::FloatRect area(gridOrigin, sf::Vector2f(static_cast<float>(gridColumns * CellSize), static_cast<float>(gridRows * CellSize)));
+    float tStart = 0.f, tEnd = 1.f;
+    {
+        sf::Vector2f unused;
+        float enter;
+        if (!area.contains(from)) {
+            if (!segmentVsBox(from, d, area, enter, unused))
+                return false;
+            tStart = enter;
+        }
+        if (!area.contains(to)) {
+            // Exit point: enter fraction of the reversed segment
+            if (!segmentVsBox(to, -d, area, enter, unused))
+                return false;
+            tEnd = 1.f - enter;
+        }
+    }
+
+    sf::Vector2f start = from + d * tStart;
+    int x = std::min(gridColumns - 1, std::max(0, static_cast<int>(std::floor((start.x - gridOrigin.x) / CellSize))));
+    int y = std::min(gridRows - 1, std::max(0, static_cast<int>(std::floor((start.y - gridOrigin.y) / CellSize))));
+
+    const float inf = std::numeric_limits<float>::infinity();
+    int stepX = d.x > 0.f ? 1 : (d.x < 0.f ? -1 : 0);
+    int stepY = d.y > 0.f ? 1 : (d.y < 0.f ? -1 : 0);
+    float deltaX = stepX ? CellSize / std::abs(d.x) : inf;     // t to cross a whole cell
+    float deltaY = stepY ? CellSize / std::abs(d.y) : inf;
+    float nextX = stepX ? ((gridOrigin.x + (x + (stepX > 0 ? 1 : 0)) * CellSize) - from.x) / d.x : inf;
+    float nextY = stepY ? ((gridOrigin.y + (y + (stepY > 0 ? 1 : 0)) * CellSize) - from.y) / d.y : inf;
+
+    while (true) {
+        // Nearest box of this cell hit before the segment leaves the cell
+        float cellExit = std::min(std::min(nextX, nextY), tEnd);
+        float best = inf;
+        sf::Vector2f bestNormal;
+        int bestItem = -1;
+
+        int cell = y * gridColumns + x;
+        for (int i = cellStart[cell]; i < cellStart[cell] + cellCount[cell]; ++i) {
+            float fraction;
+            sf::Vector2f normal;
+            if (segmentVsBox(from, d, boxes[items[i]], fraction, normal) && fraction < best && fraction <= cellExit) {
+                best = fraction;
+                bestNormal = normal;
+                bestItem = items[i];
+            }
+        }
+
+        if (bestItem >= 0) {
+            if (hit) {
+                hit->point = from + d * best;
+                hit->normal = bestNormal;
+                hit->fraction = best;
+                hit->item = bestItem;
+            }
+            return true;
+        }
+
+        if (cellExit >= tEnd)
+            return false;
+
+        if (nextX < nextY) {
+            x += stepX;
+            nextX += deltaX;
+        }
+        else {
+            y += stepY;
+            nextY += deltaY;
+        }
+        if (x < 0 || y < 0 || x >= gridColumns || y >= gridRows)
+            return false;
+    }
+}
+
+std::size_t TileGrid::queryBox(const sf::FloatRect& area, int* out, std::size_t capacity) const {
+    std::size_t count = 0;
+    forEachInBox(area, [&](int item) {
+        if (count < capacity)
+            out[count] = item;
+        count++;
+    });
+
+    // Cells are scanned row by row: restore item (creation) order
+    std::sort(out, out + std::min(count, capacity));
+    return count;
+}
+
+bool TileGrid::anyInBox(const sf::FloatRect& area) const {
+    int x0, y0, x1, y1;
+    if (!cellRange(area, x0, y0, x1, y1))
+        return false;
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            int cell = y * gridColumns + x;
+            for (int i = cellStart[cell]; i < cellStart[cell] + cellCount[cell]; ++i) {
+                if (boxes[items[i]].intersects(area))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool TileGrid::sweep(const sf::FloatRect& box, sf::Vector2f delta, SweepHit* hit) const {
+    // Everything the box passes over
+    sf::FloatRect region(std::min(box.left, box.left + delta.x), std::min(box.top, box.top + delta.y),
+        box.width + std::abs(delta.x), box.height + std::abs(delta.y));
+
+    // The box's centre against every platform grown by the box's half size
+    sf::Vector2f half(box.width / 2.f, box.height / 2.f);
+    sf::Vector2f centre(box.left + half.x, box.top + half.y);
+
+    float best = 2.f;
+    sf::Vector2f bestNormal;
+    int bestItem = -1;
+    forEachInBox(region, [&](int item) {
+        const sf::FloatRect& b = boxes[item];
+        sf::FloatRect grown(b.left - half.x, b.top - half.y, b.width + box.width, b.height + box.height);
+
+        float fraction;
+        sf::Vector2f normal;
+        if (segmentVsBox(centre, delta, grown, fraction, normal) && fraction < best) {
+            best = fraction;
+            bestNormal = normal;
+            bestItem = item;
+        }
+    });
+
+    if (bestItem < 0)
+        return false;
+
+    if (hit) {
+        hit->fraction = best;
+        hit->normal = bestNormal;
+        hit->item = bestItem;
+    }
+    return true;
+}
+
+bool TileGrid::nearestSolid(sf::Vector2f point, float maxDistance, sf::Vector2f* closest, int* item) const {
+    if (boxes.empty())
+        return false;
+
+    sf::Vector2i centre = cellOf(point);
+    int maxRing = static_cast<int>(std::ceil(maxDistance / CellSize)) + 1;
+
+    float best = maxDistance;
+    int bestItem = -1;
+    sf::Vector2f bestPoint;
+
+    // Rings of cells around the point's cell; boxes in ring r + 1 are at
+    // least r cells away, so stop once the best is closer than that
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        for (int y = centre.y - ring; y <= centre.y + ring; ++y) {
+            if (y < 0 || y >= gridRows)
+                continue;
+            bool edgeRow = (y == centre.y - ring || y == centre.y + ring);
+            for (int x = centre.x - ring; x <= centre.x + ring; x += (edgeRow || ring == 0) ? 1 : 2 * ring) {
+                if (x < 0 || x >= gridColumns)
+                    continue;
+
+                int cell = y * gridColumns + x;
+                for (int i = cellStart[cell]; i < cellStart[cell] + cellCount[cell]; ++i) {
+                    sf::Vector2f p;
+                    float distance = distanceToBox(point, boxes[items[i]], p);
+                    if (distance <= best && (bestItem < 0 || distance < best || items[i] < bestItem)) {
+                        best = distance;
+                        bestItem = items[i];
+                        bestPoint = p;
+                    }
+                }
+            }
+        }
+
+        if (bestItem >= 0 && best <= static_cast<float>(ring * CellSize))
+            break;
+    }
+
+    if (bestItem < 0)
+        return false;
+
+    if (closest)
+        *closest = bestPoint;
+    if (item)
+        *item = bestItem;
+    return true;
+}
+
+bool TileGrid::isSolidCell(int column, int row) const {
+    if (column < 0 || row < 0 || column >= gridColumns || row >= gridRows)
+        return false;
+    return cellCount[row * gridColumns + column] > 0;
+}
+
+sf::FloatRect TileGrid::cellBounds(int column, int row) const {
+    return sf::FloatRect(gridOrigin.x + column * CellSize, gridOrigin.y + row * CellSize,
+        static_cast<float>(CellSize), static_cast<float>(CellSize));
+}
+
+sf::Vector2i TileGrid::cellOf(sf::Vector2f point) const {
+    return sf::Vector2i(static_cast<int>(std::floor((point.x - gridOrigin.x) / CellSize)),
+        static_cast<int>(std::floor((point.y - gridOrigin.y) / CellSize)));
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Entities.hpp"
+#include "Pool.hpp"
+
+// ------------------------------------------------------------------
+// Spatial index of the level's platforms over a grid of 32 px cells
+//
+// Built once per level load. Each cell lists the platforms overlapping
+// it, all lists packed in one array (cellCount[c] items from
+// cellStart[c] in `items`, with a little room to spare up to
+// cellStart[c + 1]), so a query only looks at the platforms of the
+// cells it crosses instead of every platform of the level. The level
+// editor adds and removes single platforms in place (insert, remove).
+//
+// Queries never allocate: results go to a visitor or to a buffer the
+// caller provides. An item is a platform's index in creation order
+// (the order World iterates them in); bounds(item) and platform(item)
+// give it back. Boxes are the platforms' global bounds, as used by the
+// collisions.
+// ------------------------------------------------------------------
+struct RayHit {
+    sf::Vector2f point;
+    sf::Vector2f normal;       // of the side that was hit; zero if starting inside
+    float fraction;            // 0 at `from`, 1 at `to`
+    int item;
+};
+
+struct SweepHit {
+    float fraction;            // how much of the move happens before contact
+    sf::Vector2f normal;
+    int item;
+};
+
+class TileGrid {
+public:
+    static const int CellSize = 32;
+
+    TileGrid();
+
+    // Index every platform; storage is reused from level to level
+    void build(Pool<Platform>& platforms);
+
+    // Index one more platform, touching only its cells. False when it
+    // does not fit (outside the grid, or a cell out of spare room):
+    // build() again then.
+    bool insert(Platform& platform);
+
+    // Forget an item; its index may be reused by insert()
+    void remove(int item);
+
+    // First platform the segment from -> to runs into
+    bool raycast(sf::Vector2f from, sf::Vector2f to, RayHit* hit = nullptr) const;
+
+    bool lineOfSight(sf::Vector2f from, sf::Vector2f to) const { return !raycast(from, to); }
+
+    // Call visit(item) once for every platform overlapping `area`
+    template <typename Visitor>
+    void forEachInBox(const sf::FloatRect& area, Visitor visit) const;
+
+    // Platforms overlapping `area`, up to `capacity` of them written to
+    // `out` in item order; returns how many there are (possibly more
+    // than capacity)
+    std::size_t queryBox(const sf::FloatRect& area, int* out, std::size_t capacity) const;
+
+    bool anyInBox(const sf::FloatRect& area) const;
+
+    // Move `box` by `delta`: the first platform it would touch, if any
+    bool sweep(const sf::FloatRect& box, sf::Vector2f delta, SweepHit* hit = nullptr) const;
+
+    // Closest platform within maxDistance of `point`, and the closest
+    // point of it (the point itself when inside)
+    bool nearestSolid(sf::Vector2f point, float maxDistance, sf::Vector2f* closest = nullptr, int* item = nullptr) const;
+
+    // Cells holding at least one platform
+    bool isSolidCell(int column, int row) const;
+    sf::FloatRect cellBounds(int column, int row) const;
+    sf::Vector2i cellOf(sf::Vector2f point) const;
+
+    int columns() const { return gridColumns; }
+    int rows() const { return gridRows; }
+    sf::Vector2f origin() const { return gridOrigin; }
+
+    // Item indices in use so far (removed ones included)
+    std::size_t itemCount() const { return boxes.size(); }
+    const sf::FloatRect& bounds(int item) const { return boxes[item]; }
+    Platform& platform(int item) const { return *owners[item]; }
+
+private:
+    // Spare room per cell for insert(): a 32 px block with its outline
+    // covers 3x3 cells, so painting every tile around a cell adds 9
+    static const int Slack = 9;
+
+    // Cell range [x0, x1) x [y0, y1) covered by `area`, clipped to the grid
+    bool cellRange(const sf::FloatRect& area, int& x0, int& y0, int& x1, int& y1) const;
+
+    sf::Vector2f gridOrigin;
+    int gridColumns;
+    int gridRows;
+
+    std::vector<sf::FloatRect> boxes;  // empty for removed items
+    std::vector<Platform*> owners;
+    std::vector<int> cellStart;      // gridColumns * gridRows + 1 offsets into items
+    std::vector<int> cellCount;      // items used in each cell
+    std::vector<int> items;
+    std::vector<int> freeItems;      // removed item indices
+};
+
+
+template <typename Visitor>
+void TileGrid::forEachInBox(const sf::FloatRect& area, Visitor visit) const {
+    int x0, y0, x1, y1;
+    if (!cellRange(area, x0, y0, x1, y1))
+        return;
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            int cell = y * gridColumns + x;
+            for (int i = cellStart[cell]; i < cellStart[cell] + cellCount[cell]; ++i) {
+                int item = items[i];
+                const sf::FloatRect& b = boxes[item];
+                if (!b.intersects(area))
+                    continue;
+
+                // An item spans several cells: report it from the first
+                // cell it shares with the query only
+                int firstX = std::max(x0, static_cast<int>(std::floor((b.left - gridOrigin.x) / CellSize)));
+                int firstY = std::max(y0, static_cast<int>(std::floor((b.top - gridOrigin.y) / CellSize)));
+                if (x == firstX && y == firstY)
+                    visit(item);
+            }
+        }
+    }
+}
@@ -0,0 +1,1171 @@
+#include "World.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    sf::Vector2f centreOf(const sf::FloatRect& box) {
+        return sf::Vector2f(box.left + box.width / 2.f, box.top + box.height / 2.f);
+    }
+
+    // Append `copies - 1` shifted copies of everything in a pool
+    template <typename T, typename Shift>
+    void replicate(Pool<T>& pool, int copies, float spacing, Shift shift) {
+        std::vector<T> original(pool.begin(), pool.end());
+        for (int k = 1; k < copies; ++k) {
+            for (const T& entity : original) {
+                T* copy = pool.get(pool.create(entity));
+                if (!copy)
+                    return;   // pool full
+                shift(*copy, k * spacing);
+            }
+        }
+    }
+
+    // Remove the first entity of a pool whose bounds contain `point`
+    template <typename T>
+    bool eraseAt(Pool<T>& pool, sf::Vector2f point) {
+        for (T& entity : pool) {
+            if (entity.getBounds().contains(point)) {
+                pool.destroy(pool.handleOf(&entity));
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+
+World::World(std::size_t capacityScale)
+    : players(MAX_PLAYERS, Player(100, 300)),
+    playerCount(1),
+    platforms(MAX_PLATFORMS * capacityScale),
+    diamonds(MAX_DIAMONDS * capacityScale),
+    enemies(MAX_ENEMIES * capacityScale),
+    fallingRocks(MAX_FALLING_ROCKS * capacityScale),
+    icicles(MAX_ICICLES * capacityScale),
+    lavaPools(MAX_LAVA_POOLS * capacityScale),
+    hammers(1),
+    boulders(1),
+    currentLevel(1),
+    lives(3),
+    diamondsCollected(0),
+    score(0),
+    levelLoads(0),
+    levelEdits(0),
+    friction(0.85f),
+    chaseField(BAT_CHASE_RADIUS),
+    platformBatchLoads(-1)
+{
+}
+
+void World::setPlayerCount(int count) {
+    playerCount = std::max(1, std::min(count, MAX_PLAYERS));
+}
+
+void World::newGame() {
+    lives = 3;
+    score = 0;
+    diamondsCollected = 0;
+    loadLevel(1);
+}
+
+void World::loadLevel(int level) {
+    currentLevel = level;
+
+    // Levels saved by the editor replace the built-in layout
+    if (!loadLevelFile(levelFileName(level))) {
+        if (!levelError.empty())
+            std::cout << levelFileName(level) << ": " << levelError << ", using the built-in layout\n";
+        buildCommonLevelLayout();     // same layout for all 4 levels for now
+    }
+}
+
+void World::clearLevel() {
+    platforms.clear();
+    diamonds.clear();
+    enemies.clear();
+    fallingRocks.clear();
+    icicles.clear();
+    lavaPools.clear();
+    hammers.clear();
+    boulders.clear();
+    hammer = Pool<Hammer>::Handle();
+    boulder = Pool<Boulder>::Handle();
+    levelLoads++;
+}
+
+void World::buildSyntheticLevel(int level, int copies) {
+    // Always the built-in layout, never a level file saved by the
+    // editor, so that benchmark runs stay comparable
+    currentLevel = level;
+    buildCommonLevelLayout();
+
+    replicate(platforms, copies, WORLD_WIDTH, [](Platform& p, float dx) {
+        p.shape.move(dx, 0.f);
+    });
+    replicate(diamonds, copies, WORLD_WIDTH, [](Diamond& d, float dx) {
+        d.basePos.x += dx;
+        d.sprite.move(dx, 0.f);
+    });
+    replicate(enemies, copies, WORLD_WIDTH, [](Enemy& e, float dx) {
+        e.position.x += dx;
+        e.home.x += dx;
+        e.minX += dx;
+        e.maxX += dx;
+        e.sprite.setPosition(e.position);
+    });
+    replicate(fallingRocks, copies, WORLD_WIDTH, [](FallingRock& r, float dx) {
+        r.position.x += dx;
+        r.shape.setPosition(r.position);
+    });
+    replicate(icicles, copies, WORLD_WIDTH, [](Icicle& i, float dx) {
+        i.position.x += dx;
+        i.shape.setPosition(i.position);
+    });
+    replicate(lavaPools, copies, WORLD_WIDTH, [](LavaPool& l, float dx) {
+        l.position.x += dx;
+        l.shape.setPosition(l.position);
+    });
+
+    indexLevel();
+}
+
+void World::indexLevel() {
+    grid.build(platforms);
+    nav.build(grid);
+    chaseField.attach(nav);
+}
+
+TickResult World::playerDied() {
+    lives--;
+    if (lives <= 0)
+        return TICK_GAME_OVER;
+
+    loadLevel(currentLevel);
+    return TICK_RUNNING;
+}
+
+void World::movePlayer(Player& player, const PlayerInput& input) {
+    // ------- INPUT: only move when keys are pressed (fix drifting) -------
+    player.velocity.x = 0.f;   // reset each frame
+
+    // movement input...
+    if (input.left) {
+        player.velocity.x -= player.speed;
+    }
+    if (input.right) {
+        player.velocity.x += player.speed;
+    }
+
+    // NEW: update facing direction
+    if (player.velocity.x > 0.f)  player.facingDir = 1;
+    if (player.velocity.x < 0.f)  player.facingDir = -1;
+
+    // NEW: jump input
+    if (input.jump && player.grounded) {
+
+        player.velocity.y = player.jumpPower; // negative value = go up
+        player.grounded = false;
+    }
+
+
+    // ------- PHYSICS: horizontal then vertical with collision --------
+    // Only the platforms around the player can be hit; they are handled
+    // in creation order, like a scan of the whole pool would
+    const std::size_t MaxNearby = 64;
+    int nearby[MaxNearby];
+    std::size_t nearbyCount = 0;
+    auto gatherNearby = [&]() {
+        sf::FloatRect area = player.getBounds();
+        area.left -= 64.f;
+        area.top -= 64.f;
+        area.width += 128.f;
+        area.height += 128.f;
+        nearbyCount = grid.queryBox(area, nearby, MaxNearby);
+    };
+    auto forEachNearby = [&](auto visit) {
+        if (nearbyCount > MaxNearby) {
+            for (auto& platform : platforms)    // unusually crowded: scan them all
+                visit(platform);
+            return;
+        }
+        for (std::size_t i = 0; i < nearbyCount; ++i)
+            visit(grid.platform(nearby[i]));
+    };
+
+    // Horizontal move
+    player.position.x += player.velocity.x;
+    player.updatePosition();
+
+    gatherNearby();
+    forEachNearby([&](Platform& platform) {
+        sf::FloatRect playerBounds = player.getBounds();
+        sf::FloatRect platformBounds = platform.shape.getGlobalBounds();
+
+        if (playerBounds.intersects(platformBounds)) {
+            if (player.velocity.x > 0) {
+                player.position.x = platformBounds.left - playerBounds.width;
+            }
+            else if (player.velocity.x < 0) {
+                player.position.x = platformBounds.left + platformBounds.width;
+            }
+            player.updatePosition();
+        }
+    });
+
+    // Vertical move
+    player.velocity.y += GRAVITY;
+    float vyBefore = player.velocity.y;
+
+    player.position.y += player.velocity.y;
+
+    player.updatePosition();
+
+    player.grounded = false;
+    gatherNearby();
+    forEachNearby([&](Platform& platform) {
+        sf::FloatRect playerBounds = player.getBounds();
+        sf::FloatRect platformBounds = platform.shape.getGlobalBounds();
+
+        if (playerBounds.intersects(platformBounds)) {
+            if (vyBefore > 0) { // falling down onto platform
+                player.position.y = platformBounds.top - playerBounds.height;
+                player.velocity.y = 0;
+                player.grounded = true;
+                player.updatePosition();
+
+                if (platform.breakable) {
+                    platform.breakTimer += 1;
+                    if (platform.breakTimer > 120) {
+                        platform.shape.setFillColor(sf::Color(168, 216, 234, 150));
+                        if (platform.breakTimer < 122)
+                            platformBatch.invalidate(platform);   // colour just changed
+                    }
+                }
+            }
+            else if (vyBefore < 0) { // hitting head
+                player.position.y = platformBounds.top + platformBounds.height;
+                player.velocity.y = 0;
+                player.updatePosition();
+            }
+        }
+    });
+
+    // World bounds (for scrolling world)
+    if (player.position.x < 0) player.position.x = 0;
+    if (player.position.x + 32.f > WORLD_WIDTH) player.position.x = WORLD_WIDTH - 32.f;
+}
+
+void World::animate() {
+    for (auto& diamond : diamonds) {
+        diamond.update();
+    }
+    for (auto& lava : lavaPools) {
+        lava.update();
+    }
+}
+
+sf::FloatRect World::nearestPlayerBounds(float x) const {
+    const Player* nearest = &players[0];
+    for (int i = 1; i < playerCount; ++i) {
+        if (std::abs(players[i].position.x - x) < std::abs(nearest->position.x - x))
+            nearest = &players[i];
+    }
+    return nearest->getBounds();
+}
+
+TickResult World::update(const PlayerInput* inputs, int count) {
+    const PlayerInput idle;
+
+    for (int i = 0; i < playerCount; ++i) {
+        movePlayer(players[i], i < count ? inputs[i] : idle);
+
+        if (players[i].position.y > WORLD_HEIGHT + 200.f) {
+            return playerDied();
+        }
+    }
+
+    // Collectables
+    for (auto& diamond : diamonds) {
+        diamond.update();
+        for (int i = 0; i < playerCount && !diamond.collected; ++i) {
+            if (diamond.hits(players[i].getBounds())) {
+                diamond.collected = true;
+                diamondsCollected++;
+                score += 50;
+            }
+        }
+    }
+
+
+
+    // Hammer pickup: just collect it, show in HUD, and allow door use
+    Hammer* levelHammer = hammers.get(hammer);
+    for (int i = 0; i < playerCount; ++i) {
+        Player& player = players[i];
+        if (levelHammer && !levelHammer->collected && player.getBounds().intersects(levelHammer->getBounds())) {
+            levelHammer->collected = true;   // hammer disappears (render checks !collected)
+            player.hasHammer = true;    // HUD now shows "Hammer: YES"
+            score += 75;
+        }
+    }
+
+
+
+    // Enemies: bats near a player chase them through the open air
+    sf::Vector2f targets[MAX_PLAYERS];
+    for (int i = 0; i < playerCount; ++i)
+        targets[i] = centreOf(players[i].getBounds());
+    chaseField.update(nav, targets, playerCount);
+
+    for (auto& enemy : enemies) {
+        sf::Vector2f centre = centreOf(enemy.getBounds());
+        sf::Vector2f steer;
+        int steps = chaseField.distance(centre);
+        if (steps > 0) {
+            steer = chaseField.direction(centre);
+        }
+        else if (steps == 0) {
+            // Same cell: straight at the player
+            sf::Vector2f toward = centreOf(nearestPlayerBounds(centre.x)) - centre;
+            float length = std::sqrt(toward.x * toward.x + toward.y * toward.y);
+            if (length > 0.5f)
+                steer = toward / length;
+        }
+        enemy.update(steer);
+        for (int i = 0; i < playerCount; ++i) {
+            if (enemy.hits(players[i].getBounds())) {
+                return playerDied();
+            }
+        }
+    }
+
+    // Hazards (if you add them later)
+    for (auto& rock : fallingRocks) {
+        sf::FloatRect target = nearestPlayerBounds(rock.position.x);
+        rock.update(target, [&]() {
+            return grid.lineOfSight(rock.position + sf::Vector2f(12.f, 12.f), centreOf(target));
+        });
+        for (int i = 0; i < playerCount; ++i) {
+            if (rock.active && players[i].getBounds().intersects(rock.getBounds())) {
+                return playerDied();
+            }
+        }
+    }
+
+    for (auto& icicle : icicles) {
+        sf::FloatRect target = nearestPlayerBounds(icicle.position.x);
+        icicle.update(target, [&]() {
+            // Looking from the player, the block the icicle hangs from
+            // may be the first thing in the way, but nothing else
+            RayHit hit;
+            return !grid.raycast(centreOf(target), icicle.position + sf::Vector2f(4.f, 30.f), &hit) ||
+                grid.bounds(hit.item).contains(icicle.position + sf::Vector2f(4.f, -1.f));
+        });
+        for (int i = 0; i < playerCount; ++i) {
+            if (icicle.falling && players[i].getBounds().intersects(icicle.getBounds())) {
+                return playerDied();
+            }
+        }
+    }
+
+    for (auto& lava : lavaPools) {
+        lava.update();
+        for (int i = 0; i < playerCount; ++i) {
+            if (players[i].getBounds().intersects(lava.getBounds())) {
+                return playerDied();
+            }
+        }
+    }
+
+    SFML_TRACE_COUNTER("Platforms", platforms.size());
+    SFML_TRACE_COUNTER("Enemies", enemies.size());
+
+    // Exit condition: a player just needs the hammer and to touch the door
+    for (int i = 0; i < playerCount; ++i) {
+        if (players[i].hasHammer &&
+            players[i].getBounds().intersects(exitDoor.getGlobalBounds())) {
+
+            return TICK_LEVEL_COMPLETE;
+        }
+    }
+
+    return TICK_RUNNING;
+}
+
+void World::draw(sf::RenderTarget& target) {
+    // Only what this view shows: with split-screen every view goes
+    // through here, so per-view work must stay proportional to the view
+    const sf::View& view = target.getView();
+    sf::FloatRect visible(view.getCenter() - view.getSize() / 2.f, view.getSize());
+
+    if (platformBatchLoads != levelLoads) {
+        platformBatch.build(platforms);
+        platformBatchLoads = levelLoads;
+    }
+    platformBatch.refresh(platforms, &grid);
+
+    for (auto& lava : lavaPools) {
+        if (visible.intersects(lava.getBounds()))
+            target.draw(lava.shape);
+    }
+
+    platformBatch.draw(target, visible);
+
+    for (auto& diamond : diamonds) {
+        if (visible.intersects(diamond.getBounds()))
+            diamond.draw(target);
+    }
+
+    Hammer* levelHammer = hammers.get(hammer);
+    if (levelHammer && !levelHammer->collected) {
+        levelHammer->draw(target);
+    }
+
+    // Exit door
+    target.draw(exitDoor);
+
+    for (auto& rock : fallingRocks) {
+        if ((rock.active || rock.resetTimer > 0) && visible.intersects(rock.getBounds())) {
+            target.draw(rock.shape);
+        }
+    }
+
+    for (auto& icicle : icicles) {
+        if (visible.intersects(icicle.getBounds()))
+            target.draw(icicle.shape);
+    }
+
+    for (auto& enemy : enemies) {
+        if (visible.intersects(enemy.getBounds()))
+            enemy.draw(target);
+    }
+
+    for (int i = 0; i < playerCount; ++i) {
+        players[i].draw(target);
+    }
+}
+
+void World::buildCommonLevelLayout() {
+    clearLevel();
+
+    // Different fallback colours for backgrounds if texture fails
+    if (currentLevel == 2) {
+        bgColor = sf::Color(10, 20, 40);   // colder for ice level
+    }
+    else {
+        bgColor = sf::Color(20, 10, 30);   // deep cave purple
+    }
+    friction = 0.85f;
+
+    float blockSize = 32.f;
+
+    // Helper: place a 32×32 block on a grid (uses ice texture on level 2)
+    auto addBlock = [&](int gx, int gy, sf::Color color = sf::Color(60, 40, 40)) {
+        float x = gx * blockSize;
+        float y = gy * blockSize;
+
+        if (currentLevel == 2 && textures.iceBlock) {
+            platforms.create(x, y, blockSize, blockSize, textures.iceBlock);
+        }
+        else {
+            platforms.create(x, y, blockSize, blockSize, color);
+        }
+        };
+
+    // Helper: main platforms at arbitrary world positions
+    auto addMainPlatform = [&](float x, float y, sf::Color color = sf::Color(90, 70, 70)) {
+        if (currentLevel == 2 && textures.iceBlock) {
+            platforms.create(x, y, blockSize, blockSize, textures.iceBlock);
+        }
+        else {
+            platforms.create(x, y, blockSize, blockSize, color);
+        }
+        };
+
+    // Helper: path tiles, with optional vertical offset in tiles (for harder paths)
+    auto addPathTile = [&](int gx, int heightOffset, sf::Color color = sf::Color(80, 55, 55)) {
+        float basePathY = GROUND_Y - blockSize;    // default path height
+        float x = gx * blockSize;
+        float y = basePathY - heightOffset * blockSize;
+
+        if (currentLevel == 2 && textures.iceBlock) {
+            platforms.create(x, y, blockSize, blockSize, textures.iceBlock);
+        }
+        else {
+            platforms.create(x, y, blockSize, blockSize, color);
+        }
+        };
+
+    // Helper: icicle that is visually attached under an ice block
+    auto addIcicleWithBlock = [&](int gx, int gy) {
+        // Make sure there is an ice block here
+        addBlock(gx, gy);
+
+        // Icicle hangs from the bottom centre of that block
+        float x = gx * blockSize + (blockSize / 2.f) - 4.f; // 8px wide base => offset by 4
+        float y = (gy + 1) * blockSize;                     // just under the block
+        icicles.create(x, y);
+        };
+
+
+
+    // --- Ground: continuous strip of small square blocks ---
+    for (int gx = 0; gx < static_cast<int>(WORLD_WIDTH / blockSize); ++gx) {
+        float x = gx * blockSize;
+
+        if (currentLevel == 2 && textures.iceBlock) {
+            platforms.create(x, GROUND_Y, blockSize, blockSize, textures.iceBlock);
+        }
+        else {
+            platforms.create(x, GROUND_Y, blockSize, blockSize, sf::Color(60, 40, 40));
+        }
+    }
+
+
+    const sf::Texture* diamondTexToUse =
+        (currentLevel == 2 && (textures.diamond2 || textures.diamond2Mask)) ? textures.diamond2 : textures.diamond;
+    const CollisionMask* diamondMaskToUse =
+        (currentLevel == 2 && (textures.diamond2 || textures.diamond2Mask)) ? textures.diamond2Mask : textures.diamondMask;
+
+    // ----------------------------------------------------
+    // DECORATIVE CAVE CEILING (top of screen)
+    // ----------------------------------------------------
+    {
+        sf::Color ceilingColor1(45, 30, 60);
+        sf::Color ceilingColor2(55, 35, 70);
+
+        // Row 0 (very top)
+        for (int gx = 0; gx < static_cast<int>(WORLD_WIDTH / blockSize); ++gx) {
+            addBlock(gx, 0, ceilingColor1);
+        }
+
+        // Row 1 (just under the top, with some gaps for variety)
+        for (int gx = 0; gx < static_cast<int>(WORLD_WIDTH / blockSize); ++gx) {
+            if (gx % 4 == 1) continue;   // gaps for rocky look
+            addBlock(gx, 1, ceilingColor2);
+        }
+    }
+
+    // Two main platform heights (easy to reach)
+    float h1 = GROUND_Y - 60.f;   // low platforms
+    float h2 = GROUND_Y - 120.f;  // slightly higher
+    float h3 = GROUND_Y - 180.f;  // optional higher
+
+    // ----------------------------------------------------
+// CAVE PATH / PLATFORMS (different layouts per level)
+// ----------------------------------------------------
+    sf::Color pathColor(80, 55, 55);
+
+    if (currentLevel == 1) {
+        // Original stepped mid path
+        for (int gx = 1; gx <= 6; ++gx)  addBlock(gx, 16, pathColor);
+        for (int gx = 7; gx <= 12; ++gx) addBlock(gx, 15, pathColor);
+        for (int gx = 13; gx <= 18; ++gx) addBlock(gx, 14, pathColor);
+        for (int gx = 19; gx <= 22; ++gx) addBlock(gx, 15, pathColor);
+        for (int gx = 23; gx <= 26; ++gx) addBlock(gx, 16, pathColor);
+
+        // Middle platforms
+        addMainPlatform(1080.f, h1);
+        addMainPlatform(1230.f, h2);
+
+        // Right platforms
+        addMainPlatform(1564.f, h2);
+        addMainPlatform(1740.f, h1);
+        addMainPlatform(1900.f, h2);
+        addMainPlatform(2060.f, h1);
+
+        // High bonus
+        addMainPlatform(700.f, h3, sf::Color(110, 80, 90));
+        addMainPlatform(1600.f, h3, sf::Color(110, 80, 90));
+    }
+    else if (currentLevel == 2) {
+        // LEVEL 2: different, trickier ice layout
+
+        // Left: small staggered steps
+        addMainPlatform(400.f, h1);     // low
+        addMainPlatform(520.f, h2);     // higher
+        addMainPlatform(640.f, h1);     // back down
+
+        // Mid: vertical challenge
+        addMainPlatform(950.f, h2);
+        addMainPlatform(1030.f, h3);    // quite high
+        addMainPlatform(1150.f, h2);
+
+        // Right: spaced platforms toward the door
+        addMainPlatform(1500.f, h2);
+        addMainPlatform(1650.f, h3);
+        addMainPlatform(1820.f, h2);
+        addMainPlatform(1980.f, h1);
+
+        // One high bonus ledge (different from level 1)
+        addMainPlatform(1350.f, h3, sf::Color(110, 80, 90));
+    }
+
+
+    // -----------------------------------------------------------------
+    // Extra decorative blocks (do NOT block main path)
+    // -----------------------------------------------------------------
+    for (int c = 0; c < 25; ++c) addBlock(c, 0);
+    for (int c = 3; c <= 7; ++c) addBlock(c, 1);
+    for (int c = 12; c <= 17; ++c) addBlock(c, 1);
+    for (int c = 20; c <= 23; ++c) addBlock(c, 1);
+
+    // Stalactites (will be more "icy" on level 2 thanks to ice texture)
+    addBlock(5, 2); addBlock(5, 3);
+    addBlock(14, 2); addBlock(14, 3);
+    addBlock(21, 2); addBlock(21, 3);
+
+    for (int c = 25; c < 50; ++c) addBlock(c, 0);
+    for (int c = 28; c <= 32; ++c) addBlock(c, 1);
+    for (int c = 40; c <= 44; ++c) addBlock(c, 1);
+
+    for (int c = 10; c <= 13; ++c) addBlock(c, 8);
+    for (int c = 35; c <= 38; ++c) addBlock(c, 9);
+
+    // ----------------------------------------------------
+// BOTTOM PATH (walkway towards the door)
+// - Level 1: continuous, easy
+// - Level 2: stepped, with small gaps & height changes (harder)
+// ----------------------------------------------------
+    {
+        if (currentLevel == 1) {
+            float pathY = GROUND_Y - blockSize;
+            float pathEndX = WORLD_WIDTH - blockSize;
+            for (float x = 0.f; x <= pathEndX; x += blockSize) {
+                // normal rock path
+                platforms.create(
+                    x, pathY,
+                    blockSize, blockSize,
+                    pathColor
+                );
+            }
+        }
+        else if (currentLevel == 2) {
+            // Use grid columns and height offsets for a trickier path
+
+            // Segment 1: start flat
+            for (int gx = 0; gx <= 8; ++gx) {
+                addPathTile(gx, 0);
+            }
+
+            // Segment 2: one tile higher
+            for (int gx = 9; gx <= 13; ++gx) {
+                addPathTile(gx, 1);
+            }
+
+            // Small gap at 14 (no tile)
+
+            // Segment 3: back to base height
+            for (int gx = 15; gx <= 20; ++gx) {
+                addPathTile(gx, 0);
+            }
+
+            // Segment 4: two tiles higher (harder jump section)
+            for (int gx = 21; gx <= 24; ++gx) {
+                addPathTile(gx, 2);
+            }
+
+            // Gap at 25
+
+            // Segment 5: slightly raised
+            for (int gx = 26; gx <= 32; ++gx) {
+                addPathTile(gx, 1);
+            }
+
+            // Final run toward door at base height
+            for (int gx = 33; gx <= 70; ++gx) {
+                addPathTile(gx, 0);
+            }
+        }
+    }   // <-- END OF PATH SECTION
+
+    // --------------------------------------------------
+    // EXTRA END-OF-LEVEL ICE FIX (fills last columns)
+    // --------------------------------------------------
+    if (currentLevel == 2 && textures.iceBlock) {
+        float yPath = GROUND_Y - blockSize;  // path height
+        float yGround = GROUND_Y;              // true ground
+
+        // Cover the last 3 columns with ice on BOTH rows
+        for (int i = 1; i <= 3; ++i) {
+            float x = WORLD_WIDTH - i * blockSize;
+
+            // path row
+            platforms.create(x, yPath, blockSize, blockSize, textures.iceBlock);
+            // ground row
+            platforms.create(x, yGround, blockSize, blockSize, textures.iceBlock);
+        }
+    }
+
+
+
+    // ----------------------------------------------------
+    // RIGHT-HAND CAVE WALL (ceiling-to-floor at level end)
+    // ----------------------------------------------------
+    {
+        int wallCol = static_cast<int>((WORLD_WIDTH - 32.f) / 32.f); // 74
+        sf::Color wallColor(60, 40, 40);
+
+        for (int gy = 0; gy <= 16; ++gy) {
+            addBlock(wallCol, gy, wallColor);
+        }
+    }
+
+
+    // ---------------- DIAMONDS (same layout, different texture on L2) ---------------
+    diamonds.create(320.f + 4.f, h2 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(600.f + 4.f, h2 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(930.f + 4.f, h2 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(1230.f + 4.f, h2 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(1420.f + 4.f, h1 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(1580.f + 4.f, h2 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(1900.f + 4.f, h2 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(2060.f + 4.f, h1 - 40.f, diamondTexToUse, diamondMaskToUse);
+
+    // Bonus diamonds
+    diamonds.create(700.f + 4.f, h3 - 40.f, diamondTexToUse, diamondMaskToUse);
+    diamonds.create(1600.f + 4.f, h3 - 40.f, diamondTexToUse, diamondMaskToUse);
+
+    // ---------------- ENEMIES: Level 2 = more + faster ----------------
+    if (currentLevel == 1) {
+        enemies.create(550.f, h2 - 40.f, 1.0f, 480.f, 720.f, textures.bats, textures.batMasks);
+        enemies.create(1150.f, h2 - 40.f, 1.2f, 1080.f, 1350.f, textures.bats, textures.batMasks);
+        enemies.create(1850.f, h2 - 80.f, 1.0f, 1780.f, 2100.f, textures.bats, textures.batMasks);
+    }
+    else if (currentLevel == 2) {
+        // Left section bat, patrolling above the staggered platforms
+        enemies.create(520.f, h2 - 50.f, 1.5f, 380.f, 680.f, textures.bats, textures.batMasks);
+
+        // Mid vertical challenge bat over the high platform
+        enemies.create(1030.f, h3 - 50.f, 1.6f, 940.f, 1180.f, textures.bats, textures.batMasks);
+
+        // Right section bats over the last platforms
+        enemies.create(1600.f, h2 - 40.f, 1.7f, 1480.f, 1760.f, textures.bats, textures.batMasks);
+        enemies.create(1900.f, h2 - 60.f, 1.8f, 1820.f, 2140.f, textures.bats, textures.batMasks);
+    }
+
+    // ---------------- ICICLES: more, and all attached to ice blocks ----
+    if (currentLevel == 2) {
+        // These coordinates are grid-based (gx, gy)
+        addIcicleWithBlock(6, 2);
+        addIcicleWithBlock(12, 3);
+        addIcicleWithBlock(18, 3);
+        addIcicleWithBlock(24, 2);
+        addIcicleWithBlock(30, 3);
+        addIcicleWithBlock(36, 3);
+        addIcicleWithBlock(42, 2);
+    }
+
+    // ---------------- HAMMER POSITION: higher on Level 2 ---------------
+    float hammerX, hammerY;
+    if (currentLevel == 2) {
+        // Put hammer on a high platform so player MUST do trickier jumps
+        hammerX = 1600.f;
+        hammerY = h3 - 30.f;
+    }
+    else {
+        hammerX = 1100.f;
+        hammerY = h2 - 30.f;
+    }
+
+    hammer = hammers.create(hammerX, hammerY, textures.axe, textures.axeMask);
+
+    // ---------------- EXIT DOOR at far right --------------------------
+    float doorX = WORLD_WIDTH - 72.f;                 // right next to the wall
+    float doorY = (GROUND_Y - 70.f) - 32.f;           // sits level with the path
+
+    boulder = Pool<Boulder>::Handle();  // no boulder now
+
+    placeExitDoor(doorX, doorY);
+
+    // ----------------------------------------------------
+// LEVEL 3: special layout – blocks only top & bottom
+// ----------------------------------------------------
+    if (currentLevel == 3) {
+        // Remove whatever platforms were added earlier
+        platforms.clear();
+
+        float blockSize = 32.f;
+        int cols = static_cast<int>(WORLD_WIDTH / blockSize);
+        int groundRow = static_cast<int>(GROUND_Y / blockSize);
+
+        auto addColumnBlock = [&](int gx, int gy) {
+            float x = gx * blockSize;
+            float y = gy * blockSize;
+
+            if (textures.seaweed) {
+                platforms.create(x, y, blockSize, blockSize, textures.seaweed);
+            }
+            else {
+                platforms.create(x, y, blockSize, blockSize, sf::Color(60, 40, 40));
+            }
+            };
+
+        // --------- Bottom "seaweed floor" varying heights ----------
+        for (int gx = 0; gx < cols; ++gx) {
+            int heightBlocks;
+
+            // pattern of heights: 4,3,2,1,3,2,1,...
+            switch (gx % 7) {
+            case 0:
+            case 1: heightBlocks = 4; break;
+            case 2:
+            case 3: heightBlocks = 3; break;
+            case 4:
+            case 5: heightBlocks = 2; break;
+            default: heightBlocks = 1; break;
+            }
+
+            for (int i = 0; i < heightBlocks; ++i) {
+                int gy = groundRow - i;
+                addColumnBlock(gx, gy);
+            }
+        }
+
+        // --------- Top "seaweed ceiling" varying heights ----------
+        for (int gx = 0; gx < cols; ++gx) {
+            int heightBlocks;
+
+            // different pattern so top ≠ bottom
+            if (gx % 5 == 0 || gx % 5 == 3)
+                heightBlocks = 3;
+            else
+                heightBlocks = 2;
+
+            for (int gy = 0; gy < heightBlocks; ++gy) {
+                addColumnBlock(gx, gy);
+            }
+        }
+    }
+
+    indexLevel();
+
+    placePlayersAtStart();
+}
+
+void World::placeExitDoor(float x, float y) {
+    float doorWidth = 40.f;
+    float doorHeight = 70.f;
+
+    if (textures.door) {
+        exitDoor.setSize(sf::Vector2f(doorWidth, doorHeight));
+        exitDoor.setTexture(textures.door);
+        exitDoor.setTextureRect(sf::IntRect(
+            0, 0,
+            textures.door->getSize().x,
+            textures.door->getSize().y
+        ));
+    }
+    else {
+        exitDoor.setSize(sf::Vector2f(doorWidth, doorHeight));
+        exitDoor.setFillColor(sf::Color(255, 215, 0));
+    }
+    exitDoor.setPosition(x, y);
+}
+
+void World::placePlayersAtStart() {
+    // Players start at far left, slightly above ground
+    for (int i = 0; i < playerCount; ++i) {
+        players[i].reset(50.f + i * 40.f, GROUND_Y - 60.f);
+    }
+}
+
+Pool<Platform>::Handle World::createBlock(const sf::FloatRect& rect, BlockMaterial material, sf::Color color,
+    bool breakable) {
+    const sf::Texture* texture = nullptr;
+    if (material == BLOCK_ICE)
+        texture = textures.iceBlock;
+    else if (material == BLOCK_SEAWEED)
+        texture = textures.seaweed;
+
+    if (texture)
+        return platforms.create(rect.left, rect.top, rect.width, rect.height, texture, breakable);
+    return platforms.create(rect.left, rect.top, rect.width, rect.height, color, breakable);
+}
+
+Pool<Diamond>::Handle World::createDiamond(float x, float y) {
+    if (currentLevel == 2 && (textures.diamond2 || textures.diamond2Mask))
+        return diamonds.create(x, y, textures.diamond2, textures.diamond2Mask);
+    return diamonds.create(x, y, textures.diamond, textures.diamondMask);
+}
+
+std::string World::levelFileName(int level) {
+    return "level" + std::to_string(level) + ".txt";
+}
+
+bool World::loadLevelFile(const std::string& filename) {
+    levelError.clear();
+    std::ifstream in(filename.c_str());
+    if (!in)
+        return false;
+    return loadLevelText(in);
+}
+
+bool World::loadLevelText(std::istream& in) {
+    clearLevel();
+    bgColor = sf::Color(20, 10, 30);
+    friction = 0.85f;
+    placeExitDoor(WORLD_WIDTH - 72.f, (GROUND_Y - 70.f) - 32.f);
+    levelError.clear();
+
+    // A full pool fails the load too, rather than silently dropping
+    // part of the level
+    auto created = [this](bool isNull, const char* kind) {
+        if (isNull)
+            levelError = std::string("more ") + kind + " than the level pools hold";
+        return !isNull;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && std::getline(in, line)) {
+        lineNumber++;
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> kind))
+            continue;   // blank line
+
+        float x, y;
+        if (kind == "background") {
+            int r, g, b;
+            ok = static_cast<bool>(fields >> r >> g >> b);
+            bgColor = sf::Color(static_cast<sf::Uint8>(r), static_cast<sf::Uint8>(g), static_cast<sf::Uint8>(b));
+        }
+        else if (kind == "friction") {
+            ok = static_cast<bool>(fields >> friction);
+        }
+        else if (kind == "block") {
+            float w, h;
+            std::string material;
+            int r = 60, g = 40, b = 40;
+            ok = static_cast<bool>(fields >> x >> y >> w >> h >> material);
+            BlockMaterial blockMaterial = BLOCK_ROCK;
+            if (material == "ice")
+                blockMaterial = BLOCK_ICE;
+            else if (material == "seaweed")
+                blockMaterial = BLOCK_SEAWEED;
+            else if (material == "rock")
+                ok = ok && static_cast<bool>(fields >> r >> g >> b);
+            else
+                ok = false;
+
+            std::string flag;
+            bool breakable = static_cast<bool>(fields >> flag) && flag == "breakable";
+            if (ok) {
+                ok = created(createBlock(sf::FloatRect(x, y, w, h), blockMaterial,
+                    sf::Color(static_cast<sf::Uint8>(r), static_cast<sf::Uint8>(g), static_cast<sf::Uint8>(b)),
+                    breakable).isNull(), "blocks");
+            }
+        }
+        else if (kind == "diamond") {
+            ok = static_cast<bool>(fields >> x >> y);
+            if (ok) ok = created(createDiamond(x, y).isNull(), "diamonds");
+        }
+        else if (kind == "bat") {
+            float speed, minX, maxX;
+            ok = static_cast<bool>(fields >> x >> y >> speed >> minX >> maxX);
+            if (ok) ok = created(enemies.create(x, y, speed, minX, maxX, textures.bats, textures.batMasks).isNull(), "bats");
+        }
+        else if (kind == "icicle") {
+            ok = static_cast<bool>(fields >> x >> y);
+            if (ok) ok = created(icicles.create(x, y).isNull(), "icicles");
+        }
+        else if (kind == "rock") {
+            ok = static_cast<bool>(fields >> x >> y);
+            if (ok) ok = created(fallingRocks.create(x, y).isNull(), "rocks");
+        }
+        else if (kind == "lava") {
+            float width;
+            ok = static_cast<bool>(fields >> x >> y >> width);
+            if (ok) ok = created(lavaPools.create(x, y, width).isNull(), "lava pools");
+        }
+        else if (kind == "hammer") {
+            ok = static_cast<bool>(fields >> x >> y);
+            if (ok) {
+                hammers.clear();
+                hammer = hammers.create(x, y, textures.axe, textures.axeMask);
+            }
+        }
+        else if (kind == "door") {
+            ok = static_cast<bool>(fields >> x >> y);
+            if (ok) placeExitDoor(x, y);
+        }
+        else {
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        if (levelError.empty())
+            levelError = "line " + std::to_string(lineNumber) + " is malformed";
+        clearLevel();
+    }
+
+    indexLevel();
+    placePlayersAtStart();
+    return ok;
+}
+
+bool World::saveLevelFile(const std::string& filename) const {
+    std::ofstream out(filename.c_str());
+    if (!out)
+        return false;
+
+    out << "# EscapeOreo level " << currentLevel << "\n";
+    out << "background " << int(bgColor.r) << ' ' << int(bgColor.g) << ' ' << int(bgColor.b) << "\n";
+    out << "friction " << friction << "\n";
+
+    for (const Platform& p : platforms) {
+        sf::Vector2f position = p.shape.getPosition();
+        sf::Vector2f size = p.shape.getSize();
+        out << "block " << position.x << ' ' << position.y << ' ' << size.x << ' ' << size.y << ' ';
+        if (p.texture && p.texture == textures.iceBlock) {
+            out << "ice";
+        }
+        else if (p.texture && p.texture == textures.seaweed) {
+            out << "seaweed";
+        }
+        else {
+            sf::Color color = p.shape.getFillColor();
+            out << "rock " << int(color.r) << ' ' << int(color.g) << ' ' << int(color.b);
+        }
+        out << (p.breakable ? " breakable\n" : "\n");
+    }
+
+    for (const Diamond& d : diamonds)
+        out << "diamond " << d.basePos.x << ' ' << d.basePos.y << "\n";
+    for (const Enemy& e : enemies)
+        out << "bat " << e.home.x << ' ' << e.home.y << ' ' << e.speed << ' ' << e.minX << ' ' << e.maxX << "\n";
+    for (const Icicle& i : icicles)
+        out << "icicle " << i.position.x << ' ' << i.startY << "\n";
+    for (const FallingRock& r : fallingRocks)
+        out << "rock " << r.position.x << ' ' << r.startY << "\n";
+    for (const LavaPool& l : lavaPools)
+        out << "lava " << l.position.x << ' ' << l.position.y << ' ' << l.shape.getSize().x << "\n";
+
+    const Hammer* levelHammer = hammers.get(hammer);
+    if (levelHammer)
+        out << "hammer " << levelHammer->position.x << ' ' << levelHammer->position.y << "\n";
+    out << "door " << exitDoor.getPosition().x << ' ' << exitDoor.getPosition().y << "\n";
+
+    return static_cast<bool>(out);
+}
+
+void World::clearTile(sf::Vector2i tile) {
+    const float size = static_cast<float>(TileGrid::CellSize);
+    sf::Vector2f centre((tile.x + 0.5f) * size, (tile.y + 0.5f) * size);
+
+    // Collect first: removing from the grid while visiting it would
+    // reshuffle the cells being walked
+    const int MaxFound = 16;
+    int found[MaxFound];
+    int count = 0;
+    grid.forEachInBox(sf::FloatRect(centre.x - 1.f, centre.y - 1.f, 2.f, 2.f), [&](int item) {
+        if (count < MaxFound)
+            found[count++] = item;
+    });
+    if (count == 0)
+        return;
+
+    sf::FloatRect changed = grid.bounds(found[0]);
+    for (int i = 0; i < count; ++i) {
+        const sf::FloatRect& box = grid.bounds(found[i]);
+        float right = std::max(changed.left + changed.width, box.left + box.width);
+        float bottom = std::max(changed.top + changed.height, box.top + box.height);
+        changed.left = std::min(changed.left, box.left);
+        changed.top = std::min(changed.top, box.top);
+        changed.width = right - changed.left;
+        changed.height = bottom - changed.top;
+
+        Platform& platform = grid.platform(found[i]);
+        if (!platformBatch.invalidate(platform))
+            platformBatchLoads = -1;
+        grid.remove(found[i]);
+        platforms.destroy(platforms.handleOf(&platform));
+    }
+
+    nav.update(grid, changed);
+    levelEdits++;
+}
+
+bool World::paintTile(sf::Vector2i tile, BlockMaterial material, sf::Color color) {
+    // Clearing first frees the slots of the blocks being replaced, so a
+    // full pool only refuses tiles that had no block
+    clearTile(tile);
+
+    const float size = static_cast<float>(TileGrid::CellSize);
+    Platform* block = platforms.get(createBlock(sf::FloatRect(tile.x * size, tile.y * size, size, size),
+        material, color));
+    if (!block)
+        return false;   // pool full
+
+    levelEdits++;
+    if (!grid.insert(*block)) {
+        // Outside the indexed area, or its cells are full: index again
+        indexLevel();
+        platformBatchLoads = -1;
+        return true;
+    }
+    if (!platformBatch.invalidate(*block))
+        platformBatchLoads = -1;
+
+    nav.update(grid, block->shape.getGlobalBounds());
+    return true;
+}
+
+bool World::placeEntity(EntityKind kind, sf::Vector2f position) {
+    bool placed = true;
+    switch (kind) {
+    case ENTITY_DIAMOND:
+        placed = !createDiamond(position.x, position.y).isNull();
+        break;
+    case ENTITY_BAT:
+        placed = !enemies.create(position.x, position.y, 1.2f, position.x - 120.f, position.x + 120.f,
+            textures.bats, textures.batMasks).isNull();
+        break;
+    case ENTITY_ICICLE:
+        placed = !icicles.create(position.x, position.y).isNull();
+        break;
+    case ENTITY_LAVA:
+        placed = !lavaPools.create(position.x, position.y, 64.f).isNull();
+        break;
+    case ENTITY_HAMMER:
+        hammers.clear();
+        hammer = hammers.create(position.x, position.y, textures.axe, textures.axeMask);
+        break;
+    case ENTITY_DOOR:
+        placeExitDoor(position.x, position.y);
+        break;
+    }
+
+    if (placed)
+        levelEdits++;
+    return placed;
+}
+
+bool World::eraseEntity(sf::Vector2f point) {
+    if (eraseAt(diamonds, point) || eraseAt(enemies, point) || eraseAt(icicles, point) ||
+        eraseAt(fallingRocks, point) || eraseAt(lavaPools, point)) {
+        levelEdits++;
+        return true;
+    }
+
+    Hammer* levelHammer = hammers.get(hammer);
+    if (levelHammer && levelHammer->getBounds().contains(point)) {
+        hammers.destroy(hammer);
+        hammer = Pool<Hammer>::Handle();
+        levelEdits++;
+        return true;
+    }
+    return false;
+}
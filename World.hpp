@@ -0,0 +1,252 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "Entities.hpp"
+#include "NavGraph.hpp"
+#include "PlatformBatch.hpp"
+#include "Pool.hpp"
+#include "TileGrid.hpp"
+
+// ------------------------------------------------------------------
+// World: the level being played and its simulation
+//
+// Holds the player and the level entities, builds the levels and
+// advances them one tick at a time. It owns no window and no texture
+// (only pointers to Game's), so it also runs headless, e.g. in the
+// EscapeOreoBench benchmarks.
+// ------------------------------------------------------------------
+
+// World constants for scrolling
+const float WORLD_WIDTH = 2400.f;
+const float WORLD_HEIGHT = 600.f;
+const float GROUND_Y = 568.f;   // 600 - 32
+const float GRAVITY = 0.5f;
+
+// Pool capacities: the most of each entity a level can hold (the
+// biggest level has ~430 blocks). The storage for all of them is
+// allocated once, when the World is created.
+const std::size_t MAX_PLATFORMS = 512;
+const std::size_t MAX_DIAMONDS = 64;
+const std::size_t MAX_ENEMIES = 32;
+const std::size_t MAX_FALLING_ROCKS = 32;
+const std::size_t MAX_ICICLES = 64;
+const std::size_t MAX_LAVA_POOLS = 32;
+
+// Local co-op: players sharing the level (and the lives)
+const int MAX_PLAYERS = 4;
+
+// Bats leave their patrol to chase a player this many cells (32 px)
+// of open air away or closer
+const int BAT_CHASE_RADIUS = 6;
+
+// What the player asks for this tick (keyboard, script, network...)
+struct PlayerInput {
+    bool left = false;
+    bool right = false;
+    bool jump = false;
+};
+
+// Textures handed to the entities when a level is built. Any of them
+// may be null (file missing, headless run): entities then fall back
+// to plain shapes, sized after their mask when there is one (see
+// Entities.hpp).
+struct LevelTextures {
+    const sf::Texture* iceBlock = nullptr;
+    const sf::Texture* seaweed = nullptr;
+    const sf::Texture* diamond = nullptr;
+    const sf::Texture* diamond2 = nullptr;     // level 2 diamonds
+    const sf::Texture* axe = nullptr;
+    const sf::Texture* door = nullptr;
+    const std::vector<sf::Texture>* bats = nullptr;
+
+    // Pixel collision masks of some of them (see CollisionMask.hpp)
+    const CollisionMask* diamondMask = nullptr;
+    const CollisionMask* diamond2Mask = nullptr;
+    const std::vector<CollisionMask>* batMasks = nullptr;
+    const CollisionMask* axeMask = nullptr;    // only sizes the hammer (picked up by its box)
+};
+
+// What a block is made of (level files, level editor). Textured ones
+// fall back to the block's colour when the texture is missing.
+enum BlockMaterial {
+    BLOCK_ROCK,        // plain colour
+    BLOCK_ICE,         // iceBlock.png
+    BLOCK_SEAWEED      // seaweed.png
+};
+
+// What the level editor places besides blocks
+enum EntityKind {
+    ENTITY_DIAMOND,
+    ENTITY_BAT,
+    ENTITY_ICICLE,
+    ENTITY_LAVA,
+    ENTITY_HAMMER,     // moves the level's hammer
+    ENTITY_DOOR        // moves the exit door
+};
+
+// Outcome of one World::update()
+enum TickResult {
+    TICK_RUNNING,          // keep playing (a lost life restarts the level)
+    TICK_GAME_OVER,        // last life lost
+    TICK_LEVEL_COMPLETE    // player reached the door with the hammer
+};
+
+class World {
+public:
+    // Pools hold capacityScale times the MAX_* entities (benchmarks
+    // build levels bigger than the real ones)
+    explicit World(std::size_t capacityScale = 1);
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    void setTextures(const LevelTextures& levelTextures) { textures = levelTextures; }
+
+    // Number of players (1 to MAX_PLAYERS), used from the next level load
+    void setPlayerCount(int count);
+
+    // Reset lives, score and diamonds and build level 1
+    void newGame();
+
+    // (Re)build a level from scratch; the pools are emptied, not freed
+    void loadLevel(int level);
+
+    // Destroy every entity of the current level
+    void clearLevel();
+
+    // Benchmarks: build the built-in layout of a level (level files are
+    // ignored), then repeat it `copies` times side by side (as far as the
+    // pools allow)
+    void buildSyntheticLevel(int level, int copies);
+
+    // Advance the simulation by one tick; inputs[i] drives players[i],
+    // players past `count` stand still
+    TickResult update(const PlayerInput* inputs, int count);
+
+    // Single player shorthand
+    TickResult update(const PlayerInput& input) { return update(&input, 1); }
+
+    // Network clients (see Netplay.hpp): move one player the way update()
+    // would, for prediction; the rest of the state comes from the server
+    void movePlayer(int index, const PlayerInput& input) { movePlayer(players[index], input); }
+
+    // Network clients: run the purely visual animations (diamond bob,
+    // lava colour) that snapshots do not carry
+    void animate();
+
+    // Draw what the target's current view shows of the level and the
+    // players (not the background). Called once per split-screen view.
+    void draw(sf::RenderTarget& target);
+
+    // --- Level files ---
+    // Plain text, one thing per line, '#' starts a comment; positions
+    // are the entities' top-left corners in world pixels:
+    //   background <r> <g> <b>
+    //   friction <f>
+    //   block <x> <y> <w> <h> rock <r> <g> <b> [breakable]
+    //   block <x> <y> <w> <h> ice|seaweed [breakable]
+    //   diamond <x> <y>
+    //   bat <x> <y> <speed> <minX> <maxX>
+    //   icicle <x> <y>
+    //   rock <x> <y>
+    //   lava <x> <y> <width>
+    //   hammer <x> <y>
+    //   door <x> <y>
+    // A level with a file (level<N>.txt next to the ghost runs, written
+    // by the level editor) is loaded from it; the others are built by
+    // the code.
+
+    static std::string levelFileName(int level);
+
+    // Replace the level with a file's; false if it cannot be read, is
+    // malformed or has more entities than the pools hold (the level is
+    // then left empty and levelError says what went wrong)
+    bool loadLevelFile(const std::string& filename);
+
+    // Same from level text already read (hot reload, see HotReload.hpp)
+    bool loadLevelText(std::istream& in);
+
+    bool saveLevelFile(const std::string& filename) const;
+
+    // --- Level editor (see LevelEditor.hpp) ---
+    // Put a 32 px block on a tile, replacing the platforms covering its
+    // centre, or only remove those. Just the block's batch chunk and
+    // grid cells are rebuilt, whatever the size of the level. False when
+    // the platform pool is full (the tile is then left as it was).
+    bool paintTile(sf::Vector2i tile, BlockMaterial material, sf::Color color);
+    void clearTile(sf::Vector2i tile);
+
+    // Place an entity at a point (false if its pool is full), or remove
+    // the one under it (false if there is none)
+    bool placeEntity(EntityKind kind, sf::Vector2f position);
+    bool eraseEntity(sf::Vector2f point);
+
+    // MAX_PLAYERS players, the first playerCount of them in the game
+    std::vector<Player> players;
+    int playerCount;
+
+    // Level entities live in fixed pools, emptied (not freed) by every
+    // level load, so playing never allocates for them
+    Pool<Platform> platforms;
+    Pool<Diamond> diamonds;
+    Pool<Enemy> enemies;
+    Pool<FallingRock> fallingRocks;
+    Pool<Icicle> icicles;
+    Pool<LavaPool> lavaPools;
+    Pool<Hammer> hammers;
+    Pool<Boulder> boulders;
+    Pool<Hammer>::Handle hammer;     // null or stale = no hammer in this level
+    Pool<Boulder>::Handle boulder;
+    sf::RectangleShape exitDoor;
+
+    int currentLevel;
+    int lives;
+    int diamondsCollected;
+    int score;
+    int levelLoads;                  // level (re)builds so far
+    int levelEdits;                  // editor changes to the level so far (what is baked from
+                                     // the level, like the minimap, follows both counters)
+    std::string levelError;          // why the last level file failed to load
+
+    sf::Color bgColor;               // fallback background colour of the level
+    float friction;
+
+    // Spatial index of the platforms and the navigation graphs built
+    // from it, rebuilt with every level
+    TileGrid grid;
+    NavGraph nav;
+
+    // Distances to the nearest player, followed by the bats
+    FlowField chaseField;
+
+private:
+    void buildCommonLevelLayout();
+
+    Pool<Platform>::Handle createBlock(const sf::FloatRect& rect, BlockMaterial material, sf::Color color,
+        bool breakable = false);
+    Pool<Diamond>::Handle createDiamond(float x, float y);    // level 2 has its own texture
+    void placeExitDoor(float x, float y);
+    void placePlayersAtStart();
+
+    // Build grid and nav for the platforms just created
+    void indexLevel();
+
+    // Input, movement and platform collisions of one player
+    void movePlayer(Player& player, const PlayerInput& input);
+
+    // Bounds of the player horizontally closest to x (what traps react to)
+    sf::FloatRect nearestPlayerBounds(float x) const;
+
+    // Lose a life and restart the level, unless it was the last one
+    TickResult playerDied();
+
+    LevelTextures textures;
+
+    PlatformBatch platformBatch;
+    int platformBatchLoads;          // levelLoads the batch was built for
+};
@@ -31,7 +31,10 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Glyph.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/TextureAtlas.hpp>
 #include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/String.hpp>
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -39,7 +42,10 @@
 
 namespace sf
 {
+class Image;
 class InputStream;
+class RenderTarget;
+class Shader;
 
 ////////////////////////////////////////////////////////////
 /// \brief Class for loading and manipulating character fonts
@@ -208,9 +214,13 @@ public:
     /// closer than other characters. Most of the glyphs pairs have a
     /// kerning offset of zero, though.
     ///
+    /// Kerning values are cached per character size, so asking
+    /// for the same pair again is cheap.
+    ///
     /// \param first         Unicode code point of the first character
     /// \param second        Unicode code point of the second character
     /// \param characterSize Reference character size
+    /// \param bold          Retrieve the bold version or the regular one?
     ///
     /// \return Kerning value for \a first and \a second, in pixels
     ///
@@ -273,6 +283,118 @@ public:
     ////////////////////////////////////////////////////////////
     const Texture& getTexture(unsigned int characterSize) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Retrieve a glyph of the font as a signed distance field
+    ///
+    /// Distance field glyphs are rasterized once, at DistanceFieldSize,
+    /// and can be drawn at any size with a shader; sf::Text does it
+    /// when its distance field mode is enabled. The alpha channel
+    /// of their pixels holds the distance to the glyph outline:
+    /// 0.5 on the outline, 1 at DistanceFieldSpread pixels inside
+    /// and 0 at DistanceFieldSpread pixels outside. The texture keeps
+    /// DistanceFieldSpread pixels of field around the texture
+    /// rectangle of each glyph.
+    ///
+    /// The metrics of the glyph are those of DistanceFieldSize:
+    /// multiply them by characterSize / DistanceFieldSize to get
+    /// those of another size.
+    ///
+    /// \param codePoint Unicode code point of the character to get
+    /// \param bold      Retrieve the bold version or the regular one?
+    ///
+    /// \return The glyph corresponding to \a codePoint
+    ///
+    /// \see getDistanceFieldTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& getDistanceFieldGlyph(Uint32 codePoint, bool bold = false) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the kerning offset of two distance field glyphs
+    ///
+    /// Like the metrics of getDistanceFieldGlyph, it is given at
+    /// DistanceFieldSize.
+    ///
+    /// \param first  Unicode code point of the first character
+    /// \param second Unicode code point of the second character
+    /// \param bold   Retrieve the bold version or the regular one?
+    ///
+    /// \return Kerning value for \a first and \a second, in pixels of DistanceFieldSize
+    ///
+    /// \see getDistanceFieldGlyph
+    ///
+    ////////////////////////////////////////////////////////////
+    float getDistanceFieldKerning(Uint32 first, Uint32 second, bool bold = false) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Retrieve the texture containing the loaded distance field glyphs
+    ///
+    /// Like getTexture, its contents change as more glyphs are
+    /// requested. Its smooth filter is always enabled, as
+    /// distance fields rely on it.
+    ///
+    /// \return Texture containing the distance field glyphs
+    ///
+    /// \see getDistanceFieldGlyph
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getDistanceFieldTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterize glyphs in the background, before they are needed
+    ///
+    /// The first time a glyph is requested, it is rasterized and
+    /// added to the texture of its character size, which can take
+    /// a noticeable time for a whole screen of new text. This
+    /// function hands the rasterization of the given glyphs to
+    /// worker threads and returns immediately; the ready glyphs
+    /// are added to their textures together, when the texture or
+    /// a missing glyph is requested (i.e. once per frame when
+    /// drawing texts). A glyph requested before it is ready is
+    /// rasterized right away, as without preloading.
+    ///
+    /// Fonts loaded from a stream cannot be opened again by the
+    /// threads: their glyphs are rasterized before this function
+    /// returns, which still moves the work ahead of the first frame.
+    ///
+    /// \param characters       Characters to rasterize
+    /// \param characterSizes   Character sizes to rasterize them at
+    /// \param bold             Rasterize the bold version or the regular one?
+    /// \param outlineThickness Thickness of outline of the glyphs (0 for the glyphs that fill the text)
+    ///
+    /// \see preloadDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    void preload(const String& characters, const std::vector<unsigned int>& characterSizes, bool bold = false, float outlineThickness = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute distance field glyphs in the background, before they are needed
+    ///
+    /// This is the preload function for the glyphs of
+    /// getDistanceFieldGlyph.
+    ///
+    /// \param characters Characters to rasterize
+    /// \param bold       Rasterize the bold version or the regular one?
+    ///
+    /// \see preload
+    ///
+    ////////////////////////////////////////////////////////////
+    void preloadDistanceField(const String& characters, bool bold = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether preloaded glyphs are still being rasterized
+    ///
+    /// The glyphs that are ready are added to the font first. A
+    /// loading screen can call this function until it returns
+    /// false, so that the next frames don't rasterize anything.
+    ///
+    /// \return True if some preloaded glyphs are not ready yet
+    ///
+    /// \see preload, preloadDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isPreloading() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Enable or disable the smooth filter
     ///
@@ -299,6 +421,25 @@ public:
     ////////////////////////////////////////////////////////////
     bool isSmooth() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Turn the coverage of an image into a distance field
+    ///
+    /// This is the conversion applied to distance field glyphs:
+    /// the alpha channel of \a image, read as the coverage of a
+    /// shape, is replaced by the signed distance to its outline,
+    /// 128 on it, 255 at \a spread pixels inside and 0 at
+    /// \a spread pixels outside. It works on the CPU only, so
+    /// that other shapes can be converted offline and drawn
+    /// like distance field glyphs.
+    ///
+    /// \param image  Image to convert
+    /// \param spread Distance covered by the field on each side of the outline, in pixels
+    ///
+    /// \see getDistanceFieldGlyph
+    ///
+    ////////////////////////////////////////////////////////////
+    static void convertToDistanceField(Image& image, unsigned int spread = DistanceFieldSpread);
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -309,25 +450,60 @@ public:
     ////////////////////////////////////////////////////////////
     Font& operator =(const Font& right);
 
+    ////////////////////////////////////////////////////////////
+    // Static member data
+    ////////////////////////////////////////////////////////////
+    static const unsigned int DistanceFieldSize   = 48; //!< Character size at which distance field glyphs are rasterized
+    static const unsigned int DistanceFieldSpread = 8;  //!< Distance, in pixels of DistanceFieldSize, covered by the field around each glyph
+
 private:
 
+    friend class Text;
+
     ////////////////////////////////////////////////////////////
-    /// \brief Structure defining a row of glyphs
+    /// \brief Pool of threads rasterizing the preloaded glyphs
+    ///
+    /// Implementation is private in the .cpp file.
     ///
     ////////////////////////////////////////////////////////////
-    struct Row
-    {
-        Row(unsigned int rowTop, unsigned int rowHeight) : width(0), top(rowTop), height(rowHeight) {}
-
-        unsigned int width;  //!< Current width of the row
-        unsigned int top;    //!< Y position of the row into the texture
-        unsigned int height; //!< Height of the row
-    };
+    class GlyphLoader;
 
     ////////////////////////////////////////////////////////////
-    // Types
+    /// \brief Hash table mapping 64-bit keys to indices
+    ///
+    /// It uses open addressing with linear probing in flat
+    /// arrays, which is much cheaper to search than a std::map
+    /// for the few hundred keys of a page.
+    ///
     ////////////////////////////////////////////////////////////
-    typedef std::map<Uint64, Glyph> GlyphTable; //!< Table mapping a codepoint to its glyph
+    struct IndexTable
+    {
+        IndexTable();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Find the index stored for a key
+        ///
+        /// \param key   Key to search
+        /// \param index Receives the index of \a key, if found
+        ///
+        /// \return True if \a key is in the table
+        ///
+        ////////////////////////////////////////////////////////////
+        bool find(Uint64 key, Uint32& index) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Store the index of a key that is not in the table yet
+        ///
+        /// \param key   Key to add
+        /// \param index Index to store for \a key
+        ///
+        ////////////////////////////////////////////////////////////
+        void insert(Uint64 key, Uint32 index);
+
+        std::vector<Uint64> keys;  //!< Key of each slot
+        std::vector<Uint32> slots; //!< Index + 1 stored in each slot, 0 for an empty slot (the size is a power of two)
+        std::size_t         count; //!< Number of keys in the table
+    };
 
     ////////////////////////////////////////////////////////////
     /// \brief Structure defining a page of glyphs
@@ -337,10 +513,24 @@ private:
     {
         explicit Page(bool smooth);
 
-        GlyphTable       glyphs;  //!< Table mapping code points to their corresponding glyph
-        Texture          texture; //!< Texture containing the pixels of the glyphs
-        unsigned int     nextRow; //!< Y position of the next new row in the texture
-        std::vector<Row> rows;    //!< List containing the position of all the existing rows
+        std::deque<Glyph>   glyphs;           //!< Glyphs of the page, in loading order (a deque keeps them in place as it grows)
+        IndexTable          glyphTable;       //!< Table mapping glyph keys to their index in glyphs
+        Uint32              asciiGlyphs[256]; //!< Index + 1 of the regular then bold ASCII glyphs without outline, 0 if not loaded yet
+        IndexTable          kerningTable;     //!< Table mapping pairs of code points to their index in kernings
+        std::vector<float>  kernings;         //!< Kerning of each pair of code points requested so far
+        TextureAtlas        atlas;            //!< Texture containing the pixels of the glyphs
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Uniforms of the distance field shader
+    ///
+    ////////////////////////////////////////////////////////////
+    struct DistanceFieldStyle
+    {
+        float outlineWidth; //!< Width of the outline, in units of the distance field
+        Color outlineColor; //!< Color of the outline
+        float glowWidth;    //!< Width of the glow, in units of the distance field
+        Color glowColor;    //!< Color of the glow
     };
 
     ////////////////////////////////////////////////////////////
@@ -360,29 +550,92 @@ private:
     Page& loadPage(unsigned int characterSize) const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Load a new glyph and store it in the cache
+    /// \brief Find or create the page of distance field glyphs
+    ///
+    /// \return The distance field glyphs page
+    ///
+    ////////////////////////////////////////////////////////////
+    Page& loadDistanceFieldPage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find a glyph in a page, loading it if needed
+    ///
+    /// \param page             Page of the glyph
+    /// \param codePoint        Unicode code point of the character to get
+    /// \param characterSize    Reference character size of \a page
+    /// \param bold             Retrieve the bold version or the regular one?
+    /// \param outlineThickness Thickness of outline (when != 0 the glyph will not be filled)
+    /// \param distanceField    Is \a page the distance field page?
+    ///
+    /// \return The glyph corresponding to \a codePoint
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& findGlyph(Page& page, Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, bool distanceField) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the kerning offset of two glyphs of a page, computing it if needed
+    ///
+    /// \param page          Page of the glyphs
+    /// \param first         Unicode code point of the first character (not 0)
+    /// \param second        Unicode code point of the second character (not 0)
+    /// \param characterSize Reference character size of \a page
+    /// \param bold          Retrieve the bold version or the regular one?
+    /// \param distanceField Is \a page the distance field page?
+    ///
+    /// \return Kerning value for \a first and \a second, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    float getKerning(Page& page, Uint32 first, Uint32 second, unsigned int characterSize, bool bold, bool distanceField) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a new glyph into the pixel buffer
     ///
     /// \param codePoint        Unicode code point of the character to load
     /// \param characterSize    Reference character size
     /// \param bold             Retrieve the bold version or the regular one?
     /// \param outlineThickness Thickness of outline (when != 0 the glyph will not be filled)
+    /// \param distanceField    Compute a signed distance field instead of the pixels?
+    /// \param width            Receives the width of the pixels, padding included (0 if the glyph has none)
+    /// \param height           Receives the height of the pixels, padding included (0 if the glyph has none)
     ///
-    /// \return The glyph corresponding to \a codePoint and \a characterSize
+    /// \return The glyph corresponding to \a codePoint and \a characterSize, without its texture rect
     ///
     ////////////////////////////////////////////////////////////
-    Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const;
+    Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, bool distanceField, unsigned int& width, unsigned int& height) const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Find a suitable rectangle within the texture for a glyph
+    /// \brief Store a loaded glyph in a page, and its pixels in the page's atlas
     ///
-    /// \param page   Page of glyphs to search in
-    /// \param width  Width of the rectangle
-    /// \param height Height of the rectangle
+    /// \param page    Page receiving the glyph
+    /// \param key     Key of the glyph in the page
+    /// \param glyph   Glyph to store, without its texture rect
+    /// \param pixels  Pixels of the glyph, padding included (NULL if it has none)
+    /// \param width   Width of \a pixels
+    /// \param height  Height of \a pixels
+    /// \param padding Number of transparent pixels around the glyph in \a pixels
     ///
-    /// \return Found rectangle within the texture
+    /// \return Index of the glyph in the page
     ///
     ////////////////////////////////////////////////////////////
-    IntRect findGlyphRect(Page& page, unsigned int width, unsigned int height) const;
+    Uint32 addGlyph(Page& page, Uint64 key, Glyph glyph, const Uint8* pixels, unsigned int width, unsigned int height, unsigned int padding) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue glyphs of one page for the preloading threads
+    ///
+    /// \param characters       Characters to rasterize
+    /// \param characterSize    Reference character size
+    /// \param bold             Rasterize the bold version or the regular one?
+    /// \param outlineThickness Thickness of outline of the glyphs
+    /// \param distanceField    Compute distance fields, for the distance field page?
+    ///
+    ////////////////////////////////////////////////////////////
+    void preloadPage(const String& characters, unsigned int characterSize, bool bold, float outlineThickness, bool distanceField);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the glyphs rasterized by the preloading threads so far to their pages
+    ///
+    ////////////////////////////////////////////////////////////
+    void addPreloadedGlyphs() const;
 
     ////////////////////////////////////////////////////////////
     /// \brief Make sure that the given size is the current one
@@ -394,6 +647,32 @@ private:
     ////////////////////////////////////////////////////////////
     bool setCurrentSize(unsigned int characterSize) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shader drawing the distance field glyphs
+    ///
+    /// It is created on first use. Its uniforms are "outlineWidth"
+    /// and "glowWidth", in units of the distance field, and
+    /// "outlineColor" and "glowColor".
+    ///
+    /// \return The shader, or NULL if shaders are not available
+    ///
+    ////////////////////////////////////////////////////////////
+    Shader* getDistanceFieldShader() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the uniforms of the distance field shader
+    ///
+    /// Texts share the shader, and the draws that a render target
+    /// queues read its uniforms only when they are flushed: if the
+    /// style changes, the draws \a target has queued are flushed
+    /// first, so that they keep the style they were drawn with.
+    ///
+    /// \param target Target the next draws with the shader go to
+    /// \param style  Uniforms to set
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDistanceFieldStyle(RenderTarget& target, const DistanceFieldStyle& style) const;
+
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
@@ -402,17 +681,24 @@ private:
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    void*                      m_library;     //!< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
-    void*                      m_face;        //!< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
-    void*                      m_streamRec;   //!< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
-    void*                      m_stroker;     //!< Pointer to the stroker (it is typeless to avoid exposing implementation details)
-    int*                       m_refCount;    //!< Reference counter used by implicit sharing
-    bool                       m_isSmooth;    //!< Status of the smooth filter
-    Info                       m_info;        //!< Information about the font
-    mutable PageTable          m_pages;       //!< Table containing the glyphs pages by character size
-    mutable std::vector<Uint8> m_pixelBuffer; //!< Pixel buffer holding a glyph's pixels before being written to the texture
+    void*                      m_library;             //!< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
+    void*                      m_face;                //!< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
+    void*                      m_streamRec;           //!< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
+    void*                      m_stroker;             //!< Pointer to the stroker (it is typeless to avoid exposing implementation details)
+    int*                       m_refCount;            //!< Reference counter used by implicit sharing
+    bool                       m_isSmooth;            //!< Status of the smooth filter
+    Info                       m_info;                //!< Information about the font
+    mutable PageTable          m_pages;               //!< Table containing the glyphs pages by character size
+    mutable PageTable          m_distanceFieldPages;  //!< Table containing the distance field glyphs page (a single one, at DistanceFieldSize)
+    mutable Shader*            m_distanceFieldShader; //!< Shader drawing the distance field glyphs, created on first use
+    mutable DistanceFieldStyle m_distanceFieldStyle;  //!< Uniforms last set on the distance field shader
+    mutable std::vector<Uint8> m_pixelBuffer;         //!< Pixel buffer holding a glyph's pixels before being written to the texture
+    std::string                m_fileName;            //!< File the font was loaded from, empty if it wasn't (the preloading threads open it again)
+    const void*                m_fileData;            //!< Memory the font was loaded from, NULL if it wasn't
+    std::size_t                m_fileSize;            //!< Size of the memory the font was loaded from
+    mutable GlyphLoader*       m_glyphLoader;         //!< Threads rasterizing the preloaded glyphs, NULL when none are pending
     #ifdef SFML_SYSTEM_ANDROID
-    void*                      m_stream; //!< Asset file streamer (if loaded from file)
+    void*                      m_stream;              //!< Asset file streamer (if loaded from file)
     #endif
 };
 
@@ -480,6 +766,21 @@ private:
 /// text2.setStyle(sf::Text::Italic);
 /// \endcode
 ///
+/// Every character size has its own set of glyphs, rasterized
+/// on first use. Applications drawing text at many sizes can
+/// use distance field glyphs instead: they are rasterized once
+/// and scaled by a shader (see sf::Text::setDistanceField).
+///
+/// To avoid a stall on the first frame showing new text, for
+/// example when a menu opens, the glyphs it needs can be
+/// rasterized in the background beforehand:
+/// \code
+/// std::vector<unsigned int> sizes;
+/// sizes.push_back(24);
+/// sizes.push_back(48);
+/// font.preload("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789.,:!?' ", sizes);
+/// \endcode
+///
 /// Apart from loading font files, and passing them to instances
 /// of sf::Text, you should normally not have to deal directly
 /// with this class. However, it may be useful to access the
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_INSTANCEDATA_HPP
+#define SFML_INSTANCEDATA_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Define one copy of the geometry drawn by
+///        sf::RenderTarget::drawInstanced
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API InstanceData
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Identity transform, white color and empty texture rect:
+    /// the geometry is drawn as it is.
+    ///
+    ////////////////////////////////////////////////////////////
+    InstanceData();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the instance from its transform, color and texture rect
+    ///
+    /// \param theTransform   Transform of the instance
+    /// \param theColor       Color of the instance
+    /// \param theTextureRect Texture rect of the instance
+    ///
+    ////////////////////////////////////////////////////////////
+    InstanceData(const Transform& theTransform, const Color& theColor = Color::White, const FloatRect& theTextureRect = FloatRect());
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Transform transform;   //!< Transform of the instance, applied before the render states' one
+    Color     color;       //!< Color of the instance, multiplied by the color of the vertices
+    FloatRect textureRect; //!< Part of the texture to map the geometry's texture coordinates ([0, 1]) to, in pixels; empty to use them as they are
+};
+
+} // namespace sf
+
+
+#endif // SFML_INSTANCEDATA_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::InstanceData
+/// \ingroup graphics
+///
+/// An array of sf::InstanceData is given to
+/// sf::RenderTarget::drawInstanced along with some geometry,
+/// which is then drawn once per instance: moved by the
+/// instance's transform, tinted by its color and, if the
+/// instance has a texture rect, textured with that part of
+/// the texture.
+///
+/// With a texture rect, the texture coordinates of the geometry
+/// are relative to the rect: (0, 0) is its top-left corner and
+/// (1, 1) its bottom-right one. This is how many sprites of a
+/// sheet are drawn from one quad.
+///
+/// Example:
+/// \code
+/// // A 32x32 quad, texture coordinates relative to the instances' rects
+/// sf::Vertex quad[] =
+/// {
+///     sf::Vertex(sf::Vector2f( 0,  0), sf::Vector2f(0, 0)),
+///     sf::Vertex(sf::Vector2f(32,  0), sf::Vector2f(1, 0)),
+///     sf::Vertex(sf::Vector2f(32, 32), sf::Vector2f(1, 1)),
+///     sf::Vertex(sf::Vector2f( 0, 32), sf::Vector2f(0, 1))
+/// };
+/// sf::VertexArray geometry(sf::Quads, 4);
+/// for (std::size_t i = 0; i < 4; ++i)
+///     geometry[i] = quad[i];
+///
+/// std::vector<sf::InstanceData> bats(batCount);
+/// for (std::size_t i = 0; i < batCount; ++i)
+/// {
+///     bats[i].transform.translate(positions[i]);
+///     bats[i].textureRect = sf::FloatRect(frame * 32, 0, 32, 32);
+/// }
+///
+/// window.drawInstanced(geometry, &bats[0], bats.size(), &sheet);
+/// \endcode
+///
+/// \see sf::RenderTarget::drawInstanced
+///
+////////////////////////////////////////////////////////////
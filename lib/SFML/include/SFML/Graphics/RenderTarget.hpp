@@ -38,13 +38,20 @@
 #include <SFML/Graphics/PrimitiveType.hpp>
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/System/NonCopyable.hpp>
+#include <vector>
 
 
 namespace sf
 {
 class Drawable;
+class InstanceData;
 class VertexBuffer;
 
+namespace priv
+{
+    class GLCoreRenderer;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief Base class for all render targets (window, texture, ...)
 ///
@@ -53,6 +60,32 @@ class SFML_GRAPHICS_API RenderTarget : NonCopyable
 {
 public:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief When and in which order draw calls are executed
+    ///
+    /// \see setDrawMode
+    ///
+    ////////////////////////////////////////////////////////////
+    enum DrawMode
+    {
+        Immediate,      //!< Every draw is sent to OpenGL right away (default)
+        DeferredSorted, //!< Draws are queued, then sorted by layer, shader, texture and blend mode
+        DeferredStable  //!< Draws are queued, then sorted by layer only, keeping their order within a layer
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw counts of one frame
+    ///
+    /// \see getDrawStats
+    ///
+    ////////////////////////////////////////////////////////////
+    struct DrawStats
+    {
+        Uint32 draws;          //!< Calls to draw() that reached the target
+        Uint32 drawCalls;      //!< OpenGL draw calls actually issued
+        Uint32 drawCallsSaved; //!< Draws merged into others
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
     ///
@@ -268,6 +301,52 @@ public:
     ////////////////////////////////////////////////////////////
     void draw(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount, const RenderStates& states = RenderStates::Default);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw a drawable object once per instance
+    ///
+    /// Every primitive the drawable draws is drawn once for
+    /// each instance: moved by the instance's transform (applied
+    /// before \a states.transform), tinted by its color and
+    /// textured with its texture rect (see sf::InstanceData).
+    ///
+    /// With OpenGL 3.3, each of these primitives costs a single
+    /// instanced draw call, and the instances are read by the
+    /// GPU. Otherwise, or when \a states has a shader (which
+    /// can't read the instances), the copies are made on the CPU
+    /// and drawn as one batch of vertices, like an sf::VertexArray
+    /// holding all of them would be.
+    ///
+    /// Instances are drawn right away, after the draws queued
+    /// in a deferred draw mode (see setDrawMode).
+    ///
+    /// \param drawable      Object to draw
+    /// \param instances     Pointer to the instances
+    /// \param instanceCount Number of instances
+    /// \param states        Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstanced(const Drawable& drawable, const InstanceData* instances, std::size_t instanceCount,
+                       const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives of a vertex buffer once per instance
+    ///
+    /// Same as the drawable overload, except for the fallback:
+    /// when the instances only move the vertices, the buffer
+    /// is drawn once per instance with its transform. When they
+    /// tint or texture them too, the vertices are first read
+    /// back from the buffer (this is slow, and impossible on
+    /// OpenGL ES, where the draw is then skipped).
+    ///
+    /// \param vertexBuffer  Vertex buffer
+    /// \param instances     Pointer to the instances
+    /// \param instanceCount Number of instances
+    /// \param states        Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstanced(const VertexBuffer& vertexBuffer, const InstanceData* instances, std::size_t instanceCount,
+                       const RenderStates& states = RenderStates::Default);
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the rendering region of the target
     ///
@@ -374,6 +453,100 @@ public:
     ////////////////////////////////////////////////////////////
     void resetGLStates();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Change when and in which order draw calls are executed
+    ///
+    /// In the deferred modes, draw() only records the primitives
+    /// (pre-transformed, so that the transform doesn't have to
+    /// change between them) along with their render states and
+    /// the current draw layer. The queue is executed by flush(),
+    /// which is called automatically by display(), clear(),
+    /// setView(), pushGLStates() and popGLStates(): lower layers
+    /// are drawn first, and consecutive draws sharing the same
+    /// texture, shader and blend mode are merged into a single
+    /// OpenGL draw call.
+    ///
+    /// sf::RenderTarget::DeferredStable keeps the order of the
+    /// draws within a layer, so the result is always the same as
+    /// in immediate mode. sf::RenderTarget::DeferredSorted also
+    /// groups the draws of a layer by shader, texture and blend
+    /// mode, which merges many more of them but is only correct
+    /// if draws of a layer that use different states don't
+    /// overlap.
+    ///
+    /// While draws are queued, textures, vertex buffers and
+    /// shaders they use must stay alive, and shader uniforms
+    /// are the ones set when the queue is flushed.
+    ///
+    /// Changing the mode flushes the queue.
+    ///
+    /// \param mode New draw mode
+    ///
+    /// \see getDrawMode, setDrawLayer, flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDrawMode(DrawMode mode);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current draw mode
+    ///
+    /// \return Current draw mode
+    ///
+    /// \see setDrawMode
+    ///
+    ////////////////////////////////////////////////////////////
+    DrawMode getDrawMode() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the layer of the next draws in deferred modes
+    ///
+    /// Draws of a lower layer are executed before those of a
+    /// higher one, whatever the order in which they were made.
+    /// The layer is ignored in immediate mode. The default
+    /// layer is 0.
+    ///
+    /// \param layer Layer of the next draws
+    ///
+    /// \see getDrawLayer, setDrawMode
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDrawLayer(int layer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the layer of the next draws
+    ///
+    /// \return Current draw layer
+    ///
+    /// \see setDrawLayer
+    ///
+    ////////////////////////////////////////////////////////////
+    int getDrawLayer() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Execute the queued draws
+    ///
+    /// This function does nothing in immediate mode, or when
+    /// no draw is queued.
+    ///
+    /// \see setDrawMode
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the draw counts of the last frame
+    ///
+    /// A frame ends with each call to display(). The counts
+    /// are kept in every draw mode; in immediate mode no draw
+    /// call is saved.
+    ///
+    /// \return Draw counts of the last displayed frame
+    ///
+    /// \see setDrawMode
+    ///
+    ////////////////////////////////////////////////////////////
+    const DrawStats& getDrawStats() const;
+
 protected:
 
     ////////////////////////////////////////////////////////////
@@ -391,8 +564,71 @@ protected:
     ////////////////////////////////////////////////////////////
     void initialize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Flush the queued draws and close the frame statistics
+    ///
+    /// The derived classes must call this function when their
+    /// contents are displayed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void finishFrame();
+
 private:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Check (once) whether the context has a core profile
+    ///
+    /// In core profile contexts, draws go through a
+    /// priv::GLCoreRenderer instead of the fixed-function pipeline.
+    ///
+    /// \return True if the core profile backend is used
+    ///
+    ////////////////////////////////////////////////////////////
+    bool useCoreProfile();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the renderer drawing instances, if any
+    ///
+    /// In core profile contexts it is the core profile backend;
+    /// compatibility contexts create one just for instances.
+    ///
+    /// \return Renderer for instanced draws, NULL without OpenGL 3.3
+    ///
+    ////////////////////////////////////////////////////////////
+    priv::GLCoreRenderer* useInstancing();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives once per instance of drawInstanced
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstances(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw a vertex buffer once per instance of drawInstanced
+    ///
+    /// \param vertexBuffer Vertex buffer
+    /// \param firstVertex  Index of the first vertex to render
+    /// \param vertexCount  Number of vertices to render
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstances(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the render states of an instanced draw to the
+    ///        renderer of a compatibility context
+    ///
+    /// \param renderer Renderer for instanced draws
+    /// \param states   Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void beginInstancing(priv::GLCoreRenderer& renderer, const RenderStates& states);
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply the current view
     ///
@@ -423,6 +659,15 @@ private:
     ////////////////////////////////////////////////////////////
     void applyTexture(const Texture* texture);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply a new texture to a core profile renderer
+    ///
+    /// \param renderer Renderer to apply the texture to
+    /// \param texture  Texture to apply
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyTexture(priv::GLCoreRenderer& renderer, const Texture* texture);
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply a new shader
     ///
@@ -458,13 +703,35 @@ private:
     ////////////////////////////////////////////////////////////
     void cleanupDraw(const RenderStates& states);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue primitives in deferred mode
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void queueDraw(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue a vertex buffer draw in deferred mode
+    ///
+    /// \param vertexBuffer Vertex buffer
+    /// \param firstVertex  Index of the first vertex to render
+    /// \param vertexCount  Number of vertices to render
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void queueDraw(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount, const RenderStates& states);
+
     ////////////////////////////////////////////////////////////
     /// \brief Render states cache
     ///
     ////////////////////////////////////////////////////////////
     struct StatesCache
     {
-        enum {VertexCacheSize = 4};
+        enum {VertexCacheSize = 1024};
 
         bool      enable;         //!< Is the cache enabled?
         bool      glStatesSet;    //!< Are our internal GL states set yet?
@@ -472,8 +739,54 @@ private:
         BlendMode lastBlendMode;  //!< Cached blending mode
         Uint64    lastTextureId;  //!< Cached texture
         bool      texCoordsArrayEnabled; //!< Is GL_TEXTURE_COORD_ARRAY client state enabled?
-        bool      useVertexCache; //!< Did we previously use the vertex cache?
-        Vertex    vertexCache[VertexCacheSize]; //!< Pre-transformed vertices cache
+        bool      useVertexCache; //!< Did we previously draw with an identity modelview?
+        const Vertex* lastVertexData; //!< Vertices the array pointers were last set to, if useVertexCache
+        std::vector<Vertex> vertexCache; //!< Pre-transformed vertices cache, grown up to VertexCacheSize
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw recorded in deferred mode
+    ///
+    ////////////////////////////////////////////////////////////
+    struct DrawCommand
+    {
+        int                 layer;        //!< Draw layer when recorded
+        Uint32              blendKey;     //!< Blend mode packed for sorting
+        RenderStates        states;       //!< Render states (identity transform for primitives)
+        PrimitiveType       type;         //!< Points, Lines or Triangles for primitives
+        std::size_t         firstVertex;  //!< Into the queued vertices, or the vertex buffer
+        std::size_t         vertexCount;  //!< Number of vertices
+        const VertexBuffer* vertexBuffer; //!< Vertex buffer to draw, NULL for primitives
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draws waiting for flush(), and the frame statistics
+    ///
+    ////////////////////////////////////////////////////////////
+    struct DrawQueue
+    {
+        DrawMode                 mode;     //!< Current draw mode
+        int                      layer;    //!< Layer of the next draws
+        bool                     flushing; //!< Are the queued draws being executed?
+        std::vector<DrawCommand> commands; //!< Queued draws, in recording order
+        std::vector<Vertex>      vertices; //!< Pre-transformed vertices of the queued primitives
+        std::vector<Vertex>      merged;   //!< Vertices of the queued primitives, in drawing order
+        DrawStats                frame;    //!< Counts of the current frame
+        DrawStats                last;     //!< Counts of the last displayed frame
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Instances of the running drawInstanced call
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Instancing
+    {
+        const InstanceData*   instances; //!< Instances to draw, NULL outside drawInstanced
+        std::size_t           count;     //!< Number of instances
+        bool                  checked;   //!< Has the context been checked for instancing yet?
+        priv::GLCoreRenderer* renderer;  //!< Renderer for instanced draws in compatibility contexts
+        std::vector<Vertex>   vertices;  //!< Copies of the vertices per instance, without instancing
+        std::vector<Vertex>   bufferVertices; //!< Vertices read back from a vertex buffer, without instancing
     };
 
     ////////////////////////////////////////////////////////////
@@ -482,7 +795,11 @@ private:
     View        m_defaultView; //!< Default view
     View        m_view;        //!< Current view
     StatesCache m_cache;       //!< Render states cache
+    DrawQueue   m_queue;       //!< Deferred draws
     Uint64      m_id;          //!< Unique number that identifies the RenderTarget
+    bool        m_coreProfileChecked; //!< Has the profile of the context been checked yet?
+    priv::GLCoreRenderer* m_coreRenderer; //!< Backend for core profile contexts, NULL with the fixed-function pipeline
+    Instancing  m_instancing;  //!< Instanced draws
 };
 
 } // namespace sf
@@ -513,6 +830,42 @@ private:
 /// OpenGL states are not messed up by calling the
 /// pushGLStates/popGLStates functions.
 ///
+/// Render targets draw with the fixed-function pipeline (client
+/// vertex arrays and matrix stacks) by default. When their context
+/// is created with a core profile (OpenGL 3.2 or later, with
+/// sf::ContextSettings::Core in its attribute flags), they use
+/// vertex array objects, a streaming vertex buffer and built-in
+/// shaders instead, for all the drawables of the graphics module.
+/// sf::Shader is not supported there: its programs are ARB shader
+/// objects fed by the fixed-function inputs, which core profiles
+/// don't have. Draws with a shader use the built-in one instead
+/// (an error is printed the first time), and so does text in
+/// distance field mode (see sf::Text::setDistanceField).
+/// pushGLStates/popGLStates only reset the states used by SFML
+/// there (core profiles have no attribute stack).
+/// \code
+/// sf::ContextSettings settings(0, 0, 0, 3, 3, sf::ContextSettings::Core);
+/// sf::RenderWindow window(sf::VideoMode(800, 600), "Core profile", sf::Style::Default, settings);
+/// \endcode
+///
+/// By default every draw is executed right away. With
+/// setDrawMode, draws can instead be queued until display():
+/// they are then ordered by layer (see setDrawLayer), and
+/// optionally by render states, and consecutive draws that
+/// share the same states are merged into a single OpenGL
+/// draw call. getDrawStats tells how many were saved.
+/// \code
+/// window.setDrawMode(sf::RenderTarget::DeferredStable);
+///
+/// window.setDrawLayer(1);
+/// window.draw(hud);
+/// window.setDrawLayer(0);
+/// for (std::size_t i = 0; i < tiles.size(); ++i)
+///     window.draw(tiles[i]); // drawn before the HUD, in one call
+///
+/// window.display();
+/// \endcode
+///
 /// \see sf::RenderWindow, sf::RenderTexture, sf::View
 ///
 ////////////////////////////////////////////////////////////
@@ -210,6 +210,8 @@ public:
     /// has been drawn so far. Like for windows, calling this
     /// function is mandatory at the end of rendering. Not calling
     /// it may leave the texture in an undefined state.
+    /// Draws queued in a deferred draw mode (see
+    /// sf::RenderTarget::setDrawMode) are executed first.
     ///
     ////////////////////////////////////////////////////////////
     void display();
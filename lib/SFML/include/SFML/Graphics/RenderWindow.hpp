@@ -141,6 +141,22 @@ public:
     ////////////////////////////////////////////////////////////
     bool setActive(bool active = true);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Display on screen what has been rendered to the window so far
+    ///
+    /// This function executes the draws queued in the deferred
+    /// draw modes (see sf::RenderTarget::setDrawMode), then
+    /// behaves like sf::Window::display.
+    ///
+    /// \warning It hides sf::Window::display rather than overriding
+    /// it: calling display through a sf::Window reference or
+    /// pointer doesn't execute the queued draws, so in the deferred
+    /// modes they are not shown. Call it on the sf::RenderWindow,
+    /// or call flush() first.
+    ///
+    ////////////////////////////////////////////////////////////
+    void display();
+
     ////////////////////////////////////////////////////////////
     /// \brief Copy the current contents of the window to an image
     ///
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SPRITEBATCH_HPP
+#define SFML_SPRITEBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Sprite;
+
+////////////////////////////////////////////////////////////
+/// \brief Collects sprites and quads and draws those sharing
+///        the same render states with a single draw call
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API SpriteBatch : public Drawable
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief How quads are grouped into draw calls
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Mode
+    {
+        KeepOrder,   //!< Merge consecutive quads with the same states; drawn exactly in submission order
+        GroupByState //!< Every quad joins the group of its states, groups drawn in order of first use
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty batch.
+    ///
+    /// \param mode How quads are grouped into draw calls
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SpriteBatch(Mode mode = KeepOrder);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove every quad from the batch
+    ///
+    /// The memory is kept, so that refilling the batch every
+    /// frame does not allocate once it has reached its size.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a sprite to the batch
+    ///
+    /// The sprite is transformed on the CPU (by its own transform,
+    /// then states.transform), so that sprites with different
+    /// transforms still share a draw call. Its texture replaces
+    /// states.texture. A sprite without texture is ignored, like
+    /// sf::Sprite::draw does.
+    ///
+    /// \param sprite Sprite to add
+    /// \param states Blend mode, shader and extra transform to use
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Sprite& sprite, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an arbitrary quad to the batch
+    ///
+    /// \a quad points to 4 vertices, in the order used by sf::Quads
+    /// (top-left, top-right, bottom-right, bottom-left). Their
+    /// positions are transformed by states.transform on the CPU.
+    ///
+    /// \param quad   Pointer to the 4 vertices of the quad
+    /// \param states Texture, blend mode, shader and transform to use
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Vertex* quad, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of quads in the batch
+    ///
+    /// \return Number of quads added since the last clear
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getQuadCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of draw calls the batch will make
+    ///
+    /// \return Number of groups of quads sharing their states
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getBatchCount() const;
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the batch to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states (only the transform is used)
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find or start the group of quads drawn with some states
+    ///
+    /// \return Vertices of the group, to append the new quad to
+    ///
+    ////////////////////////////////////////////////////////////
+    std::vector<Vertex>& groupFor(const Texture* texture, const BlendMode& blendMode, const Shader* shader);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Quads sharing the same render states
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        const Texture*      texture;   //!< Texture of the quads
+        BlendMode           blendMode; //!< Blend mode of the quads
+        const Shader*       shader;    //!< Shader of the quads
+        std::vector<Vertex> vertices;  //!< Two triangles per quad, already transformed
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Mode               m_mode;       //!< How quads are grouped
+    std::vector<Batch> m_batches;    //!< Groups, the first m_batchCount ones in use (the others keep their memory)
+    std::size_t        m_batchCount; //!< Groups in use
+    std::size_t        m_quadCount;  //!< Quads in the batch
+};
+
+} // namespace sf
+
+
+#endif // SFML_SPRITEBATCH_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SpriteBatch
+/// \ingroup graphics
+///
+/// Drawing a sprite costs a whole draw call: states setup,
+/// transform upload and glDrawArrays for 4 vertices. When many
+/// sprites share a texture (tiles, particles, animation frames
+/// taken from one sheet...), sf::SpriteBatch draws all of them
+/// at once instead: each sprite is transformed on the CPU and
+/// appended to the group of quads using the same texture, blend
+/// mode and shader, and each group is then drawn with a single
+/// call.
+///
+/// In KeepOrder mode (the default), only consecutive quads are
+/// grouped, so the result is exactly what drawing them one by one
+/// would give. In GroupByState mode, quads join their group
+/// wherever it started, which saves more draw calls but changes
+/// how quads with different states overlap: use it for things
+/// that do not overlap, or when their order does not matter.
+///
+/// Usage example:
+/// \code
+/// sf::SpriteBatch batch;
+///
+/// // Every frame
+/// batch.clear();
+/// for (std::size_t i = 0; i < tiles.size(); ++i)
+///     batch.add(tiles[i]);
+/// window.draw(batch);
+/// \endcode
+///
+/// \see sf::Sprite, sf::VertexArray
+///
+////////////////////////////////////////////////////////////
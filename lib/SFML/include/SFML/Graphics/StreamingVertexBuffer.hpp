@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_STREAMINGVERTEXBUFFER_HPP
+#define SFML_STREAMINGVERTEXBUFFER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <cstddef>
+#include <vector>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Vertex buffer for geometry rewritten every frame,
+///        written without waiting for the GPU
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API StreamingVertexBuffer : public Drawable, private GlResource, NonCopyable
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty buffer; it is created by the first
+    /// call to map or update if create was not called.
+    ///
+    /// \param type Type of primitives to draw
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit StreamingVertexBuffer(PrimitiveType type = Triangles);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~StreamingVertexBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the buffer
+    ///
+    /// Allocates graphics memory for RegionCount regions of
+    /// \p vertexCount vertices each. Any previously allocated
+    /// memory is freed in the process, along with its contents.
+    ///
+    /// \param vertexCount Number of vertices a single update may hold
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of vertices a single update may hold
+    ///
+    /// \return Vertex count of one region, 0 if not created yet
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCapacity() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start writing new contents
+    ///
+    /// Moves on to the next region and returns where to write
+    /// its \p vertexCount vertices, which are the ones drawn
+    /// from then on. The region is only handed out once the GPU
+    /// is done with the draws that used it before, so writing
+    /// never stalls a draw in flight; the buffer grows if
+    /// \p vertexCount exceeds its capacity.
+    ///
+    /// The vertices must be written before unmap is called, and
+    /// the buffer can't be drawn until then.
+    ///
+    /// \param vertexCount Number of vertices to write
+    ///
+    /// \return Pointer to the vertices to write, or NULL on failure
+    ///
+    /// \see unmap, update
+    ///
+    ////////////////////////////////////////////////////////////
+    Vertex* map(std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Finish writing the contents started with map
+    ///
+    ////////////////////////////////////////////////////////////
+    void unmap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the contents with an array of vertices
+    ///
+    /// Same as copying the vertices between map and unmap.
+    ///
+    /// \param vertices    Array of vertices to copy to the buffer
+    /// \param vertexCount Number of vertices to copy
+    ///
+    /// \return True if the update was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const Vertex* vertices, std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of vertices drawn
+    ///
+    /// \return Vertex count of the last update
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getVertexCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the type of primitives to draw
+    ///
+    /// \param type Type of primitive
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPrimitiveType(PrimitiveType type);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the type of primitives drawn by the buffer
+    ///
+    /// \return Primitive type
+    ///
+    ////////////////////////////////////////////////////////////
+    PrimitiveType getPrimitiveType() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the buffer stays mapped between updates
+    ///
+    /// With OpenGL 4.4 or ARB_buffer_storage the buffer is
+    /// mapped once (persistent mapping) and map only waits for
+    /// the region's fence. Otherwise each map maps its region
+    /// without synchronization.
+    ///
+    /// \return True if the buffer is persistently mapped
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isPersistent() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports streaming vertex buffers
+    ///
+    /// Same requirements as sf::VertexBuffer: they are the
+    /// storage of streaming vertex buffers.
+    ///
+    /// \return True if streaming vertex buffers are supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+    ////////////////////////////////////////////////////////////
+    // Static member data
+    ////////////////////////////////////////////////////////////
+    static const std::size_t RegionCount = 3; //!< Regions the buffer cycles through (triple buffering)
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the vertices of the last update to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until the GPU is done with a region
+    ///
+    /// \param region Index of the region
+    ///
+    ////////////////////////////////////////////////////////////
+    void waitRegion(std::size_t region);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the fences and the persistent mapping
+    ///
+    ////////////////////////////////////////////////////////////
+    void release();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    VertexBuffer        m_buffer;               //!< Storage for the RegionCount regions, back to back
+    std::size_t         m_capacity;             //!< Vertices per region
+    std::size_t         m_region;               //!< Region holding the vertices drawn
+    std::size_t         m_vertexCount;          //!< Vertices written to the current region
+    Vertex*             m_persistent;           //!< Persistently mapped storage, NULL if not persistent
+    bool                m_mapped;               //!< Is a region being written?
+    std::vector<Vertex> m_staging;              //!< Vertices written when the buffer can't be mapped at all
+    void*               m_fences[RegionCount];  //!< Fence (GLsync) after the last draw of each region, NULL if none
+};
+
+} // namespace sf
+
+
+#endif // SFML_STREAMINGVERTEXBUFFER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::StreamingVertexBuffer
+/// \ingroup graphics
+///
+/// sf::VertexArray sends its vertices from client memory on every
+/// draw, and sf::VertexBuffer::update replaces the buffer's data,
+/// which makes the driver wait (or copy) while the GPU still reads
+/// the previous contents. sf::StreamingVertexBuffer is meant for
+/// geometry rebuilt every frame instead, like particles or text:
+/// its storage is split in RegionCount regions used in turn, and a
+/// fence is placed when leaving a region, so that a region is
+/// written again only once the GPU has finished drawing from it.
+/// The vertices are written straight into GPU-visible memory with
+/// map and unmap, or copied there with update.
+///
+/// The fences are placed in the context active when map is called;
+/// draw the buffer in the same context (or flush the others). When
+/// the target uses a deferred draw mode (see
+/// sf::RenderTarget::setDrawMode), update the buffer at most
+/// RegionCount - 1 times per frame, since queued draws only reach
+/// the GPU at display time.
+///
+/// Usage example:
+/// \code
+/// sf::StreamingVertexBuffer particles(sf::Triangles);
+///
+/// // Every frame
+/// sf::Vertex* vertices = particles.map(system.getVertexCount());
+/// if (vertices)
+/// {
+///     system.writeVertices(vertices);
+///     particles.unmap();
+/// }
+/// window.draw(particles, texture);
+/// \endcode
+///
+/// \see sf::VertexBuffer, sf::VertexArray
+///
+////////////////////////////////////////////////////////////
@@ -250,6 +250,63 @@ public:
     ////////////////////////////////////////////////////////////
     void setOutlineThickness(float thickness);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the glow color of the text
+    ///
+    /// The glow is a halo fading out around the text (and its
+    /// outline). It is only drawn in distance field mode.
+    /// By default, the glow color is transparent.
+    ///
+    /// \param color New glow color of the text
+    ///
+    /// \see getGlowColor, setGlowRadius, setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    void setGlowColor(const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the radius of the text's glow
+    ///
+    /// By default, the glow radius is 0.
+    ///
+    /// \param radius New glow radius, in pixels
+    ///
+    /// \see getGlowRadius, setGlowColor, setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    void setGlowRadius(float radius);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the distance field mode
+    ///
+    /// In distance field mode, the text uses the distance field
+    /// glyphs of its font (see sf::Font::getDistanceFieldGlyph),
+    /// rasterized once for all the character sizes, and a shader
+    /// draws the fill, the outline and the glow in a single pass.
+    /// This saves memory and rasterization time when a font is
+    /// used at many sizes or outline thicknesses, and keeps glyphs
+    /// sharp when the text is scaled.
+    ///
+    /// The shader replaces the one of the render states. The
+    /// outline and the glow together can't extend further than
+    /// sf::Font::DistanceFieldSpread * characterSize / sf::Font::DistanceFieldSize
+    /// pixels from the glyphs. When shaders are not available,
+    /// the text is drawn as if the mode was disabled. Render
+    /// targets with a core profile context don't apply sf::Shader
+    /// (see sf::RenderTarget): keep this mode disabled for them.
+    /// The texts of a font share its shader, so in the deferred
+    /// draw modes of sf::RenderTarget, a text whose outline or
+    /// glow differs from the one drawn before it flushes the
+    /// queue: group such texts by style to keep merging them.
+    /// The distance field mode is disabled by default.
+    ///
+    /// \param distanceField True to enable the distance field mode, false to disable it
+    ///
+    /// \see isDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDistanceField(bool distanceField);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the text's string
     ///
@@ -367,6 +424,36 @@ public:
     ////////////////////////////////////////////////////////////
     float getOutlineThickness() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the glow color of the text
+    ///
+    /// \return Glow color of the text
+    ///
+    /// \see setGlowColor
+    ///
+    ////////////////////////////////////////////////////////////
+    const Color& getGlowColor() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the glow radius of the text
+    ///
+    /// \return Glow radius of the text, in pixels
+    ///
+    /// \see setGlowRadius
+    ///
+    ////////////////////////////////////////////////////////////
+    float getGlowRadius() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the distance field mode is enabled or not
+    ///
+    /// \return True if the distance field mode is enabled
+    ///
+    /// \see setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDistanceField() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the position of the \a index-th character
     ///
@@ -432,6 +519,22 @@ private:
     ////////////////////////////////////////////////////////////
     void ensureGeometryUpdate() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the text is drawn with distance field glyphs
+    ///
+    /// \return True if the distance field mode is enabled and available
+    ///
+    ////////////////////////////////////////////////////////////
+    bool usesDistanceField() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the font texture holding the glyphs of the text
+    ///
+    /// \return Texture of the character size, or of the distance field glyphs
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getFontTexture() const;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -444,6 +547,9 @@ private:
     Color               m_fillColor;           //!< Text fill color
     Color               m_outlineColor;        //!< Text outline color
     float               m_outlineThickness;    //!< Thickness of the text's outline
+    Color               m_glowColor;           //!< Text glow color
+    float               m_glowRadius;          //!< Radius of the text's glow
+    bool                m_distanceField;       //!< Is the distance field mode enabled?
     mutable VertexArray m_vertices;            //!< Vertex array containing the fill geometry
     mutable VertexArray m_outlineVertices;     //!< Vertex array containing the outline geometry
     mutable FloatRect   m_bounds;              //!< Bounding rectangle of the text (in local coordinates)
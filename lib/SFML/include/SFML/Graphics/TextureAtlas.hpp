@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TEXTUREATLAS_HPP
+#define SFML_TEXTUREATLAS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector3.hpp>
+#include <vector>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Texture made of many small images packed together,
+///        which can be added and removed at any time
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API TextureAtlas
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Identifier returned when an image could not be added
+    ///
+    ////////////////////////////////////////////////////////////
+    static const Uint32 InvalidRegion = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty atlas, with no texture.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// The copy gets its own texture, created from the pixels
+    /// when it is requested.
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas(const TextureAtlas& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas& operator =(const TextureAtlas& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the atlas texture
+    ///
+    /// Any previous region is removed. The atlas grows on its own
+    /// when an image doesn't fit any more, so \a width and \a height
+    /// are only the initial size. The texture itself is created by
+    /// the first call to getTexture.
+    ///
+    /// \param width      Initial width of the texture
+    /// \param height     Initial height of the texture
+    /// \param background Color of the pixels not covered by any region
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int width, unsigned int height, const Color& background = Color::Transparent);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an array of pixels to the atlas
+    ///
+    /// \a pixels must hold \a width x \a height RGBA pixels.
+    /// When no free space is left, the atlas grows (one side at a
+    /// time); the existing regions keep their place, so rectangles
+    /// read before stay valid.
+    ///
+    /// \param pixels Array of pixels to copy into the atlas
+    /// \param width  Width of the image
+    /// \param height Height of the image
+    ///
+    /// \return Identifier of the new region, or InvalidRegion if it
+    ///         didn't fit in the maximum texture size
+    ///
+    /// \see remove, getRect
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 add(const Uint8* pixels, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an image to the atlas
+    ///
+    /// \param image Image to copy into the atlas
+    ///
+    /// \return Identifier of the new region, or InvalidRegion if it
+    ///         didn't fit in the maximum texture size
+    ///
+    /// \see remove, getRect
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 add(const Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a region from the atlas
+    ///
+    /// Its space is reused by the next images that fit in it, and
+    /// its identifier may be given to a later region. Once the
+    /// removed space exceeds the one still covered, the remaining
+    /// regions are packed again, which moves them: use getRect
+    /// again afterwards rather than keeping old rectangles.
+    ///
+    /// \param region Identifier returned by add
+    ///
+    /// \return True if the region existed
+    ///
+    ////////////////////////////////////////////////////////////
+    bool remove(Uint32 region);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove every region, keeping the current size
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the rectangle of a region in the texture
+    ///
+    /// \param region Identifier returned by add
+    ///
+    /// \return Texture rectangle of the region, or an empty
+    ///         rectangle if it doesn't exist
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect getRect(Uint32 region) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of regions in the atlas
+    ///
+    /// \return Number of regions
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getRegionCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current size of the atlas
+    ///
+    /// \return Size of the texture, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the fraction of the texture covered by regions
+    ///
+    /// \return Covered area divided by the texture area, in [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    float getOccupancy() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the smooth filter of the texture
+    ///
+    /// \param smooth True to enable smoothing, false to disable it
+    ///
+    /// \see Texture::setSmooth
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the smooth filter is enabled or not
+    ///
+    /// \return True if smoothing is enabled, false if it is disabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isSmooth() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture holding the regions
+    ///
+    /// The atlas works on a copy of the pixels in system memory:
+    /// the texture is created by the first call, and the changes
+    /// made since the last call are uploaded here, all at once.
+    /// Until then, adding and removing regions doesn't need an
+    /// OpenGL context.
+    ///
+    /// \return Atlas texture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pack a set of images into a single image
+    ///
+    /// This works on the CPU only, without any OpenGL context, so
+    /// that atlases can be baked offline and saved to a file. The
+    /// images are packed from the tallest to the shortest, in the
+    /// smallest power of two size they fit in.
+    ///
+    /// \param images      Images to pack
+    /// \param atlas       Image receiving the atlas
+    /// \param rects       Receives the rectangle of each image in \a atlas, in the same order as \a images
+    /// \param padding     Empty pixels kept around each image
+    /// \param maximumSize Maximum width and height of \a atlas
+    /// \param background  Color of the pixels not covered by any image
+    ///
+    /// \return True if all the images fit in \a maximumSize
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool bake(const std::vector<Image>& images, Image& atlas, std::vector<IntRect>& rects,
+                     unsigned int padding = 0, unsigned int maximumSize = 4096, const Color& background = Color::Transparent);
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enlarge the atlas, keeping the regions in place
+    ///
+    /// \param size New size of the atlas, not smaller than the current one
+    ///
+    ////////////////////////////////////////////////////////////
+    void resize(const Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pack the regions again, dropping the removed space
+    ///
+    /// The pixels of the regions are moved to their new place.
+    /// Nothing changes if they don't fit.
+    ///
+    /// \return True if the regions were packed again
+    ///
+    ////////////////////////////////////////////////////////////
+    bool compact();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark rows of pixels to be uploaded by the next getTexture
+    ///
+    /// \param top    First row that changed
+    /// \param height Number of rows that changed
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidate(unsigned int top, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    mutable Texture*                    m_texture;     //!< Texture holding the pixels of the regions, NULL until it is requested
+    Image                               m_pixels;      //!< Pixels of the regions, uploaded to the texture when it is requested
+    mutable Vector2u                    m_dirtyRows;   //!< First and past-the-last rows of pixels that changed since the last upload
+    bool                                m_isSmooth;    //!< Status of the smooth filter of the texture
+    Color                               m_background;  //!< Color of the free pixels
+    std::vector<Vector3<unsigned int> > m_skyline;     //!< Top of the packed area: one (x, y, width) segment per height, sorted by x
+    std::vector<IntRect>                m_freeRects;   //!< Space released by removed regions, under the skyline
+    std::vector<IntRect>                m_regions;     //!< Rectangle of each region, indexed by identifier - 1 (empty when removed)
+    std::vector<Uint32>                 m_freeIds;     //!< Identifiers of removed regions, to be reused
+    Uint32                              m_anchor;      //!< First region added to the empty atlas, kept at (0, 0)
+    std::size_t                         m_regionCount; //!< Number of regions in use
+    unsigned int                        m_usedArea;    //!< Pixels covered by the regions
+};
+
+} // namespace sf
+
+
+#endif // SFML_TEXTUREATLAS_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TextureAtlas
+/// \ingroup graphics
+///
+/// Drawing many small images from one texture lets them be
+/// batched into few draw calls (see sf::SpriteBatch). sf::TextureAtlas
+/// builds such a texture at runtime: each image added gets its
+/// own region, found with a skyline bottom-left packer, and is
+/// identified by the number returned by add. Regions can be
+/// removed; their space is reused by later images.
+///
+/// When an image doesn't fit, the atlas grows by doubling its
+/// shorter side; the regions keep their place, so vertices that
+/// already refer to them stay valid. Only removing regions can
+/// move the others: once more space is removed than covered, the
+/// atlas packs them again from the tallest to the shortest, so
+/// read the rectangles with getRect after removing. The first
+/// region added to an empty atlas stays at the top-left corner
+/// through re-packing, which
+/// is handy for a small opaque square used by untextured geometry
+/// (sf::Font keeps the one of text underlines there).
+///
+/// For atlases built once, bake packs a set of sf::Image into a
+/// single one without needing OpenGL, so that the result can be
+/// saved and loaded as a regular texture.
+///
+/// Usage example:
+/// \code
+/// sf::TextureAtlas atlas;
+/// atlas.create(256, 256);
+///
+/// sf::Uint32 player = atlas.add(playerImage);
+/// sf::Uint32 enemy = atlas.add(enemyImage);
+///
+/// sf::Sprite sprite(atlas.getTexture(), atlas.getRect(player));
+/// \endcode
+///
+/// \see sf::Texture, sf::Image, sf::SpriteBatch
+///
+////////////////////////////////////////////////////////////
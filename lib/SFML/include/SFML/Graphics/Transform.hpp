@@ -31,6 +31,7 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cstddef>
 
 
 namespace sf
@@ -130,6 +131,24 @@ public:
     ////////////////////////////////////////////////////////////
     Vector2f transformPoint(const Vector2f& point) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Transform an array of 2D points
+    ///
+    /// The result is the same as calling transformPoint on
+    /// each point, but several points are processed at once
+    /// with SIMD instructions where available.
+    /// \a points and \a result may be the same array, but must
+    /// not otherwise overlap.
+    ///
+    /// \param points Points to transform
+    /// \param result Array receiving the transformed points
+    /// \param count  Number of points
+    ///
+    /// \see transformPoint
+    ///
+    ////////////////////////////////////////////////////////////
+    void transformPoints(const Vector2f* points, Vector2f* result, std::size_t count) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Transform a rectangle
     ///
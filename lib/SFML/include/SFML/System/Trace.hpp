@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_TRACE_HPP
+#define SFML_TRACE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Export.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <string>
+
+
+////////////////////////////////////////////////////////////
+// Instrumentation macros
+//
+// They expand to nothing unless SFML_ENABLE_TRACE is defined
+// (CMake option of the same name), so that instrumented code
+// has no cost at all in regular builds.
+////////////////////////////////////////////////////////////
+#if defined(SFML_ENABLE_TRACE)
+
+    #define SFML_TRACE_CONCAT_IMPL(a, b) a##b
+    #define SFML_TRACE_CONCAT(a, b) SFML_TRACE_CONCAT_IMPL(a, b)
+
+    #define SFML_TRACE_ZONE(name)           sf::TraceZone SFML_TRACE_CONCAT(sfmlTraceZone, __LINE__)(name)
+    #define SFML_TRACE_COUNTER(name, value) sf::Trace::counter(name, static_cast<double>(value))
+    #define SFML_TRACE_THREAD_NAME(name)    sf::Trace::setThreadName(name)
+    #define SFML_TRACE_DUMP(filename)       sf::Trace::dump(filename)
+
+#else
+
+    #define SFML_TRACE_ZONE(name)           ((void)0)
+    #define SFML_TRACE_COUNTER(name, value) ((void)0)
+    #define SFML_TRACE_THREAD_NAME(name)    ((void)0)
+    #define SFML_TRACE_DUMP(filename)       ((void)0)
+
+#endif
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Collects timeline events and exports them as
+///        a Chrome / Perfetto JSON trace
+///
+////////////////////////////////////////////////////////////
+class SFML_SYSTEM_API Trace
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a zone on the calling thread
+    ///
+    /// Zones must be closed with endZone() in reverse order of
+    /// opening, on the same thread. The name is not copied, it
+    /// must therefore remain valid until the trace is dumped
+    /// (string literals are the natural choice).
+    ///
+    /// \param name Name of the zone
+    ///
+    /// \see endZone, sf::TraceZone
+    ///
+    ////////////////////////////////////////////////////////////
+    static void beginZone(const char* name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Close the last zone opened on the calling thread
+    ///
+    /// \see beginZone
+    ///
+    ////////////////////////////////////////////////////////////
+    static void endZone();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the current value of a counter
+    ///
+    /// Counters are displayed as graphs in the trace viewers.
+    /// As for zones, the name is not copied.
+    ///
+    /// \param name  Name of the counter
+    /// \param value Current value of the counter
+    ///
+    ////////////////////////////////////////////////////////////
+    static void counter(const char* name, double value);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Give a name to the calling thread
+    ///
+    /// The name is displayed in the trace viewers instead of
+    /// the numeric thread identifier. It is copied.
+    ///
+    /// \param name Name of the calling thread
+    ///
+    ////////////////////////////////////////////////////////////
+    static void setThreadName(const std::string& name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write all the events recorded so far to a file
+    ///
+    /// The output is in the Chrome trace event JSON format, which
+    /// can be opened with chrome://tracing or ui.perfetto.dev.
+    /// Recorded events are kept, so dumping several times
+    /// produces files containing all the events since startup.
+    ///
+    /// Threads are not paused while the trace is written: events
+    /// being recorded by other threads at the same time may or
+    /// may not be part of the output.
+    ///
+    /// Each thread can record about a million events; past that,
+    /// new events are dropped (and an error is printed by dump()),
+    /// but zones that were already open are still closed so that
+    /// every recorded beginning has its end.
+    ///
+    /// \param filename Path of the file to write
+    ///
+    /// \return True if the file was successfully written
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool dump(const std::string& filename);
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Automatic wrapper for opening and closing trace zones
+///
+////////////////////////////////////////////////////////////
+class SFML_SYSTEM_API TraceZone : NonCopyable
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a zone that lasts until the object is destroyed
+    ///
+    /// \param name Name of the zone (not copied)
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit TraceZone(const char* name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Closes the zone.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TraceZone();
+};
+
+} // namespace sf
+
+
+#endif // SFML_TRACE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::Trace
+/// \ingroup system
+///
+/// sf::Trace records a timeline of what each thread is doing,
+/// for offline analysis of frame timings: nested zones (begin
+/// and end of a named section of code), counters and thread
+/// names. The timeline can be written at any time to a JSON
+/// file, in the format understood by chrome://tracing and
+/// Perfetto.
+///
+/// Each thread writes into its own buffer, so recording an
+/// event never takes a lock nor waits for another thread; a
+/// mutex is only involved the first time a given thread
+/// records something, to register its buffer.
+///
+/// The class is usually not used directly but through the
+/// SFML_TRACE_* macros, which compile to nothing unless
+/// SFML_ENABLE_TRACE is defined. Parts of SFML itself (drawing,
+/// texture loading, audio streaming and sockets) are
+/// instrumented with these macros.
+///
+/// Usage example:
+/// \code
+/// void Game::update()
+/// {
+///     SFML_TRACE_ZONE("Game::update"); // closed at the end of the function
+///
+///     ...
+///     SFML_TRACE_COUNTER("Entities", entities.size());
+/// }
+///
+/// // Later, on demand or at exit
+/// SFML_TRACE_DUMP("trace.json");
+/// \endcode
+///
+/// \see sf::TraceZone
+///
+////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 #include <SFML/System/Sleep.hpp>
 #include <SFML/System/Err.hpp>
 #include <SFML/System/Lock.hpp>
+#include <SFML/System/Trace.hpp>
 
 #ifdef _MSC_VER
     #pragma warning(disable: 4355) // 'this' used in base member initializer list
@@ -290,6 +291,8 @@ void SoundStream::setProcessingInterval(Time interval)
 ////////////////////////////////////////////////////////////
 void SoundStream::streamData()
 {
+    SFML_TRACE_THREAD_NAME("sf::SoundStream");
+
     bool requestStop = false;
 
     {
@@ -352,6 +355,8 @@ void SoundStream::streamData()
 
         while (nbProcessed--)
         {
+            SFML_TRACE_ZONE("SoundStream::streamData");
+
             // Pop the first unused buffer from the queue
             ALuint buffer;
             alCheck(alSourceUnqueueBuffers(m_source, 1, &buffer));
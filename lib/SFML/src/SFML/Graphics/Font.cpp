@@ -27,17 +27,25 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
 #ifdef SFML_SYSTEM_ANDROID
     #include <SFML/System/Android/ResourceStream.hpp>
 #endif
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
 #include FT_STROKER_H
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
@@ -78,20 +86,509 @@ namespace
     {
         return (static_cast<sf::Uint64>(reinterpret<sf::Uint32>(outlineThickness)) << 32) | (static_cast<sf::Uint64>(bold) << 31) | index;
     }
+
+    // Combine boldness and two code points (21 bits each) into a single 64-bit key
+    sf::Uint64 combinePair(bool bold, sf::Uint32 first, sf::Uint32 second)
+    {
+        return (static_cast<sf::Uint64>(bold) << 42) | (static_cast<sf::Uint64>(first) << 21) | second;
+    }
+
+    // Mix the bits of a key, so that close keys land in distant slots (MurmurHash3 finalizer)
+    std::size_t hashKey(sf::Uint64 key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return static_cast<std::size_t>(key);
+    }
+
+    // Shrink an atlas region to the glyph it holds, without its padding
+    sf::IntRect removePadding(const sf::IntRect& rect, unsigned int padding)
+    {
+        const int offset = static_cast<int>(padding);
+        return sf::IntRect(rect.left + offset, rect.top + offset, rect.width - 2 * offset, rect.height - 2 * offset);
+    }
+
+    // Squared distance transform of one line of a grid, in place (Felzenszwalb and Huttenlocher):
+    // each cell gets the smallest squared distance plus value of all the cells of the line
+    void transformLine(std::vector<float>& grid, std::size_t offset, std::size_t stride, std::size_t length,
+                       std::vector<float>& values, std::vector<std::size_t>& parabolas, std::vector<float>& bounds)
+    {
+        const float infinity = 1e20f;
+
+        for (std::size_t q = 0; q < length; ++q)
+            values[q] = grid[offset + q * stride];
+
+        // Lower envelope of the parabolas rooted at each cell
+        std::size_t k = 0;
+        parabolas[0] = 0;
+        bounds[0] = -infinity;
+        bounds[1] = infinity;
+        for (std::size_t q = 1; q < length; ++q)
+        {
+            const float fq = static_cast<float>(q);
+            float s;
+            for (;;)
+            {
+                const float r = static_cast<float>(parabolas[k]);
+                s = ((values[q] + fq * fq) - (values[parabolas[k]] + r * r)) / (2.f * fq - 2.f * r);
+                if ((s > bounds[k]) || (k == 0))
+                    break;
+                --k;
+            }
+
+            ++k;
+            parabolas[k] = q;
+            bounds[k] = s;
+            bounds[k + 1] = infinity;
+        }
+
+        k = 0;
+        for (std::size_t q = 0; q < length; ++q)
+        {
+            while (bounds[k + 1] < static_cast<float>(q))
+                ++k;
+
+            const float d = static_cast<float>(q) - static_cast<float>(parabolas[k]);
+            grid[offset + q * stride] = d * d + values[parabolas[k]];
+        }
+    }
+
+    // Squared Euclidean distance transform of a whole grid, columns then rows
+    void transformGrid(std::vector<float>& grid, std::size_t width, std::size_t height)
+    {
+        const std::size_t length = std::max(width, height);
+        std::vector<float> values(length);
+        std::vector<std::size_t> parabolas(length);
+        std::vector<float> bounds(length + 1);
+
+        for (std::size_t x = 0; x < width; ++x)
+            transformLine(grid, x, width, height, values, parabolas, bounds);
+        for (std::size_t y = 0; y < height; ++y)
+            transformLine(grid, y * width, 1, width, values, parabolas, bounds);
+    }
+
+    // Replace the coverage stored in the alpha channel of RGBA pixels by the signed
+    // distance to the glyph outline: 0.5 on it, 1 at spread pixels inside, 0 at spread outside
+    void computeDistanceField(std::vector<sf::Uint8>& pixels, unsigned int width, unsigned int height, unsigned int spread)
+    {
+        const float infinity = 1e20f;
+        const std::size_t count = static_cast<std::size_t>(width) * height;
+
+        // Partially covered pixels start at their sub-pixel distance to the outline
+        std::vector<float> outer(count);
+        std::vector<float> inner(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float coverage = static_cast<float>(pixels[i * 4 + 3]) / 255.f;
+            if (coverage >= 1.f)
+            {
+                outer[i] = 0.f;
+                inner[i] = infinity;
+            }
+            else if (coverage <= 0.f)
+            {
+                outer[i] = infinity;
+                inner[i] = 0.f;
+            }
+            else
+            {
+                const float outside = std::max(0.f, 0.5f - coverage);
+                const float inside = std::max(0.f, coverage - 0.5f);
+                outer[i] = outside * outside;
+                inner[i] = inside * inside;
+            }
+        }
+
+        transformGrid(outer, width, height);
+        transformGrid(inner, width, height);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float distance = std::sqrt(outer[i]) - std::sqrt(inner[i]);
+            const float value = 0.5f - distance / (2.f * static_cast<float>(spread));
+            pixels[i * 4 + 3] = static_cast<sf::Uint8>(std::min(std::max(value, 0.f), 1.f) * 255.f + 0.5f);
+        }
+    }
+
+    // Leave a small padding around glyphs, so that filtering doesn't pollute them
+    // with pixels from neighbors; distance fields extend over their whole spread instead
+    unsigned int glyphPadding(bool distanceField)
+    {
+        return distanceField ? sf::Font::DistanceFieldSpread : 2;
+    }
+
+    // Load a glyph of a face at the current size of the face, and rasterize it into white pixels
+    // whose alpha channel holds the coverage (or the distance field), with padding transparent
+    // pixels around them; width and height remain 0 if the glyph has no pixels, like a space.
+    // Returns false if FreeType failed to load the glyph
+    bool rasterizeGlyph(FT_Library library, FT_Face face, FT_Stroker stroker, sf::Uint32 codePoint, bool bold, float outlineThickness,
+                        bool distanceField, sf::Glyph& glyph, std::vector<sf::Uint8>& buffer, unsigned int& width, unsigned int& height)
+    {
+        width = 0;
+        height = 0;
+
+        // Load the glyph corresponding to the code point
+        FT_Int32 flags = FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT;
+        if (outlineThickness != 0)
+            flags |= FT_LOAD_NO_BITMAP;
+        if (FT_Load_Char(face, codePoint, flags) != 0)
+            return false;
+
+        // Retrieve the glyph
+        FT_Glyph glyphDesc;
+        if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
+            return false;
+
+        // Apply bold and outline (there is no fallback for outline) if necessary -- first technique using outline (highest quality)
+        FT_Pos weight = 1 << 6;
+        bool outline = (glyphDesc->format == FT_GLYPH_FORMAT_OUTLINE);
+        if (outline)
+        {
+            if (bold)
+            {
+                FT_OutlineGlyph outlineGlyph = reinterpret_cast<FT_OutlineGlyph>(glyphDesc);
+                FT_Outline_Embolden(&outlineGlyph->outline, weight);
+            }
+
+            if (outlineThickness != 0)
+            {
+                FT_Stroker_Set(stroker, static_cast<FT_Fixed>(outlineThickness * static_cast<float>(1 << 6)), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+                FT_Glyph_Stroke(&glyphDesc, stroker, true);
+            }
+        }
+
+        // Convert the glyph to a bitmap (i.e. rasterize it)
+        // Warning! After this line, do not read any data from glyphDesc directly, use
+        // bitmapGlyph.root to access the FT_Glyph data.
+        FT_Glyph_To_Bitmap(&glyphDesc, FT_RENDER_MODE_NORMAL, 0, 1);
+        FT_BitmapGlyph bitmapGlyph = reinterpret_cast<FT_BitmapGlyph>(glyphDesc);
+        FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+
+        // Apply bold if necessary -- fallback technique using bitmap (lower quality)
+        if (!outline)
+        {
+            if (bold)
+                FT_Bitmap_Embolden(library, &bitmap, weight, weight);
+
+            if (outlineThickness != 0)
+                sf::err() << "Failed to outline glyph (no fallback available)" << std::endl;
+        }
+
+        // Compute the glyph's advance offset
+        glyph.advance = static_cast<float>(bitmapGlyph->root.advance.x >> 16);
+        if (bold)
+            glyph.advance += static_cast<float>(weight) / static_cast<float>(1 << 6);
+
+        glyph.lsbDelta = static_cast<int>(face->glyph->lsb_delta);
+        glyph.rsbDelta = static_cast<int>(face->glyph->rsb_delta);
+
+        if ((bitmap.width > 0) && (bitmap.rows > 0))
+        {
+            const unsigned int padding = glyphPadding(distanceField);
+
+            width = bitmap.width + 2 * padding;
+            height = bitmap.rows + 2 * padding;
+
+            // Compute the glyph's bounding box
+            glyph.bounds.left   = static_cast<float>( bitmapGlyph->left);
+            glyph.bounds.top    = static_cast<float>(-bitmapGlyph->top);
+            glyph.bounds.width  = static_cast<float>( bitmap.width);
+            glyph.bounds.height = static_cast<float>( bitmap.rows);
+
+            // Resize the pixel buffer to the new size and fill it with transparent white pixels
+            buffer.resize(width * height * 4);
+
+            sf::Uint8* current = &buffer[0];
+            sf::Uint8* end = current + width * height * 4;
+
+            while (current != end)
+            {
+                (*current++) = 255;
+                (*current++) = 255;
+                (*current++) = 255;
+                (*current++) = 0;
+            }
+
+            // Extract the glyph's pixels from the bitmap
+            const sf::Uint8* pixels = bitmap.buffer;
+            if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+            {
+                // Pixels are 1 bit monochrome values
+                for (unsigned int y = padding; y < height - padding; ++y)
+                {
+                    for (unsigned int x = padding; x < width - padding; ++x)
+                    {
+                        // The color channels remain white, just fill the alpha channel
+                        std::size_t index = x + y * width;
+                        buffer[index * 4 + 3] = ((pixels[(x - padding) / 8]) & (1 << (7 - ((x - padding) % 8)))) ? 255 : 0;
+                    }
+                    pixels += bitmap.pitch;
+                }
+            }
+            else
+            {
+                // Pixels are 8 bits gray levels
+                for (unsigned int y = padding; y < height - padding; ++y)
+                {
+                    for (unsigned int x = padding; x < width - padding; ++x)
+                    {
+                        // The color channels remain white, just fill the alpha channel
+                        std::size_t index = x + y * width;
+                        buffer[index * 4 + 3] = pixels[x - padding];
+                    }
+                    pixels += bitmap.pitch;
+                }
+            }
+
+            if (distanceField)
+                computeDistanceField(buffer, width, height, padding);
+        }
+
+        // Delete the FT glyph
+        FT_Done_Glyph(glyphDesc);
+
+        return true;
+    }
+
+    // Fragment shader drawing distance field glyphs: the vertex color fills the
+    // glyph, the outline and the glow surround it, all antialiased over a screen pixel
+    const char* distanceFieldShader =
+        "uniform sampler2D texture;\n"
+        "uniform float outlineWidth;\n"
+        "uniform vec4 outlineColor;\n"
+        "uniform float glowWidth;\n"
+        "uniform vec4 glowColor;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    float distance = texture2D(texture, gl_TexCoord[0].xy).a;\n"
+        "    float smoothing = max(fwidth(distance) * 0.5, 0.001);\n"
+        "    float edge = 0.5 - outlineWidth;\n"
+        "\n"
+        "    float fill = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);\n"
+        "    vec4 color = mix(outlineColor, gl_Color, fill);\n"
+        "    color.a *= smoothstep(edge - smoothing, edge + smoothing, distance);\n"
+        "\n"
+        "    float glow = glowWidth > 0.0 ? glowColor.a * smoothstep(edge - glowWidth, edge, distance) : 0.0;\n"
+        "    float alpha = color.a + glow * (1.0 - color.a);\n"
+        "    vec3 rgb = color.rgb * color.a + glowColor.rgb * glow * (1.0 - color.a);\n"
+        "    gl_FragColor = vec4(rgb / max(alpha, 0.001), alpha);\n"
+        "}\n";
 }
 
 
 namespace sf
 {
+////////////////////////////////////////////////////////////
+// Static member data
+////////////////////////////////////////////////////////////
+const unsigned int Font::DistanceFieldSize;
+const unsigned int Font::DistanceFieldSpread;
+
+
+////////////////////////////////////////////////////////////
+class Font::GlyphLoader : private NonCopyable
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    struct Request
+    {
+        Request(Uint32 theCodePoint, unsigned int theCharacterSize, bool theBold, float theOutlineThickness, bool theDistanceField) :
+        codePoint       (theCodePoint),
+        characterSize   (theCharacterSize),
+        bold            (theBold),
+        outlineThickness(theOutlineThickness),
+        distanceField   (theDistanceField)
+        {
+        }
+
+        bool operator ==(const Request& right) const
+        {
+            return (codePoint == right.codePoint) && (characterSize == right.characterSize) && (bold == right.bold) &&
+                   (outlineThickness == right.outlineThickness) && (distanceField == right.distanceField);
+        }
+
+        Uint32       codePoint;
+        unsigned int characterSize;
+        bool         bold;
+        float        outlineThickness;
+        bool         distanceField;
+    };
+
+    ////////////////////////////////////////////////////////////
+    struct Result
+    {
+        explicit Result(const Request& theRequest) :
+        request(theRequest),
+        glyph  (),
+        width  (0),
+        height (0),
+        pixels ()
+        {
+        }
+
+        Request            request;
+        Glyph              glyph;
+        unsigned int       width;
+        unsigned int       height;
+        std::vector<Uint8> pixels;
+    };
+
+    ////////////////////////////////////////////////////////////
+    GlyphLoader(const std::string& fileName, const void* fileData, std::size_t fileSize) :
+    m_fileName (fileName),
+    m_fileData (fileData),
+    m_fileSize (fileSize),
+    m_running  (0),
+    m_cancelled(false)
+    {
+        for (std::size_t i = 0; i < ThreadCount; ++i)
+            m_threads.push_back(new Thread(&GlyphLoader::run, this));
+    }
+
+    ////////////////////////////////////////////////////////////
+    ~GlyphLoader()
+    {
+        {
+            Lock lock(m_mutex);
+            m_cancelled = true;
+        }
+
+        // Destroying the threads waits for them to finish their current glyph
+        for (std::size_t i = 0; i < m_threads.size(); ++i)
+            delete m_threads[i];
+    }
+
+    ////////////////////////////////////////////////////////////
+    void add(const std::vector<Request>& requests)
+    {
+        {
+            Lock lock(m_mutex);
+            m_requests.insert(m_requests.end(), requests.begin(), requests.end());
+
+            // Threads still running will take the new requests too
+            if (m_running > 0)
+                return;
+
+            m_running = ThreadCount;
+        }
+
+        for (std::size_t i = 0; i < m_threads.size(); ++i)
+            m_threads[i]->launch();
+    }
+
+    ////////////////////////////////////////////////////////////
+    void cancel(const Request& request)
+    {
+        Lock lock(m_mutex);
+
+        std::deque<Request>::iterator it = std::find(m_requests.begin(), m_requests.end(), request);
+        if (it != m_requests.end())
+            m_requests.erase(it);
+    }
+
+    ////////////////////////////////////////////////////////////
+    bool takeResults(std::vector<Result>& results)
+    {
+        Lock lock(m_mutex);
+
+        results.swap(m_results);
+        m_results.clear();
+
+        // Once the threads have stopped, no other result will come
+        return m_running == 0;
+    }
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    void run()
+    {
+        // FreeType objects cannot be shared between threads: each thread opens the font again
+        FT_Library library = NULL;
+        FT_Face    face    = NULL;
+        FT_Stroker stroker = NULL;
+
+        bool opened = (FT_Init_FreeType(&library) == 0);
+        if (opened && m_fileName.empty())
+            opened = (FT_New_Memory_Face(library, static_cast<const FT_Byte*>(m_fileData), static_cast<FT_Long>(m_fileSize), 0, &face) == 0);
+        else if (opened)
+            opened = (FT_New_Face(library, m_fileName.c_str(), 0, &face) == 0);
+        opened = opened && (FT_Select_Charmap(face, FT_ENCODING_UNICODE) == 0) && (FT_Stroker_New(library, &stroker) == 0);
+
+        Request request(0, 0, false, 0, false);
+        for (;;)
+        {
+            {
+                Lock lock(m_mutex);
+
+                // Requests left by a thread that failed to open the font are loaded on demand
+                if (m_cancelled || m_requests.empty() || !opened)
+                {
+                    --m_running;
+                    break;
+                }
+
+                request = m_requests.front();
+                m_requests.pop_front();
+            }
+
+            Result result(request);
+            if ((FT_Set_Pixel_Sizes(face, 0, request.characterSize) == 0) &&
+                rasterizeGlyph(library, face, stroker, request.codePoint, request.bold, request.outlineThickness,
+                               request.distanceField, result.glyph, result.pixels, result.width, result.height))
+            {
+                Lock lock(m_mutex);
+                m_results.push_back(result);
+            }
+        }
+
+        if (stroker)
+            FT_Stroker_Done(stroker);
+        if (face)
+            FT_Done_Face(face);
+        if (library)
+            FT_Done_FreeType(library);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Static member data
+    ////////////////////////////////////////////////////////////
+    static const std::size_t ThreadCount = 2; //!< Rasterizing is quick: two threads keep up without competing much with the application
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::string          m_fileName;  //!< File to open the font from, empty to use m_fileData
+    const void*          m_fileData;  //!< Memory to open the font from
+    std::size_t          m_fileSize;  //!< Size of m_fileData
+    std::vector<Thread*> m_threads;   //!< Threads rasterizing the glyphs
+    Mutex                m_mutex;     //!< Mutex protecting the members below
+    std::deque<Request>  m_requests;  //!< Glyphs waiting for a thread
+    std::vector<Result>  m_results;   //!< Glyphs rasterized, waiting for Font::addPreloadedGlyphs
+    std::size_t          m_running;   //!< Number of threads running
+    bool                 m_cancelled; //!< Stop the threads?
+};
+
+
 ////////////////////////////////////////////////////////////
 Font::Font() :
-m_library  (NULL),
-m_face     (NULL),
-m_streamRec(NULL),
-m_stroker  (NULL),
-m_refCount (NULL),
-m_isSmooth (true),
-m_info     ()
+m_library            (NULL),
+m_face               (NULL),
+m_streamRec          (NULL),
+m_stroker            (NULL),
+m_refCount           (NULL),
+m_isSmooth           (true),
+m_info               (),
+m_distanceFieldShader(NULL),
+m_distanceFieldStyle (),
+m_fileData           (NULL),
+m_fileSize           (0),
+m_glyphLoader        (NULL)
 {
     #ifdef SFML_SYSTEM_ANDROID
         m_stream = NULL;
@@ -101,15 +598,22 @@ m_info     ()
 
 ////////////////////////////////////////////////////////////
 Font::Font(const Font& copy) :
-m_library    (copy.m_library),
-m_face       (copy.m_face),
-m_streamRec  (copy.m_streamRec),
-m_stroker    (copy.m_stroker),
-m_refCount   (copy.m_refCount),
-m_isSmooth   (copy.m_isSmooth),
-m_info       (copy.m_info),
-m_pages      (copy.m_pages),
-m_pixelBuffer(copy.m_pixelBuffer)
+m_library            (copy.m_library),
+m_face               (copy.m_face),
+m_streamRec          (copy.m_streamRec),
+m_stroker            (copy.m_stroker),
+m_refCount           (copy.m_refCount),
+m_isSmooth           (copy.m_isSmooth),
+m_info               (copy.m_info),
+m_pages              (copy.m_pages),
+m_distanceFieldPages (copy.m_distanceFieldPages),
+m_distanceFieldShader(NULL),
+m_distanceFieldStyle (),
+m_pixelBuffer        (copy.m_pixelBuffer),
+m_fileName           (copy.m_fileName),
+m_fileData           (copy.m_fileData),
+m_fileSize           (copy.m_fileSize),
+m_glyphLoader        (NULL)
 {
     #ifdef SFML_SYSTEM_ANDROID
         m_stream = NULL;
@@ -128,6 +632,8 @@ Font::~Font()
 {
     cleanup();
 
+    delete m_distanceFieldShader;
+
     #ifdef SFML_SYSTEM_ANDROID
 
     if (m_stream)
@@ -190,6 +696,9 @@ bool Font::loadFromFile(const std::string& filename)
     // Store the font information
     m_info.family = face->family_name ? face->family_name : std::string();
 
+    // Remember the file, for the preloading threads
+    m_fileName = filename;
+
     return true;
 
     #else
@@ -255,6 +764,10 @@ bool Font::loadFromMemory(const void* data, std::size_t sizeInBytes)
     // Store the font information
     m_info.family = face->family_name ? face->family_name : std::string();
 
+    // Remember the memory, for the preloading threads
+    m_fileData = data;
+    m_fileSize = sizeInBytes;
+
     return true;
 }
 
@@ -347,73 +860,43 @@ const Font::Info& Font::getInfo() const
 ////////////////////////////////////////////////////////////
 const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
 {
-    // Get the page corresponding to the character size
-    GlyphTable& glyphs = loadPage(characterSize).glyphs;
-
-    // Build the key by combining the glyph index (based on code point), bold flag, and outline thickness
-    Uint64 key = combine(outlineThickness, bold, FT_Get_Char_Index(static_cast<FT_Face>(m_face), codePoint));
-
-    // Search the glyph into the cache
-    GlyphTable::const_iterator it = glyphs.find(key);
-    if (it != glyphs.end())
-    {
-        // Found: just return it
-        return it->second;
-    }
-    else
-    {
-        // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold, outlineThickness);
-        return glyphs.insert(std::make_pair(key, glyph)).first->second;
-    }
+    return findGlyph(loadPage(characterSize), codePoint, characterSize, bold, outlineThickness, false);
 }
 
 
 ////////////////////////////////////////////////////////////
-bool Font::hasGlyph(Uint32 codePoint) const
+const Glyph& Font::getDistanceFieldGlyph(Uint32 codePoint, bool bold) const
 {
-    return FT_Get_Char_Index(static_cast<FT_Face>(m_face), codePoint) != 0;
+    return findGlyph(loadDistanceFieldPage(), codePoint, DistanceFieldSize, bold, 0, true);
 }
 
 
 ////////////////////////////////////////////////////////////
-float Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize, bool bold) const
+float Font::getDistanceFieldKerning(Uint32 first, Uint32 second, bool bold) const
 {
     // Special case where first or second is 0 (null character)
     if (first == 0 || second == 0)
         return 0.f;
 
-    FT_Face face = static_cast<FT_Face>(m_face);
-
-    if (face && setCurrentSize(characterSize))
-    {
-        // Convert the characters to indices
-        FT_UInt index1 = FT_Get_Char_Index(face, first);
-        FT_UInt index2 = FT_Get_Char_Index(face, second);
+    return getKerning(loadDistanceFieldPage(), first, second, DistanceFieldSize, bold, true);
+}
 
-        // Retrieve position compensation deltas generated by FT_LOAD_FORCE_AUTOHINT flag
-        float firstRsbDelta = static_cast<float>(getGlyph(first, characterSize, bold).rsbDelta);
-        float secondLsbDelta = static_cast<float>(getGlyph(second, characterSize, bold).lsbDelta);
 
-        // Get the kerning vector if present
-        FT_Vector kerning;
-        kerning.x = kerning.y = 0;
-        if (FT_HAS_KERNING(face))
-            FT_Get_Kerning(face, index1, index2, FT_KERNING_UNFITTED, &kerning);
+////////////////////////////////////////////////////////////
+bool Font::hasGlyph(Uint32 codePoint) const
+{
+    return FT_Get_Char_Index(static_cast<FT_Face>(m_face), codePoint) != 0;
+}
 
-        // X advance is already in pixels for bitmap fonts
-        if (!FT_IS_SCALABLE(face))
-            return static_cast<float>(kerning.x);
 
-        // Combine kerning with compensation deltas and return the X advance
-        // Flooring is required as we use FT_KERNING_UNFITTED flag which is not quantized in 64 based grid
-        return std::floor((secondLsbDelta - firstRsbDelta + static_cast<float>(kerning.x) + 32) / static_cast<float>(1 << 6));
-    }
-    else
-    {
-        // Invalid font
+////////////////////////////////////////////////////////////
+float Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize, bool bold) const
+{
+    // Special case where first or second is 0 (null character)
+    if (first == 0 || second == 0)
         return 0.f;
-    }
+
+    return getKerning(loadPage(characterSize), first, second, characterSize, bold, false);
 }
 
 
@@ -476,7 +959,42 @@ float Font::getUnderlineThickness(unsigned int characterSize) const
 ////////////////////////////////////////////////////////////
 const Texture& Font::getTexture(unsigned int characterSize) const
 {
-    return loadPage(characterSize).texture;
+    addPreloadedGlyphs();
+
+    return loadPage(characterSize).atlas.getTexture();
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& Font::getDistanceFieldTexture() const
+{
+    addPreloadedGlyphs();
+
+    return loadDistanceFieldPage().atlas.getTexture();
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::preload(const String& characters, const std::vector<unsigned int>& characterSizes, bool bold, float outlineThickness)
+{
+    for (std::size_t i = 0; i < characterSizes.size(); ++i)
+        preloadPage(characters, characterSizes[i], bold, outlineThickness, false);
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::preloadDistanceField(const String& characters, bool bold)
+{
+    preloadPage(characters, DistanceFieldSize, bold, 0, true);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isPreloading() const
+{
+    addPreloadedGlyphs();
+
+    return m_glyphLoader != NULL;
 }
 
 ////////////////////////////////////////////////////////////
@@ -488,7 +1006,7 @@ void Font::setSmooth(bool smooth)
 
         for (sf::Font::PageTable::iterator page = m_pages.begin(); page != m_pages.end(); ++page)
         {
-            page->second.texture.setSmooth(m_isSmooth);
+            page->second.atlas.setSmooth(m_isSmooth);
         }
     }
 }
@@ -500,20 +1018,41 @@ bool Font::isSmooth() const
 }
 
 
+////////////////////////////////////////////////////////////
+void Font::convertToDistanceField(Image& image, unsigned int spread)
+{
+    const Vector2u size = image.getSize();
+    if ((size.x == 0) || (size.y == 0) || (spread == 0))
+        return;
+
+    const Uint8* pixels = image.getPixelsPtr();
+    std::vector<Uint8> buffer(pixels, pixels + size.x * size.y * 4);
+    computeDistanceField(buffer, size.x, size.y, spread);
+    image.create(size.x, size.y, &buffer[0]);
+}
+
+
 ////////////////////////////////////////////////////////////
 Font& Font::operator =(const Font& right)
 {
     Font temp(right);
 
-    std::swap(m_library,     temp.m_library);
-    std::swap(m_face,        temp.m_face);
-    std::swap(m_streamRec,   temp.m_streamRec);
-    std::swap(m_stroker,     temp.m_stroker);
-    std::swap(m_refCount,    temp.m_refCount);
-    std::swap(m_isSmooth,    temp.m_isSmooth);
-    std::swap(m_info,        temp.m_info);
-    std::swap(m_pages,       temp.m_pages);
-    std::swap(m_pixelBuffer, temp.m_pixelBuffer);
+    std::swap(m_library,             temp.m_library);
+    std::swap(m_face,                temp.m_face);
+    std::swap(m_streamRec,           temp.m_streamRec);
+    std::swap(m_stroker,             temp.m_stroker);
+    std::swap(m_refCount,            temp.m_refCount);
+    std::swap(m_isSmooth,            temp.m_isSmooth);
+    std::swap(m_info,                temp.m_info);
+    std::swap(m_pages,               temp.m_pages);
+    std::swap(m_distanceFieldPages,  temp.m_distanceFieldPages);
+    std::swap(m_distanceFieldShader, temp.m_distanceFieldShader);
+    std::swap(m_distanceFieldStyle,  temp.m_distanceFieldStyle);
+    std::swap(m_pixelBuffer,         temp.m_pixelBuffer);
+    std::swap(m_fileName,            temp.m_fileName);
+    std::swap(m_fileData,            temp.m_fileData);
+    std::swap(m_fileSize,            temp.m_fileSize);
+    std::swap(m_glyphLoader,         temp.m_glyphLoader);
 
     #ifdef SFML_SYSTEM_ANDROID
         std::swap(m_stream, temp.m_stream);
@@ -526,6 +1065,10 @@ Font& Font::operator =(const Font& right)
 ////////////////////////////////////////////////////////////
 void Font::cleanup()
 {
+    // Stop the preloading threads, which may be reading the font data
+    delete m_glyphLoader;
+    m_glyphLoader = NULL;
+
     // Check if we must destroy the FreeType pointers
     if (m_refCount)
     {
@@ -563,7 +1106,11 @@ void Font::cleanup()
     m_streamRec = NULL;
     m_refCount  = NULL;
     m_pages.clear();
+    m_distanceFieldPages.clear();
     std::vector<Uint8>().swap(m_pixelBuffer);
+    m_fileName.clear();
+    m_fileData = NULL;
+    m_fileSize = 0;
 }
 
 
@@ -580,235 +1127,231 @@ Font::Page& Font::loadPage(unsigned int characterSize) const
 
 
 ////////////////////////////////////////////////////////////
-Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
+Font::Page& Font::loadDistanceFieldPage() const
 {
-    // The glyph to return
-    Glyph glyph;
+    // Distance fields need bilinear filtering, whatever the smooth setting of the font
+    PageTable::iterator pageIterator = m_distanceFieldPages.find(DistanceFieldSize);
+    if (pageIterator == m_distanceFieldPages.end())
+        pageIterator = m_distanceFieldPages.insert(std::make_pair(DistanceFieldSize, Page(true))).first;
 
-    // First, transform our ugly void* to a FT_Face
-    FT_Face face = static_cast<FT_Face>(m_face);
-    if (!face)
-        return glyph;
+    return pageIterator->second;
+}
 
-    // Set the character size
-    if (!setCurrentSize(characterSize))
-        return glyph;
 
-    // Load the glyph corresponding to the code point
-    FT_Int32 flags = FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT;
-    if (outlineThickness != 0)
-        flags |= FT_LOAD_NO_BITMAP;
-    if (FT_Load_Char(face, codePoint, flags) != 0)
-        return glyph;
+////////////////////////////////////////////////////////////
+const Glyph& Font::findGlyph(Page& page, Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, bool distanceField) const
+{
+    // ASCII glyphs without outline, the bulk of most texts, skip
+    // both the character map of the face and the hash table
+    Uint32* asciiGlyph = NULL;
+    if ((codePoint < 128) && (outlineThickness == 0))
+    {
+        asciiGlyph = &page.asciiGlyphs[bold ? codePoint + 128 : codePoint];
+        if (*asciiGlyph != 0)
+            return page.glyphs[*asciiGlyph - 1];
+    }
 
-    // Retrieve the glyph
-    FT_Glyph glyphDesc;
-    if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
-        return glyph;
+    // Build the key by combining the glyph index (based on code point), bold flag, and outline thickness
+    Uint64 key = combine(outlineThickness, bold, FT_Get_Char_Index(static_cast<FT_Face>(m_face), codePoint));
 
-    // Apply bold and outline (there is no fallback for outline) if necessary -- first technique using outline (highest quality)
-    FT_Pos weight = 1 << 6;
-    bool outline = (glyphDesc->format == FT_GLYPH_FORMAT_OUTLINE);
-    if (outline)
+    // Search the glyph into the cache
+    Uint32 index;
+    if (!page.glyphTable.find(key, index))
     {
-        if (bold)
-        {
-            FT_OutlineGlyph outlineGlyph = reinterpret_cast<FT_OutlineGlyph>(glyphDesc);
-            FT_Outline_Embolden(&outlineGlyph->outline, weight);
-        }
+        // It may be among the preloaded glyphs that are ready
+        addPreloadedGlyphs();
 
-        if (outlineThickness != 0)
+        if (!page.glyphTable.find(key, index))
         {
-            FT_Stroker stroker = static_cast<FT_Stroker>(m_stroker);
-
-            FT_Stroker_Set(stroker, static_cast<FT_Fixed>(outlineThickness * static_cast<float>(1 << 6)), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
-            FT_Glyph_Stroke(&glyphDesc, stroker, true);
+            // Not there: load it now rather than waiting for a preloading thread
+            if (m_glyphLoader)
+                m_glyphLoader->cancel(GlyphLoader::Request(codePoint, characterSize, bold, outlineThickness, distanceField));
+
+            unsigned int width;
+            unsigned int height;
+            Glyph glyph = loadGlyph(codePoint, characterSize, bold, outlineThickness, distanceField, width, height);
+            index = addGlyph(page, key, glyph, (width > 0) ? &m_pixelBuffer[0] : NULL, width, height, glyphPadding(distanceField));
         }
     }
 
-    // Convert the glyph to a bitmap (i.e. rasterize it)
-    // Warning! After this line, do not read any data from glyphDesc directly, use
-    // bitmapGlyph.root to access the FT_Glyph data.
-    FT_Glyph_To_Bitmap(&glyphDesc, FT_RENDER_MODE_NORMAL, 0, 1);
-    FT_BitmapGlyph bitmapGlyph = reinterpret_cast<FT_BitmapGlyph>(glyphDesc);
-    FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+    if (asciiGlyph)
+        *asciiGlyph = index + 1;
 
-    // Apply bold if necessary -- fallback technique using bitmap (lower quality)
-    if (!outline)
-    {
-        if (bold)
-            FT_Bitmap_Embolden(static_cast<FT_Library>(m_library), &bitmap, weight, weight);
+    return page.glyphs[index];
+}
 
-        if (outlineThickness != 0)
-            err() << "Failed to outline glyph (no fallback available)" << std::endl;
-    }
 
-    // Compute the glyph's advance offset
-    glyph.advance = static_cast<float>(bitmapGlyph->root.advance.x >> 16);
-    if (bold)
-        glyph.advance += static_cast<float>(weight) / static_cast<float>(1 << 6);
+////////////////////////////////////////////////////////////
+float Font::getKerning(Page& page, Uint32 first, Uint32 second, unsigned int characterSize, bool bold, bool distanceField) const
+{
+    // Code points beyond the Unicode range don't fit in the key: don't cache them
+    const bool cached = (first <= 0x10FFFF) && (second <= 0x10FFFF);
+    const Uint64 key = combinePair(bold, first, second);
 
-    glyph.lsbDelta = static_cast<int>(face->glyph->lsb_delta);
-    glyph.rsbDelta = static_cast<int>(face->glyph->rsb_delta);
+    Uint32 index;
+    if (cached && page.kerningTable.find(key, index))
+        return page.kernings[index];
 
-    unsigned int width  = bitmap.width;
-    unsigned int height = bitmap.rows;
+    float result = 0.f;
+    FT_Face face = static_cast<FT_Face>(m_face);
 
-    if ((width > 0) && (height > 0))
+    if (face && setCurrentSize(characterSize))
     {
-        // Leave a small padding around characters, so that filtering doesn't
-        // pollute them with pixels from neighbors
-        const unsigned int padding = 2;
-
-        width += 2 * padding;
-        height += 2 * padding;
-
-        // Get the glyphs page corresponding to the character size
-        Page& page = loadPage(characterSize);
-
-        // Find a good position for the new glyph into the texture
-        glyph.textureRect = findGlyphRect(page, width, height);
-
-        // Make sure the texture data is positioned in the center
-        // of the allocated texture rectangle
-        glyph.textureRect.left   += static_cast<int>(padding);
-        glyph.textureRect.top    += static_cast<int>(padding);
-        glyph.textureRect.width  -= static_cast<int>(2 * padding);
-        glyph.textureRect.height -= static_cast<int>(2 * padding);
-
-        // Compute the glyph's bounding box
-        glyph.bounds.left   = static_cast<float>( bitmapGlyph->left);
-        glyph.bounds.top    = static_cast<float>(-bitmapGlyph->top);
-        glyph.bounds.width  = static_cast<float>( bitmap.width);
-        glyph.bounds.height = static_cast<float>( bitmap.rows);
-
-        // Resize the pixel buffer to the new size and fill it with transparent white pixels
-        m_pixelBuffer.resize(width * height * 4);
+        // Convert the characters to indices
+        FT_UInt index1 = FT_Get_Char_Index(face, first);
+        FT_UInt index2 = FT_Get_Char_Index(face, second);
 
-        Uint8* current = &m_pixelBuffer[0];
-        Uint8* end = current + width * height * 4;
+        // Retrieve position compensation deltas generated by FT_LOAD_FORCE_AUTOHINT flag
+        float firstRsbDelta = static_cast<float>(findGlyph(page, first, characterSize, bold, 0, distanceField).rsbDelta);
+        float secondLsbDelta = static_cast<float>(findGlyph(page, second, characterSize, bold, 0, distanceField).lsbDelta);
 
-        while (current != end)
-        {
-            (*current++) = 255;
-            (*current++) = 255;
-            (*current++) = 255;
-            (*current++) = 0;
-        }
+        // Get the kerning vector if present
+        FT_Vector kerning;
+        kerning.x = kerning.y = 0;
+        if (FT_HAS_KERNING(face))
+            FT_Get_Kerning(face, index1, index2, FT_KERNING_UNFITTED, &kerning);
 
-        // Extract the glyph's pixels from the bitmap
-        const Uint8* pixels = bitmap.buffer;
-        if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+        if (!FT_IS_SCALABLE(face))
         {
-            // Pixels are 1 bit monochrome values
-            for (unsigned int y = padding; y < height - padding; ++y)
-            {
-                for (unsigned int x = padding; x < width - padding; ++x)
-                {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = x + y * width;
-                    m_pixelBuffer[index * 4 + 3] = ((pixels[(x - padding) / 8]) & (1 << (7 - ((x - padding) % 8)))) ? 255 : 0;
-                }
-                pixels += bitmap.pitch;
-            }
+            // X advance is already in pixels for bitmap fonts
+            result = static_cast<float>(kerning.x);
         }
         else
         {
-            // Pixels are 8 bits gray levels
-            for (unsigned int y = padding; y < height - padding; ++y)
-            {
-                for (unsigned int x = padding; x < width - padding; ++x)
-                {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = x + y * width;
-                    m_pixelBuffer[index * 4 + 3] = pixels[x - padding];
-                }
-                pixels += bitmap.pitch;
-            }
+            // Combine kerning with compensation deltas and return the X advance
+            // Flooring is required as we use FT_KERNING_UNFITTED flag which is not quantized in 64 based grid
+            result = std::floor((secondLsbDelta - firstRsbDelta + static_cast<float>(kerning.x) + 32) / static_cast<float>(1 << 6));
         }
+    }
 
-        // Write the pixels to the texture
-        unsigned int x = static_cast<unsigned int>(glyph.textureRect.left) - padding;
-        unsigned int y = static_cast<unsigned int>(glyph.textureRect.top) - padding;
-        unsigned int w = static_cast<unsigned int>(glyph.textureRect.width) + 2 * padding;
-        unsigned int h = static_cast<unsigned int>(glyph.textureRect.height) + 2 * padding;
-        page.texture.update(&m_pixelBuffer[0], w, h, x, y);
+    if (cached)
+    {
+        page.kerningTable.insert(key, static_cast<Uint32>(page.kernings.size()));
+        page.kernings.push_back(result);
     }
 
-    // Delete the FT glyph
-    FT_Done_Glyph(glyphDesc);
+    return result;
+}
+
+
+////////////////////////////////////////////////////////////
+Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, bool distanceField, unsigned int& width, unsigned int& height) const
+{
+    // The glyph to return
+    Glyph glyph;
+    width = 0;
+    height = 0;
+
+    // First, transform our ugly void* to a FT_Face
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face)
+        return glyph;
+
+    // Set the character size
+    if (!setCurrentSize(characterSize))
+        return glyph;
+
+    // Rasterize the glyph into the pixel buffer
+    rasterizeGlyph(static_cast<FT_Library>(m_library), face, static_cast<FT_Stroker>(m_stroker), codePoint, bold, outlineThickness,
+                   distanceField, glyph, m_pixelBuffer, width, height);
 
-    // Done :)
     return glyph;
 }
 
 
 ////////////////////////////////////////////////////////////
-IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height) const
+Uint32 Font::addGlyph(Page& page, Uint64 key, Glyph glyph, const Uint8* pixels, unsigned int width, unsigned int height, unsigned int padding) const
 {
-    // Find the line that fits well the glyph
-    Row* row = NULL;
-    float bestRatio = 0;
-    for (std::vector<Row>::iterator it = page.rows.begin(); it != page.rows.end() && !row; ++it)
+    if (pixels)
     {
-        float ratio = static_cast<float>(height) / static_cast<float>(it->height);
+        // Add the pixels to the atlas of the page (glyphs are never
+        // removed, so growing the atlas doesn't move the other ones)
+        Uint32 region = page.atlas.add(pixels, width, height);
+        if (region != TextureAtlas::InvalidRegion)
+        {
+            // Make sure the texture data is positioned in the center
+            // of the allocated texture rectangle
+            glyph.textureRect = removePadding(page.atlas.getRect(region), padding);
+        }
+    }
 
-        // Ignore rows that are either too small or too high
-        if ((ratio < 0.7f) || (ratio > 1.f))
-            continue;
+    Uint32 index = static_cast<Uint32>(page.glyphs.size());
+    page.glyphs.push_back(glyph);
+    page.glyphTable.insert(key, index);
 
-        // Check if there's enough horizontal space left in the row
-        if (width > page.texture.getSize().x - it->width)
-            continue;
+    return index;
+}
 
-        // Make sure that this new row is the best found so far
-        if (ratio < bestRatio)
-            continue;
 
-        // The current row passed all the tests: we can select it
-        row = &*it;
-        bestRatio = ratio;
-    }
+////////////////////////////////////////////////////////////
+void Font::preloadPage(const String& characters, unsigned int characterSize, bool bold, float outlineThickness, bool distanceField)
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face || characters.isEmpty())
+        return;
+
+    Page& page = distanceField ? loadDistanceFieldPage() : loadPage(characterSize);
 
-    // If we didn't find a matching row, create a new one (10% taller than the glyph)
-    if (!row)
+    // Fonts loaded from a stream cannot be opened again by the threads: load the glyphs now
+    if (m_fileName.empty() && !m_fileData)
     {
-        unsigned int rowHeight = height + height / 10;
-        while ((page.nextRow + rowHeight >= page.texture.getSize().y) || (width >= page.texture.getSize().x))
-        {
-            // Not enough space: resize the texture if possible
-            unsigned int textureWidth  = page.texture.getSize().x;
-            unsigned int textureHeight = page.texture.getSize().y;
-            if ((textureWidth * 2 <= Texture::getMaximumSize()) && (textureHeight * 2 <= Texture::getMaximumSize()))
-            {
-                // Make the texture 2 times bigger
-                Texture newTexture;
-                newTexture.create(textureWidth * 2, textureHeight * 2);
-                newTexture.setSmooth(m_isSmooth);
-                newTexture.update(page.texture);
-                page.texture.swap(newTexture);
-            }
-            else
-            {
-                // Oops, we've reached the maximum texture size...
-                err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
-                return IntRect(0, 0, 2, 2);
-            }
-        }
+        for (String::ConstIterator it = characters.begin(); it != characters.end(); ++it)
+            findGlyph(page, *it, characterSize, bold, outlineThickness, distanceField);
+
+        return;
+    }
 
-        // We can now create the new row
-        page.rows.push_back(Row(page.nextRow, rowHeight));
-        page.nextRow += rowHeight;
-        row = &page.rows.back();
+    // Queue the glyphs that are not loaded yet
+    std::vector<GlyphLoader::Request> requests;
+    for (String::ConstIterator it = characters.begin(); it != characters.end(); ++it)
+    {
+        Uint32 index;
+        if (!page.glyphTable.find(combine(outlineThickness, bold, FT_Get_Char_Index(face, *it)), index))
+            requests.push_back(GlyphLoader::Request(*it, characterSize, bold, outlineThickness, distanceField));
     }
 
-    // Find the glyph's rectangle on the selected row
-    IntRect rect(Rect<unsigned int>(row->width, row->top, width, height));
+    if (requests.empty())
+        return;
+
+    if (!m_glyphLoader)
+        m_glyphLoader = new GlyphLoader(m_fileName, m_fileData, m_fileSize);
+
+    m_glyphLoader->add(requests);
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::addPreloadedGlyphs() const
+{
+    if (!m_glyphLoader)
+        return;
+
+    std::vector<GlyphLoader::Result> results;
+    const bool finished = m_glyphLoader->takeResults(results);
+
+    // Upload all the ready glyphs at once, rather than one per frame as texts need them
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const GlyphLoader::Result& result = results[i];
+        const GlyphLoader::Request& request = result.request;
+
+        Page& page = request.distanceField ? loadDistanceFieldPage() : loadPage(request.characterSize);
 
-    // Update the row informations
-    row->width += width;
+        // Skip the glyphs loaded on demand in the meantime
+        Uint64 key = combine(request.outlineThickness, request.bold, FT_Get_Char_Index(static_cast<FT_Face>(m_face), request.codePoint));
+        Uint32 index;
+        if (!page.glyphTable.find(key, index))
+        {
+            addGlyph(page, key, result.glyph, (result.width > 0) ? &result.pixels[0] : NULL,
+                     result.width, result.height, glyphPadding(request.distanceField));
+        }
+    }
 
-    return rect;
+    if (finished)
+    {
+        delete m_glyphLoader;
+        m_glyphLoader = NULL;
+    }
 }
 
 
@@ -854,21 +1397,124 @@ bool Font::setCurrentSize(unsigned int characterSize) const
 
 
 ////////////////////////////////////////////////////////////
-Font::Page::Page(bool smooth) :
-nextRow(3)
+Shader* Font::getDistanceFieldShader() const
 {
-    // Make sure that the texture is initialized by default
-    sf::Image image;
-    image.create(128, 128, Color(255, 255, 255, 0));
+    if (!m_distanceFieldShader && Shader::isAvailable())
+    {
+        // Keep the shader even if it failed to compile, not to try again on every draw
+        m_distanceFieldShader = new Shader;
+        if (m_distanceFieldShader->loadFromMemory(distanceFieldShader, Shader::Fragment))
+        {
+            m_distanceFieldShader->setUniform("texture", Shader::CurrentTexture);
+
+            // No outline can be narrower: the first style is always set
+            m_distanceFieldStyle.outlineWidth = -1.f;
+        }
+    }
+
+    if (!m_distanceFieldShader || !m_distanceFieldShader->getNativeHandle())
+        return NULL;
+
+    return m_distanceFieldShader;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::setDistanceFieldStyle(RenderTarget& target, const DistanceFieldStyle& style) const
+{
+    const DistanceFieldStyle& current = m_distanceFieldStyle;
+    if ((style.outlineWidth == current.outlineWidth) && (style.outlineColor == current.outlineColor) &&
+        (style.glowWidth == current.glowWidth) && (style.glowColor == current.glowColor))
+        return;
+
+    // The queued draws would take the new uniforms
+    target.flush();
+
+    m_distanceFieldShader->setUniform("outlineWidth", style.outlineWidth);
+    m_distanceFieldShader->setUniform("outlineColor", Glsl::Vec4(style.outlineColor));
+    m_distanceFieldShader->setUniform("glowWidth", style.glowWidth);
+    m_distanceFieldShader->setUniform("glowColor", Glsl::Vec4(style.glowColor));
+    m_distanceFieldStyle = style;
+}
+
+
+////////////////////////////////////////////////////////////
+Font::IndexTable::IndexTable() :
+keys (32),
+slots(32, 0),
+count(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::IndexTable::find(Uint64 key, Uint32& index) const
+{
+    const std::size_t mask = slots.size() - 1;
+
+    // Probe the slots following the one of the key, until an empty one
+    for (std::size_t i = hashKey(key) & mask; slots[i] != 0; i = (i + 1) & mask)
+    {
+        if (keys[i] == key)
+        {
+            index = slots[i] - 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::IndexTable::insert(Uint64 key, Uint32 index)
+{
+    // Keep the table at most half full, so that probe sequences remain short
+    if ((count + 1) * 2 > slots.size())
+    {
+        std::vector<Uint64> oldKeys(slots.size() * 2);
+        std::vector<Uint32> oldSlots(slots.size() * 2, 0);
+        keys.swap(oldKeys);
+        slots.swap(oldSlots);
+        count = 0;
+
+        for (std::size_t i = 0; i < oldSlots.size(); ++i)
+        {
+            if (oldSlots[i] != 0)
+                insert(oldKeys[i], oldSlots[i] - 1);
+        }
+    }
+
+    const std::size_t mask = slots.size() - 1;
+
+    std::size_t i = hashKey(key) & mask;
+    while (slots[i] != 0)
+        i = (i + 1) & mask;
+
+    keys[i]  = key;
+    slots[i] = index + 1;
+    ++count;
+}
 
-    // Reserve a 2x2 white square for texturing underlines
-    for (unsigned int x = 0; x < 2; ++x)
-        for (unsigned int y = 0; y < 2; ++y)
-            image.setPixel(x, y, Color(255, 255, 255, 255));
 
-    // Create the texture
-    texture.loadFromImage(image);
-    texture.setSmooth(smooth);
+////////////////////////////////////////////////////////////
+Font::Page::Page(bool smooth)
+{
+    // No ASCII glyph is loaded yet
+    std::fill(asciiGlyphs, asciiGlyphs + 256, 0);
+
+    // Make sure that the texture is initialized by default
+    atlas.create(128, 128, Color(255, 255, 255, 0));
+    atlas.setSmooth(smooth);
+
+    // Reserve a 2x2 white square for texturing underlines; as the
+    // first region, it stays in the top-left corner when the atlas grows
+    const Uint8 white[2 * 2 * 4] =
+    {
+        255, 255, 255, 255,  255, 255, 255, 255,
+        255, 255, 255, 255,  255, 255, 255, 255
+    };
+    atlas.add(white, 2, 2);
 }
 
 } // namespace sf
@@ -0,0 +1,780 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/GLCoreRenderer.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Graphics/InstanceData.hpp>
+#include <SFML/Window/Context.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#ifndef SFML_OPENGL_ES
+
+namespace
+{
+    // A nested named namespace is used here to allow unity builds of SFML.
+    namespace GLCoreRendererImpl
+    {
+        // Vertex attribute locations of the built-in program, then the instance ones
+        enum {PositionAttribute, ColorAttribute, TexCoordsAttribute,
+              InstanceXAttribute, InstanceYAttribute, InstanceOriginAttribute, InstanceColorAttribute, InstanceRectAttribute};
+
+        // Where the instance attributes are in sf::InstanceData (sf::Transform
+        // is its 4x4 matrix: the 2D axes are columns 0 and 1, the origin column 3)
+        const std::size_t instanceXOffset = offsetof(sf::InstanceData, transform);
+        const std::size_t instanceYOffset = offsetof(sf::InstanceData, transform) + 4 * sizeof(float);
+        const std::size_t instanceOriginOffset = offsetof(sf::InstanceData, transform) + 12 * sizeof(float);
+        const std::size_t instanceColorOffset = offsetof(sf::InstanceData, color);
+        const std::size_t instanceRectOffset = offsetof(sf::InstanceData, textureRect);
+
+        // Initial size of the streaming buffer: 1 MB (about 50k vertices)
+        const std::size_t initialStreamSize = 1024 * 1024;
+
+        // GLSL 1.50 is the version of OpenGL 3.2, the first with core profiles
+        const char* vertexShader =
+            "#version 150\n"
+            "uniform mat4 sf_view;\n"
+            "uniform mat4 sf_model;\n"
+            "uniform mat4 sf_textureMatrix;\n"
+            "in vec2 sf_position;\n"
+            "in vec4 sf_color;\n"
+            "in vec2 sf_texCoords;\n"
+            "in vec2 sf_instanceX;\n"
+            "in vec2 sf_instanceY;\n"
+            "in vec2 sf_instanceOrigin;\n"
+            "in vec4 sf_instanceColor;\n"
+            "in vec4 sf_instanceRect;\n"
+            "out vec4 color;\n"
+            "out vec2 texCoords;\n"
+            "void main()\n"
+            "{\n"
+            "    vec2 position = sf_instanceX * sf_position.x + sf_instanceY * sf_position.y + sf_instanceOrigin;\n"
+            "    vec2 coords = sf_texCoords;\n"
+            "    if (sf_instanceRect.z != 0.0 || sf_instanceRect.w != 0.0)\n"
+            "        coords = sf_instanceRect.xy + sf_texCoords * sf_instanceRect.zw;\n"
+            "    gl_Position = sf_view * sf_model * vec4(position, 0.0, 1.0);\n"
+            "    color = sf_color * sf_instanceColor;\n"
+            "    texCoords = (sf_textureMatrix * vec4(coords, 0.0, 1.0)).xy;\n"
+            "}\n";
+
+        const char* fragmentShader =
+            "#version 150\n"
+            "uniform sampler2D sf_texture;\n"
+            "uniform bool sf_textured;\n"
+            "in vec4 color;\n"
+            "in vec2 texCoords;\n"
+            "out vec4 fragColor;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColor = sf_textured ? color * texture(sf_texture, texCoords) : color;\n"
+            "}\n";
+
+        const float identity[16] = {1.f, 0.f, 0.f, 0.f,
+                                    0.f, 1.f, 0.f, 0.f,
+                                    0.f, 0.f, 1.f, 0.f,
+                                    0.f, 0.f, 0.f, 1.f};
+
+        // Compile one stage of the built-in program, 0 on failure
+        GLuint compileShader(GLenum type, const char* source)
+        {
+            GLuint shader = glCreateShader(type);
+            glCheck(glShaderSource(shader, 1, &source, NULL));
+            glCheck(glCompileShader(shader));
+
+            GLint success = GL_FALSE;
+            glCheck(glGetShaderiv(shader, GL_COMPILE_STATUS, &success));
+            if (success == GL_FALSE)
+            {
+                char log[1024];
+                glCheck(glGetShaderInfoLog(shader, sizeof(log), NULL, log));
+                sf::err() << "Failed to compile the core profile shader:" << std::endl << log << std::endl;
+                glCheck(glDeleteShader(shader));
+                return 0;
+            }
+
+            return shader;
+        }
+
+        // OpenGL primitive type of an sf::PrimitiveType (quads are drawn as triangles)
+        GLenum primitiveMode(sf::PrimitiveType type)
+        {
+            static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
+                                           GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_TRIANGLES};
+            return modes[type];
+        }
+
+        // Number of vertices streamed for vertexCount vertices: quads become two triangles each
+        std::size_t streamedCount(std::size_t vertexCount, sf::PrimitiveType type)
+        {
+            return (type == sf::Quads) ? vertexCount / 4 * 6 : vertexCount;
+        }
+
+        // Copy vertices to the streaming buffer, quads as two triangles each
+        void streamVertices(sf::Vertex* out, const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type)
+        {
+            if (type == sf::Quads)
+            {
+                for (std::size_t i = 0; i + 3 < vertexCount; i += 4)
+                {
+                    *out++ = vertices[i];
+                    *out++ = vertices[i + 1];
+                    *out++ = vertices[i + 2];
+                    *out++ = vertices[i];
+                    *out++ = vertices[i + 2];
+                    *out++ = vertices[i + 3];
+                }
+            }
+            else
+            {
+                std::copy(vertices, vertices + vertexCount, out);
+            }
+        }
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+GLCoreRenderer::GLCoreRenderer() :
+m_program              (0),
+m_viewLocation         (-1),
+m_modelLocation        (-1),
+m_textureMatrixLocation(-1),
+m_texturedLocation     (-1),
+m_vertexArrays         (),
+m_stream               (0),
+m_streamSize           (0),
+m_streamOffset         (0),
+m_quadIndices          (0),
+m_quadCount            (0),
+m_textured             (false),
+m_uniformsChanged      (true)
+{
+    std::memcpy(m_view, GLCoreRendererImpl::identity, sizeof(m_view));
+    std::memcpy(m_model, GLCoreRendererImpl::identity, sizeof(m_model));
+    std::memcpy(m_textureMatrix, GLCoreRendererImpl::identity, sizeof(m_textureMatrix));
+}
+
+
+////////////////////////////////////////////////////////////
+GLCoreRenderer::~GLCoreRenderer()
+{
+    TransientContextLock lock;
+
+    // The program and buffer are shared between contexts, vertex array
+    // objects are not: only the one of the current context can be deleted,
+    // the others go away with their context
+    VertexArrayMap::iterator vertexArray = m_vertexArrays.find(Context::getActiveContextId());
+    if (vertexArray != m_vertexArrays.end())
+        glCheck(glDeleteVertexArrays(1, &vertexArray->second));
+
+    if (m_stream)
+        glCheck(glDeleteBuffers(1, &m_stream));
+
+    if (m_quadIndices)
+        glCheck(glDeleteBuffers(1, &m_quadIndices));
+
+    if (m_program)
+        glCheck(glDeleteProgram(m_program));
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::isCoreProfile()
+{
+    if (!GLEXT_GL_VERSION_3_2)
+        return false;
+
+    GLint profile = 0;
+    glCheck(glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &profile));
+
+    return (profile & GL_CONTEXT_CORE_PROFILE_BIT) != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::isInstancingAvailable()
+{
+    // Attribute divisors and instanced draws are both core since 3.3
+    return GLEXT_GL_VERSION_3_3 != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::activate()
+{
+    if (!m_program && !createProgram())
+        return false;
+
+    if (!m_stream)
+    {
+        m_streamSize = GLCoreRendererImpl::initialStreamSize;
+        glCheck(glGenBuffers(1, &m_stream));
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_stream));
+        glCheck(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_streamSize), NULL, GL_STREAM_DRAW));
+    }
+
+    // Each context needs its own vertex array object
+    Uint64 contextId = Context::getActiveContextId();
+    VertexArrayMap::iterator vertexArray = m_vertexArrays.find(contextId);
+    if (vertexArray == m_vertexArrays.end())
+    {
+        GLuint name = 0;
+        glCheck(glGenVertexArrays(1, &name));
+        vertexArray = m_vertexArrays.insert(std::make_pair(contextId, name)).first;
+
+        glCheck(glBindVertexArray(name));
+        glCheck(glEnableVertexAttribArray(GLCoreRendererImpl::PositionAttribute));
+        glCheck(glEnableVertexAttribArray(GLCoreRendererImpl::ColorAttribute));
+        glCheck(glEnableVertexAttribArray(GLCoreRendererImpl::TexCoordsAttribute));
+
+        // Instance attributes advance once per instance, when their arrays are enabled
+        if (isInstancingAvailable())
+        {
+            for (GLuint i = GLCoreRendererImpl::InstanceXAttribute; i <= GLCoreRendererImpl::InstanceRectAttribute; ++i)
+                glCheck(glVertexAttribDivisor(i, 1));
+        }
+    }
+
+    glCheck(glBindVertexArray(vertexArray->second));
+    setAttributes(m_stream);
+    resetInstanceAttributes();
+
+    glCheck(glUseProgram(m_program));
+    m_uniformsChanged = true;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::deactivate()
+{
+    glCheck(glUseProgram(0));
+    glCheck(glBindVertexArray(0));
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setViewMatrix(const float* matrix)
+{
+    std::memcpy(m_view, matrix, sizeof(m_view));
+    m_uniformsChanged = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setModelMatrix(const float* matrix)
+{
+    std::memcpy(m_model, matrix, sizeof(m_model));
+    m_uniformsChanged = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setTexture(unsigned int texture, const float* matrix)
+{
+    glCheck(glBindTexture(GL_TEXTURE_2D, texture));
+
+    m_textured = (texture != 0);
+    if (m_textured)
+        std::memcpy(m_textureMatrix, matrix, sizeof(m_textureMatrix));
+
+    m_uniformsChanged = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::draw(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type)
+{
+    std::size_t streamCount = GLCoreRendererImpl::streamedCount(vertexCount, type);
+    std::size_t bytes = streamCount * sizeof(Vertex);
+    if (bytes == 0)
+        return;
+
+    void* data = beginStream(bytes);
+    if (!data)
+        return;
+
+    GLCoreRendererImpl::streamVertices(static_cast<Vertex*>(data), vertices, vertexCount, type);
+    std::size_t offset = endStream(bytes);
+
+    updateUniforms();
+
+    GLint first = static_cast<GLint>(offset / sizeof(Vertex));
+    glCheck(glDrawArrays(GLCoreRendererImpl::primitiveMode(type), first, static_cast<GLsizei>(streamCount)));
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::draw(unsigned int buffer, PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount)
+{
+    updateUniforms();
+
+    setAttributes(buffer);
+    if (type == Quads)
+    {
+        // The buffer can't be rewritten: its quads are indexed as two triangles each
+        std::size_t quadCount = vertexCount / 4;
+        if (quadCount > 0)
+        {
+            bindQuadIndices(quadCount);
+            glCheck(glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(quadCount * 6), GL_UNSIGNED_INT, NULL,
+                                             static_cast<GLint>(firstVertex)));
+        }
+    }
+    else
+    {
+        glCheck(glDrawArrays(GLCoreRendererImpl::primitiveMode(type), static_cast<GLint>(firstVertex), static_cast<GLsizei>(vertexCount)));
+    }
+    setAttributes(m_stream);
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::drawInstanced(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type,
+                                   const InstanceData* instances, std::size_t instanceCount)
+{
+    std::size_t streamCount = GLCoreRendererImpl::streamedCount(vertexCount, type);
+    std::size_t vertexBytes = streamCount * sizeof(Vertex);
+    std::size_t instanceBytes = instanceCount * sizeof(InstanceData);
+    if ((vertexBytes == 0) || (instanceBytes == 0))
+        return;
+
+    // Vertices and instances go in the same range, instances last
+    char* data = static_cast<char*>(beginStream(vertexBytes + instanceBytes));
+    if (!data)
+        return;
+
+    GLCoreRendererImpl::streamVertices(reinterpret_cast<Vertex*>(data), vertices, vertexCount, type);
+    std::memcpy(data + vertexBytes, instances, instanceBytes);
+    std::size_t offset = endStream(vertexBytes + instanceBytes);
+
+    updateUniforms();
+
+    setInstanceAttributes(offset + vertexBytes);
+    glCheck(glDrawArraysInstanced(GLCoreRendererImpl::primitiveMode(type), static_cast<GLint>(offset / sizeof(Vertex)),
+                                  static_cast<GLsizei>(streamCount), static_cast<GLsizei>(instanceCount)));
+    resetInstanceAttributes();
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::drawInstanced(unsigned int buffer, PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount,
+                                   const InstanceData* instances, std::size_t instanceCount)
+{
+    std::size_t instanceBytes = instanceCount * sizeof(InstanceData);
+    std::size_t quadCount = vertexCount / 4;
+    if ((vertexCount == 0) || (instanceBytes == 0) || ((type == Quads) && (quadCount == 0)))
+        return;
+
+    void* data = beginStream(instanceBytes);
+    if (!data)
+        return;
+
+    std::memcpy(data, instances, instanceBytes);
+    std::size_t offset = endStream(instanceBytes);
+
+    updateUniforms();
+
+    setAttributes(buffer);
+    setInstanceAttributes(offset);
+    if (type == Quads)
+    {
+        bindQuadIndices(quadCount);
+        glCheck(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(quadCount * 6), GL_UNSIGNED_INT, NULL,
+                                                  static_cast<GLsizei>(instanceCount), static_cast<GLint>(firstVertex)));
+    }
+    else
+    {
+        glCheck(glDrawArraysInstanced(GLCoreRendererImpl::primitiveMode(type), static_cast<GLint>(firstVertex),
+                                      static_cast<GLsizei>(vertexCount), static_cast<GLsizei>(instanceCount)));
+    }
+    resetInstanceAttributes();
+    setAttributes(m_stream);
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::createProgram()
+{
+    using namespace GLCoreRendererImpl;
+
+    GLuint vertex = compileShader(GL_VERTEX_SHADER, vertexShader);
+    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
+    if (!vertex || !fragment)
+    {
+        if (vertex)
+            glCheck(glDeleteShader(vertex));
+        if (fragment)
+            glCheck(glDeleteShader(fragment));
+        return false;
+    }
+
+    GLuint program = glCreateProgram();
+    glCheck(glAttachShader(program, vertex));
+    glCheck(glAttachShader(program, fragment));
+    glCheck(glBindAttribLocation(program, PositionAttribute, "sf_position"));
+    glCheck(glBindAttribLocation(program, ColorAttribute, "sf_color"));
+    glCheck(glBindAttribLocation(program, TexCoordsAttribute, "sf_texCoords"));
+    glCheck(glBindAttribLocation(program, InstanceXAttribute, "sf_instanceX"));
+    glCheck(glBindAttribLocation(program, InstanceYAttribute, "sf_instanceY"));
+    glCheck(glBindAttribLocation(program, InstanceOriginAttribute, "sf_instanceOrigin"));
+    glCheck(glBindAttribLocation(program, InstanceColorAttribute, "sf_instanceColor"));
+    glCheck(glBindAttribLocation(program, InstanceRectAttribute, "sf_instanceRect"));
+    glCheck(glBindFragDataLocation(program, 0, "fragColor"));
+    glCheck(glLinkProgram(program));
+
+    // The program keeps the stages alive as long as it needs them
+    glCheck(glDeleteShader(vertex));
+    glCheck(glDeleteShader(fragment));
+
+    GLint success = GL_FALSE;
+    glCheck(glGetProgramiv(program, GL_LINK_STATUS, &success));
+    if (success == GL_FALSE)
+    {
+        char log[1024];
+        glCheck(glGetProgramInfoLog(program, sizeof(log), NULL, log));
+        err() << "Failed to link the core profile shader:" << std::endl << log << std::endl;
+        glCheck(glDeleteProgram(program));
+        return false;
+    }
+
+    m_program = program;
+    m_viewLocation = glGetUniformLocation(program, "sf_view");
+    m_modelLocation = glGetUniformLocation(program, "sf_model");
+    m_textureMatrixLocation = glGetUniformLocation(program, "sf_textureMatrix");
+    m_texturedLocation = glGetUniformLocation(program, "sf_textured");
+
+    // Textures always go to unit 0
+    glCheck(glUseProgram(program));
+    glCheck(glUniform1i(glGetUniformLocation(program, "sf_texture"), 0));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setAttributes(unsigned int buffer)
+{
+    using namespace GLCoreRendererImpl;
+
+    // Same layout as sf::Vertex: position, color, texCoords
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+    glCheck(glVertexAttribPointer(PositionAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>(0)));
+    glCheck(glVertexAttribPointer(ColorAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
+    glCheck(glVertexAttribPointer(TexCoordsAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>(12)));
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setInstanceAttributes(std::size_t offset)
+{
+    using namespace GLCoreRendererImpl;
+
+    GLsizei stride = sizeof(InstanceData);
+
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_stream));
+    glCheck(glVertexAttribPointer(InstanceXAttribute, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + instanceXOffset)));
+    glCheck(glVertexAttribPointer(InstanceYAttribute, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + instanceYOffset)));
+    glCheck(glVertexAttribPointer(InstanceOriginAttribute, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + instanceOriginOffset)));
+    glCheck(glVertexAttribPointer(InstanceColorAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<const void*>(offset + instanceColorOffset)));
+    glCheck(glVertexAttribPointer(InstanceRectAttribute, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + instanceRectOffset)));
+
+    for (GLuint i = InstanceXAttribute; i <= InstanceRectAttribute; ++i)
+        glCheck(glEnableVertexAttribArray(i));
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::resetInstanceAttributes()
+{
+    using namespace GLCoreRendererImpl;
+
+    for (GLuint i = InstanceXAttribute; i <= InstanceRectAttribute; ++i)
+        glCheck(glDisableVertexAttribArray(i));
+
+    // Identity transform, white, no texture rect
+    glCheck(glVertexAttrib2f(InstanceXAttribute, 1.f, 0.f));
+    glCheck(glVertexAttrib2f(InstanceYAttribute, 0.f, 1.f));
+    glCheck(glVertexAttrib2f(InstanceOriginAttribute, 0.f, 0.f));
+    glCheck(glVertexAttrib4f(InstanceColorAttribute, 1.f, 1.f, 1.f, 1.f));
+    glCheck(glVertexAttrib4f(InstanceRectAttribute, 0.f, 0.f, 0.f, 0.f));
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::bindQuadIndices(std::size_t quadCount)
+{
+    if (!m_quadIndices)
+        glCheck(glGenBuffers(1, &m_quadIndices));
+
+    // The element buffer binding belongs to the bound vertex array object
+    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadIndices));
+
+    if (quadCount <= m_quadCount)
+        return;
+
+    // Grow by doubling, so that drawing bigger and bigger buffers rarely regenerates the indices
+    m_quadCount = std::max(quadCount, m_quadCount * 2);
+
+    std::vector<Uint32> indices(m_quadCount * 6);
+    for (std::size_t i = 0; i < m_quadCount; ++i)
+    {
+        Uint32 first = static_cast<Uint32>(i * 4);
+        indices[i * 6 + 0] = first;
+        indices[i * 6 + 1] = first + 1;
+        indices[i * 6 + 2] = first + 2;
+        indices[i * 6 + 3] = first;
+        indices[i * 6 + 4] = first + 2;
+        indices[i * 6 + 5] = first + 3;
+    }
+
+    glCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(Uint32)), &indices[0], GL_STATIC_DRAW));
+}
+
+
+////////////////////////////////////////////////////////////
+void* GLCoreRenderer::beginStream(std::size_t size)
+{
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_stream));
+
+    // Vertices are drawn by index: streamed ranges start on a vertex boundary
+    m_streamOffset = (m_streamOffset + sizeof(Vertex) - 1) / sizeof(Vertex) * sizeof(Vertex);
+
+    // Out of room: orphan the buffer (the driver keeps the old storage
+    // alive for the draws still using it) and start again from its beginning
+    if (m_streamOffset + size > m_streamSize)
+    {
+        m_streamSize = std::max(m_streamSize, size);
+        m_streamOffset = 0;
+        glCheck(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_streamSize), NULL, GL_STREAM_DRAW));
+    }
+
+    // Nothing the GPU may still read is overwritten, so no need to synchronize
+    void* data = NULL;
+    glCheck(data = glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(m_streamOffset), static_cast<GLsizeiptr>(size),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+    return data;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t GLCoreRenderer::endStream(std::size_t size)
+{
+    glCheck(glUnmapBuffer(GL_ARRAY_BUFFER));
+
+    std::size_t offset = m_streamOffset;
+    m_streamOffset += size;
+
+    return offset;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::updateUniforms()
+{
+    if (!m_uniformsChanged)
+        return;
+
+    glCheck(glUniformMatrix4fv(m_viewLocation, 1, GL_FALSE, m_view));
+    glCheck(glUniformMatrix4fv(m_modelLocation, 1, GL_FALSE, m_model));
+    glCheck(glUniformMatrix4fv(m_textureMatrixLocation, 1, GL_FALSE, m_textureMatrix));
+    glCheck(glUniform1i(m_texturedLocation, m_textured ? 1 : 0));
+
+    m_uniformsChanged = false;
+}
+
+} // namespace priv
+
+} // namespace sf
+
+#else // SFML_OPENGL_ES
+
+// OpenGL ES 1 has no core profile: sf::RenderTarget never creates a GLCoreRenderer
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+GLCoreRenderer::GLCoreRenderer() :
+m_program              (0),
+m_viewLocation         (-1),
+m_modelLocation        (-1),
+m_textureMatrixLocation(-1),
+m_texturedLocation     (-1),
+m_vertexArrays         (),
+m_stream               (0),
+m_streamSize           (0),
+m_streamOffset         (0),
+m_quadIndices          (0),
+m_quadCount            (0),
+m_textured             (false),
+m_uniformsChanged      (false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+GLCoreRenderer::~GLCoreRenderer()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::isCoreProfile()
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::isInstancingAvailable()
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::activate()
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::deactivate()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setViewMatrix(const float*)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setModelMatrix(const float*)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setTexture(unsigned int, const float*)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::draw(const Vertex*, std::size_t, PrimitiveType)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::draw(unsigned int, PrimitiveType, std::size_t, std::size_t)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::drawInstanced(const Vertex*, std::size_t, PrimitiveType, const InstanceData*, std::size_t)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::drawInstanced(unsigned int, PrimitiveType, std::size_t, std::size_t, const InstanceData*, std::size_t)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool GLCoreRenderer::createProgram()
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setAttributes(unsigned int)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::setInstanceAttributes(std::size_t)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::resetInstanceAttributes()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::bindQuadIndices(std::size_t)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void* GLCoreRenderer::beginStream(std::size_t)
+{
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t GLCoreRenderer::endStream(std::size_t)
+{
+    return 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void GLCoreRenderer::updateUniforms()
+{
+}
+
+} // namespace priv
+
+} // namespace sf
+
+#endif // SFML_OPENGL_ES
@@ -0,0 +1,296 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_GLCORERENDERER_HPP
+#define SFML_GLCORERENDERER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <cstddef>
+#include <map>
+
+
+namespace sf
+{
+class InstanceData;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Draws for sf::RenderTarget in core profile contexts
+///
+/// Core profiles have no fixed-function pipeline: vertices
+/// go through a streaming vertex buffer and a vertex array
+/// object, and are shaded by a built-in program that does
+/// what the fixed-function states did (view and model
+/// matrices, texture matrix, vertex colors).
+///
+/// The program also reads per-instance attributes, so that
+/// compatibility contexts use it for instanced draws too.
+///
+////////////////////////////////////////////////////////////
+class GLCoreRenderer : GlResource, NonCopyable
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// OpenGL objects are created by the first call to activate.
+    ///
+    ////////////////////////////////////////////////////////////
+    GLCoreRenderer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~GLCoreRenderer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the active context has a core profile
+    ///
+    /// \return True if the context has no fixed-function pipeline
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isCoreProfile();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the active context can draw instances
+    ///
+    /// \return True if the context has OpenGL 3.3
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isInstancingAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind the program, vertex array and streaming buffer
+    ///
+    /// This function must be called whenever the OpenGL states
+    /// are reset, in the context that will be used to draw.
+    ///
+    /// \return True if the renderer is ready to draw
+    ///
+    ////////////////////////////////////////////////////////////
+    bool activate();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unbind the program, vertex array and buffer
+    ///
+    /// For compatibility contexts, which go back to the
+    /// fixed-function pipeline after an instanced draw.
+    ///
+    ////////////////////////////////////////////////////////////
+    void deactivate();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the projection matrix (the view)
+    ///
+    /// \param matrix 4x4 matrix, column-major
+    ///
+    ////////////////////////////////////////////////////////////
+    void setViewMatrix(const float* matrix);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the model-view matrix (the transform)
+    ///
+    /// \param matrix 4x4 matrix, column-major
+    ///
+    ////////////////////////////////////////////////////////////
+    void setModelMatrix(const float* matrix);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind a texture, or none
+    ///
+    /// \param texture OpenGL name of the texture, 0 for none
+    /// \param matrix  4x4 texture matrix, column-major (ignored without texture)
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(unsigned int texture, const float* matrix);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stream vertices and draw them
+    ///
+    /// Quads, unavailable in core profiles, are drawn as
+    /// pairs of triangles.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices
+    /// \param type        Type of primitives to draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw vertices of a vertex buffer
+    ///
+    /// Quads are indexed as pairs of triangles.
+    ///
+    /// \param buffer      OpenGL name of the buffer
+    /// \param type        Type of primitives to draw
+    /// \param firstVertex Index of the first vertex to draw
+    /// \param vertexCount Number of vertices to draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(unsigned int buffer, PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stream vertices and instances and draw one copy of
+    ///        the vertices per instance
+    ///
+    /// \param vertices      Pointer to the vertices
+    /// \param vertexCount   Number of vertices
+    /// \param type          Type of primitives to draw
+    /// \param instances     Pointer to the instances
+    /// \param instanceCount Number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstanced(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type,
+                       const InstanceData* instances, std::size_t instanceCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stream instances and draw one copy of vertices of
+    ///        a vertex buffer per instance
+    ///
+    /// \param buffer        OpenGL name of the buffer
+    /// \param type          Type of primitives to draw (quads are indexed as triangles)
+    /// \param firstVertex   Index of the first vertex to draw
+    /// \param vertexCount   Number of vertices to draw
+    /// \param instances     Pointer to the instances
+    /// \param instanceCount Number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstanced(unsigned int buffer, PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount,
+                       const InstanceData* instances, std::size_t instanceCount);
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compile and link the built-in program
+    ///
+    /// \return True on success
+    ///
+    ////////////////////////////////////////////////////////////
+    bool createProgram();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Point the vertex attributes at a buffer
+    ///
+    /// \param buffer OpenGL name of the buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAttributes(unsigned int buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Point the instance attributes at streamed instances
+    ///
+    /// \param offset Offset of the instances in the streaming buffer, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    void setInstanceAttributes(std::size_t offset);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Give the instance attributes the values of a
+    ///        default instance, for draws without instances
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetInstanceAttributes();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind indices drawing quads as pairs of triangles
+    ///
+    /// The indices are shared by every buffer: index i*6 starts
+    /// the quad made of the vertices 4*i to 4*i+3.
+    ///
+    /// \param quadCount Number of quads the indices must cover
+    ///
+    ////////////////////////////////////////////////////////////
+    void bindQuadIndices(std::size_t quadCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Map the next range of the streaming buffer
+    ///
+    /// Orphans the buffer first if the range doesn't fit.
+    ///
+    /// \param size Size of the range, in bytes
+    ///
+    /// \return Pointer to the range, NULL on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    void* beginStream(std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unmap the range mapped by beginStream
+    ///
+    /// \param size Size of the range, in bytes
+    ///
+    /// \return Offset of the range in the streaming buffer, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t endStream(std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the matrices that changed since the last draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateUniforms();
+
+    ////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////
+    typedef std::map<Uint64, unsigned int> VertexArrayMap;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int   m_program;        //!< Built-in program
+    int            m_viewLocation;   //!< Location of the view matrix uniform
+    int            m_modelLocation;  //!< Location of the model-view matrix uniform
+    int            m_textureMatrixLocation; //!< Location of the texture matrix uniform
+    int            m_texturedLocation; //!< Location of the "has a texture" uniform
+    VertexArrayMap m_vertexArrays;   //!< Vertex array objects, per context (they are not shared)
+    unsigned int   m_stream;         //!< Streaming vertex buffer
+    std::size_t    m_streamSize;     //!< Size of the streaming buffer, in bytes
+    std::size_t    m_streamOffset;   //!< Where the next vertices are streamed, in bytes
+    unsigned int   m_quadIndices;    //!< Element buffer drawing quads as triangles
+    std::size_t    m_quadCount;      //!< Number of quads m_quadIndices covers
+    float          m_view[16];       //!< Current view matrix
+    float          m_model[16];      //!< Current model-view matrix
+    float          m_textureMatrix[16]; //!< Current texture matrix
+    bool           m_textured;       //!< Is a texture bound?
+    bool           m_uniformsChanged; //!< Must the matrices be uploaded before the next draw?
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_GLCORERENDERER_HPP
@@ -133,6 +133,15 @@
     #define GLEXT_copy_buffer                         false
     #define GLEXT_GL_COPY_READ_BUFFER                 0
     #define GLEXT_GL_COPY_WRITE_BUFFER                0
+
+    // Core since 3.0 - EXT_map_buffer_range
+    #define GLEXT_map_buffer_range                    false
+
+    // Core since 3.0 - APPLE_sync
+    #define GLEXT_sync                                false
+
+    // Not core - EXT_buffer_storage
+    #define GLEXT_buffer_storage                      false
     #define GLEXT_glCopyBufferSubData                 glCopyBufferSubData // Placeholder to satisfy the compiler, entry point is not loaded in GLES
 
     // Core since 3.0 - EXT_sRGB
@@ -183,11 +192,11 @@
     #define GLEXT_GL_TEXTURE0                         GL_TEXTURE0_ARB
 
     // Core since 1.4 - EXT_blend_func_separate
-    #define GLEXT_blend_func_separate                 SF_GLAD_GL_EXT_blend_func_separate
+    #define GLEXT_blend_func_separate                 (SF_GLAD_GL_EXT_blend_func_separate || SF_GLAD_GL_VERSION_1_4)
     #define GLEXT_glBlendFuncSeparate                 glBlendFuncSeparateEXT
 
     // Core since 1.5 - ARB_vertex_buffer_object
-    #define GLEXT_vertex_buffer_object                SF_GLAD_GL_ARB_vertex_buffer_object
+    #define GLEXT_vertex_buffer_object                (SF_GLAD_GL_ARB_vertex_buffer_object || SF_GLAD_GL_VERSION_1_5)
     #define GLEXT_GL_ARRAY_BUFFER                     GL_ARRAY_BUFFER_ARB
     #define GLEXT_GL_DYNAMIC_DRAW                     GL_DYNAMIC_DRAW_ARB
     #define GLEXT_GL_READ_ONLY                        GL_READ_ONLY_ARB
@@ -199,6 +208,7 @@
     #define GLEXT_glBufferSubData                     glBufferSubDataARB
     #define GLEXT_glDeleteBuffers                     glDeleteBuffersARB
     #define GLEXT_glGenBuffers                        glGenBuffersARB
+    #define GLEXT_glGetBufferSubData                  glGetBufferSubDataARB
     #define GLEXT_glMapBuffer                         glMapBufferARB
     #define GLEXT_glUnmapBuffer                       glUnmapBufferARB
 
@@ -252,7 +262,7 @@
     #define GLEXT_texture_non_power_of_two            SF_GLAD_GL_ARB_texture_non_power_of_two
 
     // Core since 2.0 - EXT_blend_equation_separate
-    #define GLEXT_blend_equation_separate             SF_GLAD_GL_EXT_blend_equation_separate
+    #define GLEXT_blend_equation_separate             (SF_GLAD_GL_EXT_blend_equation_separate || SF_GLAD_GL_VERSION_2_0)
     #define GLEXT_glBlendEquationSeparate             glBlendEquationSeparateEXT
 
     // Core since 2.1 - EXT_texture_sRGB
@@ -308,6 +318,15 @@
     #define GLEXT_geometry_shader4                    SF_GLAD_GL_ARB_geometry_shader4
     #define GLEXT_GL_GEOMETRY_SHADER                  GL_GEOMETRY_SHADER_ARB
 
+    // Core since 3.0 - ARB_map_buffer_range
+    #define GLEXT_map_buffer_range                    (SF_GLAD_GL_ARB_map_buffer_range || SF_GLAD_GL_VERSION_3_0)
+
+    // Core since 3.2 - ARB_sync
+    #define GLEXT_sync                                (SF_GLAD_GL_ARB_sync || SF_GLAD_GL_VERSION_3_2)
+
+    // Core since 4.4 - ARB_buffer_storage
+    #define GLEXT_buffer_storage                      (SF_GLAD_GL_ARB_buffer_storage || SF_GLAD_GL_VERSION_4_4)
+
 #endif
 
     // OpenGL Versions
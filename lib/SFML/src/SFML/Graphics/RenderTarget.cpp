@@ -32,13 +32,18 @@
 #include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/VertexBuffer.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Graphics/GLCoreRenderer.hpp>
+#include <SFML/Graphics/InstanceData.hpp>
+#include <SFML/Graphics/TransformPoints.hpp>
 #include <SFML/Window/Context.hpp>
 #include <SFML/System/Mutex.hpp>
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Trace.hpp>
 #include <cassert>
 #include <iostream>
 #include <algorithm>
+#include <functional>
 #include <map>
 
 
@@ -145,6 +150,163 @@ namespace
 
             return GLEXT_GL_FUNC_ADD;
         }
+
+
+        // Pack a blend mode into an integer, for sorting deferred draws
+        sf::Uint32 blendKey(const sf::BlendMode& mode)
+        {
+            return (static_cast<sf::Uint32>(mode.colorSrcFactor) << 0)  |
+                   (static_cast<sf::Uint32>(mode.colorDstFactor) << 4)  |
+                   (static_cast<sf::Uint32>(mode.colorEquation)  << 8)  |
+                   (static_cast<sf::Uint32>(mode.alphaSrcFactor) << 12) |
+                   (static_cast<sf::Uint32>(mode.alphaDstFactor) << 16) |
+                   (static_cast<sf::Uint32>(mode.alphaEquation)  << 20);
+        }
+
+
+        // Append primitives of any type as an equivalent list of points, lines or
+        // triangles, so that consecutive draws can be merged; return the list type.
+        // Incomplete primitives are dropped, as they would shift the ones merged after.
+        sf::PrimitiveType appendAsList(std::vector<sf::Vertex>& out, const sf::Vertex* vertices, std::size_t count,
+                                       sf::PrimitiveType type)
+        {
+            switch (type)
+            {
+                case sf::Points:
+                {
+                    out.insert(out.end(), vertices, vertices + count);
+                    return type;
+                }
+
+                case sf::Lines:
+                {
+                    out.insert(out.end(), vertices, vertices + count - count % 2);
+                    return type;
+                }
+
+                case sf::Triangles:
+                {
+                    out.insert(out.end(), vertices, vertices + count - count % 3);
+                    return type;
+                }
+
+                case sf::LineStrip:
+                {
+                    for (std::size_t i = 1; i < count; ++i)
+                    {
+                        out.push_back(vertices[i - 1]);
+                        out.push_back(vertices[i]);
+                    }
+                    return sf::Lines;
+                }
+
+                case sf::TriangleStrip:
+                {
+                    for (std::size_t i = 2; i < count; ++i)
+                    {
+                        out.push_back(vertices[i - 2]);
+                        out.push_back(vertices[i - 1]);
+                        out.push_back(vertices[i]);
+                    }
+                    return sf::Triangles;
+                }
+
+                case sf::TriangleFan:
+                {
+                    for (std::size_t i = 2; i < count; ++i)
+                    {
+                        out.push_back(vertices[0]);
+                        out.push_back(vertices[i - 1]);
+                        out.push_back(vertices[i]);
+                    }
+                    return sf::Triangles;
+                }
+
+                case sf::Quads:
+                {
+                    for (std::size_t i = 3; i < count; i += 4)
+                    {
+                        out.push_back(vertices[i - 3]);
+                        out.push_back(vertices[i - 2]);
+                        out.push_back(vertices[i - 1]);
+                        out.push_back(vertices[i - 3]);
+                        out.push_back(vertices[i - 1]);
+                        out.push_back(vertices[i]);
+                    }
+                    return sf::Triangles;
+                }
+            }
+
+            return type;
+        }
+
+
+        // Apply an instance to vertices copied for it: transform, color and texture rect
+        void applyInstance(const sf::InstanceData& instance, sf::Vertex* vertices, std::size_t count)
+        {
+            sf::Vector2f* positions = &vertices[0].position;
+            sf::priv::transformPoints(instance.transform, positions, sizeof(sf::Vertex), positions, sizeof(sf::Vertex), count);
+
+            const sf::FloatRect& rect = instance.textureRect;
+            bool textured = (rect.width != 0.f) || (rect.height != 0.f);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                vertices[i].color *= instance.color;
+                if (textured)
+                    vertices[i].texCoords = sf::Vector2f(rect.left + vertices[i].texCoords.x * rect.width,
+                                                         rect.top + vertices[i].texCoords.y * rect.height);
+            }
+        }
+
+
+        // Do instances leave the color and texture coordinates of the vertices as they are?
+        bool onlyTransforms(const sf::InstanceData* instances, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const sf::FloatRect& rect = instances[i].textureRect;
+                if ((instances[i].color != sf::Color::White) || (rect.width != 0.f) || (rect.height != 0.f))
+                    return false;
+            }
+
+            return true;
+        }
+
+
+        // Order of deferred draws in DeferredStable mode
+        template <typename Command>
+        bool layerLess(const Command& a, const Command& b)
+        {
+            return a.layer < b.layer;
+        }
+
+
+        // Order of deferred draws in DeferredSorted mode
+        template <typename Command>
+        bool stateLess(const Command& a, const Command& b)
+        {
+            if (a.layer != b.layer)
+                return a.layer < b.layer;
+            if (a.states.shader != b.states.shader)
+                return std::less<const sf::Shader*>()(a.states.shader, b.states.shader);
+            if (a.states.texture != b.states.texture)
+                return std::less<const sf::Texture*>()(a.states.texture, b.states.texture);
+            if (a.blendKey != b.blendKey)
+                return a.blendKey < b.blendKey;
+            return a.type < b.type;
+        }
+
+
+        // Can two deferred draws be merged into one?
+        template <typename Command>
+        bool canMerge(const Command& a, const Command& b)
+        {
+            return !a.vertexBuffer && !b.vertexBuffer &&
+                   (a.type == b.type) &&
+                   (a.states.texture == b.states.texture) &&
+                   (a.states.shader == b.states.shader) &&
+                   (a.blendKey == b.blendKey);
+        }
     }
 }
 
@@ -156,24 +318,47 @@ RenderTarget::RenderTarget() :
 m_defaultView(),
 m_view       (),
 m_cache      (),
-m_id         (0)
+m_queue      (),
+m_id         (0),
+m_coreProfileChecked(false),
+m_coreRenderer(NULL),
+m_instancing ()
 {
     m_cache.glStatesSet = false;
+
+    m_queue.mode = Immediate;
+    m_queue.layer = 0;
+    m_queue.flushing = false;
+
+    m_instancing.instances = NULL;
+    m_instancing.count = 0;
+    m_instancing.checked = false;
+    m_instancing.renderer = NULL;
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderTarget::~RenderTarget()
 {
+    delete m_instancing.renderer;
+    delete m_coreRenderer;
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTarget::clear(const Color& color)
 {
+    // Queued draws would be cleared anyway (they are not counted as saved)
+    if (!m_queue.flushing && !m_queue.commands.empty())
+    {
+        m_queue.commands.clear();
+        m_queue.vertices.clear();
+    }
+
     if (RenderTargetImpl::isActive(m_id) || setActive(true))
     {
         // Unbind texture to fix RenderTexture preventing clear
+        useCoreProfile();
         applyTexture(NULL);
 
         glCheck(glClearColor(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f));
@@ -185,6 +370,9 @@ void RenderTarget::clear(const Color& color)
 ////////////////////////////////////////////////////////////
 void RenderTarget::setView(const View& view)
 {
+    // Queued draws use the previous view
+    flush();
+
     m_view = view;
     m_cache.viewChanged = true;
 }
@@ -277,6 +465,8 @@ void RenderTarget::draw(const Vertex* vertices, std::size_t vertexCount,
     if (!vertices || (vertexCount == 0))
         return;
 
+    SFML_TRACE_ZONE("RenderTarget::draw");
+
     // GL_QUADS is unavailable on OpenGL ES
     #ifdef SFML_OPENGL_ES
         if (type == Quads)
@@ -286,63 +476,94 @@ void RenderTarget::draw(const Vertex* vertices, std::size_t vertexCount,
         }
     #endif
 
+    // Inside drawInstanced: one copy per instance
+    if (m_instancing.instances)
+    {
+        ++m_queue.frame.draws;
+        drawInstances(vertices, vertexCount, type, states);
+        return;
+    }
+
+    if (!m_queue.flushing)
+    {
+        ++m_queue.frame.draws;
+
+        if (m_queue.mode != Immediate)
+        {
+            queueDraw(vertices, vertexCount, type, states);
+            return;
+        }
+    }
+
     if (RenderTargetImpl::isActive(m_id) || setActive(true))
     {
         // Check if the vertex count is low enough so that we can pre-transform them
         bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
+        const Vertex* vertexData = vertices;
 
-        if (useVertexCache)
+        // Vertices already in world coordinates are drawn from where they are
+        if (useVertexCache && (states.transform != Transform::Identity))
         {
             // Pre-transform the vertices and store them into the vertex cache
-            for (std::size_t i = 0; i < vertexCount; ++i)
-            {
-                Vertex& vertex = m_cache.vertexCache[i];
-                vertex.position = states.transform * vertices[i].position;
-                vertex.color = vertices[i].color;
-                vertex.texCoords = vertices[i].texCoords;
-            }
+            if (m_cache.vertexCache.size() < vertexCount)
+                m_cache.vertexCache.resize(vertexCount);
+
+            std::copy(vertices, vertices + vertexCount, m_cache.vertexCache.begin());
+            priv::transformPoints(states.transform, &vertices[0].position, sizeof(Vertex),
+                                  &m_cache.vertexCache[0].position, sizeof(Vertex), vertexCount);
+
+            vertexData = &m_cache.vertexCache[0];
         }
 
         setupDraw(useVertexCache, states);
 
-        // Check if texture coordinates array is needed, and update client state accordingly
-        bool enableTexCoordsArray = (states.texture || states.shader);
-        if (!m_cache.enable || (enableTexCoordsArray != m_cache.texCoordsArrayEnabled))
+        // Core profile: the vertices are streamed to a buffer
+        bool enableTexCoordsArray = true;
+        if (m_coreRenderer)
         {
-            if (enableTexCoordsArray)
-                glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
-            else
-                glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+            m_coreRenderer->draw(vertexData, vertexCount, type);
+            ++m_queue.frame.drawCalls;
         }
-
-        // If we switch between non-cache and cache mode or enable texture
-        // coordinates we need to set up the pointers to the vertices' components
-        if (!m_cache.enable || !useVertexCache || !m_cache.useVertexCache)
+        else
         {
-            const char* data = reinterpret_cast<const char*>(vertices);
+            // Check if texture coordinates array is needed, and update client state accordingly
+            enableTexCoordsArray = (states.texture || states.shader);
+            if (!m_cache.enable || (enableTexCoordsArray != m_cache.texCoordsArrayEnabled))
+            {
+                if (enableTexCoordsArray)
+                    glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+                else
+                    glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+            }
+
+            // If we switch between non-cache and cache mode, or to other vertices (the
+            // cache grew, or the caller's vertices need no transform), or enable texture
+            // coordinates we need to set up the pointers to the vertices' components
+            if (!m_cache.enable || !useVertexCache || !m_cache.useVertexCache || (vertexData != m_cache.lastVertexData))
+            {
+                const char* data = reinterpret_cast<const char*>(vertexData);
 
-            // If we pre-transform the vertices, we must use our internal vertex cache
-            if (useVertexCache)
-                data = reinterpret_cast<const char*>(m_cache.vertexCache);
+                glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
+                glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
+                if (enableTexCoordsArray)
+                    glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+            }
+            else if (enableTexCoordsArray && !m_cache.texCoordsArrayEnabled)
+            {
+                // If we enter this block, the pointers are already set to these vertices
+                const char* data = reinterpret_cast<const char*>(vertexData);
 
-            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
-            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
-            if (enableTexCoordsArray)
                 glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
-        }
-        else if (enableTexCoordsArray && !m_cache.texCoordsArrayEnabled)
-        {
-            // If we enter this block, we are already using our internal vertex cache
-            const char* data = reinterpret_cast<const char*>(m_cache.vertexCache);
+            }
 
-            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+            drawPrimitives(type, 0, vertexCount);
         }
 
-        drawPrimitives(type, 0, vertexCount);
         cleanupDraw(states);
 
         // Update the cache
         m_cache.useVertexCache = useVertexCache;
+        m_cache.lastVertexData = useVertexCache ? vertexData : NULL;
         m_cache.texCoordsArrayEnabled = enableTexCoordsArray;
     }
 }
@@ -377,6 +598,8 @@ void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVerte
     if (!vertexCount || !vertexBuffer.getNativeHandle())
         return;
 
+    SFML_TRACE_ZONE("RenderTarget::draw(VertexBuffer)");
+
     // GL_QUADS is unavailable on OpenGL ES
     #ifdef SFML_OPENGL_ES
         if (vertexBuffer.getPrimitiveType() == Quads)
@@ -386,25 +609,53 @@ void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVerte
         }
     #endif
 
+    // Inside drawInstanced: one copy per instance
+    if (m_instancing.instances)
+    {
+        ++m_queue.frame.draws;
+        drawInstances(vertexBuffer, firstVertex, vertexCount, states);
+        return;
+    }
+
+    if (!m_queue.flushing)
+    {
+        ++m_queue.frame.draws;
+
+        if (m_queue.mode != Immediate)
+        {
+            queueDraw(vertexBuffer, firstVertex, vertexCount, states);
+            return;
+        }
+    }
+
     if (RenderTargetImpl::isActive(m_id) || setActive(true))
     {
         setupDraw(false, states);
 
-        // Bind vertex buffer
-        VertexBuffer::bind(&vertexBuffer);
+        if (m_coreRenderer)
+        {
+            // Core profiles have no quads: the renderer indexes them as triangles
+            m_coreRenderer->draw(vertexBuffer.getNativeHandle(), vertexBuffer.getPrimitiveType(), firstVertex, vertexCount);
+            ++m_queue.frame.drawCalls;
+        }
+        else
+        {
+            // Bind vertex buffer
+            VertexBuffer::bind(&vertexBuffer);
 
-        // Always enable texture coordinates
-        if (!m_cache.enable || !m_cache.texCoordsArrayEnabled)
-            glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+            // Always enable texture coordinates
+            if (!m_cache.enable || !m_cache.texCoordsArrayEnabled)
+                glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
 
-        glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(0)));
-        glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
-        glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(12)));
+            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(0)));
+            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
+            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(12)));
 
-        drawPrimitives(vertexBuffer.getPrimitiveType(), firstVertex, vertexCount);
+            drawPrimitives(vertexBuffer.getPrimitiveType(), firstVertex, vertexCount);
 
-        // Unbind vertex buffer
-        VertexBuffer::bind(NULL);
+            // Unbind vertex buffer
+            VertexBuffer::bind(NULL);
+        }
 
         cleanupDraw(states);
 
@@ -415,6 +666,33 @@ void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVerte
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::drawInstanced(const Drawable& drawable, const InstanceData* instances, std::size_t instanceCount,
+                                 const RenderStates& states)
+{
+    if (!instances || (instanceCount == 0))
+        return;
+
+    // Instances are drawn right away, after what is queued
+    flush();
+
+    // Every primitive the drawable draws goes to drawInstances
+    m_instancing.instances = instances;
+    m_instancing.count = instanceCount;
+    drawable.draw(*this, states);
+    m_instancing.instances = NULL;
+    m_instancing.count = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawInstanced(const VertexBuffer& vertexBuffer, const InstanceData* instances, std::size_t instanceCount,
+                                 const RenderStates& states)
+{
+    drawInstanced(static_cast<const Drawable&>(vertexBuffer), instances, instanceCount, states);
+}
+
+
 ////////////////////////////////////////////////////////////
 bool RenderTarget::isSrgb() const
 {
@@ -467,7 +745,10 @@ bool RenderTarget::setActive(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTarget::pushGLStates()
 {
-    if (RenderTargetImpl::isActive(m_id) || setActive(true))
+    flush();
+
+    // Core profiles have no attribute and matrix stacks: only reset our states
+    if ((RenderTargetImpl::isActive(m_id) || setActive(true)) && !useCoreProfile())
     {
         #ifdef SFML_DEBUG
             // make sure that the user didn't leave an unchecked OpenGL error
@@ -499,7 +780,9 @@ void RenderTarget::pushGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::popGLStates()
 {
-    if (RenderTargetImpl::isActive(m_id) || setActive(true))
+    flush();
+
+    if ((RenderTargetImpl::isActive(m_id) || setActive(true)) && !useCoreProfile())
     {
         glCheck(glMatrixMode(GL_PROJECTION));
         glCheck(glPopMatrix());
@@ -533,35 +816,52 @@ void RenderTarget::resetGLStates()
         // Make sure that extensions are initialized
         priv::ensureExtensionsInit();
 
-        // Make sure that the texture unit which is active is the number 0
-        if (GLEXT_multitexture)
+        if (useCoreProfile())
         {
-            glCheck(GLEXT_glClientActiveTexture(GLEXT_GL_TEXTURE0));
+            // Define the default OpenGL states, and bind our program and buffers
             glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0));
+            glCheck(glDisable(GL_CULL_FACE));
+            glCheck(glDisable(GL_DEPTH_TEST));
+            glCheck(glEnable(GL_BLEND));
+            m_coreRenderer->activate();
+            m_cache.glStatesSet = true;
+
+            // Apply the default SFML states
+            applyBlendMode(BlendAlpha);
+            applyTexture(NULL);
         }
+        else
+        {
+            // Make sure that the texture unit which is active is the number 0
+            if (GLEXT_multitexture)
+            {
+                glCheck(GLEXT_glClientActiveTexture(GLEXT_GL_TEXTURE0));
+                glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0));
+            }
 
-        // Define the default OpenGL states
-        glCheck(glDisable(GL_CULL_FACE));
-        glCheck(glDisable(GL_LIGHTING));
-        glCheck(glDisable(GL_DEPTH_TEST));
-        glCheck(glDisable(GL_ALPHA_TEST));
-        glCheck(glEnable(GL_TEXTURE_2D));
-        glCheck(glEnable(GL_BLEND));
-        glCheck(glMatrixMode(GL_MODELVIEW));
-        glCheck(glLoadIdentity());
-        glCheck(glEnableClientState(GL_VERTEX_ARRAY));
-        glCheck(glEnableClientState(GL_COLOR_ARRAY));
-        glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
-        m_cache.glStatesSet = true;
+            // Define the default OpenGL states
+            glCheck(glDisable(GL_CULL_FACE));
+            glCheck(glDisable(GL_LIGHTING));
+            glCheck(glDisable(GL_DEPTH_TEST));
+            glCheck(glDisable(GL_ALPHA_TEST));
+            glCheck(glEnable(GL_TEXTURE_2D));
+            glCheck(glEnable(GL_BLEND));
+            glCheck(glMatrixMode(GL_MODELVIEW));
+            glCheck(glLoadIdentity());
+            glCheck(glEnableClientState(GL_VERTEX_ARRAY));
+            glCheck(glEnableClientState(GL_COLOR_ARRAY));
+            glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+            m_cache.glStatesSet = true;
 
-        // Apply the default SFML states
-        applyBlendMode(BlendAlpha);
-        applyTexture(NULL);
-        if (shaderAvailable)
-            applyShader(NULL);
+            // Apply the default SFML states
+            applyBlendMode(BlendAlpha);
+            applyTexture(NULL);
+            if (shaderAvailable)
+                applyShader(NULL);
 
-        if (vertexBufferAvailable)
-            glCheck(VertexBuffer::bind(NULL));
+            if (vertexBufferAvailable)
+                glCheck(VertexBuffer::bind(NULL));
+        }
 
         m_cache.texCoordsArrayEnabled = true;
 
@@ -575,6 +875,103 @@ void RenderTarget::resetGLStates()
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::setDrawMode(DrawMode mode)
+{
+    flush();
+
+    m_queue.mode = mode;
+}
+
+
+////////////////////////////////////////////////////////////
+RenderTarget::DrawMode RenderTarget::getDrawMode() const
+{
+    return m_queue.mode;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setDrawLayer(int layer)
+{
+    m_queue.layer = layer;
+}
+
+
+////////////////////////////////////////////////////////////
+int RenderTarget::getDrawLayer() const
+{
+    return m_queue.layer;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flush()
+{
+    // Nothing queued, or already flushing (resetGLStates sets the view)
+    if (m_queue.flushing || m_queue.commands.empty())
+        return;
+
+    SFML_TRACE_ZONE("RenderTarget::flush");
+
+    std::vector<DrawCommand>& commands = m_queue.commands;
+    if (m_queue.mode == DeferredSorted)
+        std::stable_sort(commands.begin(), commands.end(), RenderTargetImpl::stateLess<DrawCommand>);
+    else
+        std::stable_sort(commands.begin(), commands.end(), RenderTargetImpl::layerLess<DrawCommand>);
+
+    // Every queued vertex is copied once, so the storage never moves while drawing
+    std::vector<Vertex>& merged = m_queue.merged;
+    merged.clear();
+    merged.reserve(m_queue.vertices.size());
+
+    m_queue.flushing = true;
+
+    std::size_t i = 0;
+    while (i < commands.size())
+    {
+        const DrawCommand& command = commands[i];
+
+        if (command.vertexBuffer)
+        {
+            draw(*command.vertexBuffer, command.firstVertex, command.vertexCount, command.states);
+            ++i;
+            continue;
+        }
+
+        // Gather the following draws that share the same states
+        std::size_t first = merged.size();
+        std::size_t next = i;
+        do
+        {
+            const Vertex* vertices = &m_queue.vertices[commands[next].firstVertex];
+            merged.insert(merged.end(), vertices, vertices + commands[next].vertexCount);
+            ++next;
+        }
+        while ((next < commands.size()) && RenderTargetImpl::canMerge(command, commands[next]));
+
+        m_queue.frame.drawCallsSaved += static_cast<Uint32>(next - i - 1);
+
+        if (merged.size() > first)
+            draw(&merged[first], merged.size() - first, command.type, command.states);
+
+        i = next;
+    }
+
+    m_queue.flushing = false;
+
+    commands.clear();
+    m_queue.vertices.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+const RenderTarget::DrawStats& RenderTarget::getDrawStats() const
+{
+    return m_queue.last;
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::initialize()
 {
@@ -591,6 +988,202 @@ void RenderTarget::initialize()
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::finishFrame()
+{
+    flush();
+
+    m_queue.last = m_queue.frame;
+    m_queue.frame = DrawStats();
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::useCoreProfile()
+{
+    if (!m_coreProfileChecked)
+    {
+        priv::ensureExtensionsInit();
+
+        if (priv::GLCoreRenderer::isCoreProfile())
+            m_coreRenderer = new priv::GLCoreRenderer;
+
+        m_coreProfileChecked = true;
+    }
+
+    return m_coreRenderer != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+priv::GLCoreRenderer* RenderTarget::useInstancing()
+{
+    if (!m_instancing.checked)
+    {
+        priv::ensureExtensionsInit();
+
+        // Compatibility contexts get a renderer of their own, just for its program;
+        // if that program can't be built, instances take the fallback for good
+        if (!useCoreProfile() && priv::GLCoreRenderer::isInstancingAvailable())
+        {
+            m_instancing.renderer = new priv::GLCoreRenderer;
+            if (m_instancing.renderer->activate())
+            {
+                m_instancing.renderer->deactivate();
+            }
+            else
+            {
+                delete m_instancing.renderer;
+                m_instancing.renderer = NULL;
+            }
+        }
+
+        m_instancing.checked = true;
+    }
+
+    if (m_coreRenderer)
+        return priv::GLCoreRenderer::isInstancingAvailable() ? m_coreRenderer : NULL;
+
+    return m_instancing.renderer;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawInstances(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type, const RenderStates& states)
+{
+    if (!RenderTargetImpl::isActive(m_id) && !setActive(true))
+        return;
+
+    // User shaders don't read the instances
+    priv::GLCoreRenderer* renderer = states.shader ? NULL : useInstancing();
+    if (renderer)
+    {
+        setupDraw(false, states);
+        if (renderer != m_coreRenderer)
+            beginInstancing(*renderer, states);
+
+        renderer->drawInstanced(vertices, vertexCount, type, m_instancing.instances, m_instancing.count);
+        ++m_queue.frame.drawCalls;
+
+        if (renderer != m_coreRenderer)
+            renderer->deactivate();
+
+        cleanupDraw(states);
+
+        // Update the cache
+        m_cache.useVertexCache = false;
+        return;
+    }
+
+    // Fallback: copy the vertices once per instance and draw them all at once
+    std::vector<Vertex>& copies = m_instancing.vertices;
+    copies.clear();
+
+    PrimitiveType listType = type;
+    for (std::size_t i = 0; i < m_instancing.count; ++i)
+    {
+        std::size_t first = copies.size();
+        listType = RenderTargetImpl::appendAsList(copies, vertices, vertexCount, type);
+        if (copies.size() == first)
+            break;
+
+        RenderTargetImpl::applyInstance(m_instancing.instances[i], &copies[first], copies.size() - first);
+    }
+
+    if (copies.empty())
+        return;
+
+    // Draw them like queued draws are flushed: right away, without instances
+    const InstanceData* instances = m_instancing.instances;
+    bool flushing = m_queue.flushing;
+    m_instancing.instances = NULL;
+    m_queue.flushing = true;
+
+    draw(&copies[0], copies.size(), listType, states);
+
+    m_instancing.instances = instances;
+    m_queue.flushing = flushing;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawInstances(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount, const RenderStates& states)
+{
+    if (!RenderTargetImpl::isActive(m_id) && !setActive(true))
+        return;
+
+    // User shaders don't read the instances
+    priv::GLCoreRenderer* renderer = states.shader ? NULL : useInstancing();
+    if (renderer)
+    {
+        setupDraw(false, states);
+        if (renderer != m_coreRenderer)
+            beginInstancing(*renderer, states);
+
+        renderer->drawInstanced(vertexBuffer.getNativeHandle(), vertexBuffer.getPrimitiveType(), firstVertex, vertexCount,
+                                m_instancing.instances, m_instancing.count);
+        ++m_queue.frame.drawCalls;
+
+        if (renderer != m_coreRenderer)
+            renderer->deactivate();
+
+        cleanupDraw(states);
+
+        // Update the cache
+        m_cache.useVertexCache = false;
+        return;
+    }
+
+    const InstanceData* instances = m_instancing.instances;
+    std::size_t count = m_instancing.count;
+
+    // Fallback for instances that tint or texture the vertices: read them back and copy them
+    if (!RenderTargetImpl::onlyTransforms(instances, count))
+    {
+#ifndef SFML_OPENGL_ES
+        std::vector<Vertex>& vertices = m_instancing.bufferVertices;
+        vertices.resize(vertexCount);
+
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, vertexBuffer.getNativeHandle()));
+        glCheck(GLEXT_glGetBufferSubData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLintptrARB>(sizeof(Vertex) * firstVertex),
+                                         static_cast<GLsizeiptrARB>(sizeof(Vertex) * vertexCount), &vertices[0]));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+
+        drawInstances(&vertices[0], vertexCount, vertexBuffer.getPrimitiveType(), states);
+#else
+        err() << "Instance colors and texture rects of vertex buffers need OpenGL 3.3 on OpenGL ES platforms, drawing skipped" << std::endl;
+#endif
+        return;
+    }
+
+    // Fallback for instances that only move the vertices: one draw per instance
+    bool flushing = m_queue.flushing;
+    m_instancing.instances = NULL;
+    m_queue.flushing = true;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        RenderStates instanceStates(states);
+        instanceStates.transform *= instances[i].transform;
+        draw(vertexBuffer, firstVertex, vertexCount, instanceStates);
+    }
+
+    m_instancing.instances = instances;
+    m_queue.flushing = flushing;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::beginInstancing(priv::GLCoreRenderer& renderer, const RenderStates& states)
+{
+    // setupDraw applied the states to the fixed-function pipeline, the renderer needs them too
+    renderer.activate();
+    renderer.setViewMatrix(m_view.getTransform().getMatrix());
+    renderer.setModelMatrix(states.transform.getMatrix());
+    applyTexture(renderer, states.texture);
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyCurrentView()
 {
@@ -600,11 +1193,18 @@ void RenderTarget::applyCurrentView()
     glCheck(glViewport(viewport.left, top, viewport.width, viewport.height));
 
     // Set the projection matrix
-    glCheck(glMatrixMode(GL_PROJECTION));
-    glCheck(glLoadMatrixf(m_view.getTransform().getMatrix()));
+    if (m_coreRenderer)
+    {
+        m_coreRenderer->setViewMatrix(m_view.getTransform().getMatrix());
+    }
+    else
+    {
+        glCheck(glMatrixMode(GL_PROJECTION));
+        glCheck(glLoadMatrixf(m_view.getTransform().getMatrix()));
 
-    // Go back to model-view mode
-    glCheck(glMatrixMode(GL_MODELVIEW));
+        // Go back to model-view mode
+        glCheck(glMatrixMode(GL_MODELVIEW));
+    }
 
     m_cache.viewChanged = false;
 }
@@ -668,6 +1268,12 @@ void RenderTarget::applyBlendMode(const BlendMode& mode)
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyTransform(const Transform& transform)
 {
+    if (m_coreRenderer)
+    {
+        m_coreRenderer->setModelMatrix(transform.getMatrix());
+        return;
+    }
+
     // No need to call glMatrixMode(GL_MODELVIEW), it is always the
     // current mode (for optimization purpose, since it's the most used)
     if (transform == Transform::Identity)
@@ -680,15 +1286,49 @@ void RenderTarget::applyTransform(const Transform& transform)
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyTexture(const Texture* texture)
 {
-    Texture::bind(texture, Texture::Pixels);
+    if (m_coreRenderer)
+        applyTexture(*m_coreRenderer, texture);
+    else
+        Texture::bind(texture, Texture::Pixels);
 
     m_cache.lastTextureId = texture ? texture->m_cacheId : 0;
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::applyTexture(priv::GLCoreRenderer& renderer, const Texture* texture)
+{
+    // The texture matrix Texture::bind would set: pixels to [0 .. 1], flipped if needed
+    Transform matrix;
+    if (texture && texture->m_texture)
+    {
+        float width = static_cast<float>(texture->m_actualSize.x);
+        float height = static_cast<float>(texture->m_actualSize.y);
+        if (texture->m_pixelsFlipped)
+            matrix = Transform(1.f / width, 0.f, 0.f, 0.f, -1.f / height, static_cast<float>(texture->m_size.y) / height, 0.f, 0.f, 1.f);
+        else
+            matrix = Transform(1.f / width, 0.f, 0.f, 0.f, 1.f / height, 0.f, 0.f, 0.f, 1.f);
+    }
+
+    renderer.setTexture(texture ? texture->m_texture : 0, matrix.getMatrix());
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyShader(const Shader* shader)
 {
+    if (m_coreRenderer)
+    {
+        // sf::Shader is made of ARB shader objects, fed by fixed-function inputs
+        static bool warned = false;
+        if (shader && !warned)
+        {
+            err() << "sf::Shader is not supported by core profile contexts, drawing with the default shader" << std::endl;
+            warned = true;
+        }
+        return;
+    }
+
     Shader::bind(shader);
 }
 
@@ -714,7 +1354,7 @@ void RenderTarget::setupDraw(bool useVertexCache, const RenderStates& states)
     {
         // Since vertices are transformed, we must use an identity transform to render them
         if (!m_cache.enable || !m_cache.useVertexCache)
-            glCheck(glLoadIdentity());
+            applyTransform(Transform::Identity);
     }
     else
     {
@@ -763,6 +1403,8 @@ void RenderTarget::drawPrimitives(PrimitiveType type, std::size_t firstVertex, s
 
     // Draw the primitives
     glCheck(glDrawArrays(mode, static_cast<GLint>(firstVertex), static_cast<GLsizei>(vertexCount)));
+
+    ++m_queue.frame.drawCalls;
 }
 
 
@@ -782,6 +1424,50 @@ void RenderTarget::cleanupDraw(const RenderStates& states)
     m_cache.enable = true;
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderTarget::queueDraw(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type, const RenderStates& states)
+{
+    DrawCommand command;
+    command.layer = m_queue.layer;
+    command.blendKey = RenderTargetImpl::blendKey(states.blendMode);
+    command.states = states;
+    command.states.transform = Transform::Identity;
+    command.firstVertex = m_queue.vertices.size();
+    command.type = RenderTargetImpl::appendAsList(m_queue.vertices, vertices, vertexCount, type);
+    command.vertexCount = m_queue.vertices.size() - command.firstVertex;
+    command.vertexBuffer = NULL;
+
+    // Not even one whole primitive: nothing to draw
+    if (command.vertexCount == 0)
+        return;
+
+    // Pre-transform the appended vertices in place
+    if (states.transform != Transform::Identity)
+    {
+        Vector2f* positions = &m_queue.vertices[command.firstVertex].position;
+        priv::transformPoints(states.transform, positions, sizeof(Vertex), positions, sizeof(Vertex), command.vertexCount);
+    }
+
+    m_queue.commands.push_back(command);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::queueDraw(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount, const RenderStates& states)
+{
+    DrawCommand command;
+    command.layer = m_queue.layer;
+    command.blendKey = RenderTargetImpl::blendKey(states.blendMode);
+    command.states = states;
+    command.type = vertexBuffer.getPrimitiveType();
+    command.firstVertex = firstVertex;
+    command.vertexCount = vertexCount;
+    command.vertexBuffer = &vertexBuffer;
+
+    m_queue.commands.push_back(command);
+}
+
 } // namespace sf
 
 
@@ -799,7 +1485,11 @@ void RenderTarget::cleanupDraw(const RenderStates& states)
 //   lead, in worst case, to changing it every 4 vertices.
 //   To avoid that, when the vertex count is low enough, we
 //   pre-transform them and therefore use an identity transform
-//   to render them.
+//   to render them. The transform runs with SIMD instructions
+//   (see priv::transformPoints) into a cache that grows up to
+//   VertexCacheSize vertices, so that most shapes, sprites and
+//   texts share the identity transform. Vertices drawn with an
+//   identity transform are used in place.
 //
 // * Blending mode
 //   Since it overloads the == operator, we can easily check
@@ -820,4 +1510,18 @@ void RenderTarget::cleanupDraw(const RenderStates& states)
 //   do is that we avoid setting a null shader if there was
 //   already none for the previous draw.
 //
+// * Deferred draws
+//   In the deferred draw modes the states are not cached but
+//   sorted: draws are queued with pre-transformed vertices and
+//   converted to lists (points, lines, triangles), so that any
+//   run of draws sharing texture, shader and blend mode can be
+//   concatenated and sent in one call when the queue is flushed.
+//
+// * Core profile
+//   Contexts created with the Core attribute have neither the
+//   fixed-function matrices nor client-side arrays. The states
+//   above are then applied to priv::GLCoreRenderer (uniforms
+//   of a built-in program) and vertices are streamed to a
+//   buffer object instead of being pointed to.
+//
 ////////////////////////////////////////////////////////////
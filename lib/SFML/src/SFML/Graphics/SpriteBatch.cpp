@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SpriteBatch.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <cstdlib>
+
+
+namespace
+{
+    // A nested named namespace is used here to allow unity builds of SFML.
+    namespace SpriteBatchImpl
+    {
+        // Append a quad (corners in sf::Quads order) as two triangles
+        void appendQuad(std::vector<sf::Vertex>& vertices, const sf::Vertex& topLeft, const sf::Vertex& topRight,
+                        const sf::Vertex& bottomRight, const sf::Vertex& bottomLeft)
+        {
+            vertices.push_back(topLeft);
+            vertices.push_back(topRight);
+            vertices.push_back(bottomLeft);
+            vertices.push_back(bottomLeft);
+            vertices.push_back(topRight);
+            vertices.push_back(bottomRight);
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch(Mode mode) :
+m_mode      (mode),
+m_batches   (),
+m_batchCount(0),
+m_quadCount (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::clear()
+{
+    for (std::size_t i = 0; i < m_batchCount; ++i)
+        m_batches[i].vertices.clear();
+
+    m_batchCount = 0;
+    m_quadCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::add(const Sprite& sprite, const RenderStates& states)
+{
+    const Texture* texture = sprite.getTexture();
+    if (!texture)
+        return;
+
+    // Same corners and texture coordinates as sf::Sprite's own vertices
+    Transform transform = states.transform * sprite.getTransform();
+    FloatRect bounds = sprite.getLocalBounds();
+    FloatRect rect = FloatRect(sprite.getTextureRect());
+    Color color = sprite.getColor();
+
+    float texRight = rect.left + rect.width;
+    float texBottom = rect.top + rect.height;
+
+    Vector2f corners[4] = {Vector2f(0.f, 0.f), Vector2f(bounds.width, 0.f),
+                           Vector2f(bounds.width, bounds.height), Vector2f(0.f, bounds.height)};
+    transform.transformPoints(corners, corners, 4);
+
+    std::vector<Vertex>& vertices = groupFor(texture, states.blendMode, states.shader);
+    SpriteBatchImpl::appendQuad(vertices,
+        Vertex(corners[0], color, Vector2f(rect.left, rect.top)),
+        Vertex(corners[1], color, Vector2f(texRight, rect.top)),
+        Vertex(corners[2], color, Vector2f(texRight, texBottom)),
+        Vertex(corners[3], color, Vector2f(rect.left, texBottom)));
+    ++m_quadCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::add(const Vertex* quad, const RenderStates& states)
+{
+    if (!quad)
+        return;
+
+    Vertex corners[4];
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        corners[i] = quad[i];
+        corners[i].position = states.transform.transformPoint(quad[i].position);
+    }
+
+    std::vector<Vertex>& vertices = groupFor(states.texture, states.blendMode, states.shader);
+    SpriteBatchImpl::appendQuad(vertices, corners[0], corners[1], corners[2], corners[3]);
+    ++m_quadCount;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SpriteBatch::getQuadCount() const
+{
+    return m_quadCount;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SpriteBatch::getBatchCount() const
+{
+    return m_batchCount;
+}
+
+
+////////////////////////////////////////////////////////////
+std::vector<Vertex>& SpriteBatch::groupFor(const Texture* texture, const BlendMode& blendMode, const Shader* shader)
+{
+    // KeepOrder can only extend the last group; GroupByState looks
+    // through all of them (there are usually a handful)
+    std::size_t first = (m_mode == KeepOrder && m_batchCount > 0) ? m_batchCount - 1 : 0;
+    for (std::size_t i = first; i < m_batchCount; ++i)
+    {
+        Batch& batch = m_batches[i];
+        if ((batch.texture == texture) && (batch.blendMode == blendMode) && (batch.shader == shader))
+            return batch.vertices;
+    }
+
+    // Start a new group, reusing the memory of a previous frame's if any
+    if (m_batchCount == m_batches.size())
+        m_batches.push_back(Batch());
+
+    Batch& batch = m_batches[m_batchCount++];
+    batch.texture = texture;
+    batch.blendMode = blendMode;
+    batch.shader = shader;
+    batch.vertices.clear();
+    return batch.vertices;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::draw(RenderTarget& target, RenderStates states) const
+{
+    for (std::size_t i = 0; i < m_batchCount; ++i)
+    {
+        const Batch& batch = m_batches[i];
+
+        states.texture = batch.texture;
+        states.blendMode = batch.blendMode;
+        states.shader = batch.shader;
+        target.draw(&batch.vertices[0], batch.vertices.size(), Triangles, states);
+    }
+}
+
+} // namespace sf
@@ -0,0 +1,369 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/StreamingVertexBuffer.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // A nested named namespace is used here to allow unity builds of SFML.
+    namespace StreamingVertexBufferImpl
+    {
+        // How long to wait for a fence before checking again: 1 ms
+        const GLuint64 waitTimeout = 1000000;
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+const std::size_t StreamingVertexBuffer::RegionCount;
+
+
+////////////////////////////////////////////////////////////
+StreamingVertexBuffer::StreamingVertexBuffer(PrimitiveType type) :
+m_buffer     (type, VertexBuffer::Stream),
+m_capacity   (0),
+m_region     (0),
+m_vertexCount(0),
+m_persistent (NULL),
+m_mapped     (false),
+m_staging    ()
+{
+    for (std::size_t i = 0; i < RegionCount; ++i)
+        m_fences[i] = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+    TransientContextLock contextLock;
+
+    release();
+}
+
+
+////////////////////////////////////////////////////////////
+bool StreamingVertexBuffer::create(std::size_t vertexCount)
+{
+    if (!isAvailable())
+        return false;
+
+    TransientContextLock contextLock;
+
+    // Start from a new buffer object: storage made immutable by
+    // glBufferStorage can't be reallocated
+    release();
+    m_buffer = VertexBuffer(m_buffer.getPrimitiveType(), VertexBuffer::Stream);
+    m_capacity = 0;
+    m_vertexCount = 0;
+    m_mapped = false;
+
+    if (vertexCount == 0)
+        return true;
+
+    if (!m_buffer.create(vertexCount * RegionCount))
+        return false;
+
+#ifndef SFML_OPENGL_ES
+
+    // Map the whole buffer once for good if possible (fences are needed to use it safely)
+    if (GLEXT_buffer_storage && GLEXT_sync)
+    {
+        GLsizeiptr size = static_cast<GLsizeiptr>(sizeof(Vertex) * vertexCount * RegionCount);
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        void* data = NULL;
+
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer.getNativeHandle()));
+        glCheck(glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags));
+        glCheck(data = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+
+        m_persistent = static_cast<Vertex*>(data);
+    }
+
+#endif
+
+    m_capacity = vertexCount;
+
+    // So that the first map starts with the first region
+    m_region = RegionCount - 1;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t StreamingVertexBuffer::getCapacity() const
+{
+    return m_capacity;
+}
+
+
+////////////////////////////////////////////////////////////
+Vertex* StreamingVertexBuffer::map(std::size_t vertexCount)
+{
+    if (m_mapped)
+    {
+        err() << "Failed to map streaming vertex buffer, it is already mapped" << std::endl;
+        return NULL;
+    }
+
+    if (vertexCount == 0)
+    {
+        m_vertexCount = 0;
+        return NULL;
+    }
+
+    // Grow geometrically, so that slowly growing contents don't reallocate every frame
+    if ((vertexCount > m_capacity) && !create(std::max(vertexCount, m_capacity * 2)))
+        return NULL;
+
+    TransientContextLock contextLock;
+
+#ifndef SFML_OPENGL_ES
+
+    // Leave the current region: fence the draws issued so far, the last ones that may read it
+    if (GLEXT_sync)
+    {
+        if (m_fences[m_region])
+            glCheck(glDeleteSync(static_cast<GLsync>(m_fences[m_region])));
+
+        GLsync fence = NULL;
+        glCheck(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        m_fences[m_region] = fence;
+    }
+
+#endif
+
+    m_region = (m_region + 1) % RegionCount;
+    waitRegion(m_region);
+
+    m_vertexCount = vertexCount;
+    m_mapped = true;
+
+    std::size_t first = m_region * m_capacity;
+    if (m_persistent)
+        return m_persistent + first;
+
+#ifndef SFML_OPENGL_ES
+
+    if (GLEXT_map_buffer_range)
+    {
+        void* data = NULL;
+
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer.getNativeHandle()));
+
+        // Without fences, orphan the whole buffer when coming back to
+        // the first region instead: draws in flight keep the old storage
+        if (!GLEXT_sync && (m_region == 0))
+            glCheck(GLEXT_glBufferData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLsizeiptrARB>(sizeof(Vertex) * m_capacity * RegionCount), NULL, GLEXT_GL_STREAM_DRAW));
+
+        // The region is not in use anymore: no need for the driver to synchronize
+        glCheck(data = glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(Vertex) * first), static_cast<GLsizeiptr>(sizeof(Vertex) * vertexCount),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+
+        if (!data)
+        {
+            err() << "Failed to map streaming vertex buffer" << std::endl;
+            m_mapped = false;
+            m_vertexCount = 0;
+        }
+
+        return static_cast<Vertex*>(data);
+    }
+
+#endif
+
+    // No mapping: the vertices are uploaded by unmap
+    m_staging.resize(vertexCount);
+    return &m_staging[0];
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexBuffer::unmap()
+{
+    if (!m_mapped)
+        return;
+
+    m_mapped = false;
+
+    // Coherent persistent mapping: writes are visible to the GPU as they are
+    if (m_persistent)
+        return;
+
+#ifndef SFML_OPENGL_ES
+
+    if (GLEXT_map_buffer_range)
+    {
+        TransientContextLock contextLock;
+
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer.getNativeHandle()));
+        glCheck(glUnmapBuffer(GL_ARRAY_BUFFER));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+        return;
+    }
+
+#endif
+
+    m_buffer.update(&m_staging[0], m_vertexCount, static_cast<unsigned int>(m_region * m_capacity));
+}
+
+
+////////////////////////////////////////////////////////////
+bool StreamingVertexBuffer::update(const Vertex* vertices, std::size_t vertexCount)
+{
+    if (!vertices || (vertexCount == 0))
+    {
+        m_vertexCount = 0;
+        return vertices != NULL;
+    }
+
+    Vertex* data = map(vertexCount);
+    if (!data)
+        return false;
+
+    std::copy(vertices, vertices + vertexCount, data);
+    unmap();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t StreamingVertexBuffer::getVertexCount() const
+{
+    return m_vertexCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexBuffer::setPrimitiveType(PrimitiveType type)
+{
+    m_buffer.setPrimitiveType(type);
+}
+
+
+////////////////////////////////////////////////////////////
+PrimitiveType StreamingVertexBuffer::getPrimitiveType() const
+{
+    return m_buffer.getPrimitiveType();
+}
+
+
+////////////////////////////////////////////////////////////
+bool StreamingVertexBuffer::isPersistent() const
+{
+    return m_persistent != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool StreamingVertexBuffer::isAvailable()
+{
+    return VertexBuffer::isAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexBuffer::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_mapped)
+    {
+        err() << "Failed to draw streaming vertex buffer, it is still mapped" << std::endl;
+        return;
+    }
+
+    if (m_vertexCount)
+        target.draw(m_buffer, m_region * m_capacity, m_vertexCount, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexBuffer::waitRegion(std::size_t region)
+{
+#ifndef SFML_OPENGL_ES
+
+    GLsync fence = static_cast<GLsync>(m_fences[region]);
+    if (!fence)
+        return;
+
+    // Flush the first time, or the fence may never be reached
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    GLenum result = GL_TIMEOUT_EXPIRED;
+    while (result == GL_TIMEOUT_EXPIRED)
+    {
+        glCheck(result = glClientWaitSync(fence, flags, StreamingVertexBufferImpl::waitTimeout));
+        flags = 0;
+    }
+
+    glCheck(glDeleteSync(fence));
+    m_fences[region] = NULL;
+
+#else
+
+    (void)region;
+
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexBuffer::release()
+{
+#ifndef SFML_OPENGL_ES
+
+    for (std::size_t i = 0; i < RegionCount; ++i)
+    {
+        if (m_fences[i])
+            glCheck(glDeleteSync(static_cast<GLsync>(m_fences[i])));
+
+        m_fences[i] = NULL;
+    }
+
+    if (m_persistent)
+    {
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer.getNativeHandle()));
+        glCheck(glUnmapBuffer(GL_ARRAY_BUFFER));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+    }
+
+#endif
+
+    m_persistent = NULL;
+}
+
+} // namespace sf
@@ -28,6 +28,7 @@
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
 #include <cmath>
 
 
@@ -47,15 +48,17 @@ namespace
         vertices.append(sf::Vertex(sf::Vector2f(lineLength + outlineThickness, bottom + outlineThickness), color, sf::Vector2f(1, 1)));
     }
 
-    // Add a glyph quad to the vertex array
-    void addGlyphQuad(sf::VertexArray& vertices, sf::Vector2f position, const sf::Color& color, const sf::Glyph& glyph, float italicShear)
+    // Add a glyph quad to the vertex array, with padding texels around the glyph
+    // (the quad is scaled from the texture when drawing distance field glyphs)
+    void addGlyphQuad(sf::VertexArray& vertices, sf::Vector2f position, const sf::Color& color, const sf::Glyph& glyph, float italicShear,
+                      float padding = 1.f, float scale = 1.f)
     {
-        float padding = 1.0;
+        float margin = padding * scale;
 
-        float left   = glyph.bounds.left - padding;
-        float top    = glyph.bounds.top - padding;
-        float right  = glyph.bounds.left + glyph.bounds.width + padding;
-        float bottom = glyph.bounds.top  + glyph.bounds.height + padding;
+        float left   = glyph.bounds.left - margin;
+        float top    = glyph.bounds.top - margin;
+        float right  = glyph.bounds.left + glyph.bounds.width + margin;
+        float bottom = glyph.bounds.top  + glyph.bounds.height + margin;
 
         float u1 = static_cast<float>(glyph.textureRect.left) - padding;
         float v1 = static_cast<float>(glyph.textureRect.top) - padding;
@@ -69,6 +72,30 @@ namespace
         vertices.append(sf::Vertex(sf::Vector2f(position.x + right - italicShear * top   , position.y + top),    color, sf::Vector2f(u2, v1)));
         vertices.append(sf::Vertex(sf::Vector2f(position.x + right - italicShear * bottom, position.y + bottom), color, sf::Vector2f(u2, v2)));
     }
+
+    // Get a glyph of the font, scaled from its distance field glyph in distance field mode
+    sf::Glyph getGlyph(const sf::Font& font, sf::Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField)
+    {
+        if (!distanceField)
+            return font.getGlyph(codePoint, characterSize, bold);
+
+        const float scale = static_cast<float>(characterSize) / static_cast<float>(sf::Font::DistanceFieldSize);
+        sf::Glyph glyph = font.getDistanceFieldGlyph(codePoint, bold);
+        glyph.advance *= scale;
+        glyph.bounds = sf::FloatRect(glyph.bounds.left * scale, glyph.bounds.top * scale, glyph.bounds.width * scale, glyph.bounds.height * scale);
+
+        return glyph;
+    }
+
+    // Get the kerning of two glyphs of the font, scaled from the distance field glyphs in distance field mode
+    float getKerning(const sf::Font& font, sf::Uint32 first, sf::Uint32 second, unsigned int characterSize, bool bold, bool distanceField)
+    {
+        if (!distanceField)
+            return font.getKerning(first, second, characterSize, bold);
+
+        const float scale = static_cast<float>(characterSize) / static_cast<float>(sf::Font::DistanceFieldSize);
+        return font.getDistanceFieldKerning(first, second, bold) * scale;
+    }
 }
 
 
@@ -85,6 +112,9 @@ m_style              (Regular),
 m_fillColor          (255, 255, 255),
 m_outlineColor       (0, 0, 0),
 m_outlineThickness   (0),
+m_glowColor          (Color::Transparent),
+m_glowRadius         (0),
+m_distanceField      (false),
 m_vertices           (Triangles),
 m_outlineVertices    (Triangles),
 m_bounds             (),
@@ -106,6 +136,9 @@ m_style              (Regular),
 m_fillColor          (255, 255, 255),
 m_outlineColor       (0, 0, 0),
 m_outlineThickness   (0),
+m_glowColor          (Color::Transparent),
+m_glowRadius         (0),
+m_distanceField      (false),
 m_vertices           (Triangles),
 m_outlineVertices    (Triangles),
 m_bounds             (),
@@ -236,6 +269,31 @@ void Text::setOutlineThickness(float thickness)
 }
 
 
+////////////////////////////////////////////////////////////
+void Text::setGlowColor(const Color& color)
+{
+    m_glowColor = color;
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::setGlowRadius(float radius)
+{
+    m_glowRadius = radius;
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::setDistanceField(bool distanceField)
+{
+    if (distanceField != m_distanceField)
+    {
+        m_distanceField = distanceField;
+        m_geometryNeedUpdate = true;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 const String& Text::getString() const
 {
@@ -306,6 +364,27 @@ float Text::getOutlineThickness() const
 }
 
 
+////////////////////////////////////////////////////////////
+const Color& Text::getGlowColor() const
+{
+    return m_glowColor;
+}
+
+
+////////////////////////////////////////////////////////////
+float Text::getGlowRadius() const
+{
+    return m_glowRadius;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Text::isDistanceField() const
+{
+    return m_distanceField;
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2f Text::findCharacterPos(std::size_t index) const
 {
@@ -319,7 +398,8 @@ Vector2f Text::findCharacterPos(std::size_t index) const
 
     // Precompute the variables needed by the algorithm
     bool  isBold          = m_style & Bold;
-    float whitespaceWidth = m_font->getGlyph(L' ', m_characterSize, isBold).advance;
+    bool  distanceField   = usesDistanceField();
+    float whitespaceWidth = getGlyph(*m_font, L' ', m_characterSize, isBold, distanceField).advance;
     float letterSpacing   = ( whitespaceWidth / 3.f ) * ( m_letterSpacingFactor - 1.f );
     whitespaceWidth      += letterSpacing;
     float lineSpacing     = m_font->getLineSpacing(m_characterSize) * m_lineSpacingFactor;
@@ -332,7 +412,7 @@ Vector2f Text::findCharacterPos(std::size_t index) const
         Uint32 curChar = m_string[i];
 
         // Apply the kerning offset
-        position.x += m_font->getKerning(prevChar, curChar, m_characterSize, isBold);
+        position.x += getKerning(*m_font, prevChar, curChar, m_characterSize, isBold, distanceField);
         prevChar = curChar;
 
         // Handle special characters
@@ -344,7 +424,7 @@ Vector2f Text::findCharacterPos(std::size_t index) const
         }
 
         // For regular characters, add the advance offset of the glyph
-        position.x += m_font->getGlyph(curChar, m_characterSize, isBold).advance + letterSpacing;
+        position.x += getGlyph(*m_font, curChar, m_characterSize, isBold, distanceField).advance + letterSpacing;
     }
 
     // Transform the position to global coordinates
@@ -375,10 +455,27 @@ void Text::draw(RenderTarget& target, RenderStates states) const
 {
     if (m_font)
     {
+        // Get the texture first: it adds the glyphs the font preloaded
+        // since the last frame, which the geometry must account for
+        states.texture = &getFontTexture();
         ensureGeometryUpdate();
 
         states.transform *= getTransform();
-        states.texture = &m_font->getTexture(m_characterSize);
+
+        if (usesDistanceField())
+        {
+            // Convert the outline and glow sizes from pixels to distance field units
+            const float scale = static_cast<float>(Font::DistanceFieldSize) /
+                                (static_cast<float>(m_characterSize) * 2.f * static_cast<float>(Font::DistanceFieldSpread));
+
+            Font::DistanceFieldStyle style;
+            style.outlineWidth = std::abs(m_outlineThickness) * scale;
+            style.outlineColor = m_outlineThickness != 0 ? m_outlineColor : m_fillColor;
+            style.glowWidth = m_glowRadius * scale;
+            style.glowColor = m_glowColor;
+            m_font->setDistanceFieldStyle(target, style);
+            states.shader = m_font->getDistanceFieldShader();
+        }
 
         // Only draw the outline if there is something to draw
         if (m_outlineThickness != 0)
@@ -396,11 +493,11 @@ void Text::ensureGeometryUpdate() const
         return;
 
     // Do nothing, if geometry has not changed and the font texture has not changed
-    if (!m_geometryNeedUpdate && m_font->getTexture(m_characterSize).m_cacheId == m_fontTextureId)
+    if (!m_geometryNeedUpdate && getFontTexture().m_cacheId == m_fontTextureId)
         return;
 
     // Save the current fonts texture id
-    m_fontTextureId = m_font->getTexture(m_characterSize).m_cacheId;
+    m_fontTextureId = getFontTexture().m_cacheId;
 
     // Mark geometry as updated
     m_geometryNeedUpdate = false;
@@ -422,14 +519,19 @@ void Text::ensureGeometryUpdate() const
     float underlineOffset    = m_font->getUnderlinePosition(m_characterSize);
     float underlineThickness = m_font->getUnderlineThickness(m_characterSize);
 
+    // Distance field glyphs are scaled from their size, and have their whole spread around them
+    bool  distanceField      = usesDistanceField();
+    float glyphPadding       = distanceField ? static_cast<float>(Font::DistanceFieldSpread) : 1.f;
+    float glyphScale         = distanceField ? static_cast<float>(m_characterSize) / static_cast<float>(Font::DistanceFieldSize) : 1.f;
+
     // Compute the location of the strike through dynamically
     // We use the center point of the lowercase 'x' glyph as the reference
     // We reuse the underline thickness as the thickness of the strike through as well
-    FloatRect xBounds = m_font->getGlyph(L'x', m_characterSize, isBold).bounds;
+    FloatRect xBounds = getGlyph(*m_font, L'x', m_characterSize, isBold, distanceField).bounds;
     float strikeThroughOffset = xBounds.top + xBounds.height / 2.f;
 
     // Precompute the variables needed by the algorithm
-    float whitespaceWidth = m_font->getGlyph(L' ', m_characterSize, isBold).advance;
+    float whitespaceWidth = getGlyph(*m_font, L' ', m_characterSize, isBold, distanceField).advance;
     float letterSpacing   = ( whitespaceWidth / 3.f ) * ( m_letterSpacingFactor - 1.f );
     whitespaceWidth      += letterSpacing;
     float lineSpacing     = m_font->getLineSpacing(m_characterSize) * m_lineSpacingFactor;
@@ -451,7 +553,7 @@ void Text::ensureGeometryUpdate() const
             continue;
 
         // Apply the kerning offset
-        x += m_font->getKerning(prevChar, curChar, m_characterSize, isBold);
+        x += getKerning(*m_font, prevChar, curChar, m_characterSize, isBold, distanceField);
 
         // If we're using the underlined style and there's a new line, draw a line
         if (isUnderlined && (curChar == L'\n' && prevChar != L'\n'))
@@ -495,8 +597,8 @@ void Text::ensureGeometryUpdate() const
             continue;
         }
 
-        // Apply the outline
-        if (m_outlineThickness != 0)
+        // Apply the outline (the distance field shader draws it around the fill)
+        if ((m_outlineThickness != 0) && !distanceField)
         {
             const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, isBold, m_outlineThickness);
 
@@ -505,10 +607,10 @@ void Text::ensureGeometryUpdate() const
         }
 
         // Extract the current glyph's description
-        const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, isBold);
+        const Glyph glyph = getGlyph(*m_font, curChar, m_characterSize, isBold, distanceField);
 
         // Add the glyph to the vertices
-        addGlyphQuad(m_vertices, Vector2f(x, y), m_fillColor, glyph, italicShear);
+        addGlyphQuad(m_vertices, Vector2f(x, y), m_fillColor, glyph, italicShear, glyphPadding, glyphScale);
 
         // Update the current bounds
         float left   = glyph.bounds.left;
@@ -558,6 +660,24 @@ void Text::ensureGeometryUpdate() const
     m_bounds.top = minY;
     m_bounds.width = maxX - minX;
     m_bounds.height = maxY - minY;
+
+    // Loading new glyphs updated the font texture, but the glyphs already
+    // there keep their place in it: no need to build again at the next draw
+    m_fontTextureId = getFontTexture().m_cacheId;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Text::usesDistanceField() const
+{
+    return m_distanceField && (m_characterSize > 0) && m_font->getDistanceFieldShader();
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& Text::getFontTexture() const
+{
+    return usesDistanceField() ? m_font->getDistanceFieldTexture() : m_font->getTexture(m_characterSize);
 }
 
 } // namespace sf
@@ -34,6 +34,7 @@
 #include <SFML/System/Mutex.hpp>
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Trace.hpp>
 #include <cassert>
 #include <cstring>
 #include <climits>
@@ -226,6 +227,8 @@ bool Texture::create(unsigned int width, unsigned int height)
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromFile(const std::string& filename, const IntRect& area)
 {
+    SFML_TRACE_ZONE("Texture::loadFromFile");
+
     Image image;
     return image.loadFromFile(filename) && loadFromImage(image, area);
 }
@@ -234,6 +237,8 @@ bool Texture::loadFromFile(const std::string& filename, const IntRect& area)
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromMemory(const void* data, std::size_t size, const IntRect& area)
 {
+    SFML_TRACE_ZONE("Texture::loadFromMemory");
+
     Image image;
     return image.loadFromMemory(data, size) && loadFromImage(image, area);
 }
@@ -242,6 +247,8 @@ bool Texture::loadFromMemory(const void* data, std::size_t size, const IntRect&
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromStream(InputStream& stream, const IntRect& area)
 {
+    SFML_TRACE_ZONE("Texture::loadFromStream");
+
     Image image;
     return image.loadFromStream(stream) && loadFromImage(image, area);
 }
@@ -0,0 +1,681 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextureAtlas.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    namespace TextureAtlasImpl
+    {
+        // Segment of the skyline: x, y (top of the packed area) and width
+        typedef sf::Vector3<unsigned int> Segment;
+
+        // Find the lowest place of the skyline where a rectangle fits;
+        // on ties, the narrowest segment is preferred to leave wide ones free
+        bool findPosition(const std::vector<Segment>& skyline, const sf::Vector2u& atlasSize, const sf::Vector2u& size,
+                          std::size_t& index, sf::Vector2u& position)
+        {
+            bool found = false;
+            unsigned int bestBottom = 0;
+            unsigned int bestWidth = 0;
+
+            for (std::size_t i = 0; i < skyline.size(); ++i)
+            {
+                // Segments are sorted by x: the next ones can't fit either
+                if (skyline[i].x + size.x > atlasSize.x)
+                    break;
+
+                // The rectangle rests on the highest segment it spans
+                unsigned int y = 0;
+                unsigned int covered = 0;
+                for (std::size_t j = i; covered < size.x; ++j)
+                {
+                    y = std::max(y, skyline[j].y);
+                    covered += skyline[j].z;
+                }
+
+                unsigned int bottom = y + size.y;
+                if (bottom > atlasSize.y)
+                    continue;
+
+                if (!found || (bottom < bestBottom) || ((bottom == bestBottom) && (skyline[i].z < bestWidth)))
+                {
+                    found = true;
+                    bestBottom = bottom;
+                    bestWidth = skyline[i].z;
+                    index = i;
+                    position = sf::Vector2u(skyline[i].x, y);
+                }
+            }
+
+            return found;
+        }
+
+        // Raise the skyline over a rectangle placed by findPosition
+        void place(std::vector<Segment>& skyline, std::size_t index, const sf::Vector2u& position, const sf::Vector2u& size)
+        {
+            skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(index), Segment(position.x, position.y + size.y, size.x));
+
+            // Cut the segments that are now under the rectangle
+            const unsigned int right = position.x + size.x;
+            std::size_t i = index + 1;
+            while ((i < skyline.size()) && (skyline[i].x < right))
+            {
+                unsigned int end = skyline[i].x + skyline[i].z;
+                if (end <= right)
+                {
+                    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+                else
+                {
+                    skyline[i].x = right;
+                    skyline[i].z = end - right;
+                    break;
+                }
+            }
+
+            // Merge the neighbours of the same height
+            for (i = 0; i + 1 < skyline.size();)
+            {
+                if (skyline[i].y == skyline[i + 1].y)
+                {
+                    skyline[i].z += skyline[i + 1].z;
+                    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        // Take the smallest space released by a removed region that fits a rectangle
+        bool takeFreeRect(std::vector<sf::IntRect>& freeRects, const sf::Vector2u& size, sf::IntRect& rect)
+        {
+            const int width = static_cast<int>(size.x);
+            const int height = static_cast<int>(size.y);
+
+            std::size_t best = freeRects.size();
+            for (std::size_t i = 0; i < freeRects.size(); ++i)
+            {
+                const sf::IntRect& space = freeRects[i];
+                if ((space.width < width) || (space.height < height))
+                    continue;
+
+                if ((best == freeRects.size()) || (space.width * space.height < freeRects[best].width * freeRects[best].height))
+                    best = i;
+            }
+
+            if (best == freeRects.size())
+                return false;
+
+            sf::IntRect space = freeRects[best];
+            freeRects[best] = freeRects.back();
+            freeRects.pop_back();
+
+            // Keep what's left on the right of the rectangle and below it
+            rect = sf::IntRect(space.left, space.top, width, height);
+            if (space.width > width)
+                freeRects.push_back(sf::IntRect(space.left + width, space.top, space.width - width, height));
+            if (space.height > height)
+                freeRects.push_back(sf::IntRect(space.left, space.top + height, space.width, space.height - height));
+
+            return true;
+        }
+
+        // Orders rectangles from the tallest to the shortest, then the widest to the narrowest
+        struct TallerFirst
+        {
+            explicit TallerFirst(const std::vector<sf::Vector2u>& theSizes) : sizes(theSizes) {}
+
+            bool operator ()(std::size_t left, std::size_t right) const
+            {
+                if (sizes[left].y != sizes[right].y)
+                    return sizes[left].y > sizes[right].y;
+                if (sizes[left].x != sizes[right].x)
+                    return sizes[left].x > sizes[right].x;
+                return left < right;
+            }
+
+            const std::vector<sf::Vector2u>& sizes;
+        };
+
+        // Pack rectangles in the given order into an empty atlas
+        bool packAll(const std::vector<sf::Vector2u>& sizes, const std::vector<std::size_t>& order, const sf::Vector2u& atlasSize,
+                     std::vector<Segment>& skyline, std::vector<sf::IntRect>& rects)
+        {
+            skyline.assign(1, Segment(0, 0, atlasSize.x));
+            rects.resize(sizes.size());
+
+            for (std::size_t i = 0; i < order.size(); ++i)
+            {
+                const sf::Vector2u& size = sizes[order[i]];
+                std::size_t index = 0;
+                sf::Vector2u position;
+                if (!findPosition(skyline, atlasSize, size, index, position))
+                    return false;
+
+                place(skyline, index, position, size);
+                rects[order[i]] = sf::IntRect(sf::Rect<unsigned int>(position.x, position.y, size.x, size.y));
+            }
+
+            return true;
+        }
+
+        // Double the shorter side of the atlas
+        void grow(sf::Vector2u& atlasSize)
+        {
+            if (atlasSize.x <= atlasSize.y)
+                atlasSize.x *= 2;
+            else
+                atlasSize.y *= 2;
+        }
+
+        // Area of the space released by removed regions
+        unsigned int freeArea(const std::vector<sf::IntRect>& freeRects)
+        {
+            unsigned int area = 0;
+            for (std::size_t i = 0; i < freeRects.size(); ++i)
+                area += static_cast<unsigned int>(freeRects[i].width * freeRects[i].height);
+
+            return area;
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+// Static member data
+////////////////////////////////////////////////////////////
+const Uint32 TextureAtlas::InvalidRegion;
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas() :
+m_texture    (NULL),
+m_pixels     (),
+m_dirtyRows  (0, 0),
+m_isSmooth   (false),
+m_background (Color::Transparent),
+m_skyline    (),
+m_freeRects  (),
+m_regions    (),
+m_freeIds    (),
+m_anchor     (InvalidRegion),
+m_regionCount(0),
+m_usedArea   (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas(const TextureAtlas& copy) :
+m_texture    (NULL),
+m_pixels     (copy.m_pixels),
+m_dirtyRows  (0, copy.m_pixels.getSize().y),
+m_isSmooth   (copy.m_isSmooth),
+m_background (copy.m_background),
+m_skyline    (copy.m_skyline),
+m_freeRects  (copy.m_freeRects),
+m_regions    (copy.m_regions),
+m_freeIds    (copy.m_freeIds),
+m_anchor     (copy.m_anchor),
+m_regionCount(copy.m_regionCount),
+m_usedArea   (copy.m_usedArea)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::~TextureAtlas()
+{
+    delete m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas& TextureAtlas::operator =(const TextureAtlas& right)
+{
+    TextureAtlas temp(right);
+
+    std::swap(m_texture,     temp.m_texture);
+    std::swap(m_pixels,      temp.m_pixels);
+    std::swap(m_dirtyRows,   temp.m_dirtyRows);
+    std::swap(m_isSmooth,    temp.m_isSmooth);
+    std::swap(m_background,  temp.m_background);
+    std::swap(m_skyline,     temp.m_skyline);
+    std::swap(m_freeRects,   temp.m_freeRects);
+    std::swap(m_regions,     temp.m_regions);
+    std::swap(m_freeIds,     temp.m_freeIds);
+    std::swap(m_anchor,      temp.m_anchor);
+    std::swap(m_regionCount, temp.m_regionCount);
+    std::swap(m_usedArea,    temp.m_usedArea);
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::create(unsigned int width, unsigned int height, const Color& background)
+{
+    if ((width == 0) || (height == 0))
+        return false;
+
+    m_pixels.create(width, height, background);
+    invalidate(0, height);
+    m_background = background;
+    m_skyline.assign(1, TextureAtlasImpl::Segment(0, 0, width));
+    m_freeRects.clear();
+    m_regions.clear();
+    m_freeIds.clear();
+    m_anchor = InvalidRegion;
+    m_regionCount = 0;
+    m_usedArea = 0;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 TextureAtlas::add(const Uint8* pixels, unsigned int width, unsigned int height)
+{
+    if (m_skyline.empty())
+    {
+        err() << "Failed to add an image to the texture atlas, the atlas has not been created" << std::endl;
+        return InvalidRegion;
+    }
+
+    if (!pixels || (width == 0) || (height == 0))
+    {
+        err() << "Failed to add an image to the texture atlas, the image is empty" << std::endl;
+        return InvalidRegion;
+    }
+
+    // Look for space released by removed regions, then on top of the skyline
+    const Vector2u size(width, height);
+    IntRect rect;
+    if (!TextureAtlasImpl::takeFreeRect(m_freeRects, size, rect))
+    {
+        std::size_t index = 0;
+        Vector2u position;
+        Vector2u atlasSize = m_pixels.getSize();
+
+        // No room left: grow, the new space extends the skyline and nothing moves
+        while (!TextureAtlasImpl::findPosition(m_skyline, atlasSize, size, index, position))
+        {
+            TextureAtlasImpl::grow(atlasSize);
+            const unsigned int maximumSize = Texture::getMaximumSize();
+            if ((atlasSize.x > maximumSize) || (atlasSize.y > maximumSize))
+            {
+                err() << "Failed to add an image to the texture atlas, the maximum texture size has been reached" << std::endl;
+                return InvalidRegion;
+            }
+
+            resize(atlasSize);
+        }
+
+        TextureAtlasImpl::place(m_skyline, index, position, size);
+        rect = IntRect(Rect<unsigned int>(position.x, position.y, width, height));
+    }
+
+    const unsigned int top = static_cast<unsigned int>(rect.top);
+    Image image;
+    image.create(width, height, pixels);
+    m_pixels.copy(image, static_cast<unsigned int>(rect.left), top);
+    invalidate(top, height);
+
+    // Give the region an identifier, reusing those of removed regions
+    Uint32 region;
+    if (m_freeIds.empty())
+    {
+        m_regions.push_back(rect);
+        region = static_cast<Uint32>(m_regions.size());
+    }
+    else
+    {
+        region = m_freeIds.back();
+        m_freeIds.pop_back();
+        m_regions[region - 1] = rect;
+    }
+
+    if (m_regionCount == 0)
+        m_anchor = region;
+
+    ++m_regionCount;
+    m_usedArea += width * height;
+
+    return region;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 TextureAtlas::add(const Image& image)
+{
+    return add(image.getPixelsPtr(), image.getSize().x, image.getSize().y);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::remove(Uint32 region)
+{
+    if ((region == InvalidRegion) || (region > m_regions.size()) || (m_regions[region - 1].width == 0))
+        return false;
+
+    IntRect rect = m_regions[region - 1];
+    m_regions[region - 1] = IntRect();
+    m_freeIds.push_back(region);
+    --m_regionCount;
+    m_usedArea -= static_cast<unsigned int>(rect.width * rect.height);
+
+    if (region == m_anchor)
+        m_anchor = InvalidRegion;
+
+    if (m_regionCount == 0)
+    {
+        // Start again from an empty layout, so that the next region becomes the anchor
+        m_skyline.assign(1, TextureAtlasImpl::Segment(0, 0, m_pixels.getSize().x));
+        m_freeRects.clear();
+        m_regions.clear();
+        m_freeIds.clear();
+    }
+    else
+    {
+        m_freeRects.push_back(rect);
+    }
+
+    // Erase the pixels, so that smaller regions placed there later
+    // don't get the old ones bleeding on their border
+    const unsigned int top = static_cast<unsigned int>(rect.top);
+    const unsigned int height = static_cast<unsigned int>(rect.height);
+    Image background;
+    background.create(static_cast<unsigned int>(rect.width), height, m_background);
+    m_pixels.copy(background, static_cast<unsigned int>(rect.left), top);
+    invalidate(top, height);
+
+    // Once the holes outgrow the regions, pack the regions again
+    if (TextureAtlasImpl::freeArea(m_freeRects) > m_usedArea)
+        compact();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::clear()
+{
+    if (!m_skyline.empty())
+        create(m_pixels.getSize().x, m_pixels.getSize().y, m_background);
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect TextureAtlas::getRect(Uint32 region) const
+{
+    if ((region == InvalidRegion) || (region > m_regions.size()))
+        return IntRect();
+
+    return m_regions[region - 1];
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureAtlas::getRegionCount() const
+{
+    return m_regionCount;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u TextureAtlas::getSize() const
+{
+    return m_pixels.getSize();
+}
+
+
+////////////////////////////////////////////////////////////
+float TextureAtlas::getOccupancy() const
+{
+    const Vector2u size = m_pixels.getSize();
+    if ((size.x == 0) || (size.y == 0))
+        return 0.f;
+
+    return static_cast<float>(m_usedArea) / (static_cast<float>(size.x) * static_cast<float>(size.y));
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::setSmooth(bool smooth)
+{
+    m_isSmooth = smooth;
+
+    if (m_texture)
+        m_texture->setSmooth(smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::isSmooth() const
+{
+    return m_isSmooth;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureAtlas::getTexture() const
+{
+    if (!m_texture)
+    {
+        m_texture = new Texture;
+        m_texture->setSmooth(m_isSmooth);
+    }
+
+    if (m_dirtyRows.y > m_dirtyRows.x)
+    {
+        // Upload the changed rows at once, or everything if the atlas grew
+        const Vector2u size = m_pixels.getSize();
+        if (m_texture->getSize() != size)
+        {
+            if (!m_texture->loadFromImage(m_pixels))
+                err() << "Failed to create the texture of the texture atlas" << std::endl;
+        }
+        else
+        {
+            const Uint8* rows = m_pixels.getPixelsPtr() + static_cast<std::size_t>(m_dirtyRows.x) * size.x * 4;
+            m_texture->update(rows, size.x, m_dirtyRows.y - m_dirtyRows.x, 0, m_dirtyRows.x);
+        }
+
+        m_dirtyRows = Vector2u(0, 0);
+    }
+
+    return *m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::bake(const std::vector<Image>& images, Image& atlas, std::vector<IntRect>& rects,
+                        unsigned int padding, unsigned int maximumSize, const Color& background)
+{
+    // Every image takes its padding on both sides
+    std::vector<Vector2u> sizes(images.size());
+    std::vector<std::size_t> order;
+    Vector2u atlasSize(1, 1);
+    Uint64 area = 0;
+    for (std::size_t i = 0; i < images.size(); ++i)
+    {
+        const Vector2u size = images[i].getSize();
+        if ((size.x == 0) || (size.y == 0))
+            continue;
+
+        sizes[i] = Vector2u(size.x + 2 * padding, size.y + 2 * padding);
+        order.push_back(i);
+        area += static_cast<Uint64>(sizes[i].x) * sizes[i].y;
+
+        while (atlasSize.x < sizes[i].x)
+            atlasSize.x *= 2;
+        while (atlasSize.y < sizes[i].y)
+            atlasSize.y *= 2;
+    }
+
+    std::sort(order.begin(), order.end(), TextureAtlasImpl::TallerFirst(sizes));
+
+    // Start from the smallest power of two size holding the total
+    // area, and grow until everything fits
+    while (static_cast<Uint64>(atlasSize.x) * atlasSize.y < area)
+        TextureAtlasImpl::grow(atlasSize);
+
+    std::vector<TextureAtlasImpl::Segment> skyline;
+    std::vector<IntRect> packed;
+    for (;;)
+    {
+        if ((atlasSize.x > maximumSize) || (atlasSize.y > maximumSize))
+        {
+            err() << "Failed to bake the texture atlas, the images don't fit in " << maximumSize << "x" << maximumSize << std::endl;
+            return false;
+        }
+
+        if (TextureAtlasImpl::packAll(sizes, order, atlasSize, skyline, packed))
+            break;
+
+        TextureAtlasImpl::grow(atlasSize);
+    }
+
+    // Copy the images into their rectangle, inside the padding
+    atlas.create(atlasSize.x, atlasSize.y, background);
+    rects.assign(images.size(), IntRect());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const std::size_t index = order[i];
+        const Vector2u size = images[index].getSize();
+        const unsigned int left = static_cast<unsigned int>(packed[index].left) + padding;
+        const unsigned int top = static_cast<unsigned int>(packed[index].top) + padding;
+
+        atlas.copy(images[index], left, top);
+        rects[index] = IntRect(Rect<unsigned int>(left, top, size.x, size.y));
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::resize(const Vector2u& size)
+{
+    const Vector2u previousSize = m_pixels.getSize();
+
+    Image pixels;
+    pixels.create(size.x, size.y, m_background);
+    pixels.copy(m_pixels, 0, 0);
+    m_pixels = pixels;
+    invalidate(0, size.y);
+
+    // Extend the skyline over the new columns, at the bottom of the atlas
+    if (size.x > previousSize.x)
+    {
+        TextureAtlasImpl::Segment& last = m_skyline.back();
+        if (last.y == 0)
+            last.z += size.x - previousSize.x;
+        else
+            m_skyline.push_back(TextureAtlasImpl::Segment(previousSize.x, 0, size.x - previousSize.x));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::compact()
+{
+    // Collect the regions in use
+    std::vector<Vector2u> sizes;
+    std::vector<Uint32> regions;
+    for (std::size_t i = 0; i < m_regions.size(); ++i)
+    {
+        if (m_regions[i].width == 0)
+            continue;
+
+        sizes.push_back(Vector2u(static_cast<unsigned int>(m_regions[i].width), static_cast<unsigned int>(m_regions[i].height)));
+        regions.push_back(static_cast<Uint32>(i + 1));
+    }
+
+    std::vector<std::size_t> order(sizes.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), TextureAtlasImpl::TallerFirst(sizes));
+
+    // The anchor goes first, so that it lands in the top-left corner again
+    std::vector<Uint32>::const_iterator anchor = std::find(regions.begin(), regions.end(), m_anchor);
+    if (anchor != regions.end())
+    {
+        std::vector<std::size_t>::iterator first = std::find(order.begin(), order.end(), static_cast<std::size_t>(anchor - regions.begin()));
+        std::rotate(order.begin(), first, first + 1);
+    }
+
+    const Vector2u size = m_pixels.getSize();
+    std::vector<TextureAtlasImpl::Segment> skyline;
+    std::vector<IntRect> rects;
+    if (!TextureAtlasImpl::packAll(sizes, order, size, skyline, rects))
+        return false;
+
+    // Move the pixels of the regions to their new place
+    Image pixels;
+    pixels.create(size.x, size.y, m_background);
+    for (std::size_t i = 0; i < regions.size(); ++i)
+        pixels.copy(m_pixels, static_cast<unsigned int>(rects[i].left), static_cast<unsigned int>(rects[i].top), m_regions[regions[i] - 1]);
+
+    m_pixels = pixels;
+    invalidate(0, size.y);
+
+    for (std::size_t i = 0; i < regions.size(); ++i)
+        m_regions[regions[i] - 1] = rects[i];
+
+    m_skyline.swap(skyline);
+    m_freeRects.clear();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::invalidate(unsigned int top, unsigned int height)
+{
+    if (m_dirtyRows.y > m_dirtyRows.x)
+    {
+        m_dirtyRows.x = std::min(m_dirtyRows.x, top);
+        m_dirtyRows.y = std::max(m_dirtyRows.y, top + height);
+    }
+    else
+    {
+        m_dirtyRows = Vector2u(top, top + height);
+    }
+}
+
+} // namespace sf
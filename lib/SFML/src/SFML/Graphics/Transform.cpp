@@ -26,8 +26,17 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/TransformPoints.hpp>
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define SFML_TRANSFORM_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define SFML_TRANSFORM_NEON
+#endif
+
 
 namespace sf
 {
@@ -109,6 +118,13 @@ Vector2f Transform::transformPoint(const Vector2f& point) const
 }
 
 
+////////////////////////////////////////////////////////////
+void Transform::transformPoints(const Vector2f* points, Vector2f* result, std::size_t count) const
+{
+    priv::transformPoints(*this, points, sizeof(Vector2f), result, sizeof(Vector2f), count);
+}
+
+
 ////////////////////////////////////////////////////////////
 FloatRect Transform::transformRect(const FloatRect& rectangle) const
 {
@@ -288,4 +304,64 @@ bool operator !=(const Transform& left, const Transform& right)
     return !(left == right);
 }
 
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+void transformPoints(const Transform& transform, const Vector2f* points, std::size_t stride,
+                     Vector2f* result, std::size_t resultStride, std::size_t count)
+{
+    const float* m = transform.getMatrix();
+    const char* in = reinterpret_cast<const char*>(points);
+    char* out = reinterpret_cast<char*>(result);
+    std::size_t i = 0;
+
+#if defined(SFML_TRANSFORM_SSE2)
+
+    // Two points per register: (x0, y0, x1, y1)
+    const __m128 column0 = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128 column1 = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    const __m128 offset = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+
+    for (; i + 1 < count; i += 2)
+    {
+        __m128 point = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(in + i * stride));
+        point = _mm_loadh_pi(point, reinterpret_cast<const __m64*>(in + (i + 1) * stride));
+
+        __m128 x = _mm_shuffle_ps(point, point, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y = _mm_shuffle_ps(point, point, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 transformed = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, x), _mm_mul_ps(column1, y)), offset);
+
+        _mm_storel_pi(reinterpret_cast<__m64*>(out + i * resultStride), transformed);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(out + (i + 1) * resultStride), transformed);
+    }
+
+#elif defined(SFML_TRANSFORM_NEON)
+
+    // One point per register: (x, y)
+    const float columns[6] = {m[0], m[1], m[4], m[5], m[12], m[13]};
+    const float32x2_t column0 = vld1_f32(columns);
+    const float32x2_t column1 = vld1_f32(columns + 2);
+    const float32x2_t offset = vld1_f32(columns + 4);
+
+    for (; i < count; ++i)
+    {
+        float32x2_t point = vld1_f32(reinterpret_cast<const float*>(in + i * stride));
+        float32x2_t transformed = vadd_f32(vadd_f32(vmul_lane_f32(column0, point, 0), vmul_lane_f32(column1, point, 1)), offset);
+
+        vst1_f32(reinterpret_cast<float*>(out + i * resultStride), transformed);
+    }
+
+#endif
+
+    // Remaining points (all of them without SIMD)
+    for (; i < count; ++i)
+    {
+        const Vector2f& point = *reinterpret_cast<const Vector2f*>(in + i * stride);
+        *reinterpret_cast<Vector2f*>(out + i * resultStride) = transform.transformPoint(point);
+    }
+}
+
+} // namespace priv
+
 } // namespace sf
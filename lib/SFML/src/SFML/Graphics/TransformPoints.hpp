@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TRANSFORMPOINTS_HPP
+#define SFML_TRANSFORMPOINTS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Transform.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Transform points stored with a stride
+///
+/// This is the kernel behind sf::Transform::transformPoints,
+/// for points that are members of larger structures (like
+/// the position of sf::Vertex). It uses SSE2 or NEON when
+/// the target supports them.
+///
+/// \param transform Transform to apply
+/// \param points    First point to transform
+/// \param stride    Distance in bytes between two source points
+/// \param result    Where to write the first transformed point
+/// \param resultStride Distance in bytes between two transformed points
+/// \param count     Number of points
+///
+////////////////////////////////////////////////////////////
+void transformPoints(const Transform& transform, const Vector2f* points, std::size_t stride,
+                     Vector2f* result, std::size_t resultStride, std::size_t count);
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_TRANSFORMPOINTS_HPP
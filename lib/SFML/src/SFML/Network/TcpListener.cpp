@@ -29,6 +29,7 @@
 #include <SFML/Network/TcpSocket.hpp>
 #include <SFML/Network/SocketImpl.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Trace.hpp>
 
 
 namespace sf
@@ -105,6 +106,8 @@ void TcpListener::close()
 ////////////////////////////////////////////////////////////
 Socket::Status TcpListener::accept(TcpSocket& socket)
 {
+    SFML_TRACE_ZONE("TcpListener::accept");
+
     // Make sure that we're listening
     if (getHandle() == priv::SocketImpl::invalidSocket())
     {
@@ -30,6 +30,7 @@
 #include <SFML/Network/Packet.hpp>
 #include <SFML/Network/SocketImpl.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Trace.hpp>
 #include <algorithm>
 #include <cstring>
 
@@ -118,6 +119,8 @@ unsigned short TcpSocket::getRemotePort() const
 ////////////////////////////////////////////////////////////
 Socket::Status TcpSocket::connect(const IpAddress& remoteAddress, unsigned short remotePort, Time timeout)
 {
+    SFML_TRACE_ZONE("TcpSocket::connect");
+
     // Disconnect the socket if it is already connected
     disconnect();
 
@@ -234,6 +237,8 @@ Socket::Status TcpSocket::send(const void* data, std::size_t size)
 ////////////////////////////////////////////////////////////
 Socket::Status TcpSocket::send(const void* data, std::size_t size, std::size_t& sent)
 {
+    SFML_TRACE_ZONE("TcpSocket::send");
+
     // Check the parameters
     if (!data || (size == 0))
     {
@@ -270,6 +275,8 @@ Socket::Status TcpSocket::send(const void* data, std::size_t size, std::size_t&
 ////////////////////////////////////////////////////////////
 Socket::Status TcpSocket::receive(void* data, std::size_t size, std::size_t& received)
 {
+    SFML_TRACE_ZONE("TcpSocket::receive");
+
     // First clear the variables to fill
     received = 0;
 
@@ -30,6 +30,7 @@
 #include <SFML/Network/Packet.hpp>
 #include <SFML/Network/SocketImpl.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Trace.hpp>
 #include <algorithm>
 
 
@@ -99,6 +100,8 @@ void UdpSocket::unbind()
 ////////////////////////////////////////////////////////////
 Socket::Status UdpSocket::send(const void* data, std::size_t size, const IpAddress& remoteAddress, unsigned short remotePort)
 {
+    SFML_TRACE_ZONE("UdpSocket::send");
+
     // Create the internal socket if it doesn't exist
     create();
 
@@ -130,6 +133,8 @@ Socket::Status UdpSocket::send(const void* data, std::size_t size, const IpAddre
 ////////////////////////////////////////////////////////////
 Socket::Status UdpSocket::receive(void* data, std::size_t size, std::size_t& received, IpAddress& remoteAddress, unsigned short& remotePort)
 {
+    SFML_TRACE_ZONE("UdpSocket::receive");
+
     // First clear the variables to fill
     received      = 0;
     remoteAddress = IpAddress();
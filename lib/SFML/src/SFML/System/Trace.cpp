@@ -0,0 +1,343 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Trace.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Err.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/ThreadLocalPtr.hpp>
+#include <fstream>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+namespace
+{
+    // Loads and stores of values shared between the recording thread and
+    // dump(): the owner publishes new events with a release store, dump()
+    // reads them with an acquire load so that it never sees a count (or
+    // a chunk) before the events it covers are written
+    template <typename T>
+    T loadAcquire(const T& value)
+    {
+#if defined(_MSC_VER)
+        T result = *static_cast<const volatile T*>(&value);
+    #if defined(_M_ARM) || defined(_M_ARM64)
+        __dmb(_ARM64_BARRIER_ISH);
+    #else
+        _ReadWriteBarrier();
+    #endif
+        return result;
+#else
+        return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#endif
+    }
+
+    template <typename T>
+    void storeRelease(T& destination, T value)
+    {
+#if defined(_MSC_VER)
+    #if defined(_M_ARM) || defined(_M_ARM64)
+        __dmb(_ARM64_BARRIER_ISH);
+    #else
+        _ReadWriteBarrier();
+    #endif
+        *static_cast<volatile T*>(&destination) = value;
+#else
+        __atomic_store_n(&destination, value, __ATOMIC_RELEASE);
+#endif
+    }
+
+    // A single timeline event
+    struct Event
+    {
+        const char*  name;
+        sf::Int64    time;  // microseconds since startup
+        double       value; // counters only
+        char         phase; // 'B' (begin), 'E' (end) or 'C' (counter)
+    };
+
+    // Events are stored in fixed-size chunks which never move once
+    // allocated, so that dump() can read them while the owning thread
+    // keeps appending new ones
+    const std::size_t eventsPerChunk     = 4096;
+    const std::size_t maxChunksPerThread = 256;
+
+    struct Chunk
+    {
+        Chunk() : count(0), next(NULL) {}
+
+        Event       events[eventsPerChunk];
+        std::size_t count; // published with storeRelease after the event is written
+        Chunk*      next;  // published with storeRelease once the chunk is ready
+    };
+
+    // Per-thread event storage, only ever written by its owning thread
+    struct ThreadBuffer
+    {
+        unsigned int id;
+        std::string  name; // protected by bufferMutex
+        Chunk*       first;
+        Chunk*       last;
+        std::size_t  chunkCount;
+        std::size_t  depth;        // zones recorded and not closed yet
+        std::size_t  droppedDepth; // zones dropped and not closed yet
+        bool         overflowed;   // published with storeRelease, read by dump()
+    };
+
+    // The registry of all the thread buffers ever created; buffers of
+    // threads that have finished are kept so that their events are dumped too
+    sf::Mutex                        bufferMutex;
+    std::vector<ThreadBuffer*>       buffers;
+    sf::ThreadLocalPtr<ThreadBuffer> currentBuffer(NULL);
+    sf::Clock                        traceClock;
+
+    // Get the buffer of the calling thread, registering it if needed
+    ThreadBuffer& getCurrentBuffer()
+    {
+        if (!currentBuffer)
+        {
+            ThreadBuffer* buffer = new ThreadBuffer;
+            buffer->first      = new Chunk;
+            buffer->last       = buffer->first;
+            buffer->chunkCount   = 1;
+            buffer->depth        = 0;
+            buffer->droppedDepth = 0;
+            buffer->overflowed   = false;
+
+            sf::Lock lock(bufferMutex);
+            buffer->id = static_cast<unsigned int>(buffers.size()) + 1;
+            buffers.push_back(buffer);
+            currentBuffer = buffer;
+        }
+
+        return *currentBuffer;
+    }
+
+    // Number of events that the buffer can still hold
+    std::size_t getFreeEvents(const ThreadBuffer& buffer)
+    {
+        return (maxChunksPerThread - buffer.chunkCount) * eventsPerChunk + (eventsPerChunk - buffer.last->count);
+    }
+
+    // Append an event to the buffer of the calling thread
+    void record(const char* name, char phase, double value)
+    {
+        ThreadBuffer& buffer = getCurrentBuffer();
+
+        if (phase == 'E')
+        {
+            // The beginning of this zone was dropped, drop its end too
+            if (buffer.droppedDepth > 0)
+            {
+                buffer.droppedDepth--;
+                return;
+            }
+
+            if (buffer.depth > 0)
+                buffer.depth--;
+        }
+        else
+        {
+            // Stop recording rather than eating up all the memory, but always
+            // keep enough room to close the zones that are currently open so
+            // that the output stays balanced
+            std::size_t needed = 1 + buffer.depth + (phase == 'B' ? 1 : 0);
+            if (getFreeEvents(buffer) < needed)
+            {
+                storeRelease(buffer.overflowed, true);
+                if (phase == 'B')
+                    buffer.droppedDepth++;
+                return;
+            }
+
+            if (phase == 'B')
+                buffer.depth++;
+        }
+
+        Chunk* chunk = buffer.last;
+        if (chunk->count == eventsPerChunk)
+        {
+            // Only reachable by an endZone() without matching beginZone()
+            if (buffer.chunkCount == maxChunksPerThread)
+            {
+                storeRelease(buffer.overflowed, true);
+                return;
+            }
+
+            Chunk* next = new Chunk;
+            storeRelease(chunk->next, next);
+            buffer.last = next;
+            buffer.chunkCount++;
+            chunk = next;
+        }
+
+        Event& event = chunk->events[chunk->count];
+        event.name  = name;
+        event.time  = traceClock.getElapsedTime().asMicroseconds();
+        event.value = value;
+        event.phase = phase;
+
+        storeRelease(chunk->count, chunk->count + 1);
+    }
+
+    // Write a string as a JSON string literal
+    void writeString(std::ostream& out, const char* str)
+    {
+        out << '"';
+        for (; str && *str; ++str)
+        {
+            char c = *str;
+            if ((c == '"') || (c == '\\'))
+                out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                out << ' ';
+            else
+                out << c;
+        }
+        out << '"';
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+void Trace::beginZone(const char* name)
+{
+    record(name, 'B', 0.0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Trace::endZone()
+{
+    record(NULL, 'E', 0.0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Trace::counter(const char* name, double value)
+{
+    record(name, 'C', value);
+}
+
+
+////////////////////////////////////////////////////////////
+void Trace::setThreadName(const std::string& name)
+{
+    ThreadBuffer& buffer = getCurrentBuffer();
+
+    Lock lock(bufferMutex);
+    buffer.name = name;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Trace::dump(const std::string& filename)
+{
+    std::ofstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to open trace file \"" << filename << "\" for writing" << std::endl;
+        return false;
+    }
+
+    // Numbers are written with enough precision for microsecond timestamps
+    file.precision(15);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    Lock lock(bufferMutex);
+
+    bool first = true;
+    for (std::vector<ThreadBuffer*>::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+    {
+        const ThreadBuffer& buffer = **it;
+
+        // Thread name metadata
+        if (!buffer.name.empty())
+        {
+            file << (first ? "" : ",\n") << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.id
+                 << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            writeString(file, buffer.name.c_str());
+            file << "}}";
+            first = false;
+        }
+
+        if (loadAcquire(buffer.overflowed))
+            err() << "Trace buffer of thread " << buffer.id << " is full, late events were dropped" << std::endl;
+
+        for (const Chunk* chunk = buffer.first; chunk; chunk = loadAcquire(chunk->next))
+        {
+            std::size_t count = loadAcquire(chunk->count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const Event& event = chunk->events[i];
+
+                file << (first ? "" : ",\n") << "{\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer.id
+                     << ",\"ts\":" << event.time;
+
+                if (event.name)
+                {
+                    file << ",\"name\":";
+                    writeString(file, event.name);
+                }
+
+                if (event.phase == 'C')
+                    file << ",\"args\":{\"value\":" << event.value << "}";
+
+                file << "}";
+                first = false;
+            }
+        }
+    }
+
+    file << "\n]}\n";
+
+    return !file.fail();
+}
+
+
+////////////////////////////////////////////////////////////
+TraceZone::TraceZone(const char* name)
+{
+    Trace::beginZone(name);
+}
+
+
+////////////////////////////////////////////////////////////
+TraceZone::~TraceZone()
+{
+    Trace::endZone();
+}
+
+} // namespace sf
@@ -30,6 +30,7 @@
 #include <SFML/Window/WindowImpl.hpp>
 #include <SFML/System/Sleep.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Trace.hpp>
 
 
 namespace sf
@@ -214,6 +215,8 @@ bool Window::setActive(bool active) const
 ////////////////////////////////////////////////////////////
 void Window::display()
 {
+    SFML_TRACE_ZONE("Window::display");
+
     // Display the backbuffer on screen
     if (setActive())
         m_context->display();
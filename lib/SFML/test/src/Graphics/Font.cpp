@@ -0,0 +1,210 @@
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/System/String.hpp>
+#include "GraphicsUtil.hpp"
+
+namespace
+{
+    // Alpha of a pixel, as a fraction
+    float alpha(const sf::Image& image, unsigned int x, unsigned int y)
+    {
+        return static_cast<float>(image.getPixel(x, y).a) / 255.f;
+    }
+
+    // Check that two glyphs have the same metrics and texture rectangle
+    void checkSameGlyph(const sf::Glyph& left, const sf::Glyph& right, bool sameRect)
+    {
+        CHECK(left.advance == right.advance);
+        CHECK(left.lsbDelta == right.lsbDelta);
+        CHECK(left.rsbDelta == right.rsbDelta);
+        CHECK(left.bounds == right.bounds);
+        if (sameRect)
+            CHECK(left.textureRect == right.textureRect);
+    }
+
+    // ASCII characters go through the fast path of the glyph cache, the others through the hash table
+    const sf::Uint32 characters[] = {'A', 'V', 'T', 'o', 'j', '.', ' ', 0xE9, 0xFC, 0x20AC};
+    const std::size_t characterCount = sizeof(characters) / sizeof(characters[0]);
+
+    // Wait for the preloading threads, adding the glyphs they rasterized
+    void waitForPreload(const sf::Font& font)
+    {
+        while (font.isPreloading())
+            sf::sleep(sf::milliseconds(1));
+    }
+}
+
+// Glyph lookups only touch the atlas of the font in system memory, which
+// doesn't need a display as long as it doesn't grow: keep the sizes small
+TEST_CASE("sf::Font glyph and kerning caches", "[graphics]")
+{
+    sf::Font font;
+    REQUIRE(font.loadFromFile("resources/tuffy.ttf"));
+
+    // The same lookups on a font that was never asked for anything, in reverse order
+    sf::Font reference;
+    REQUIRE(reference.loadFromFile("resources/tuffy.ttf"));
+
+    const unsigned int sizes[] = {12, 16};
+    const float outlines[] = {0.f, 2.f};
+    for (std::size_t s = 0; s < 2; ++s)
+    {
+        for (int bold = 0; bold < 2; ++bold)
+        {
+            for (std::size_t o = 0; o < 2; ++o)
+            {
+                INFO("size " << sizes[s] << ", bold " << bold << ", outline " << outlines[o]);
+
+                std::vector<sf::Glyph> loaded;
+                for (std::size_t i = 0; i < characterCount; ++i)
+                    loaded.push_back(font.getGlyph(characters[i], sizes[s], bold != 0, outlines[o]));
+
+                for (std::size_t i = characterCount; i-- > 0;)
+                {
+                    const sf::Glyph& uncached = reference.getGlyph(characters[i], sizes[s], bold != 0, outlines[o]);
+                    const sf::Glyph& cached = font.getGlyph(characters[i], sizes[s], bold != 0, outlines[o]);
+                    checkSameGlyph(cached, loaded[i], true);
+                    checkSameGlyph(cached, uncached, false);
+                }
+            }
+        }
+    }
+
+    SECTION("Bold and outlined glyphs are not mixed up with the regular ones")
+    {
+        CHECK(font.getGlyph('A', 16, true).bounds != font.getGlyph('A', 16, false).bounds);
+        CHECK(font.getGlyph('A', 16, false, 2.f).bounds != font.getGlyph('A', 16, false).bounds);
+        CHECK(font.getGlyph(0xE9, 16, true).bounds != font.getGlyph(0xE9, 16, false).bounds);
+    }
+
+    SECTION("Kernings")
+    {
+        const sf::String pairs = "AVTAVAToLTPAWAyAFA..";
+        bool kerned = false;
+        for (std::size_t i = 0; i + 1 < pairs.getSize(); ++i)
+        {
+            for (int bold = 0; bold < 2; ++bold)
+            {
+                const float uncached = reference.getKerning(pairs[i], pairs[i + 1], 16, bold != 0);
+                const float first = font.getKerning(pairs[i], pairs[i + 1], 16, bold != 0);
+                const float cached = font.getKerning(pairs[i], pairs[i + 1], 16, bold != 0);
+                CHECK(first == uncached);
+                CHECK(cached == uncached);
+                kerned = kerned || (uncached != 0.f);
+            }
+        }
+
+        // Otherwise the test would not check much
+        CHECK(kerned);
+        CHECK(font.getKerning(0, 'A', 16) == 0.f);
+    }
+}
+
+TEST_CASE("sf::Font::convertToDistanceField", "[graphics]")
+{
+    // A 16x16 square covering the pixels 8 to 23, with a half covered pixel on its left side
+    sf::Image image;
+    image.create(32, 32, sf::Color::Transparent);
+    for (unsigned int y = 8; y < 24; ++y)
+        for (unsigned int x = 8; x < 24; ++x)
+            image.setPixel(x, y, sf::Color::White);
+    image.setPixel(7, 16, sf::Color(255, 255, 255, 128));
+
+    sf::Font::convertToDistanceField(image, 8);
+
+    SECTION("Keeps the size and the colors")
+    {
+        CHECK(image.getSize() == sf::Vector2u(32, 32));
+        CHECK(image.getPixel(16, 16).r == 255);
+        CHECK(image.getPixel(0, 0).r == 0);
+    }
+
+    SECTION("Is above one half inside, growing with the distance")
+    {
+        // 1 pixel to the nearest empty one, then 5
+        CHECK(alpha(image, 23, 16) == Approx(0.5f + 1.f / 16.f).margin(0.005));
+        CHECK(alpha(image, 12, 12) == Approx(0.5f + 5.f / 16.f).margin(0.005));
+        CHECK(alpha(image, 16, 16) == 1.f);
+    }
+
+    SECTION("Is one half on the outline")
+    {
+        CHECK(alpha(image, 7, 16) == Approx(0.5f).margin(0.005));
+    }
+
+    SECTION("Is below one half outside, shrinking with the distance")
+    {
+        // 1 pixel to the nearest covered one, then 5, then further than the spread
+        CHECK(alpha(image, 24, 16) == Approx(0.5f - 1.f / 16.f).margin(0.005));
+        CHECK(alpha(image, 28, 16) == Approx(0.5f - 5.f / 16.f).margin(0.005));
+        CHECK(alpha(image, 0, 0) == 0.f);
+    }
+}
+
+// Like above, small sizes keep the atlas in system memory
+TEST_CASE("sf::Font::preload", "[graphics]")
+{
+    sf::Font reference;
+    REQUIRE(reference.loadFromFile("resources/tuffy.ttf"));
+
+    const sf::String text(L"AVTo.j fox \u00E9\u00FC\u20AC");
+    std::vector<unsigned int> sizes;
+    sizes.push_back(12);
+    sizes.push_back(16);
+
+    SECTION("Preloaded glyphs are the ones loaded on demand")
+    {
+        sf::Font font;
+        REQUIRE(font.loadFromFile("resources/tuffy.ttf"));
+        font.preload(text, sizes);
+        font.preload(text, sizes, true, 1.f);
+        waitForPreload(font);
+
+        for (std::size_t s = 0; s < sizes.size(); ++s)
+        {
+            for (std::size_t i = 0; i < text.getSize(); ++i)
+            {
+                INFO("size " << sizes[s] << ", character " << text[i]);
+                checkSameGlyph(font.getGlyph(text[i], sizes[s], false), reference.getGlyph(text[i], sizes[s], false), false);
+                checkSameGlyph(font.getGlyph(text[i], sizes[s], true, 1.f), reference.getGlyph(text[i], sizes[s], true, 1.f), false);
+            }
+        }
+
+        CHECK(!font.isPreloading());
+    }
+
+    SECTION("Glyphs requested while they are preloaded are loaded once")
+    {
+        // Requesting the glyphs right away cancels the ones still queued, and races
+        // with the ones being rasterized: repeat it to hit both cases
+        for (int run = 0; run < 20; ++run)
+        {
+            sf::Font font;
+            REQUIRE(font.loadFromFile("resources/tuffy.ttf"));
+            font.preload(text, sizes);
+
+            std::vector<sf::Glyph> loaded;
+            for (std::size_t i = 0; i < text.getSize(); ++i)
+                loaded.push_back(font.getGlyph(text[i], 16, false));
+
+            waitForPreload(font);
+
+            // The glyphs that came from the threads afterwards didn't replace the ones loaded on demand
+            for (std::size_t i = 0; i < text.getSize(); ++i)
+            {
+                INFO("run " << run << ", character " << text[i]);
+                const sf::Glyph& glyph = font.getGlyph(text[i], 16, false);
+                checkSameGlyph(glyph, loaded[i], true);
+                checkSameGlyph(glyph, reference.getGlyph(text[i], 16, false), false);
+
+                // Each glyph has its own region, except blank ones which have none
+                for (std::size_t j = 0; j < i; ++j)
+                {
+                    if ((text[i] != text[j]) && (glyph.textureRect.width > 0) && (loaded[j].textureRect.width > 0))
+                        CHECK(!glyph.textureRect.intersects(loaded[j].textureRect));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#include <SFML/Graphics/InstanceData.hpp>
+#include "GraphicsUtil.hpp"
+
+TEST_CASE("sf::InstanceData class", "[graphics]")
+{
+    SECTION("Default constructor")
+    {
+        const sf::InstanceData instance;
+        CHECK(instance.transform == sf::Transform::Identity);
+        CHECK(instance.color == sf::Color::White);
+        CHECK(instance.textureRect == sf::FloatRect());
+    }
+
+    SECTION("Transform, color and texture rect constructor")
+    {
+        sf::Transform transform;
+        transform.translate(10.f, 20.f);
+
+        const sf::InstanceData instance(transform, sf::Color::Red, sf::FloatRect(32.f, 0.f, 32.f, 32.f));
+        CHECK(instance.transform == transform);
+        CHECK(instance.color == sf::Color::Red);
+        CHECK(instance.textureRect == sf::FloatRect(32.f, 0.f, 32.f, 32.f));
+    }
+}
@@ -0,0 +1,271 @@
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/InstanceData.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Window/Context.hpp>
+#include "GraphicsUtil.hpp"
+
+namespace
+{
+    // Target without OpenGL: it only queues and merges draws, which is enough for the draw statistics
+    class QueueTarget : public sf::RenderTarget
+    {
+    public:
+        QueueTarget()
+        {
+            initialize();
+        }
+
+        virtual sf::Vector2u getSize() const
+        {
+            return sf::Vector2u(64, 64);
+        }
+
+        virtual bool setActive(bool)
+        {
+            return false;
+        }
+
+        void display()
+        {
+            finishFrame();
+        }
+    };
+
+    // Draw count vertices of the given type, with the given blend mode
+    void drawPrimitives(sf::RenderTarget& target, sf::PrimitiveType type, std::size_t count,
+                        const sf::BlendMode& blendMode = sf::BlendAlpha)
+    {
+        sf::VertexArray vertices(type, count);
+        for (std::size_t i = 0; i < count; ++i)
+            vertices[i].position = sf::Vector2f(static_cast<float>(i % 2) * 8.f, static_cast<float>(i / 2) * 8.f);
+
+        target.draw(vertices, sf::RenderStates(blendMode));
+    }
+
+    // Four vertices of a quad
+    void setQuad(sf::Vertex* quad, const sf::FloatRect& rect, const sf::Color& color)
+    {
+        quad[0] = sf::Vertex(sf::Vector2f(rect.left, rect.top), color);
+        quad[1] = sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top), color);
+        quad[2] = sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top + rect.height), color);
+        quad[3] = sf::Vertex(sf::Vector2f(rect.left, rect.top + rect.height), color);
+    }
+
+    // Shader drawing the vertex colors, as without shader
+    const char* const vertexShader =
+        "void main()\n"
+        "{\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+        "    gl_FrontColor = gl_Color;\n"
+        "}\n";
+
+    const char* const fragmentShader =
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = gl_Color;\n"
+        "}\n";
+
+    // Draw the same scene with a context created with the given settings and read it back
+    sf::Image renderScene(const sf::ContextSettings& settings, const sf::Shader* shader)
+    {
+        // The render texture draws with the active context
+        sf::Context context(settings, 64, 64);
+        REQUIRE(context.setActive(true));
+        REQUIRE((context.getSettings().attributeFlags & sf::ContextSettings::Core) == (settings.attributeFlags & sf::ContextSettings::Core));
+
+        sf::RenderTexture target;
+        REQUIRE(target.create(64, 64));
+        target.clear(sf::Color::Blue);
+
+        sf::RectangleShape rectangle(sf::Vector2f(16.f, 16.f));
+        rectangle.setPosition(8.f, 8.f);
+        rectangle.setFillColor(sf::Color::Red);
+        target.draw(rectangle);
+
+        // Quads from a vertex buffer, which core profiles can't draw as they are
+        sf::Vertex quads[8];
+        setQuad(quads, sf::FloatRect(26.f, 8.f, 12.f, 7.f), sf::Color::Yellow);
+        setQuad(quads + 4, sf::FloatRect(26.f, 17.f, 12.f, 7.f), sf::Color::Yellow);
+        sf::VertexBuffer buffer(sf::Quads, sf::VertexBuffer::Static);
+        REQUIRE(buffer.create(8));
+        REQUIRE(buffer.update(quads));
+        target.draw(buffer);
+
+        sf::VertexArray quad(sf::Quads, 4);
+        setQuad(&quad[0], sf::FloatRect(32.f, 32.f, 24.f, 24.f), sf::Color::Green);
+        target.draw(quad);
+
+        // Two more red squares, drawn as instances of a 16x16 one
+        sf::RectangleShape square(sf::Vector2f(16.f, 16.f));
+        sf::InstanceData instances[2];
+        instances[0] = sf::InstanceData(sf::Transform().translate(40.f, 8.f), sf::Color::Red);
+        instances[1] = sf::InstanceData(sf::Transform().translate(8.f, 40.f), sf::Color::Red);
+        target.drawInstanced(square, instances, 2);
+
+        // Instances of a vertex buffer, with and without shader (which can't read the instances)
+        sf::Vertex small[4];
+        setQuad(small, sf::FloatRect(0.f, 0.f, 6.f, 6.f), sf::Color::White);
+        sf::VertexBuffer smallBuffer(sf::Quads, sf::VertexBuffer::Static);
+        REQUIRE(smallBuffer.create(4));
+        REQUIRE(smallBuffer.update(small));
+
+        instances[0] = sf::InstanceData(sf::Transform().translate(2.f, 28.f), sf::Color::Cyan);
+        instances[1] = sf::InstanceData(sf::Transform().translate(12.f, 28.f), sf::Color::Magenta);
+        target.drawInstanced(smallBuffer, instances, 2);
+
+        instances[0] = sf::InstanceData(sf::Transform().translate(25.f, 40.f), sf::Color::Cyan);
+        instances[1] = sf::InstanceData(sf::Transform().translate(25.f, 50.f), sf::Color::Magenta);
+        target.drawInstanced(smallBuffer, instances, 2, shader);
+
+        target.display();
+        return target.getTexture().copyToImage();
+    }
+}
+
+TEST_CASE("sf::RenderTarget draw queue", "[graphics]")
+{
+    QueueTarget target;
+
+    SECTION("Immediate mode saves nothing")
+    {
+        for (int i = 0; i < 4; ++i)
+            drawPrimitives(target, sf::Triangles, 3);
+        target.display();
+
+        CHECK(target.getDrawStats().draws == 4);
+        CHECK(target.getDrawStats().drawCallsSaved == 0);
+    }
+
+    SECTION("Draws sharing their states are merged")
+    {
+        target.setDrawMode(sf::RenderTarget::DeferredStable);
+        for (int i = 0; i < 4; ++i)
+            drawPrimitives(target, sf::Triangles, 3);
+        drawPrimitives(target, sf::Lines, 2);
+        drawPrimitives(target, sf::Lines, 2);
+        target.display();
+
+        CHECK(target.getDrawStats().draws == 6);
+        CHECK(target.getDrawStats().drawCallsSaved == 4);
+    }
+
+    SECTION("Strips, fans and quads are merged as triangles")
+    {
+        target.setDrawMode(sf::RenderTarget::DeferredStable);
+        drawPrimitives(target, sf::Triangles, 3);
+        drawPrimitives(target, sf::TriangleStrip, 5);
+        drawPrimitives(target, sf::TriangleFan, 4);
+        drawPrimitives(target, sf::Quads, 8);
+        drawPrimitives(target, sf::LineStrip, 3);
+        drawPrimitives(target, sf::Lines, 2);
+        target.display();
+
+        CHECK(target.getDrawStats().draws == 6);
+        CHECK(target.getDrawStats().drawCallsSaved == 4);
+    }
+
+    SECTION("Draws without a whole primitive are skipped")
+    {
+        target.setDrawMode(sf::RenderTarget::DeferredStable);
+        drawPrimitives(target, sf::Triangles, 3);
+        drawPrimitives(target, sf::LineStrip, 1);
+        drawPrimitives(target, sf::Quads, 3);
+        drawPrimitives(target, sf::Triangles, 2);
+        drawPrimitives(target, sf::Triangles, 4);
+        target.display();
+
+        // Nothing is left between the first and the last triangles
+        CHECK(target.getDrawStats().draws == 5);
+        CHECK(target.getDrawStats().drawCallsSaved == 1);
+    }
+
+    SECTION("DeferredStable keeps the order within a layer")
+    {
+        target.setDrawMode(sf::RenderTarget::DeferredStable);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAlpha);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAdd);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAlpha);
+        target.display();
+
+        CHECK(target.getDrawStats().drawCallsSaved == 0);
+    }
+
+    SECTION("DeferredStable orders the layers")
+    {
+        target.setDrawMode(sf::RenderTarget::DeferredStable);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAlpha);
+        target.setDrawLayer(1);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAdd);
+        target.setDrawLayer(0);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAlpha);
+        target.setDrawLayer(1);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAdd);
+        target.display();
+
+        // Both layer 0 draws, then both layer 1 draws
+        CHECK(target.getDrawStats().draws == 4);
+        CHECK(target.getDrawStats().drawCallsSaved == 2);
+    }
+
+    SECTION("DeferredSorted groups the states within a layer")
+    {
+        target.setDrawMode(sf::RenderTarget::DeferredSorted);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAlpha);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAdd);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAlpha);
+        drawPrimitives(target, sf::Triangles, 3, sf::BlendAdd);
+        target.display();
+
+        CHECK(target.getDrawStats().draws == 4);
+        CHECK(target.getDrawStats().drawCallsSaved == 2);
+    }
+
+    SECTION("Cleared draws are not counted as saved")
+    {
+        target.setDrawMode(sf::RenderTarget::DeferredStable);
+        drawPrimitives(target, sf::Triangles, 3);
+        drawPrimitives(target, sf::Triangles, 3);
+        target.clear();
+        drawPrimitives(target, sf::Triangles, 3);
+        target.display();
+
+        CHECK(target.getDrawStats().draws == 3);
+        CHECK(target.getDrawStats().drawCallsSaved == 0);
+    }
+}
+
+// Needs an OpenGL 3.3 driver (e.g. llvmpipe): run with "[display]"
+TEST_CASE("sf::RenderTarget core profile", "[.][display]")
+{
+    // Core profiles ignore the shader, but it still makes instanced draws take the fallback
+    sf::Shader shader;
+    bool shaderLoaded = sf::Shader::isAvailable() && shader.loadFromMemory(vertexShader, fragmentShader);
+
+    sf::ContextSettings core(0, 0, 0, 3, 3, sf::ContextSettings::Core);
+    sf::Image legacy = renderScene(sf::ContextSettings(), shaderLoaded ? &shader : NULL);
+    sf::Image modern = renderScene(core, shaderLoaded ? &shader : NULL);
+
+    SECTION("Both backends draw the same pixels")
+    {
+        CHECK(modern.getPixel(2, 2) == sf::Color::Blue);
+        CHECK(modern.getPixel(16, 16) == sf::Color::Red);
+        CHECK(modern.getPixel(30, 10) == sf::Color::Yellow);
+        CHECK(modern.getPixel(30, 16) == sf::Color::Blue);
+        CHECK(modern.getPixel(30, 20) == sf::Color::Yellow);
+        CHECK(modern.getPixel(44, 44) == sf::Color::Green);
+        CHECK(modern.getPixel(48, 16) == sf::Color::Red);
+        CHECK(modern.getPixel(16, 48) == sf::Color::Red);
+        CHECK(modern.getPixel(5, 31) == sf::Color::Cyan);
+        CHECK(modern.getPixel(15, 31) == sf::Color::Magenta);
+        CHECK(modern.getPixel(28, 43) == sf::Color::Cyan);
+        CHECK(modern.getPixel(28, 53) == sf::Color::Magenta);
+
+        for (unsigned int y = 0; y < 64; y += 4)
+            for (unsigned int x = 0; x < 64; x += 4)
+                CHECK(modern.getPixel(x, y) == legacy.getPixel(x, y));
+    }
+}
@@ -0,0 +1,73 @@
+#include <SFML/Graphics/SpriteBatch.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include "GraphicsUtil.hpp"
+
+// Textures need an OpenGL context: quads are told apart by blend mode here
+TEST_CASE("sf::SpriteBatch class", "[graphics]")
+{
+    sf::Vertex quad[4];
+    const sf::RenderStates alpha(sf::BlendAlpha);
+    const sf::RenderStates add(sf::BlendAdd);
+
+    SECTION("Empty batch")
+    {
+        sf::SpriteBatch batch;
+        CHECK(batch.getQuadCount() == 0);
+        CHECK(batch.getBatchCount() == 0);
+    }
+
+    SECTION("Sprites without texture are ignored")
+    {
+        sf::SpriteBatch batch;
+        batch.add(sf::Sprite());
+        CHECK(batch.getQuadCount() == 0);
+        CHECK(batch.getBatchCount() == 0);
+    }
+
+    SECTION("KeepOrder merges consecutive quads only")
+    {
+        sf::SpriteBatch batch(sf::SpriteBatch::KeepOrder);
+        batch.add(quad, alpha);
+        batch.add(quad, alpha);
+        batch.add(quad, add);
+        batch.add(quad, alpha);
+        CHECK(batch.getQuadCount() == 4);
+        CHECK(batch.getBatchCount() == 3);
+    }
+
+    SECTION("GroupByState merges every quad with the same states")
+    {
+        sf::SpriteBatch batch(sf::SpriteBatch::GroupByState);
+        batch.add(quad, alpha);
+        batch.add(quad, add);
+        batch.add(quad, alpha);
+        batch.add(quad, add);
+        CHECK(batch.getQuadCount() == 4);
+        CHECK(batch.getBatchCount() == 2);
+
+        batch.add(quad, sf::RenderStates(sf::BlendMultiply));
+        CHECK(batch.getBatchCount() == 3);
+    }
+
+    SECTION("Transforms do not split batches")
+    {
+        sf::SpriteBatch batch;
+        batch.add(quad, sf::RenderStates(sf::Transform().translate(10.f, 0.f)));
+        batch.add(quad, sf::RenderStates(sf::Transform().rotate(45.f)));
+        CHECK(batch.getQuadCount() == 2);
+        CHECK(batch.getBatchCount() == 1);
+    }
+
+    SECTION("Clear")
+    {
+        sf::SpriteBatch batch;
+        batch.add(quad, alpha);
+        batch.add(quad, add);
+        batch.clear();
+        CHECK(batch.getQuadCount() == 0);
+        CHECK(batch.getBatchCount() == 0);
+
+        batch.add(quad, add);
+        CHECK(batch.getBatchCount() == 1);
+    }
+}
@@ -0,0 +1,63 @@
+#include <SFML/Graphics/StreamingVertexBuffer.hpp>
+#include <SFML/Window/Context.hpp>
+#include "GraphicsUtil.hpp"
+
+// Every GL resource creates the shared context: run with "[display]"
+TEST_CASE("sf::StreamingVertexBuffer class", "[.][display]")
+{
+    sf::Context context;
+    sf::Vertex vertices[6];
+
+    SECTION("Default constructor")
+    {
+        sf::StreamingVertexBuffer buffer;
+        CHECK(buffer.getCapacity() == 0);
+        CHECK(buffer.getVertexCount() == 0);
+        CHECK(buffer.getPrimitiveType() == sf::Triangles);
+        CHECK(!buffer.isPersistent());
+    }
+
+    SECTION("Primitive type")
+    {
+        sf::StreamingVertexBuffer buffer(sf::Lines);
+        CHECK(buffer.getPrimitiveType() == sf::Lines);
+
+        buffer.setPrimitiveType(sf::TriangleStrip);
+        CHECK(buffer.getPrimitiveType() == sf::TriangleStrip);
+    }
+
+    SECTION("Empty updates")
+    {
+        sf::StreamingVertexBuffer buffer;
+        CHECK(!buffer.update(NULL, 4));
+        CHECK(buffer.map(0) == NULL);
+        CHECK(buffer.getVertexCount() == 0);
+        CHECK(buffer.getCapacity() == 0);
+    }
+
+    SECTION("Updates cycle through the regions and grow the buffer")
+    {
+        if (!sf::StreamingVertexBuffer::isAvailable())
+            return;
+
+        sf::StreamingVertexBuffer buffer;
+        REQUIRE(buffer.create(3));
+        CHECK(buffer.getCapacity() == 3);
+
+        for (std::size_t i = 0; i < 2 * sf::StreamingVertexBuffer::RegionCount; ++i)
+        {
+            CHECK(buffer.update(vertices, 3));
+            CHECK(buffer.getVertexCount() == 3);
+        }
+
+        CHECK(buffer.update(vertices, 6));
+        CHECK(buffer.getVertexCount() == 6);
+        CHECK(buffer.getCapacity() == 6);
+
+        sf::Vertex* data = buffer.map(2);
+        REQUIRE(data != NULL);
+        CHECK(buffer.map(2) == NULL);
+        buffer.unmap();
+        CHECK(buffer.getVertexCount() == 2);
+    }
+}
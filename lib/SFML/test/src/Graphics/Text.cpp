@@ -0,0 +1,28 @@
+#include <SFML/Graphics/Text.hpp>
+#include "GraphicsUtil.hpp"
+
+TEST_CASE("sf::Text class", "[graphics]")
+{
+    SECTION("Default constructor")
+    {
+        const sf::Text text;
+        CHECK(text.getGlowColor() == sf::Color::Transparent);
+        CHECK(text.getGlowRadius() == 0.f);
+        CHECK(!text.isDistanceField());
+        CHECK(text.getLocalBounds() == sf::FloatRect());
+    }
+
+    SECTION("Distance field mode and glow")
+    {
+        sf::Text text;
+        text.setDistanceField(true);
+        text.setGlowColor(sf::Color::Yellow);
+        text.setGlowRadius(6.f);
+        CHECK(text.isDistanceField());
+        CHECK(text.getGlowColor() == sf::Color::Yellow);
+        CHECK(text.getGlowRadius() == 6.f);
+
+        text.setDistanceField(false);
+        CHECK(!text.isDistanceField());
+    }
+}
@@ -0,0 +1,194 @@
+#include <SFML/Graphics/TextureAtlas.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include "GraphicsUtil.hpp"
+
+namespace
+{
+    sf::Image makeImage(unsigned int width, unsigned int height, const sf::Color& color)
+    {
+        sf::Image image;
+        image.create(width, height, color);
+        return image;
+    }
+
+    bool overlap(const sf::IntRect& left, const sf::IntRect& right)
+    {
+        return left.intersects(right);
+    }
+}
+
+TEST_CASE("sf::TextureAtlas::bake", "[graphics]")
+{
+    SECTION("Packs the images without overlap")
+    {
+        std::vector<sf::Image> images;
+        for (unsigned int i = 1; i <= 20; ++i)
+            images.push_back(makeImage(4 + i * 3 % 17, 4 + i * 7 % 13, sf::Color(static_cast<sf::Uint8>(i * 10), 0, 0)));
+
+        sf::Image atlas;
+        std::vector<sf::IntRect> rects;
+        REQUIRE(sf::TextureAtlas::bake(images, atlas, rects, 1));
+        REQUIRE(rects.size() == images.size());
+
+        for (std::size_t i = 0; i < rects.size(); ++i)
+        {
+            CHECK(rects[i].width == static_cast<int>(images[i].getSize().x));
+            CHECK(rects[i].height == static_cast<int>(images[i].getSize().y));
+            CHECK(rects[i].left >= 1);
+            CHECK(rects[i].top >= 1);
+            CHECK(rects[i].left + rects[i].width < static_cast<int>(atlas.getSize().x));
+            CHECK(rects[i].top + rects[i].height < static_cast<int>(atlas.getSize().y));
+
+            for (std::size_t j = 0; j < i; ++j)
+                CHECK(!overlap(rects[i], rects[j]));
+        }
+    }
+
+    SECTION("Copies the pixels and keeps the padding")
+    {
+        std::vector<sf::Image> images;
+        images.push_back(makeImage(8, 8, sf::Color::Red));
+        images.push_back(makeImage(8, 4, sf::Color::Green));
+
+        sf::Image atlas;
+        std::vector<sf::IntRect> rects;
+        REQUIRE(sf::TextureAtlas::bake(images, atlas, rects, 2, 4096, sf::Color::Blue));
+
+        for (std::size_t i = 0; i < rects.size(); ++i)
+        {
+            const unsigned int left = static_cast<unsigned int>(rects[i].left);
+            const unsigned int top = static_cast<unsigned int>(rects[i].top);
+            CHECK(atlas.getPixel(left, top) == images[i].getPixel(0, 0));
+            CHECK(atlas.getPixel(left - 1, top - 1) == sf::Color::Blue);
+        }
+
+        // The padding of the two images doesn't overlap
+        sf::IntRect first(rects[0].left - 2, rects[0].top - 2, rects[0].width + 4, rects[0].height + 4);
+        sf::IntRect second(rects[1].left - 2, rects[1].top - 2, rects[1].width + 4, rects[1].height + 4);
+        CHECK(!overlap(first, second));
+    }
+
+    SECTION("Uses the smallest power of two size")
+    {
+        std::vector<sf::Image> images(4, makeImage(16, 16, sf::Color::White));
+
+        sf::Image atlas;
+        std::vector<sf::IntRect> rects;
+        REQUIRE(sf::TextureAtlas::bake(images, atlas, rects));
+        CHECK(atlas.getSize() == sf::Vector2u(32, 32));
+    }
+
+    SECTION("Skips empty images")
+    {
+        std::vector<sf::Image> images(2);
+        images[1] = makeImage(4, 4, sf::Color::White);
+
+        sf::Image atlas;
+        std::vector<sf::IntRect> rects;
+        REQUIRE(sf::TextureAtlas::bake(images, atlas, rects));
+        CHECK(rects[0] == sf::IntRect());
+        CHECK(rects[1] == sf::IntRect(0, 0, 4, 4));
+    }
+
+    SECTION("Fails when the images don't fit")
+    {
+        std::vector<sf::Image> images(5, makeImage(16, 16, sf::Color::White));
+
+        sf::Image atlas;
+        std::vector<sf::IntRect> rects;
+        CHECK(!sf::TextureAtlas::bake(images, atlas, rects, 0, 32));
+    }
+}
+
+// Needs a display and an OpenGL driver: run with "[display]"
+TEST_CASE("sf::TextureAtlas class", "[.][display]")
+{
+    sf::TextureAtlas atlas;
+    REQUIRE(atlas.create(32, 32));
+
+    const sf::Image red = makeImage(8, 8, sf::Color::Red);
+    const sf::Image green = makeImage(16, 8, sf::Color::Green);
+
+    SECTION("Add and remove regions")
+    {
+        const sf::Uint32 first = atlas.add(red);
+        const sf::Uint32 second = atlas.add(green);
+        REQUIRE(first != sf::TextureAtlas::InvalidRegion);
+        REQUIRE(second != sf::TextureAtlas::InvalidRegion);
+        CHECK(atlas.getRegionCount() == 2);
+        CHECK(atlas.getRect(first) == sf::IntRect(0, 0, 8, 8));
+        CHECK(!overlap(atlas.getRect(first), atlas.getRect(second)));
+
+        CHECK(atlas.remove(second));
+        CHECK(!atlas.remove(second));
+        CHECK(atlas.getRegionCount() == 1);
+        CHECK(atlas.getRect(second) == sf::IntRect());
+
+        // The freed space is reused
+        const sf::Uint32 third = atlas.add(red);
+        CHECK(atlas.getSize() == sf::Vector2u(32, 32));
+        CHECK(!overlap(atlas.getRect(first), atlas.getRect(third)));
+    }
+
+    SECTION("Grows without moving the regions, keeping the pixels")
+    {
+        const sf::Uint32 anchor = atlas.add(red);
+        std::vector<sf::Uint32> regions;
+        std::vector<sf::IntRect> rects;
+        for (int i = 0; i < 8; ++i)
+        {
+            regions.push_back(atlas.add(green));
+            rects.push_back(atlas.getRect(regions.back()));
+        }
+
+        CHECK(atlas.getSize().x * atlas.getSize().y > 32 * 32);
+        CHECK(atlas.getRect(anchor) == sf::IntRect(0, 0, 8, 8));
+        for (std::size_t i = 0; i < regions.size(); ++i)
+            CHECK(atlas.getRect(regions[i]) == rects[i]);
+
+        const sf::Image pixels = atlas.getTexture().copyToImage();
+        CHECK(pixels.getPixel(4, 4) == sf::Color::Red);
+        for (std::size_t i = 0; i < regions.size(); ++i)
+        {
+            const sf::IntRect rect = atlas.getRect(regions[i]);
+            CHECK(pixels.getPixel(static_cast<unsigned int>(rect.left), static_cast<unsigned int>(rect.top)) == sf::Color::Green);
+            CHECK(!overlap(rect, atlas.getRect(anchor)));
+        }
+    }
+
+    SECTION("Removing most of the regions packs the others again")
+    {
+        // The first row is full, so the last region goes below
+        const sf::Uint32 anchor = atlas.add(red);
+        std::vector<sf::Uint32> regions;
+        regions.push_back(atlas.add(makeImage(24, 8, sf::Color::Green)));
+        for (int i = 0; i < 3; ++i)
+            regions.push_back(atlas.add(green));
+        const sf::Uint32 last = atlas.add(red);
+        const sf::IntRect before = atlas.getRect(last);
+        REQUIRE(before.top > 0);
+
+        for (std::size_t i = 0; i < regions.size(); ++i)
+            CHECK(atlas.remove(regions[i]));
+
+        // Once most of the space was removed, the rest fit in the first row
+        const sf::IntRect after = atlas.getRect(last);
+        CHECK(atlas.getRect(anchor) == sf::IntRect(0, 0, 8, 8));
+        CHECK(after.top == 0);
+
+        const sf::Image pixels = atlas.getTexture().copyToImage();
+        CHECK(pixels.getPixel(static_cast<unsigned int>(after.left), 0) == sf::Color::Red);
+        CHECK(pixels.getPixel(static_cast<unsigned int>(before.left), static_cast<unsigned int>(before.top)) == sf::Color::Transparent);
+    }
+
+    SECTION("Occupancy")
+    {
+        atlas.add(red);
+        atlas.add(green);
+        CHECK(atlas.getOccupancy() == Approx((64.f + 128.f) / (32.f * 32.f)));
+
+        atlas.clear();
+        CHECK(atlas.getRegionCount() == 0);
+        CHECK(atlas.getOccupancy() == 0.f);
+    }
+}
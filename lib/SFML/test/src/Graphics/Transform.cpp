@@ -0,0 +1,46 @@
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+#include "GraphicsUtil.hpp"
+#include <vector>
+
+TEST_CASE("sf::Transform class - transformPoints", "[graphics]")
+{
+    sf::Transform transform;
+    transform.translate(10.f, -4.f).rotate(30.f).scale(2.f, 0.5f);
+
+    // Odd count: whole SIMD steps and a remainder
+    std::vector<sf::Vector2f> points;
+    for (int i = 0; i < 7; ++i)
+        points.push_back(sf::Vector2f(i * 3.5f - 7.f, 20.f - i * i));
+
+    SECTION("Same result as transformPoint")
+    {
+        std::vector<sf::Vector2f> result(points.size());
+        transform.transformPoints(&points[0], &result[0], points.size());
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            CHECK(result[i].x == Approx(transform.transformPoint(points[i]).x));
+            CHECK(result[i].y == Approx(transform.transformPoint(points[i]).y));
+        }
+    }
+
+    SECTION("In place")
+    {
+        std::vector<sf::Vector2f> result = points;
+        transform.transformPoints(&result[0], &result[0], result.size());
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            CHECK(result[i].x == Approx(transform.transformPoint(points[i]).x));
+            CHECK(result[i].y == Approx(transform.transformPoint(points[i]).y));
+        }
+    }
+
+    SECTION("Nothing to transform")
+    {
+        sf::Vector2f untouched(1.f, 2.f);
+        transform.transformPoints(&points[0], &untouched, 0);
+        CHECK(untouched == sf::Vector2f(1.f, 2.f));
+    }
+}
@@ -0,0 +1,98 @@
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Trace.hpp>
+#include "SystemUtil.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+static std::string readFile(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios_base::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static std::size_t countOccurrences(const std::string& str, const std::string& pattern)
+{
+    std::size_t count = 0;
+    for (std::size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+        ++count;
+    return count;
+}
+
+static void workerFunction()
+{
+    sf::Trace::setThreadName("Worker \"1\"");
+    sf::TraceZone zone("Worker zone");
+}
+
+static void overflowFunction()
+{
+    // More events than a thread buffer can hold, with zones open when it fills up
+    sf::TraceZone outer("Overflow outer");
+    for (int i = 0; i < 600000; ++i)
+    {
+        sf::TraceZone inner("Overflow inner");
+        sf::Trace::counter("Overflow counter", i);
+    }
+}
+
+TEST_CASE("sf::Trace class", "[system]")
+{
+    const std::string filename = "test-sfml-trace.json";
+
+    sf::Trace::setThreadName("Test thread");
+    {
+        sf::TraceZone zone("Outer zone");
+        sf::Trace::beginZone("Inner zone");
+        sf::Trace::counter("Counter", 42);
+        sf::Trace::endZone();
+    }
+
+    sf::Thread worker(&workerFunction);
+    worker.launch();
+    worker.wait();
+
+    REQUIRE(sf::Trace::dump(filename));
+    const std::string json = readFile(filename);
+    std::remove(filename.c_str());
+
+    SECTION("Chrome trace event format")
+    {
+        CHECK(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+        CHECK(json.find("]}") != std::string::npos);
+    }
+
+    SECTION("Zones and counters")
+    {
+        CHECK(json.find("\"ph\":\"B\",\"pid\":1,\"tid\":1") != std::string::npos);
+        CHECK(json.find("\"name\":\"Outer zone\"") != std::string::npos);
+        CHECK(json.find("\"name\":\"Inner zone\"") != std::string::npos);
+        CHECK(json.find("\"name\":\"Counter\",\"args\":{\"value\":42}") != std::string::npos);
+        CHECK(json.find("\"ph\":\"E\"") != std::string::npos);
+    }
+
+    SECTION("Thread names")
+    {
+        CHECK(json.find("\"args\":{\"name\":\"Test thread\"}") != std::string::npos);
+        CHECK(json.find("\"args\":{\"name\":\"Worker \\\"1\\\"\"}") != std::string::npos);
+        CHECK(json.find("\"name\":\"Worker zone\"") != std::string::npos);
+    }
+}
+
+TEST_CASE("sf::Trace overflow", "[system]")
+{
+    const std::string filename = "test-sfml-trace-overflow.json";
+
+    sf::Thread overflow(&overflowFunction);
+    overflow.launch();
+    overflow.wait();
+
+    REQUIRE(sf::Trace::dump(filename));
+    const std::string json = readFile(filename);
+    std::remove(filename.c_str());
+
+    // Zones stay balanced when a buffer is full
+    CHECK(json.find("\"name\":\"Overflow outer\"") != std::string::npos);
+    CHECK(countOccurrences(json, "\"ph\":\"B\"") == countOccurrences(json, "\"ph\":\"E\""));
+}
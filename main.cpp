@@ -7,12 +7,24 @@
 #include <algorithm> // for std::min / std::max
 #include <cstdlib>  // ADDED: rand(), srand()
 #include <ctime>    // ADDED: time() for srand seed
+#include <memory>
+
+#include "AllocationCounter.hpp"
+#include "AssetPack.hpp"
+#include "GhostRun.hpp"
+#include "HotReload.hpp"
+#include "LevelEditor.hpp"
+#include "Minimap.hpp"
+#include "Netplay.hpp"
+#include "SplitScreen.hpp"
+#include "World.hpp"
 
 
 enum GameState {
     MENU,
     PLAYING,
     PAUSED,
+    EDITING,           // level editor, entered from PAUSED
     LEVEL_COMPLETE,
     GAME_OVER
 };
@@ -26,588 +38,82 @@ enum MenuPage {
     SHOP_PAGE
 };
 
-struct Platform {
-    sf::RectangleShape shape;
-    const sf::Texture* texture;   // NEW
-    bool breakable;
-    float breakTimer;
-
-    // Colour-based platform (used for rock blocks etc.)
-    Platform(float x, float y, float w, float h, sf::Color color, bool canBreak = false)
-        : texture(nullptr), breakable(canBreak), breakTimer(0)
-    {
-        shape.setPosition(x, y);
-        shape.setSize(sf::Vector2f(w, h));
-
-        shape.setOutlineThickness(2);
-        shape.setOutlineColor(sf::Color(
-            0, 0, 0, 120  // or whatever looks good with your texture
-        ));
-
-        shape.setFillColor(color);
-    }
-
-    // Texture-based platform (used for iceBlock.png etc.)
-    Platform(float x, float y, float w, float h, const sf::Texture* tex, bool canBreak = false)
-        : texture(tex), breakable(canBreak), breakTimer(0)
-    {
-        shape.setPosition(x, y);
-        shape.setSize(sf::Vector2f(w, h));
-        if (texture) {
-            shape.setTexture(texture);
-        }
-    }
-};
-
-
-struct Diamond {
-    sf::Sprite sprite;
-    const sf::Texture* texture;
-    bool collected;
-    float animOffset;
-    sf::Vector2f basePos;
-
-    Diamond(float x, float y, const sf::Texture* tex)
-        : texture(tex), collected(false), animOffset(0.f), basePos(x, y)
-    {
-        if (texture) {
-            sprite.setTexture(*texture);
-
-            // Resize diamond to a nice size (similar to old height)
-            sf::FloatRect b = sprite.getLocalBounds();
-            float targetHeight = 26.f;        // tweak if you want bigger/smaller
-            float scale = targetHeight / b.height;
-            sprite.setScale(scale, scale);
-
-            sprite.setPosition(x, y);
-        }
-    }
-
-    void update() {
-        animOffset += 0.05f;
-        float yOffset = std::sin(animOffset) * 5;
-        sprite.setPosition(basePos.x, basePos.y + yOffset);
-    }
-
-    sf::FloatRect getBounds() const {
-        return sprite.getGlobalBounds();
-    }
-
-    void draw(sf::RenderWindow& window) {
-        if (!collected)
-            window.draw(sprite);
-    }
-};
-
-
-
-
-struct Enemy {
-    sf::Sprite sprite;
-    sf::Vector2f position;
-    float speed;
-    int direction;
-    float minX, maxX;
-
-    // animation
-    const std::vector<sf::Texture>* textures;
-    int currentFrame;
-    float frameTimer;         // counts frames/time between swaps
-
-    Enemy(float x, float y, float spd, float min, float max,
-        const std::vector<sf::Texture>* texPtr)
-        : position(x, y),
-        speed(spd),
-        direction(1),
-        minX(min),
-        maxX(max),
-        textures(texPtr),
-        currentFrame(0),
-        frameTimer(0.f)
-    {
-        if (textures && !textures->empty()) {
-            sprite.setTexture((*textures)[0]);
-        }
-        sprite.setPosition(position);
-    }
-
-    void update() {
-        // move horizontally like before
-        position.x += direction * speed;
-        if (position.x <= minX || position.x >= maxX) {
-            direction *= -1;
-        }
-
-        // small vertical bob
-        position.y += std::sin(position.x * 0.01f) * 0.2f;
-        sprite.setPosition(position);
-
-        // flip sprite when changing direction
-        if (textures && !textures->empty()) {
-            float scaleX = (direction > 0) ? -1.f : 1.f;
-            sprite.setScale(scaleX, 1.f);
-        }
-
-        // animation: cycle through the 9 images
-        frameTimer += 0.15f;          // tweak speed if you want
-        if (frameTimer >= 1.f) {      // every ~1 frame here because we use arbitrary units
-            frameTimer = 0.f;
-            if (textures && !textures->empty()) {
-                currentFrame = (currentFrame + 1) % static_cast<int>(textures->size());
-                sprite.setTexture((*textures)[currentFrame], true);
-            }
-        }
-    }
-
-    void draw(sf::RenderWindow& window) {
-        window.draw(sprite);
-    }
-
-    sf::FloatRect getBounds() const {
-        return sprite.getGlobalBounds();
-    }
-};
-
-
-struct Hammer {
-    sf::Sprite sprite;
-    const sf::Texture* texture;
-    sf::Vector2f position;
-    bool collected;
-
-    Hammer(float x, float y, const sf::Texture* tex)
-        : texture(tex), position(x, y), collected(false)
-    {
-        if (texture) {
-            sprite.setTexture(*texture);
-
-            // --- Resize so the axe is only slightly bigger than before ---
-            sf::FloatRect bounds = sprite.getLocalBounds();
-            float targetHeight = 65.f;              // a bit bigger than old ~25px
-            float scale = targetHeight / bounds.height;
-            sprite.setScale(scale, scale);
-
-            // Position after scaling (x,y is top-left like before)
-            sprite.setPosition(position);
-        }
-    }
-
-
-    sf::FloatRect getBounds() const {
-        return sprite.getGlobalBounds();
-    }
-
-    void draw(sf::RenderWindow& window) {
-        window.draw(sprite);
-    }
-};
-
-
-struct Boulder {
-    sf::RectangleShape shape;
-    std::vector<sf::RectangleShape> cracks;
-    bool broken;
-
-    Boulder(float x, float y) : broken(false) {
-        shape.setSize(sf::Vector2f(50, 50));
-        shape.setPosition(x, y);
-        shape.setFillColor(sf::Color(85, 85, 85));
-        shape.setOutlineThickness(3);
-        shape.setOutlineColor(sf::Color(51, 51, 51));
-
-        for (int i = 0; i < 3; i++) {
-            sf::RectangleShape crack(sf::Vector2f(30, 2));
-            crack.setPosition(x + 10, y + 15 + i * 12);
-            crack.setFillColor(sf::Color(40, 40, 40));
-            cracks.push_back(crack);
-        }
-    }
-
-    void draw(sf::RenderWindow& window) {
-        window.draw(shape);
-        for (auto& crack : cracks) {
-            window.draw(crack);
-        }
-    }
-
-    sf::FloatRect getBounds() const {
-        return shape.getGlobalBounds();
-    }
-};
-
-// Kept for future hazards if you want them later
-struct FallingRock {
-    sf::CircleShape shape;
-    sf::Vector2f position;
-    sf::Vector2f velocity;
-    bool active;
-    bool triggered;
-    float resetTimer;
-    float startY;
-
-    FallingRock(float x, float y) : position(x, y), velocity(0, 0),
-        active(false), triggered(false), resetTimer(0), startY(y) {
-        shape.setRadius(12);
-        shape.setFillColor(sf::Color(100, 100, 100));
-        shape.setOutlineThickness(2);
-        shape.setOutlineColor(sf::Color(70, 70, 70));
-        shape.setPosition(position);
-    }
-
-    void update(sf::FloatRect playerBounds) {
-        if (!triggered && resetTimer <= 0) {
-            if (std::abs(playerBounds.left - position.x) < 40 && playerBounds.top > position.y) {
-                triggered = true;
-                active = true;
-            }
-        }
-
-        if (active) {
-            velocity.y += 0.5f;
-            position.y += velocity.y;
-            shape.setPosition(position);
-
-            if (position.y > 650) {
-                active = false;
-                triggered = false;
-                resetTimer = 240;
-                position.y = startY;
-                velocity.y = 0;
-                shape.setPosition(position);
-            }
-        }
-
-        if (resetTimer > 0) resetTimer--;
-    }
-
-    sf::FloatRect getBounds() const {
-        return shape.getGlobalBounds();
-    }
-};
-
-struct Icicle {
-    sf::ConvexShape shape;
-    sf::Vector2f position;
-    sf::Vector2f velocity;
-    bool falling;
-    float fallTimer;
-    float resetTimer;
-    float startY;
-
-    Icicle(float x, float y) : position(x, y), velocity(0, 0), falling(false),
-        fallTimer(60), resetTimer(0), startY(y) {
-        shape.setPointCount(3);
-        shape.setPoint(0, sf::Vector2f(0, 0));
-        shape.setPoint(1, sf::Vector2f(8, 0));
-        shape.setPoint(2, sf::Vector2f(4, 30));
-        shape.setPosition(position);
-        shape.setFillColor(sf::Color(200, 230, 255));
-        shape.setOutlineThickness(1);
-        shape.setOutlineColor(sf::Color(150, 200, 255));
-    }
-
-    void update(sf::FloatRect playerBounds) {
-        if (!falling && resetTimer <= 0) {
-            if (std::abs(playerBounds.left - position.x) < 40 && playerBounds.top < position.y) {
-                fallTimer--;
-                if (fallTimer <= 0) {
-                    falling = true;
-                }
-            }
-            else {
-                fallTimer = 60;
-            }
-        }
-
-        if (falling) {
-            velocity.y += 0.8f;
-            position.y += velocity.y;
-            shape.setPosition(position);
-
-            if (position.y > 650) {
-                falling = false;
-                resetTimer = 300;
-                position.y = startY;
-                velocity.y = 0;
-                fallTimer = 60;
-                shape.setPosition(position);
-            }
-        }
-
-        if (resetTimer > 0) resetTimer--;
-    }
-
-    sf::FloatRect getBounds() const {
-        return shape.getGlobalBounds();
-    }
-};
-
-struct LavaPool {
-    sf::RectangleShape shape;
-    sf::Vector2f position;
-    float animOffset;
-
-    LavaPool(float x, float y, float w) : position(x, y), animOffset(0) {
-        shape.setSize(sf::Vector2f(w, 30));
-        shape.setPosition(position);
-        shape.setFillColor(sf::Color(255, 100, 0));
-    }
-
-    void update() {
-        animOffset += 0.1f;
-        sf::Color lavaColor(255, static_cast<sf::Uint8>(100 + std::sin(animOffset) * 50), 0);
-        shape.setFillColor(lavaColor);
-    }
-
-    sf::FloatRect getBounds() const {
-        return shape.getGlobalBounds();
-    }
-};
-
-class Player {
-public:
-    // --- animation data ---
-    sf::Sprite sprite;
-    const std::vector<sf::Texture>* animTextures; // set in setAnimationTextures
-    int currentFrame;
-    float frameTimer;
-    int facingDir;   // 1 = right, -1 = left
-
-    enum AnimState { IDLE, RUNNING, JUMPING };
-    AnimState animState;
-
-    float spriteBaseScale; // controls how small the sprite is
-
-    // --- old shape pieces (used only as fallback) ---
-    sf::RectangleShape body;
-    sf::RectangleShape hat;
-    sf::CircleShape head;
-    sf::RectangleShape eyeLeft;
-    sf::RectangleShape eyeRight;
-    sf::RectangleShape mustacheLeft;
-    sf::RectangleShape mustacheRight;
-    sf::RectangleShape legLeft;
-    sf::RectangleShape legRight;
-
-    sf::Vector2f position;
-    sf::Vector2f velocity;
-    float speed;
-    float jumpPower;
-    bool grounded;
-    bool hasHammer;
-    float animTimer;
-
-    Player(float x, float y)
-        : animTextures(nullptr),
-        currentFrame(0),
-        frameTimer(0.f),
-        facingDir(1),
-        animState(IDLE),
-        spriteBaseScale(0.6f),
-        position(x, y),
-        velocity(0.f, 0.f),
-        speed(4.0f),
-        jumpPower(-12.0f),
-        grounded(false),
-        hasHammer(false),
-        animTimer(0.f)
-    {
-        body.setSize(sf::Vector2f(24, 28));
-        body.setFillColor(sf::Color::Red);
-
-        head.setRadius(14);
-        head.setFillColor(sf::Color(255, 220, 177));
-
-        hat.setSize(sf::Vector2f(28, 8));
-        hat.setFillColor(sf::Color::Red);
-
-        eyeLeft.setSize(sf::Vector2f(4, 4));
-        eyeLeft.setFillColor(sf::Color::Black);
-        eyeRight.setSize(sf::Vector2f(4, 4));
-        eyeRight.setFillColor(sf::Color::Black);
-
-        mustacheLeft.setSize(sf::Vector2f(8, 3));
-        mustacheLeft.setFillColor(sf::Color(101, 67, 33));
-        mustacheRight.setSize(sf::Vector2f(8, 3));
-        mustacheRight.setFillColor(sf::Color(101, 67, 33));
-
-        legLeft.setSize(sf::Vector2f(10, 6));
-        legLeft.setFillColor(sf::Color(50, 50, 200));
-        legRight.setSize(sf::Vector2f(10, 6));
-        legRight.setFillColor(sf::Color(50, 50, 200));
-
-        updatePosition();
-    }
-
-    void setAnimationTextures(const std::vector<sf::Texture>* texPtr) {
-        animTextures = texPtr;
-        currentFrame = 0;
-        frameTimer = 0.f;
-
-        if (animTextures && !animTextures->empty()) {
-            sprite.setTexture((*animTextures)[0]);
-
-            // origin at bottom centre so flipping works nicely
-            sf::FloatRect bounds = sprite.getLocalBounds();
-            sprite.setOrigin(bounds.width / 2.f, bounds.height);
-        }
-    }
-
-    void updatePosition() {
-        // existing leg wobble (used only in fallback draw)
-        animTimer += 0.15f;
-        float legOffset = grounded ? std::sin(animTimer) * 2 : 0;
-
-        body.setPosition(position.x + 8, position.y + 18);
-        head.setPosition(position.x + 4, position.y - 4);
-        hat.setPosition(position.x + 2, position.y - 10);
-        eyeLeft.setPosition(position.x + 10, position.y + 4);
-        eyeRight.setPosition(position.x + 18, position.y + 4);
-        mustacheLeft.setPosition(position.x + 6, position.y + 12);
-        mustacheRight.setPosition(position.x + 18, position.y + 12);
-        legLeft.setPosition(position.x + 8, position.y + 40 + legOffset);
-        legRight.setPosition(position.x + 22, position.y + 40 - legOffset);
-
-        // --- sprite animation ---
-        if (!animTextures || animTextures->empty())
-            return;
-
-        // Put sprite feet where the old body bottom was
-        sprite.setPosition(position.x + 16.f, position.y + 46.f);
-
-        // Decide animation state
-        if (!grounded) {
-            animState = JUMPING;
-        }
-        else if (std::fabs(velocity.x) > 0.1f) {
-            animState = RUNNING;
-        }
-        else {
-            animState = IDLE;
-        }
-
-        // Flip + scale
-        float sx = (facingDir > 0 ? 1.f : -1.f) * spriteBaseScale;
-        float sy = spriteBaseScale;
-        sprite.setScale(sx, sy);
-
-        // Frame ranges: 0 = idle, 1–4 = run, 5 = jump
-        int idleFrame = 0;
-        int runStart = 1;
-        int runEnd = 4;
-        int jumpFrame = 5;
-
-        switch (animState) {
-        case IDLE:
-            if (currentFrame != idleFrame) {
-                currentFrame = idleFrame;
-                sprite.setTexture((*animTextures)[currentFrame], true);
-            }
-            break;
-
-        case RUNNING:
-            frameTimer += 0.2f;   // animation speed
-            if (frameTimer >= 1.f) {
-                frameTimer = 0.f;
-                if (currentFrame < runStart || currentFrame > runEnd)
-                    currentFrame = runStart;
-                else
-                    currentFrame++;
-
-                if (currentFrame > runEnd)
-                    currentFrame = runStart;
-
-                sprite.setTexture((*animTextures)[currentFrame], true);
-            }
-            break;
-
-        case JUMPING:
-            if (currentFrame != jumpFrame) {
-                currentFrame = jumpFrame;
-                sprite.setTexture((*animTextures)[currentFrame], true);
-            }
-            break;
-        }
-    }
-
-    sf::FloatRect getBounds() const {
-        return sf::FloatRect(position.x, position.y, 32, 46);
-    }
-
-    void draw(sf::RenderWindow& window) {
-        if (animTextures && !animTextures->empty()) {
-            window.draw(sprite);
-        }
-        else {
-            // fallback if textures missing
-            window.draw(legLeft);
-            window.draw(legRight);
-            window.draw(body);
-            window.draw(head);
-            window.draw(hat);
-            window.draw(eyeLeft);
-            window.draw(eyeRight);
-            window.draw(mustacheLeft);
-            window.draw(mustacheRight);
-        }
-    }
-
-    void reset(float x, float y) {
-        position = sf::Vector2f(x, y);
-        velocity = sf::Vector2f(0, 0);
-        grounded = false;
-        hasHammer = false;
-
-        facingDir = 1;
-        animState = IDLE;
-        currentFrame = 0;
-        frameTimer = 0.f;
-
-        updatePosition();
-    }
-};
-
 
 class Game {
 private:
     sf::RenderWindow window;
-    sf::View view;              // ADDED: for side-scrolling camera
-    Player player;
-
-    std::vector<Platform> platforms;
-    std::vector<Diamond> diamonds;
-    std::vector<Enemy> enemies;
-    std::vector<FallingRock> fallingRocks;
-    std::vector<Icicle> icicles;
-    std::vector<LavaPool> lavaPools;
-    Hammer* hammer;
-    Boulder* boulder;
-    sf::RectangleShape exitDoor;
+    sf::View views[MAX_PLAYERS];   // side-scrolling camera of each player (split-screen)
+
+    // --- Dynamic resolution ---
+    // The world is drawn offscreen at renderScale x the window resolution and
+    // stretched over the window; the HUD is drawn on top at native resolution.
+    // renderScale follows the measured frame time (see updateRenderScale).
+    sf::RenderTexture worldTarget;      // allocated once at maxRenderScale
+    bool worldTargetAvailable = false;  // false = world drawn straight to the window
+    float renderScale = 1.f;
+    float maxRenderScale = 1.f;         // MAX_RENDER_SCALE, or less if the GPU cannot hold it
+    float smoothedFrameTime = 0.f;      // seconds, exponential moving average
+    int framesSinceScaleChange = 0;
+    bool worldSmooth = true;            // bilinear (true) or nearest (false) filtering, toggled with F7
+
+    // Packed assets (assets.pak), mapped for the whole game lifetime:
+    // declared before every resource so they are destroyed first
+    AssetPack assets;
+
+    // Level, player and gameplay rules (see World.hpp)
+    World world;
+
+    // E in the pause menu (offline only): edit the level being played
+    LevelEditor editor{ world };
+
+    // Set when playing on a server (--connect): the server runs the game,
+    // world then only mirrors it (see Netplay.hpp)
+    std::unique_ptr<NetClient> net;
+
+    // Map of the current level, re-baked whenever world.levelLoads or
+    // world.levelEdits changes
+    Minimap minimap;
+    int minimapLevelLoads = -1;
+    int minimapLevelEdits = -1;
+
+    // --- Ghost run ---
+    // Every tick of the current attempt is recorded; the fastest completed
+    // run of each level is kept in ghost_level<N>.dat and replayed as a
+    // translucent player while playing that level. G hides/shows it.
+    GhostRun ghostRecording;            // attempt in progress
+    GhostRun ghostBest;                 // best run of ghostLevel (empty = none yet)
+    GhostRun::Reader ghostReader;
+    GhostFrame ghostFrame;              // where the ghost is this tick
+    bool ghostActive = false;           // false once its run is over
+    bool ghostEnabled = true;
+    int ghostLevel = 0;                 // level ghostBest was loaded for
+    int ghostLevelLoads = -1;
+    sf::Sprite ghostSprite;
 
     GameState state;
     MenuPage menuPage;      // which menu page we are on
-    int currentLevel;
-    int lives;
-    int diamondsCollected;
-    int score;
 
     sf::Font font;
     bool fontLoaded;
-    sf::Color bgColor;
-    float friction;
 
-    const float GRAVITY = 0.5f;
     const int WINDOW_WIDTH = 800;
     const int WINDOW_HEIGHT = 600;
 
+    const float FRAME_BUDGET = 1.f / 60.f;   // seconds per frame (60 FPS)
+    const float MIN_RENDER_SCALE = 0.5f;
+    const float MAX_RENDER_SCALE = 2.f;      // 2x2 supersampling; bilinear filtering averages it exactly
+    const float RENDER_SCALE_STEP = 0.125f;  // 800x600 * 0.125 = 100x75, so every step is a whole pixel size
+
     // --- Axe (hammer) texture ---
     sf::Texture axeTexture;
     bool axeLoaded = false;
 
     sf::Texture diamondTexture;
+    CollisionMask diamondMask;
     bool diamondLoaded = false;
 
     sf::Texture diamondTexture2;
+    CollisionMask diamondMask2;
     bool diamond2Loaded = false;
 
     sf::Texture iceBlockTexture;
@@ -624,11 +130,6 @@ private:
     bool bgLoaded[4] = { false, false, false, false };
 
 
-    // ADDED: world constants for scrolling
-    const float WORLD_WIDTH = 2400.f;
-    const float GROUND_Y = 568.f;   // 600 - 32
-
-
     // --- MENU UI ---
     sf::RectangleShape startButton;
     sf::RectangleShape instructionsButton;
@@ -638,6 +139,13 @@ private:
     sf::RectangleShape backButton;
     sf::RectangleShape menuPanel;
 
+    // --- Pre-rendered static part of the menu (panels, buttons, text) ---
+    // Redrawn only when the page, the settings values or the window size change
+    sf::RenderTexture menuStaticLayer;
+    MenuPage menuStaticPage = MAIN_MENU;
+    bool menuStaticValid = false;       // false = must be redrawn before use
+    bool menuStaticAvailable = true;    // false if the render texture could not be created
+
     // --- Level 1 background image ---
     sf::Texture bgTexture1;
     sf::Sprite  bgSprite1;
@@ -649,12 +157,17 @@ private:
 
     // --- Bat enemy textures ---
     std::vector<sf::Texture> batTextures;
+    std::vector<CollisionMask> batMasks;    // one per frame, same order
     bool batsLoaded = false;
 
     // --- Player animation textures ---
     std::vector<sf::Texture> playerTextures;
     bool playerAnimLoaded = false;
 
+    // Textures and level files reloaded when they change on disk (after
+    // the textures: it points at them)
+    HotReload hotReload;
+
     //Settings variables 
     int musicVolume = 100;     // 0..100
     bool musicMuted = false;   // true = muted
@@ -845,566 +358,261 @@ private:
 
 
 
-    void buildCommonLevelLayout() {
-        platforms.clear();
-        diamonds.clear();
-        enemies.clear();
-        fallingRocks.clear();
-        icicles.clear();
-        lavaPools.clear();
-        delete hammer;
-        delete boulder;
-        hammer = nullptr;
-        boulder = nullptr;
-
-
-        // Different fallback colours for backgrounds if texture fails
-        if (currentLevel == 2) {
-            bgColor = sf::Color(10, 20, 40);   // colder for ice level
-        }
-        else {
-            bgColor = sf::Color(20, 10, 30);   // deep cave purple
+    // Load a texture from the asset pack if it has the file, from disk otherwise.
+    // With a mask, the image is decoded first to build its collision mask.
+    bool loadTexture(sf::Texture& texture, const std::string& filename, CollisionMask* mask = nullptr) {
+        AssetPack::View data = assets.find(filename);
+        if (!mask) {
+            if (data.data)
+                return texture.loadFromMemory(data.data, data.size);
+            return texture.loadFromFile(filename);
         }
-        friction = 0.85f;
 
-        float blockSize = 32.f;
+        sf::Image image;
+        bool decoded = data.data ? image.loadFromMemory(data.data, data.size) : image.loadFromFile(filename);
+        if (!decoded || !texture.loadFromImage(image))
+            return false;
+        mask->build(image);
+        return true;
+    }
 
-        // Helper: place a 32×32 block on a grid (uses ice texture on level 2)
-        auto addBlock = [&](int gx, int gy, sf::Color color = sf::Color(60, 40, 40)) {
-            float x = gx * blockSize;
-            float y = gy * blockSize;
+    // Same for fonts; sf::Font reads lazily from the mapped pack (no copy)
+    bool loadFont(sf::Font& target, const std::string& filename) {
+        AssetPack::View data = assets.find(filename);
+        if (data.data)
+            return target.loadFromMemory(data.data, data.size);
+        return target.loadFromFile(filename);
+    }
 
-            if (currentLevel == 2 && iceBlockLoaded) {
-                platforms.emplace_back(x, y, blockSize, blockSize, &iceBlockTexture);
-            }
-            else {
-                platforms.emplace_back(x, y, blockSize, blockSize, color);
-            }
-            };
 
-        // Helper: main platforms at arbitrary world positions
-        auto addMainPlatform = [&](float x, float y, sf::Color color = sf::Color(90, 70, 70)) {
-            if (currentLevel == 2 && iceBlockLoaded) {
-                platforms.emplace_back(x, y, blockSize, blockSize, &iceBlockTexture);
-            }
-            else {
-                platforms.emplace_back(x, y, blockSize, blockSize, color);
-            }
-            };
 
-        // Helper: path tiles, with optional vertical offset in tiles (for harder paths)
-        auto addPathTile = [&](int gx, int heightOffset, sf::Color color = sf::Color(80, 55, 55)) {
-            float basePathY = GROUND_Y - blockSize;    // default path height
-            float x = gx * blockSize;
-            float y = basePathY - heightOffset * blockSize;
+    // Fill the whole screen with a level background
+    void fitBackground(sf::Sprite& sprite, const sf::Texture& texture) {
+        sf::Vector2u texSize = texture.getSize();
+        sprite.setTextureRect(sf::IntRect(0, 0, texSize.x, texSize.y));
+        sprite.setScale(WINDOW_WIDTH / static_cast<float>(texSize.x), WINDOW_HEIGHT / static_cast<float>(texSize.y));
+    }
 
-            if (currentLevel == 2 && iceBlockLoaded) {
-                platforms.emplace_back(x, y, blockSize, blockSize, &iceBlockTexture);
-            }
-            else {
-                platforms.emplace_back(x, y, blockSize, blockSize, color);
-            }
-            };
+    // Hot reload of the textures that loaded and of the level files
+    void watchFiles() {
+        for (int i = 0; i < 4; ++i) {
+            if (bgLoaded[i]) {
+                hotReload.addTexture("tiles/background" + std::to_string(i + 1) + ".png", bgTextures[i], nullptr,
+                    [this, i]() { fitBackground(bgSprites[i], bgTextures[i]); });
+            }
+        }
+        for (std::size_t i = 0; i < batTextures.size(); ++i)
+            hotReload.addTexture("tiles/bat" + std::to_string(i + 1) + ".png", batTextures[i], &batMasks[i]);
+        for (std::size_t i = 0; i < playerTextures.size(); ++i)
+            hotReload.addTexture("tiles/character" + std::to_string(i + 1) + ".png", playerTextures[i]);
+
+        if (axeLoaded) hotReload.addTexture("tiles/axe.png", axeTexture);
+        if (doorLoaded) hotReload.addTexture("tiles/door.png", doorTexture);
+        if (diamondLoaded) hotReload.addTexture("tiles/diamond.png", diamondTexture, &diamondMask);
+        if (diamond2Loaded) hotReload.addTexture("tiles/diamond2.png", diamondTexture2, &diamondMask2);
+        if (iceBlockLoaded) hotReload.addTexture("tiles/iceBlock.png", iceBlockTexture);
+        if (seaweedLoaded) hotReload.addTexture("tiles/seaweed.png", seaweedTexture);
+
+        // A level file is applied when it is the level being played (the
+        // editor's own saves are not read back)
+        for (int level = 1; level <= 4; ++level) {
+            hotReload.addLevelFile(World::levelFileName(level), [this, level](const std::string& text) {
+                if (level != world.currentLevel || state == EDITING || net)
+                    return;
+                std::istringstream in(text);
+                // loadLevel reads the same file again, reports what is
+                // wrong with it and falls back to the built-in layout
+                if (!world.loadLevelText(in))
+                    world.loadLevel(level);
+            });
+        }
+
+        if (!hotReload.start())
+            std::cout << "Hot reload not available on this platform\n";
+    }
 
-        // Helper: icicle that is visually attached under an ice block
-        auto addIcicleWithBlock = [&](int gx, int gy) {
-            // Make sure there is an ice block here
-            addBlock(gx, gy);
+public:
+    Game() :
+        window(sf::VideoMode(800, 600), "Oreo Escape - Cave Adventure"),
+        state(MENU),
+        menuPage(MAIN_MENU),
+        fontLoaded(false),
+        menuAnimTime(0.f),
+        titleBounce(0.f),
+        glowPulse(150.f) {
+
+        // No setFramerateLimit(): run() paces frames itself so that it can
+        // measure how long a frame really took before sleeping
 
-            // Icicle hangs from the bottom centre of that block
-            float x = gx * blockSize + (blockSize / 2.f) - 4.f; // 8px wide base => offset by 4
-            float y = (gy + 1) * blockSize;                     // just under the block
-            icicles.emplace_back(x, y);
-            };
+        // Offscreen target for the world pass, sized for the largest scale
+        // once; lower scales only use its top-left corner
+        maxRenderScale = std::min(MAX_RENDER_SCALE,
+            static_cast<float>(sf::Texture::getMaximumSize()) / WINDOW_WIDTH);
+        if (maxRenderScale >= 1.f &&
+            worldTarget.create(static_cast<unsigned>(WINDOW_WIDTH * maxRenderScale),
+                static_cast<unsigned>(WINDOW_HEIGHT * maxRenderScale))) {
+            worldTarget.setSmooth(worldSmooth);
+            worldTargetAvailable = true;
 
+            // Queue the world pass: runs of draws with the same texture
+            // (tiles, diamonds, bats) go out as one draw call at display()
+            worldTarget.setDrawMode(sf::RenderTarget::DeferredStable);
+        }
+        else {
+            std::cout << "Failed to create the world render texture, rendering at native resolution\n";
+        }
 
+        // One mapped archive instead of dozens of loose files when available
+        // (build it with the EscapeOreoAssets target); missing entries and a
+        // missing pack both fall back to the files under tiles/
+        assets.open("assets.pak");
 
-        // --- Ground: continuous strip of small square blocks ---
-        for (int gx = 0; gx < static_cast<int>(WORLD_WIDTH / blockSize); ++gx) {
-            float x = gx * blockSize;
+        // Load 4 level backgrounds
+        for (int i = 0; i < 4; i++) {
+            std::string filename = "tiles/background" + std::to_string(i + 1) + ".png";
+            if (loadTexture(bgTextures[i], filename)) {
+                bgLoaded[i] = true;
+                bgSprites[i].setTexture(bgTextures[i]);
 
-            if (currentLevel == 2 && iceBlockLoaded) {
-                platforms.emplace_back(x, GROUND_Y, blockSize, blockSize, &iceBlockTexture);
+                // Scale each background to fill the screen
+                fitBackground(bgSprites[i], bgTextures[i]);
+                bgSprites[i].setPosition(0.f, 0.f);
             }
             else {
-                platforms.emplace_back(x, GROUND_Y, blockSize, blockSize, sf::Color(60, 40, 40));
+                std::cout << "Failed to load " << filename << "\n";
             }
         }
 
+        fontLoaded = loadFont(font, "arial.ttf") ||
+            font.loadFromFile("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf") ||
+            font.loadFromFile("C:/Windows/Fonts/arial.ttf");
 
-        // --- Diamond textures ---
-        if (diamondTexture.loadFromFile("tiles/diamond.png")) {
-            diamondLoaded = true;
+        // Rasterize the UI glyphs in the background while the rest loads,
+        // instead of on the first frame of each menu
+        if (fontLoaded) {
+            std::string printable;
+            for (char c = ' '; c <= '~'; ++c)
+                printable += c;
+            font.preload(printable, { 14, 16, 18, 20, 22, 36, 40 });
+            font.preloadDistanceField(printable);
         }
 
-        if (diamondTexture2.loadFromFile("tiles/diamond2.png")) {
-            diamond2Loaded = true;
+
+        // --- Load Level 1 background image ---
+        if (loadTexture(bgTexture1, "tiles/background1.png")) {
+            bg1Loaded = true;
+            bgSprite1.setTexture(bgTexture1);
+
+            sf::Vector2u texSize = bgTexture1.getSize();
+            float scaleX = WINDOW_WIDTH / static_cast<float>(texSize.x);
+            float scaleY = WINDOW_HEIGHT / static_cast<float>(texSize.y);
+            bgSprite1.setScale(scaleX, scaleY);
+            bgSprite1.setPosition(0.f, 0.f);
         }
         else {
-            std::cout << "Failed to load tiles/diamond2.png\n";
+            std::cout << "Failed to load tiles/background1.png\n";
         }
 
-        const sf::Texture* diamondTexToUse =
-            (currentLevel == 2 && diamond2Loaded) ? &diamondTexture2 : &diamondTexture;
+        // --- Load bat animation frames ---
+        for (int i = 1; i <= 9; ++i) {
+            sf::Texture tex;
+            CollisionMask mask;
+            std::string fileName = "tiles/bat" + std::to_string(i) + ".png";
+            if (!loadTexture(tex, fileName, &mask)) {
+                std::cout << "Failed to load " << fileName << "\n";
+                break;
+            }
+            batTextures.push_back(tex);
+            batMasks.push_back(mask);
+        }
 
-        // ----------------------------------------------------
-        // DECORATIVE CAVE CEILING (top of screen)
-        // ----------------------------------------------------
-        {
-            sf::Color ceilingColor1(45, 30, 60);
-            sf::Color ceilingColor2(55, 35, 70);
+        batsLoaded = (batTextures.size() == 9);
 
-            // Row 0 (very top)
-            for (int gx = 0; gx < static_cast<int>(WORLD_WIDTH / blockSize); ++gx) {
-                addBlock(gx, 0, ceilingColor1);
+        // --- Load player animation frames ---
+        for (int i = 1; i <= 6; ++i) {
+            sf::Texture tex;
+            std::string fileName = "tiles/character" + std::to_string(i) + ".png";
+            if (!loadTexture(tex, fileName)) {
+                std::cout << "Failed to load " << fileName << "\n";
+                break;
             }
+            playerTextures.push_back(tex);
+        }
 
-            // Row 1 (just under the top, with some gaps for variety)
-            for (int gx = 0; gx < static_cast<int>(WORLD_WIDTH / blockSize); ++gx) {
-                if (gx % 4 == 1) continue;   // gaps for rocky look
-                addBlock(gx, 1, ceilingColor2);
-            }
+        // --- Load axe image for hammer pickup ---
+        if (loadTexture(axeTexture, "tiles/axe.png")) {   // adjust path if needed
+            axeLoaded = true;
+        }
+        else {
+            std::cout << "Failed to load tiles/axe.png\n";
         }
 
-        // Two main platform heights (easy to reach)
-        float h1 = GROUND_Y - 60.f;   // low platforms
-        float h2 = GROUND_Y - 120.f;  // slightly higher
-        float h3 = GROUND_Y - 180.f;  // optional higher
-
-        // ----------------------------------------------------
-// CAVE PATH / PLATFORMS (different layouts per level)
-// ----------------------------------------------------
-        sf::Color pathColor(80, 55, 55);
-
-        if (currentLevel == 1) {
-            // Original stepped mid path
-            for (int gx = 1; gx <= 6; ++gx)  addBlock(gx, 16, pathColor);
-            for (int gx = 7; gx <= 12; ++gx) addBlock(gx, 15, pathColor);
-            for (int gx = 13; gx <= 18; ++gx) addBlock(gx, 14, pathColor);
-            for (int gx = 19; gx <= 22; ++gx) addBlock(gx, 15, pathColor);
-            for (int gx = 23; gx <= 26; ++gx) addBlock(gx, 16, pathColor);
-
-            // Middle platforms
-            addMainPlatform(1080.f, h1);
-            addMainPlatform(1230.f, h2);
-
-            // Right platforms
-            addMainPlatform(1564.f, h2);
-            addMainPlatform(1740.f, h1);
-            addMainPlatform(1900.f, h2);
-            addMainPlatform(2060.f, h1);
-
-            // High bonus
-            addMainPlatform(700.f, h3, sf::Color(110, 80, 90));
-            addMainPlatform(1600.f, h3, sf::Color(110, 80, 90));
-        }
-        else if (currentLevel == 2) {
-            // LEVEL 2: different, trickier ice layout
-
-            // Left: small staggered steps
-            addMainPlatform(400.f, h1);     // low
-            addMainPlatform(520.f, h2);     // higher
-            addMainPlatform(640.f, h1);     // back down
-
-            // Mid: vertical challenge
-            addMainPlatform(950.f, h2);
-            addMainPlatform(1030.f, h3);    // quite high
-            addMainPlatform(1150.f, h2);
-
-            // Right: spaced platforms toward the door
-            addMainPlatform(1500.f, h2);
-            addMainPlatform(1650.f, h3);
-            addMainPlatform(1820.f, h2);
-            addMainPlatform(1980.f, h1);
-
-            // One high bonus ledge (different from level 1)
-            addMainPlatform(1350.f, h3, sf::Color(110, 80, 90));
-        }
-
-
-        // -----------------------------------------------------------------
-        // Extra decorative blocks (do NOT block main path)
-        // -----------------------------------------------------------------
-        for (int c = 0; c < 25; ++c) addBlock(c, 0);
-        for (int c = 3; c <= 7; ++c) addBlock(c, 1);
-        for (int c = 12; c <= 17; ++c) addBlock(c, 1);
-        for (int c = 20; c <= 23; ++c) addBlock(c, 1);
-
-        // Stalactites (will be more "icy" on level 2 thanks to ice texture)
-        addBlock(5, 2); addBlock(5, 3);
-        addBlock(14, 2); addBlock(14, 3);
-        addBlock(21, 2); addBlock(21, 3);
-
-        for (int c = 25; c < 50; ++c) addBlock(c, 0);
-        for (int c = 28; c <= 32; ++c) addBlock(c, 1);
-        for (int c = 40; c <= 44; ++c) addBlock(c, 1);
-
-        for (int c = 10; c <= 13; ++c) addBlock(c, 8);
-        for (int c = 35; c <= 38; ++c) addBlock(c, 9);
-
-        // ----------------------------------------------------
-// BOTTOM PATH (walkway towards the door)
-// - Level 1: continuous, easy
-// - Level 2: stepped, with small gaps & height changes (harder)
-// ----------------------------------------------------
-        {
-            if (currentLevel == 1) {
-                float pathY = GROUND_Y - blockSize;
-                float pathEndX = WORLD_WIDTH - blockSize;
-                for (float x = 0.f; x <= pathEndX; x += blockSize) {
-                    // normal rock path
-                    platforms.emplace_back(
-                        x, pathY,
-                        blockSize, blockSize,
-                        pathColor
-                    );
-                }
-            }
-            else if (currentLevel == 2) {
-                // Use grid columns and height offsets for a trickier path
+        playerAnimLoaded = (playerTextures.size() == 6);
+        if (playerAnimLoaded) {
+            for (int i = 0; i < MAX_PLAYERS; ++i) {
+                world.players[i].setAnimationTextures(&playerTextures);
 
-                // Segment 1: start flat
-                for (int gx = 0; gx <= 8; ++gx) {
-                    addPathTile(gx, 0);
-                }
+                // Co-op players get a light tint of their colour
+                sf::Color c = SplitScreen::playerColor(i);
+                if (i > 0)
+                    world.players[i].sprite.setColor(sf::Color((255 + c.r) / 2, (255 + c.g) / 2, (255 + c.b) / 2));
+            }
+        }
 
-                // Segment 2: one tile higher
-                for (int gx = 9; gx <= 13; ++gx) {
-                    addPathTile(gx, 1);
-                }
+        // -- - Load door image-- -
+        if (loadTexture(doorTexture, "tiles/door.png")) {
+            doorLoaded = true;
+        }
+        else {
+            std::cout << "Failed to load tiles/door.png\n";
+        }
 
-                // Small gap at 14 (no tile)
+        // --- Diamond textures (loaded once here instead of on every level build) ---
+        if (loadTexture(diamondTexture, "tiles/diamond.png", &diamondMask)) {
+            diamondLoaded = true;
+        }
 
-                // Segment 3: back to base height
-                for (int gx = 15; gx <= 20; ++gx) {
-                    addPathTile(gx, 0);
-                }
-
-                // Segment 4: two tiles higher (harder jump section)
-                for (int gx = 21; gx <= 24; ++gx) {
-                    addPathTile(gx, 2);
-                }
-
-                // Gap at 25
-
-                // Segment 5: slightly raised
-                for (int gx = 26; gx <= 32; ++gx) {
-                    addPathTile(gx, 1);
-                }
-
-                // Final run toward door at base height
-                for (int gx = 33; gx <= 70; ++gx) {
-                    addPathTile(gx, 0);
-                }
-            }
-        }   // <-- END OF PATH SECTION
-
-        // --------------------------------------------------
-        // EXTRA END-OF-LEVEL ICE FIX (fills last columns)
-        // --------------------------------------------------
-        if (currentLevel == 2 && iceBlockLoaded) {
-            float yPath = GROUND_Y - blockSize;  // path height
-            float yGround = GROUND_Y;              // true ground
-
-            // Cover the last 3 columns with ice on BOTH rows
-            for (int i = 1; i <= 3; ++i) {
-                float x = WORLD_WIDTH - i * blockSize;
-
-                // path row
-                platforms.emplace_back(x, yPath, blockSize, blockSize, &iceBlockTexture);
-                // ground row
-                platforms.emplace_back(x, yGround, blockSize, blockSize, &iceBlockTexture);
-            }
-        }
-
-
-
-        // ----------------------------------------------------
-        // RIGHT-HAND CAVE WALL (ceiling-to-floor at level end)
-        // ----------------------------------------------------
-        {
-            int wallCol = static_cast<int>((WORLD_WIDTH - 32.f) / 32.f); // 74
-            sf::Color wallColor(60, 40, 40);
-
-            for (int gy = 0; gy <= 16; ++gy) {
-                addBlock(wallCol, gy, wallColor);
-            }
-        }
-
-
-        // ---------------- DIAMONDS (same layout, different texture on L2) ---------------
-        diamonds.emplace_back(320.f + 4.f, h2 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(600.f + 4.f, h2 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(930.f + 4.f, h2 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(1230.f + 4.f, h2 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(1420.f + 4.f, h1 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(1580.f + 4.f, h2 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(1900.f + 4.f, h2 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(2060.f + 4.f, h1 - 40.f, diamondTexToUse);
-
-        // Bonus diamonds
-        diamonds.emplace_back(700.f + 4.f, h3 - 40.f, diamondTexToUse);
-        diamonds.emplace_back(1600.f + 4.f, h3 - 40.f, diamondTexToUse);
-
-        // ---------------- ENEMIES: Level 2 = more + faster ----------------
-        if (currentLevel == 1) {
-            enemies.emplace_back(550.f, h2 - 40.f, 1.0f, 480.f, 720.f, &batTextures);
-            enemies.emplace_back(1150.f, h2 - 40.f, 1.2f, 1080.f, 1350.f, &batTextures);
-            enemies.emplace_back(1850.f, h2 - 80.f, 1.0f, 1780.f, 2100.f, &batTextures);
-        }
-        else if (currentLevel == 2) {
-            // Left section bat, patrolling above the staggered platforms
-            enemies.emplace_back(520.f, h2 - 50.f, 1.5f, 380.f, 680.f, &batTextures);
-
-            // Mid vertical challenge bat over the high platform
-            enemies.emplace_back(1030.f, h3 - 50.f, 1.6f, 940.f, 1180.f, &batTextures);
-
-            // Right section bats over the last platforms
-            enemies.emplace_back(1600.f, h2 - 40.f, 1.7f, 1480.f, 1760.f, &batTextures);
-            enemies.emplace_back(1900.f, h2 - 60.f, 1.8f, 1820.f, 2140.f, &batTextures);
-        }
-
-        // ---------------- ICICLES: more, and all attached to ice blocks ----
-        if (currentLevel == 2) {
-            // These coordinates are grid-based (gx, gy)
-            addIcicleWithBlock(6, 2);
-            addIcicleWithBlock(12, 3);
-            addIcicleWithBlock(18, 3);
-            addIcicleWithBlock(24, 2);
-            addIcicleWithBlock(30, 3);
-            addIcicleWithBlock(36, 3);
-            addIcicleWithBlock(42, 2);
-        }
-
-        // ---------------- HAMMER POSITION: higher on Level 2 ---------------
-        float hammerX, hammerY;
-        if (currentLevel == 2) {
-            // Put hammer on a high platform so player MUST do trickier jumps
-            hammerX = 1600.f;
-            hammerY = h3 - 30.f;
-        }
-        else {
-            hammerX = 1100.f;
-            hammerY = h2 - 30.f;
-        }
-
-        if (axeLoaded)
-            hammer = new Hammer(hammerX, hammerY, &axeTexture);
-        else
-            hammer = nullptr;
-
-        // ---------------- EXIT DOOR at far right --------------------------
-        float doorWidth = 40.f;
-        float doorHeight = 70.f;
-
-        float doorX = WORLD_WIDTH - 72.f;                 // right next to the wall
-        float doorY = (GROUND_Y - doorHeight) - 32.f;     // sits level with the path
-
-        boulder = nullptr;  // no boulder now
-
-        if (doorLoaded) {
-            exitDoor.setSize(sf::Vector2f(doorWidth, doorHeight));
-            exitDoor.setTexture(&doorTexture);
-            exitDoor.setTextureRect(sf::IntRect(
-                0, 0,
-                doorTexture.getSize().x,
-                doorTexture.getSize().y
-            ));
-        }
-        else {
-            exitDoor.setSize(sf::Vector2f(doorWidth, doorHeight));
-            exitDoor.setFillColor(sf::Color(255, 215, 0));
-        }
-        exitDoor.setPosition(doorX, doorY);
-
-        // ----------------------------------------------------
-// LEVEL 3: special layout – blocks only top & bottom
-// ----------------------------------------------------
-        if (currentLevel == 3) {
-            // Remove whatever platforms were added earlier
-            platforms.clear();
-
-            float blockSize = 32.f;
-            int cols = static_cast<int>(WORLD_WIDTH / blockSize);
-            int groundRow = static_cast<int>(GROUND_Y / blockSize);
-
-            auto addColumnBlock = [&](int gx, int gy) {
-                float x = gx * blockSize;
-                float y = gy * blockSize;
-
-                if (seaweedLoaded) {
-                    platforms.emplace_back(x, y, blockSize, blockSize, &seaweedTexture);
-                }
-                else {
-                    platforms.emplace_back(x, y, blockSize, blockSize, sf::Color(60, 40, 40));
-                }
-                };
-
-            // --------- Bottom "seaweed floor" varying heights ----------
-            for (int gx = 0; gx < cols; ++gx) {
-                int heightBlocks;
-
-                // pattern of heights: 4,3,2,1,3,2,1,...
-                switch (gx % 7) {
-                case 0:
-                case 1: heightBlocks = 4; break;
-                case 2:
-                case 3: heightBlocks = 3; break;
-                case 4:
-                case 5: heightBlocks = 2; break;
-                default: heightBlocks = 1; break;
-                }
-
-                for (int i = 0; i < heightBlocks; ++i) {
-                    int gy = groundRow - i;
-                    addColumnBlock(gx, gy);
-                }
-            }
-
-            // --------- Top "seaweed ceiling" varying heights ----------
-            for (int gx = 0; gx < cols; ++gx) {
-                int heightBlocks;
-
-                // different pattern so top ≠ bottom
-                if (gx % 5 == 0 || gx % 5 == 3)
-                    heightBlocks = 3;
-                else
-                    heightBlocks = 2;
-
-                for (int gy = 0; gy < heightBlocks; ++gy) {
-                    addColumnBlock(gx, gy);
-                }
-            }
-        }
-
-
-
-
-        // Player start at far left, slightly above ground
-        player.reset(50.f, GROUND_Y - 60.f);
-    }
-
-
-public:
-    Game() :
-        window(sf::VideoMode(800, 600), "Oreo Escape - Cave Adventure"),
-        view(sf::FloatRect(0.f, 0.f, 800.f, 600.f)),
-        player(100, 300),
-        state(MENU),
-        menuPage(MAIN_MENU),
-        currentLevel(1),
-        lives(3),
-        diamondsCollected(0),
-        score(0),
-        hammer(nullptr),
-        boulder(nullptr),
-        fontLoaded(false),
-        friction(0.85f),
-        menuAnimTime(0.f),
-        titleBounce(0.f),
-        glowPulse(150.f) {
-
-        window.setFramerateLimit(60);
-
-        // Load 4 level backgrounds
-        for (int i = 0; i < 4; i++) {
-            std::string filename = "tiles/background" + std::to_string(i + 1) + ".png";
-            if (bgTextures[i].loadFromFile(filename)) {
-                bgLoaded[i] = true;
-                bgSprites[i].setTexture(bgTextures[i]);
-
-                // Scale each background to fill the screen
-                sf::Vector2u texSize = bgTextures[i].getSize();
-                float scaleX = WINDOW_WIDTH / static_cast<float>(texSize.x);
-                float scaleY = WINDOW_HEIGHT / static_cast<float>(texSize.y);
-                bgSprites[i].setScale(scaleX, scaleY);
-                bgSprites[i].setPosition(0.f, 0.f);
-            }
-            else {
-                std::cout << "Failed to load " << filename << "\n";
-            }
-        }
-
-        fontLoaded = font.loadFromFile("arial.ttf") ||
-            font.loadFromFile("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf") ||
-            font.loadFromFile("C:/Windows/Fonts/arial.ttf");
-
-
-        // --- Load Level 1 background image ---
-        if (bgTexture1.loadFromFile("tiles/background1.png")) {
-            bg1Loaded = true;
-            bgSprite1.setTexture(bgTexture1);
-
-            sf::Vector2u texSize = bgTexture1.getSize();
-            float scaleX = WINDOW_WIDTH / static_cast<float>(texSize.x);
-            float scaleY = WINDOW_HEIGHT / static_cast<float>(texSize.y);
-            bgSprite1.setScale(scaleX, scaleY);
-            bgSprite1.setPosition(0.f, 0.f);
-        }
-        else {
-            std::cout << "Failed to load tiles/background1.png\n";
-        }
-
-        // --- Load bat animation frames ---
-        for (int i = 1; i <= 9; ++i) {
-            sf::Texture tex;
-            std::string fileName = "tiles/bat" + std::to_string(i) + ".png";
-            if (!tex.loadFromFile(fileName)) {
-                std::cout << "Failed to load " << fileName << "\n";
-                break;
-            }
-            batTextures.push_back(tex);
-        }
-
-        batsLoaded = (batTextures.size() == 9);
-
-        // --- Load player animation frames ---
-        for (int i = 1; i <= 6; ++i) {
-            sf::Texture tex;
-            std::string fileName = "tiles/character" + std::to_string(i) + ".png";
-            if (!tex.loadFromFile(fileName)) {
-                std::cout << "Failed to load " << fileName << "\n";
-                break;
-            }
-            playerTextures.push_back(tex);
-        }
-
-        // --- Load axe image for hammer pickup ---
-        if (axeTexture.loadFromFile("tiles/axe.png")) {   // adjust path if needed
-            axeLoaded = true;
-        }
-        else {
-            std::cout << "Failed to load tiles/axe.png\n";
-        }
-
-        playerAnimLoaded = (playerTextures.size() == 6);
-        if (playerAnimLoaded) {
-            player.setAnimationTextures(&playerTextures);
-        }
-
-        // -- - Load door image-- -
-        if (doorTexture.loadFromFile("tiles/door.png")) {
-            doorLoaded = true;
+        if (loadTexture(diamondTexture2, "tiles/diamond2.png", &diamondMask2)) {
+            diamond2Loaded = true;
         }
         else {
-            std::cout << "Failed to load tiles/door.png\n";
+            std::cout << "Failed to load tiles/diamond2.png\n";
         }
 
-        if (iceBlockTexture.loadFromFile("tiles/iceBlock.png")) {
+        if (loadTexture(iceBlockTexture, "tiles/iceBlock.png")) {
             iceBlockLoaded = true;
         }
-        if (seaweedTexture.loadFromFile("tiles/seaweed.png")) {
+        if (loadTexture(seaweedTexture, "tiles/seaweed.png")) {
             seaweedLoaded = true;
         }
         else {
             std::cout << "Failed to load tiles/seaweed.png\n";
         }
 
+        // Hand the textures that did load to the level builder
+        LevelTextures levelTextures;
+        levelTextures.iceBlock = iceBlockLoaded ? &iceBlockTexture : nullptr;
+        levelTextures.seaweed = seaweedLoaded ? &seaweedTexture : nullptr;
+        levelTextures.diamond = diamondLoaded ? &diamondTexture : nullptr;
+        levelTextures.diamond2 = diamond2Loaded ? &diamondTexture2 : nullptr;
+        levelTextures.axe = axeLoaded ? &axeTexture : nullptr;
+        levelTextures.door = doorLoaded ? &doorTexture : nullptr;
+        levelTextures.bats = &batTextures;
+        levelTextures.diamondMask = diamondLoaded ? &diamondMask : nullptr;
+        levelTextures.diamond2Mask = diamond2Loaded ? &diamondMask2 : nullptr;
+        levelTextures.batMasks = &batMasks;
+        world.setTextures(levelTextures);
+
+        // Build level 1 already, so the map page has a level to show
+        world.loadLevel(1);
+
+        watchFiles();
 
 
 
 
-        view.setCenter(400.f, 300.f);
+
+        updateCameras();
 
         menuPanel.setSize(sf::Vector2f(360.f, 360.f));
         menuPanel.setPosition(220.f, 160.f);
@@ -1474,24 +682,37 @@ public:
         initMenuParticles();
     }
 
-    ~Game() {
-        delete hammer;
-        delete boulder;
-    }
-
-    void loadLevel(int level) {
-        currentLevel = level;
-        buildCommonLevelLayout();     // same layout for all 4 levels for now
-    }
-
 
 
     void handleInput() {
+        SFML_TRACE_ZONE("Game::handleInput");
+
         sf::Event event;
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed)
                 window.close();
 
+            // Re-render the cached menu layer at the new resolution
+            if (event.type == sf::Event::Resized)
+                menuStaticValid = false;
+
+            // F9: write the timeline recorded so far (only in builds with SFML_ENABLE_TRACE)
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F9)
+                SFML_TRACE_DUMP("escapeoreo_trace.json");
+
+            // F7: switch the world upscaling between bilinear and nearest filtering
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F7) {
+                worldSmooth = !worldSmooth;
+                worldTarget.setSmooth(worldSmooth);
+            }
+
+            // G: show or hide the ghost of the best run
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::G)
+                ghostEnabled = !ghostEnabled;
+
+            if (state == EDITING)
+                editor.handleEvent(event, window);
+
             if (state == MENU) {
                 window.setView(window.getDefaultView());
 
@@ -1501,10 +722,8 @@ public:
 
                     if (menuPage == MAIN_MENU) {
                         if (startButton.getGlobalBounds().contains(mousePosF)) {
-                            lives = 3;
-                            score = 0;
-                            diamondsCollected = 0;
-                            loadLevel(1);
+                            world.setPlayerCount(1);
+                            world.newGame();
                             state = PLAYING;
                         }
                         else if (mapButton.getGlobalBounds().contains(mousePosF)) {
@@ -1530,6 +749,8 @@ public:
                         // SETTINGS PAGE BUTTON CLICKS (ADDED)
                         // ================================
                         if (menuPage == SETTINGS_PAGE) {
+                            // Volume text and mute label are part of the cached layer
+                            menuStaticValid = false;
 
                             // "-" decrease volume
                             if (volDownButton.getGlobalBounds().contains(mousePosF)) {
@@ -1563,24 +784,35 @@ public:
                 }
 
                 if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter) {
-                    lives = 3;
-                    score = 0;
-                    diamondsCollected = 0;
-                    loadLevel(1);
+                    world.setPlayerCount(1);
+                    world.newGame();
+                    state = PLAYING;
+                }
+
+                // 2, 3, 4: split-screen co-op with that many players
+                if (event.type == sf::Event::KeyPressed &&
+                    event.key.code >= sf::Keyboard::Num2 && event.key.code <= sf::Keyboard::Num4) {
+                    world.setPlayerCount(2 + (event.key.code - sf::Keyboard::Num2));
+                    world.newGame();
                     state = PLAYING;
                 }
             }
             else if (event.type == sf::Event::KeyPressed) {
                 if (event.key.code == sf::Keyboard::Escape) {
-                    state = (state == PLAYING) ? PAUSED : (state == PAUSED) ? PLAYING : state;
+                    state = (state == PLAYING) ? PAUSED : (state == PAUSED) ? PLAYING :
+                        (state == EDITING) ? PAUSED : state;
                 }
-                if (event.key.code == sf::Keyboard::R && state == PLAYING) {
-                    loadLevel(currentLevel);
+                if (event.key.code == sf::Keyboard::E && state == PAUSED && !net) {
+                    editor.begin(views[0]);
+                    state = EDITING;
+                }
+                if (event.key.code == sf::Keyboard::R && state == PLAYING && !net) {
+                    world.loadLevel(world.currentLevel);
                 }
                 if (event.key.code == sf::Keyboard::Enter) {
                     if (state == LEVEL_COMPLETE) {
-                        if (currentLevel < 4) {
-                            loadLevel(currentLevel + 1);
+                        if (world.currentLevel < 4) {
+                            world.loadLevel(world.currentLevel + 1);
                             state = PLAYING;
                         }
                         else {
@@ -1597,277 +829,288 @@ public:
         }
     }
 
-    void update() {
-        if (state != PLAYING) return;
-
-        // ------- INPUT: only move when keys are pressed (fix drifting) -------
-        player.velocity.x = 0.f;   // reset each frame
-
-        // movement input...
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::A)) {
-            player.velocity.x -= player.speed;
+    // Gameplay keys of one player, read once per tick. Alone, the player
+    // has both the arrows and WASD; in co-op each player gets one set
+    // (WASD, arrows, IJKL, numpad 4-6-8), and joystick `index` if plugged in.
+    PlayerInput readPlayerInput(int index) const {
+        using K = sf::Keyboard;
+        static const K::Key keys[MAX_PLAYERS][3] = {
+            { K::A, K::D, K::W },
+            { K::Left, K::Right, K::Up },
+            { K::J, K::L, K::I },
+            { K::Numpad4, K::Numpad6, K::Numpad8 }
+        };
+
+        PlayerInput input;
+        if (world.playerCount == 1 || net) {
+            input.left = K::isKeyPressed(K::Left) || K::isKeyPressed(K::A);
+            input.right = K::isKeyPressed(K::Right) || K::isKeyPressed(K::D);
+            input.jump = K::isKeyPressed(K::Space) || K::isKeyPressed(K::Up) || K::isKeyPressed(K::W);
+        }
+        else {
+            input.left = K::isKeyPressed(keys[index][0]);
+            input.right = K::isKeyPressed(keys[index][1]);
+            input.jump = K::isKeyPressed(keys[index][2]) || (index == 0 && K::isKeyPressed(K::Space));
         }
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::D)) {
-            player.velocity.x += player.speed;
+
+        if (sf::Joystick::isConnected(index)) {
+            float x = sf::Joystick::getAxisPosition(index, sf::Joystick::X);
+            input.left = input.left || x < -50.f;
+            input.right = input.right || x > 50.f;
+            input.jump = input.jump || sf::Joystick::isButtonPressed(index, 0);
         }
+        return input;
+    }
 
-        // NEW: update facing direction
-        if (player.velocity.x > 0.f)  player.facingDir = 1;
-        if (player.velocity.x < 0.f)  player.facingDir = -1;
+    // Split-screen views: one per local player, online only ours
+    int viewCount() const {
+        return net ? 1 : world.playerCount;
+    }
 
-        // NEW: jump input
-        if ((sf::Keyboard::isKeyPressed(sf::Keyboard::Space) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::Up) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::W)) && player.grounded) {
+    // Fit every player's view to the split-screen layout and follow them
+    void updateCameras() {
+        sf::Vector2f size = SplitScreen::viewSize(viewCount());
+        for (int i = 0; i < viewCount(); ++i) {
+            views[i].setSize(size);
+            views[i].setViewport(SplitScreen::viewport(i, viewCount()));
 
-            player.velocity.y = player.jumpPower; // negative value = go up
-            player.grounded = false;
+            int player = net ? net->playerIndex() : i;
+            float camX = world.players[player].position.x + 16.f;
+            camX = std::max(size.x / 2.f, std::min(camX, WORLD_WIDTH - size.x / 2.f));
+            views[i].setCenter(camX, 300.f);
         }
+    }
 
+    void update() {
+        SFML_TRACE_ZONE("Game::update");
 
-        // ------- PHYSICS: horizontal then vertical with collision --------
-        // Horizontal move
-        player.position.x += player.velocity.x;
-        player.updatePosition();
-
-        for (auto& platform : platforms) {
-            sf::FloatRect playerBounds = player.getBounds();
-            sf::FloatRect platformBounds = platform.shape.getGlobalBounds();
+        // Online: keep talking to the server even while paused
+        if (net) {
+            net->update(state == PLAYING ? readPlayerInput(0) : PlayerInput());
+            updateCameras();
+            return;
+        }
 
-            if (playerBounds.intersects(platformBounds)) {
-                if (player.velocity.x > 0) {
-                    player.position.x = platformBounds.left - playerBounds.width;
-                }
-                else if (player.velocity.x < 0) {
-                    player.position.x = platformBounds.left + platformBounds.width;
-                }
-                player.updatePosition();
-            }
+        if (state == EDITING) {
+            editor.update(window);
+            return;
         }
 
-        // Vertical move
-        player.velocity.y += GRAVITY;
-        float vyBefore = player.velocity.y;
+        if (state != PLAYING) return;
 
-        player.position.y += player.velocity.y;
+        PlayerInput inputs[MAX_PLAYERS];
+        for (int i = 0; i < world.playerCount; ++i)
+            inputs[i] = readPlayerInput(i);
 
-        player.updatePosition();
+        TickResult result = world.update(inputs, world.playerCount);
+        if (result == TICK_GAME_OVER) {
+            state = GAME_OVER;
+        }
+        else if (result == TICK_LEVEL_COMPLETE) {
+            state = LEVEL_COMPLETE;
+        }
 
-        player.grounded = false;
-        for (auto& platform : platforms) {
-            sf::FloatRect playerBounds = player.getBounds();
-            sf::FloatRect platformBounds = platform.shape.getGlobalBounds();
+        updateGhost(result);
 
-            if (playerBounds.intersects(platformBounds)) {
-                if (vyBefore > 0) { // falling down onto platform
-                    player.position.y = platformBounds.top - playerBounds.height;
-                    player.velocity.y = 0;
-                    player.grounded = true;
-                    player.updatePosition();
+        // Camera follow
+        updateCameras();
+    }
 
-                    if (platform.breakable) {
-                        platform.breakTimer += 1;
-                        if (platform.breakTimer > 120) {
-                            platform.shape.setFillColor(sf::Color(168, 216, 234, 150));
-                        }
-                    }
-                }
-                else if (vyBefore < 0) { // hitting head
-                    player.position.y = platformBounds.top + platformBounds.height;
-                    player.velocity.y = 0;
-                    player.updatePosition();
-                }
-            }
-        }
+    static std::string ghostFileName(int level) {
+        std::ostringstream name;
+        name << "ghost_level" << level << ".dat";
+        return name.str();
+    }
 
-        // World bounds (for scrolling world)
-        if (player.position.x < 0) player.position.x = 0;
-        if (player.position.x + 32.f > WORLD_WIDTH) player.position.x = WORLD_WIDTH - 32.f;
+    // Start recording a new attempt, and replay the best run from the start
+    void restartGhost() {
+        if (world.currentLevel != ghostLevel) {
+            ghostBest.loadFromFile(ghostFileName(world.currentLevel), world.currentLevel);
+            ghostLevel = world.currentLevel;
+        }
+        ghostRecording.clear();
+        ghostReader = GhostRun::Reader(&ghostBest);
+        ghostActive = false;
+        ghostLevelLoads = world.levelLoads;
+    }
 
-        if (player.position.y > WINDOW_HEIGHT + 200.f) {
-            lives--;
-            if (lives <= 0) {
-                state = GAME_OVER;
-            }
-            else {
-                loadLevel(currentLevel);
-            }
+    // Once per tick, after world.update(): record the player, move the
+    // ghost, and keep the run if it beat the best one
+    void updateGhost(TickResult result) {
+        // Co-op runs are neither recorded nor raced against
+        if (world.playerCount > 1) {
+            ghostActive = false;
             return;
         }
 
-        // Collectables
-        for (auto& diamond : diamonds) {
-            diamond.update();
-            if (!diamond.collected && player.getBounds().intersects(diamond.getBounds())) {
-                diamond.collected = true;
-                diamondsCollected++;
-                score += 50;
-            }
-        }
+        // Level changed, or restarted after a death or with R
+        if (world.levelLoads != ghostLevelLoads)
+            restartGhost();
 
+        const Player& player = world.players[0];
+        GhostFrame frame;
+        frame.x = player.position.x;
+        frame.y = player.position.y;
+        frame.facing = player.facingDir;
+        frame.animFrame = player.currentFrame;
+        ghostRecording.append(frame);
 
+        ghostActive = ghostReader.next(ghostFrame);
 
-        // Hammer pickup: just collect it, show in HUD, and allow door use
-        if (hammer && !hammer->collected && player.getBounds().intersects(hammer->getBounds())) {
-            hammer->collected = true;   // hammer disappears (render checks !collected)
-            player.hasHammer = true;    // HUD now shows "Hammer: YES"
-            score += 75;
+        if (result == TICK_LEVEL_COMPLETE && !ghostRecording.isFull() &&
+            (ghostBest.empty() || ghostRecording.frameCount() < ghostBest.frameCount())) {
+            ghostBest.copyFrom(ghostRecording);
+            if (!ghostBest.saveToFile(ghostFileName(world.currentLevel), world.currentLevel))
+                std::cout << "Failed to save the ghost run of level " << world.currentLevel << "\n";
         }
+    }
 
+    void drawGhost(sf::RenderTarget& target) {
+        if (!ghostEnabled || !ghostActive)
+            return;
 
-
-        // Enemies
-        for (auto& enemy : enemies) {
-            enemy.update();
-            if (player.getBounds().intersects(enemy.getBounds())) {
-                lives--;
-                if (lives <= 0) {
-                    state = GAME_OVER;
-                }
-                else {
-                    loadLevel(currentLevel);
-                }
-                return;
-            }
+        const sf::Color tint(255, 255, 255, 110);
+        if (playerAnimLoaded) {
+            int frame = std::min(ghostFrame.animFrame, static_cast<int>(playerTextures.size()) - 1);
+            ghostSprite.setTexture(playerTextures[frame], true);
+
+            // Same placement as Player::updatePosition: feet at the bottom centre
+            sf::FloatRect bounds = ghostSprite.getLocalBounds();
+            ghostSprite.setOrigin(bounds.width / 2.f, bounds.height);
+            float scale = world.players[0].spriteBaseScale;
+            ghostSprite.setScale((ghostFrame.facing > 0 ? 1.f : -1.f) * scale, scale);
+            ghostSprite.setPosition(ghostFrame.x + 16.f, ghostFrame.y + 46.f);
+            ghostSprite.setColor(tint);
+            target.draw(ghostSprite);
         }
-
-        // Hazards (if you add them later)
-        for (auto& rock : fallingRocks) {
-            rock.update(player.getBounds());
-            if (rock.active && player.getBounds().intersects(rock.getBounds())) {
-                lives--;
-                if (lives <= 0) {
-                    state = GAME_OVER;
-                }
-                else {
-                    loadLevel(currentLevel);
-                }
-                return;
-            }
+        else {
+            sf::RectangleShape box(sf::Vector2f(32.f, 46.f));
+            box.setPosition(ghostFrame.x, ghostFrame.y);
+            box.setFillColor(tint);
+            target.draw(box);
         }
+    }
 
-        for (auto& icicle : icicles) {
-            icicle.update(player.getBounds());
-            if (icicle.falling && player.getBounds().intersects(icicle.getBounds())) {
-                lives--;
-                if (lives <= 0) {
-                    state = GAME_OVER;
-                }
-                else {
-                    loadLevel(currentLevel);
-                }
-                return;
+    // Draw one menu button with its label, in its normal or hovered style
+    void drawMenuButton(sf::RenderTarget& target, sf::RectangleShape& button, const std::string& label,
+        bool primary, float yPos, bool hovered) {
+        // Always reset to default state first (fixes disappearing/offset bugs)
+        button.setOrigin(0, 0);
+        button.setPosition(270.f, yPos);
+        button.setScale(1.f, 1.f);
+
+        if (hovered) {
+            // Brighter colors when hovering
+            if (primary) {
+                button.setFillColor(sf::Color(255, 200, 20));
+                button.setOutlineColor(sf::Color(255, 220, 80));
+            }
+            else {
+                button.setFillColor(sf::Color(70, 110, 180));
+                button.setOutlineColor(sf::Color(150, 190, 255));
             }
+            button.setOutlineThickness(4.f);  // Thicker when hovering
         }
-
-        for (auto& lava : lavaPools) {
-            lava.update();
-            if (player.getBounds().intersects(lava.getBounds())) {
-                lives--;
-                if (lives <= 0) {
-                    state = GAME_OVER;
-                }
-                else {
-                    loadLevel(currentLevel);
-                }
-                return;
+        else {
+            // Normal colors
+            if (primary) {
+                button.setFillColor(sf::Color(255, 180, 0));
+                button.setOutlineColor(sf::Color(200, 140, 0));
+            }
+            else {
+                button.setFillColor(sf::Color(50, 80, 130));
+                button.setOutlineColor(sf::Color(100, 150, 220));
             }
+            button.setOutlineThickness(3.f);
         }
 
-        // Exit condition: player just needs the hammer and to touch the door
-        if (player.hasHammer &&
-            player.getBounds().intersects(exitDoor.getGlobalBounds())) {
+        target.draw(button);
 
-            state = LEVEL_COMPLETE;
+        // Draw label text on top of button
+        if (fontLoaded) {
+            sf::Text t;
+            t.setFont(font);
+            t.setString(label);
+            t.setCharacterSize(primary ? 22 : 20);
+            t.setFillColor(primary ? sf::Color::Black : sf::Color::White);
+
+            // Simple centering
+            sf::FloatRect tb = t.getLocalBounds();
+            sf::Vector2f bp = button.getPosition();
+            sf::Vector2f bs = button.getSize();
+            t.setPosition(
+                bp.x + (bs.x - tb.width) / 2.f - tb.left,
+                bp.y + (bs.y - tb.height) / 2.f - tb.top - 2.f
+            );
+
+            target.draw(t);
         }
+    }
 
+    // BACK button of the sub-pages, normal or hovered
+    void drawBackButton(sf::RenderTarget& target, bool hovered) {
+        if (hovered) {
+            backButton.setFillColor(sf::Color(120, 120, 120));
+            backButton.setOutlineThickness(3.f);
+        }
+        else {
+            backButton.setFillColor(sf::Color(80, 80, 80));
+            backButton.setOutlineThickness(2.f);
+        }
 
-        // Camera follow
-        float camX = player.position.x + 16.f;
-        camX = std::max(400.f, std::min(camX, WORLD_WIDTH - 400.f));
-        view.setCenter(camX, 300.f);
+        target.draw(backButton);
+
+        if (fontLoaded) {
+            sf::Text backText;
+            backText.setFont(font);
+            backText.setString("BACK");
+            backText.setCharacterSize(18);
+            backText.setFillColor(sf::Color::White);
+            backText.setPosition(backButton.getPosition().x + 30.f, backButton.getPosition().y + 5.f);
+            target.draw(backText);
+        }
     }
 
-    void drawMenu() {
-        window.setView(window.getDefaultView());
+    // Everything on the menu that only changes with the page (or the settings
+    // values): panels, buttons in their normal state, labels and page text.
+    // Drawn into menuStaticLayer once, then reused every frame.
+    void drawMenuStatic(sf::RenderTarget& target) {
+        if (fontLoaded) {
+            // SETTINGS UI (ADDED)
+            // ================================
+            if (menuPage == SETTINGS_PAGE) {
+                target.draw(volDownButton);
+                target.draw(volUpButton);
+                target.draw(muteButton);
 
-      
-        //  Animated Gradient Background + Particles
-        
-        sf::RectangleShape bgGradient(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
-        bgGradient.setFillColor(sf::Color(15, 10, 35));  // Deep purple
-        window.draw(bgGradient);
+                sf::Text t;
+                t.setFont(font);
+                t.setCharacterSize(18);
+                t.setFillColor(sf::Color::White);
 
-        // ADDED: Update and draw all animated particles/diamonds every frame
-        updateMenuAnimation();
-        for (auto& p : menuParticles) window.draw(p.shape);
-        for (auto& d : floatingDiamonds) window.draw(d.shape);
+                // "-" label
+                t.setString("-");
+                t.setPosition(volDownButton.getPosition().x + 18.f, volDownButton.getPosition().y + 5.f);
+                target.draw(t);
 
-        
-        // Bouncing Title with Glow Effect
-        
-        if (fontLoaded) {
-            // ADDED: Glowing shadow layer (behind main title)
-            sf::Text titleGlow;
-            titleGlow.setFont(font);
-            titleGlow.setString("OREO ESCAPE");
-            titleGlow.setCharacterSize(72);  // Bigger than before!
-            titleGlow.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(glowPulse)));
-            titleGlow.setOutlineThickness(8.f);  // Thick glow
-            titleGlow.setOutlineColor(sf::Color(255, 150, 0, static_cast<sf::Uint8>(glowPulse * 0.5f)));
-            titleGlow.setPosition(175 + titleBounce * 0.5f, 35 + titleBounce);  // Bounces!
-            window.draw(titleGlow);
+                // "+" label
+                t.setString("+");
+                t.setPosition(volUpButton.getPosition().x + 16.f, volUpButton.getPosition().y + 5.f);
+                target.draw(t);
 
-            // ADDED: Main title on top
-            sf::Text title;
-            title.setFont(font);
-            title.setString("OREO ESCAPE");
-            title.setCharacterSize(72);
-            title.setFillColor(sf::Color(255, 235, 100));  // Bright gold
-            title.setOutlineThickness(4.f);
-            title.setOutlineColor(sf::Color(180, 100, 0));
-            title.setPosition(180, 40 + titleBounce);  // Bounces
-            window.draw(title);
+                // Mute label
+                t.setString(musicMuted ? "UNMUTE" : "MUTE");
+                t.setPosition(muteButton.getPosition().x + 35.f, muteButton.getPosition().y + 5.f);
+                target.draw(t);
 
-            // SETTINGS UI (ADDED)
-// ================================
-            if (menuPage == SETTINGS_PAGE) {
-                window.draw(volDownButton);
-                window.draw(volUpButton);
-                window.draw(muteButton);
-
-                if (fontLoaded) {
-                    sf::Text t;
-                    t.setFont(font);
-                    t.setCharacterSize(18);
-                    t.setFillColor(sf::Color::White);
-
-                    // "-" label
-                    t.setString("-");
-                    t.setPosition(volDownButton.getPosition().x + 18.f, volDownButton.getPosition().y + 5.f);
-                    window.draw(t);
-
-                    // "+" label
-                    t.setString("+");
-                    t.setPosition(volUpButton.getPosition().x + 16.f, volUpButton.getPosition().y + 5.f);
-                    window.draw(t);
-
-                    // Mute label
-                    t.setString(musicMuted ? "UNMUTE" : "MUTE");
-                    t.setPosition(muteButton.getPosition().x + 35.f, muteButton.getPosition().y + 5.f);
-                    window.draw(t);
-
-                    // Volume display text
-                    sf::Text volText;
-                    volText.setFont(font);
-                    volText.setCharacterSize(18);
-                    volText.setFillColor(sf::Color(255, 235, 150));
-                    volText.setString("Music Volume: " + std::to_string(musicMuted ? 0 : musicVolume));
-                    volText.setPosition(200.f, 300.f);
-                    window.draw(volText);
-                }
+                // Volume display text
+                sf::Text volText;
+                volText.setFont(font);
+                volText.setCharacterSize(18);
+                volText.setFillColor(sf::Color(255, 235, 150));
+                volText.setString("Music Volume: " + std::to_string(musicMuted ? 0 : musicVolume));
+                volText.setPosition(200.f, 300.f);
+                target.draw(volText);
             }
 
 
@@ -1894,104 +1137,22 @@ public:
                 subtitle.setString("Shop");
             }
 
-            window.draw(subtitle);
+            target.draw(subtitle);
         }
 
-      
-        // MAIN MENU PAGE
-      
-        if (menuPage == MAIN_MENU) {
-            window.draw(menuPanel);
-
-            sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-            sf::Vector2f mousePosF(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
 
-         
-            // Interactive Button Hover Effects
-         
-            auto styleButton = [&](sf::RectangleShape& button, const std::string& label,
-                bool primary, float yPos) {
-                    bool hovered = button.getGlobalBounds().contains(mousePosF);
-
-                    // Always reset to default state first (fixes disappearing/offset bugs)
-                    button.setOrigin(0, 0);
-                    button.setPosition(270.f, yPos);
-                    button.setScale(1.f, 1.f);
-
-                    if (hovered) {
-                        // Brighter colors when hovering
-                        if (primary) {
-                            button.setFillColor(sf::Color(255, 200, 20));
-                            button.setOutlineColor(sf::Color(255, 220, 80));
-                        }
-                        else {
-                            button.setFillColor(sf::Color(70, 110, 180));
-                            button.setOutlineColor(sf::Color(150, 190, 255));
-                        }
-                        button.setOutlineThickness(4.f);  // Thicker when hovering
-                    }
-                    else {
-                        // Normal colors
-                        if (primary) {
-                            button.setFillColor(sf::Color(255, 180, 0));
-                            button.setOutlineColor(sf::Color(200, 140, 0));
-                        }
-                        else {
-                            button.setFillColor(sf::Color(50, 80, 130));
-                            button.setOutlineColor(sf::Color(100, 150, 220));
-                        }
-                        button.setOutlineThickness(3.f);
-                    }
+        // MAIN MENU PAGE
 
-                    window.draw(button);
-
-                    // Draw label text on top of button
-                    if (fontLoaded) {
-                        sf::Text t;
-                        t.setFont(font);
-                        t.setString(label);
-                        t.setCharacterSize(primary ? 22 : 20);
-                        t.setFillColor(primary ? sf::Color::Black : sf::Color::White);
-
-                        // Simple centering
-                        sf::FloatRect tb = t.getLocalBounds();
-                        sf::Vector2f bp = button.getPosition();
-                        sf::Vector2f bs = button.getSize();
-                        t.setPosition(
-                            bp.x + (bs.x - tb.width) / 2.f - tb.left,
-                            bp.y + (bs.y - tb.height) / 2.f - tb.top - 2.f
-                        );
-
-                        window.draw(t);
-                    }
-                };
+        if (menuPage == MAIN_MENU) {
+            target.draw(menuPanel);
 
             // ADDED: Call with Y positions to fix button placement
-            styleButton(mapButton, "MAP", false, 175);
-            styleButton(settingsButton, "SETTINGS", false, 230);
-            styleButton(instructionsButton, "INSTRUCTIONS", false, 285);
-            styleButton(shopButton, "SHOP", false, 340);
-            styleButton(startButton, "START ADVENTURE", true, 410);
-
-            // ============================================================
-            // ✨ ENHANCEMENT #6D: Pulsing Hint Text
-            // ============================================================
-            if (fontLoaded) {
-                sf::Text hint;
-                hint.setFont(font);
-                hint.setString("Press ENTER or click START to begin");
-                hint.setCharacterSize(18);
-                hint.setFillColor(sf::Color(180, 200, 255, 200));
-                hint.setPosition(220, 550);
-
-                // Pulsing fade effect using sine wave
-                float pulse = 200.f + std::sin(menuAnimTime * 4.f) * 55.f;
-                sf::Color hintColor = hint.getFillColor();
-                hintColor.a = static_cast<sf::Uint8>(pulse);
-                hint.setFillColor(hintColor);
-
-                window.draw(hint);
-            }
+            // (hovered buttons are drawn again on top, see drawMenu)
+            drawMenuButton(target, mapButton, "MAP", false, 175, false);
+            drawMenuButton(target, settingsButton, "SETTINGS", false, 230, false);
+            drawMenuButton(target, instructionsButton, "INSTRUCTIONS", false, 285, false);
+            drawMenuButton(target, shopButton, "SHOP", false, 340, false);
+            drawMenuButton(target, startButton, "START ADVENTURE", true, 410, false);
         }
         // OTHER PAGES (keeps your existing panels/content)
         else {
@@ -2000,36 +1161,11 @@ public:
             panel.setFillColor(sf::Color(0, 0, 0, 220));
             panel.setOutlineThickness(2.f);
             panel.setOutlineColor(sf::Color(200, 200, 200));
-            window.draw(panel);
-
-            sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-            sf::Vector2f mousePosF(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
-            bool backHovered = backButton.getGlobalBounds().contains(mousePosF);
-
-            if (backHovered) {
-                sf::Color c = backButton.getFillColor();
-                c.r = std::min(255, c.r + 40);
-                c.g = std::min(255, c.g + 40);
-                c.b = std::min(255, c.b + 40);
-                backButton.setFillColor(c);
-                backButton.setOutlineThickness(3.f);
-            }
-            else {
-                backButton.setFillColor(sf::Color(80, 80, 80));
-                backButton.setOutlineThickness(2.f);
-            }
+            target.draw(panel);
 
-            window.draw(backButton);
+            drawBackButton(target, false);
 
             if (fontLoaded) {
-                sf::Text backText;
-                backText.setFont(font);
-                backText.setString("BACK");
-                backText.setCharacterSize(18);
-                backText.setFillColor(sf::Color::White);
-                backText.setPosition(backButton.getPosition().x + 30.f, backButton.getPosition().y + 5.f);
-                window.draw(backText);
-
                 sf::Text content;
                 content.setFont(font);
                 content.setCharacterSize(14);
@@ -2045,7 +1181,8 @@ public:
                         "Space / W / Up     : Jump\n"
                         "E                  : Use Hammer on Boulder\n"
                         "ESC                : Pause game\n"
-                        "R                  : Restart current level\n\n"
+                        "R                  : Restart current level\n"
+                        "2 / 3 / 4 on menu  : Split-screen co-op\n\n"
                         "Goal:\n"
                         "- Collect diamonds\n"
                         "- Avoid enemies and hazards\n"
@@ -2092,15 +1229,173 @@ public:
                     );
                 }
 
-                window.draw(content);
+                target.draw(content);
             }
         }
     }
 
+    // Bring the cached static layer up to date; returns false if the
+    // render texture is not usable (the static part is then drawn directly)
+    bool updateMenuStaticLayer() {
+        if (!menuStaticAvailable)
+            return false;
+
+        if (menuStaticValid && menuStaticPage == menuPage)
+            return true;
+
+        // Render at the window's real resolution so text stays sharp after a resize
+        sf::Vector2u size = window.getSize();
+        if (menuStaticLayer.getSize() != size && !menuStaticLayer.create(size.x, size.y)) {
+            std::cout << "Failed to create the menu render texture, drawing the menu directly\n";
+            menuStaticAvailable = false;
+            return false;
+        }
+        menuStaticLayer.setSmooth(true);
+
+        menuStaticLayer.setView(sf::View(sf::FloatRect(0.f, 0.f,
+            static_cast<float>(WINDOW_WIDTH), static_cast<float>(WINDOW_HEIGHT))));
+        menuStaticLayer.clear(sf::Color::Transparent);
+        drawMenuStatic(menuStaticLayer);
+        menuStaticLayer.display();
+
+        menuStaticPage = menuPage;
+        menuStaticValid = true;
+        return true;
+    }
+
+    void drawMenu() {
+        window.setView(window.getDefaultView());
+
+      
+        //  Animated Particles (the background colour is the window clear colour)
+
+        // ADDED: Update and draw all animated particles/diamonds every frame
+        updateMenuAnimation();
+        for (auto& p : menuParticles) window.draw(p.shape);
+        for (auto& d : floatingDiamonds) window.draw(d.shape);
+
+        
+        // Bouncing Title with Glow Effect
+        
+        if (fontLoaded) {
+            // ADDED: Glowing shadow layer (behind main title)
+            sf::Text titleGlow;
+            titleGlow.setFont(font);
+            titleGlow.setString("OREO ESCAPE");
+            titleGlow.setCharacterSize(72);  // Bigger than before!
+            titleGlow.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(glowPulse)));
+            titleGlow.setOutlineThickness(8.f);  // Thick glow
+            titleGlow.setOutlineColor(sf::Color(255, 150, 0, static_cast<sf::Uint8>(glowPulse * 0.5f)));
+            titleGlow.setDistanceField(true);  // No 72px glyph set per outline thickness
+            titleGlow.setPosition(175 + titleBounce * 0.5f, 35 + titleBounce);  // Bounces!
+            window.draw(titleGlow);
+
+            // ADDED: Main title on top
+            sf::Text title;
+            title.setFont(font);
+            title.setString("OREO ESCAPE");
+            title.setCharacterSize(72);
+            title.setFillColor(sf::Color(255, 235, 100));  // Bright gold
+            title.setOutlineThickness(4.f);
+            title.setOutlineColor(sf::Color(180, 100, 0));
+            title.setDistanceField(true);
+            title.setPosition(180, 40 + titleBounce);  // Bounces
+            window.draw(title);
+        }
+
+
+        // Static layer: one textured quad while the page does not change.
+        // Its colours are premultiplied by alpha (rendered over transparent
+        // black), hence the One / OneMinusSrcAlpha blending.
+        if (updateMenuStaticLayer()) {
+            sf::Sprite layer(menuStaticLayer.getTexture());
+            sf::Vector2u size = menuStaticLayer.getSize();
+            layer.setScale(WINDOW_WIDTH / static_cast<float>(size.x), WINDOW_HEIGHT / static_cast<float>(size.y));
+            window.draw(layer, sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha));
+        }
+        else {
+            drawMenuStatic(window);
+        }
+
+
+        // Dynamic layer: hover highlights and the pulsing hint
+
+        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        sf::Vector2f mousePosF(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
+
+        if (menuPage == MAIN_MENU) {
+         
+            // Interactive Button Hover Effects (redraws only the hovered button)
+            if (mapButton.getGlobalBounds().contains(mousePosF))
+                drawMenuButton(window, mapButton, "MAP", false, 175, true);
+            else if (settingsButton.getGlobalBounds().contains(mousePosF))
+                drawMenuButton(window, settingsButton, "SETTINGS", false, 230, true);
+            else if (instructionsButton.getGlobalBounds().contains(mousePosF))
+                drawMenuButton(window, instructionsButton, "INSTRUCTIONS", false, 285, true);
+            else if (shopButton.getGlobalBounds().contains(mousePosF))
+                drawMenuButton(window, shopButton, "SHOP", false, 340, true);
+            else if (startButton.getGlobalBounds().contains(mousePosF))
+                drawMenuButton(window, startButton, "START ADVENTURE", true, 410, true);
+
+            // ============================================================
+            // ✨ ENHANCEMENT #6D: Pulsing Hint Text
+            // ============================================================
+            if (fontLoaded) {
+                sf::Text hint;
+                hint.setFont(font);
+                hint.setString("Press ENTER or click START to begin");
+                hint.setCharacterSize(18);
+                hint.setFillColor(sf::Color(180, 200, 255, 200));
+                hint.setPosition(220, 550);
+
+                // Pulsing fade effect using sine wave
+                float pulse = 200.f + std::sin(menuAnimTime * 4.f) * 55.f;
+                sf::Color hintColor = hint.getFillColor();
+                hintColor.a = static_cast<sf::Uint8>(pulse);
+                hint.setFillColor(hintColor);
+
+                window.draw(hint);
+            }
+        }
+        else if (backButton.getGlobalBounds().contains(mousePosF)) {
+            drawBackButton(window, true);
+        }
+
+        // Map of the current (or last played) level under the page text
+        if (menuPage == MAP_PAGE) {
+            minimap.draw(window, sf::FloatRect(220.f, 392.f, 360.f, 91.f), world);
+        }
+    }
+
+
+    // Lines between the co-op views
+    void drawSplitScreenBorders() {
+        if (viewCount() < 2)
+            return;
+
+        sf::RectangleShape line;
+        line.setFillColor(sf::Color(20, 12, 20));
+
+        line.setSize(sf::Vector2f(4.f, static_cast<float>(WINDOW_HEIGHT)));
+        line.setPosition(WINDOW_WIDTH / 2.f - 2.f, 0.f);
+        window.draw(line);
+
+        if (viewCount() > 2) {
+            line.setSize(sf::Vector2f(static_cast<float>(WINDOW_WIDTH), 4.f));
+            line.setPosition(0.f, WINDOW_HEIGHT / 2.f - 2.f);
+            window.draw(line);
+        }
+    }
 
     void drawHUD() {
         // Extra height so all lines fit comfortably
-        float hudHeight = player.hasHammer ? 170.f : 150.f;
+        bool hammerReady = false;
+        for (int i = 0; i < world.playerCount; ++i)
+            hammerReady = hammerReady || world.players[i].hasHammer;
+
+        float hudHeight = hammerReady ? 170.f : 150.f;
+        if (net)
+            hudHeight += 22.f;
 
         sf::RectangleShape hudFrame(sf::Vector2f(230.f, hudHeight));
         hudFrame.setPosition(12.f, 12.f);
@@ -2133,17 +1428,37 @@ public:
             text.setPosition(25.f, 50.f);   // moved further down
 
             std::stringstream ss;
-            ss << "Level: " << currentLevel << " / 4\n";
-            ss << "Lives: " << lives << "\n";
-            ss << "Diamonds: " << diamondsCollected << "\n";
-            ss << "Score: " << score;
-            if (player.hasHammer) {
+            ss << "Level: " << world.currentLevel << " / 4\n";
+            ss << "Lives: " << world.lives << "\n";
+            ss << "Diamonds: " << world.diamondsCollected << "\n";
+            ss << "Score: " << world.score;
+            if (hammerReady) {
                 ss << "\nHammer: READY";
             }
+            if (net) {
+                if (net->isConnected())
+                    ss << "\nOnline: player " << net->playerIndex() + 1;
+                else
+                    ss << (net->wasRejected() ? "\nServer full" : "\nConnecting...");
+            }
 
             text.setString(ss.str());
             window.draw(text);
         }
+
+        // Minimap, top-right: 3 screen pixels per tile
+        if (minimap.isReady()) {
+            sf::FloatRect mapArea(WINDOW_WIDTH - 12.f - 225.f, 12.f, 225.f, 57.f);
+
+            sf::RectangleShape mapFrame(sf::Vector2f(mapArea.width, mapArea.height));
+            mapFrame.setPosition(mapArea.left, mapArea.top);
+            mapFrame.setFillColor(sf::Color::Transparent);
+            mapFrame.setOutlineThickness(3.f);
+            mapFrame.setOutlineColor(sf::Color(255, 215, 120, 230));
+            window.draw(mapFrame);
+
+            minimap.draw(window, mapArea, world);
+        }
     }
 
 
@@ -2155,7 +1470,7 @@ public:
         if (fontLoaded) {
             sf::Text text;
             text.setFont(font);
-            text.setString("PAUSED\n\nESC - Resume\nR - Restart Level");
+            text.setString(net ? "PAUSED\n\nESC - Resume" : "PAUSED\n\nESC - Resume\nR - Restart Level\nE - Level Editor");
             text.setCharacterSize(40);
             text.setFillColor(sf::Color::White);
             text.setPosition(280, 220);
@@ -2173,8 +1488,8 @@ public:
             text.setFont(font);
             std::stringstream ss;
             ss << "GAME OVER\n\n";
-            ss << "Final Score: " << score << "\n";
-            ss << "Diamonds: " << diamondsCollected << "\n\n";
+            ss << "Final Score: " << world.score << "\n";
+            ss << "Diamonds: " << world.diamondsCollected << "\n\n";
             ss << "Press ENTER to Menu";
             text.setString(ss.str());
             text.setCharacterSize(36);
@@ -2194,9 +1509,9 @@ public:
             text.setFont(font);
             std::stringstream ss;
             ss << "LEVEL COMPLETE!\n\n";
-            ss << "Score: " << score << "\n";
-            ss << "Diamonds: " << diamondsCollected << "\n\n";
-            if (currentLevel < 4) {
+            ss << "Score: " << world.score << "\n";
+            ss << "Diamonds: " << world.diamondsCollected << "\n\n";
+            if (world.currentLevel < 4) {
                 ss << "Press ENTER for\nNext Level";
             }
             else {
@@ -2211,76 +1526,134 @@ public:
         }
     }
 
+    // Size in pixels of the part of worldTarget used at the current scale
+    sf::Vector2u scaledWorldSize() const {
+        return sf::Vector2u(static_cast<unsigned>(WINDOW_WIDTH * renderScale + 0.5f),
+            static_cast<unsigned>(WINDOW_HEIGHT * renderScale + 0.5f));
+    }
+
+    // Same view, its viewport mapped into the used part of worldTarget
+    // when it is in use
+    sf::View worldPassView(const sf::View& source) const {
+        sf::View result(source);
+        if (worldTargetAvailable) {
+            sf::Vector2u used = scaledWorldSize();
+            sf::Vector2u size = worldTarget.getSize();
+            float fx = static_cast<float>(used.x) / size.x;
+            float fy = static_cast<float>(used.y) / size.y;
+            sf::FloatRect viewport = source.getViewport();
+            result.setViewport(sf::FloatRect(viewport.left * fx, viewport.top * fy,
+                viewport.width * fx, viewport.height * fy));
+        }
+        return result;
+    }
+
+    // Adjust renderScale to hold FRAME_BUDGET: step down when frames get
+    // close to the budget, step up when there is plenty of headroom.
+    // Changes are at least half a second apart so the average can settle.
+    void updateRenderScale(sf::Time frameTime) {
+        if (!worldTargetAvailable || state == MENU)
+            return;
+
+        smoothedFrameTime = smoothedFrameTime * 0.9f + frameTime.asSeconds() * 0.1f;
+        SFML_TRACE_COUNTER("Render scale", renderScale);
+
+        if (++framesSinceScaleChange < 30)
+            return;
+
+        if (smoothedFrameTime > FRAME_BUDGET * 0.9f && renderScale > MIN_RENDER_SCALE)
+            renderScale = std::max(MIN_RENDER_SCALE, renderScale - RENDER_SCALE_STEP);
+        else if (smoothedFrameTime < FRAME_BUDGET * 0.6f && renderScale < maxRenderScale)
+            renderScale = std::min(maxRenderScale, renderScale + RENDER_SCALE_STEP);
+        else
+            return;
+
+        framesSinceScaleChange = 0;
+    }
+
     void render() {
+        SFML_TRACE_ZONE("Game::render");
+
+        // Bake the minimap of every newly built or edited level (on a
+        // worker thread), and upload it once it is done
+        if (world.levelLoads != minimapLevelLoads || world.levelEdits != minimapLevelEdits) {
+            minimap.bake(world);
+            minimapLevelLoads = world.levelLoads;
+            minimapLevelEdits = world.levelEdits;
+        }
+        minimap.update();
+
         if (state == MENU) {
             // --- MENU SCREEN ---
             window.setView(window.getDefaultView());
-            window.clear(sf::Color(30, 30, 50));  // menu background colour
+            window.clear(sf::Color(15, 10, 35));  // menu background colour (dark purple gradient base)
             drawMenu();
         }
         else {
             // --- GAMEPLAY ---
-            window.clear();
-
-            // 1) Draw background in screen space (full window)
-            // Draw correct background for each level
-            window.setView(window.getDefaultView());
-            int bgIndex = currentLevel - 1; // 0–3
-
-            if (bgIndex >= 0 && bgIndex < 4 && bgLoaded[bgIndex]) {
-                window.draw(bgSprites[bgIndex]);
-            }
-            else {
-                // fallback if missing image
-                sf::RectangleShape bgRect(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
-                bgRect.setFillColor(bgColor);
-                window.draw(bgRect);
-            }
-
-
-            // 2) Draw world with scrolling camera
-            window.setView(view);
-
-            for (auto& lava : lavaPools) {
-                window.draw(lava.shape);
-            }
-
-            for (auto& platform : platforms) {
-                window.draw(platform.shape);
-            }
-
-            for (auto& diamond : diamonds) {
-                diamond.draw(window);
-            }
+            // The world goes to the offscreen target (or straight to the window
+            // if it could not be created), the HUD to the window
+            sf::RenderTarget& scene = worldTargetAvailable
+                ? static_cast<sf::RenderTarget&>(worldTarget)
+                : static_cast<sf::RenderTarget&>(window);
+            scene.clear();
+
+            // One pass per player view (a single one outside co-op): the
+            // level geometry is batched once in World, each view only culls it.
+            // The editor has its own camera over the whole window.
+            bool editing = state == EDITING;
+            int passes = editing ? 1 : viewCount();
+            for (int i = 0; i < passes; ++i) {
+                const sf::View& camera = editing ? editor.view() : views[i];
+
+                // 1) Draw background in screen space (whole view)
+                // Draw correct background for each level
+                sf::View screen = window.getDefaultView();
+                screen.setViewport(camera.getViewport());
+                scene.setView(worldPassView(screen));
+                int bgIndex = world.currentLevel - 1; // 0–3
+
+                if (bgIndex >= 0 && bgIndex < 4 && bgLoaded[bgIndex]) {
+                    scene.draw(bgSprites[bgIndex]);
+                }
+                else {
+                    // fallback if missing image
+                    sf::RectangleShape bgRect(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+                    bgRect.setFillColor(world.bgColor);
+                    scene.draw(bgRect);
+                }
 
 
-            if (hammer && !hammer->collected) {
-                hammer->draw(window);
+                // 2) Draw world with scrolling camera
+                scene.setView(worldPassView(camera));
+                world.draw(scene);
+                if (editing)
+                    editor.draw(scene);
+                else
+                    drawGhost(scene);
             }
 
-            // Exit door
-            window.draw(exitDoor);
+            // 3) Stretch the world over the window (opaque, no blending needed)
+            window.setView(window.getDefaultView());
+            if (worldTargetAvailable) {
+                worldTarget.display();
+                SFML_TRACE_COUNTER("World draw calls saved", worldTarget.getDrawStats().drawCallsSaved);
 
-            for (auto& rock : fallingRocks) {
-                if (rock.active || rock.resetTimer > 0) {
-                    window.draw(rock.shape);
-                }
+                sf::Vector2u used = scaledWorldSize();
+                sf::Sprite frame(worldTarget.getTexture(), sf::IntRect(0, 0, used.x, used.y));
+                frame.setScale(static_cast<float>(WINDOW_WIDTH) / used.x, static_cast<float>(WINDOW_HEIGHT) / used.y);
+                window.draw(frame, sf::BlendNone);
             }
 
-            for (auto& icicle : icicles) {
-                window.draw(icicle.shape);
+            // 4) HUD & overlays in screen-space again, at native resolution
+            if (editing) {
+                editor.drawHUD(window, fontLoaded ? &font : nullptr);
             }
-
-            for (auto& enemy : enemies) {
-                enemy.draw(window);
+            else {
+                drawSplitScreenBorders();
+                drawHUD();
             }
 
-            player.draw(window);
-
-            // 3) HUD & overlays in screen-space again
-            window.setView(window.getDefaultView());
-            drawHUD();
-
             if (state == PAUSED)        drawPauseMenu();
             if (state == GAME_OVER)     drawGameOver();
             if (state == LEVEL_COMPLETE) drawLevelComplete();
@@ -2291,17 +1664,143 @@ public:
     }
 
 
+    // Play on a server instead of locally; false if no socket could be bound
+    bool joinServer(const sf::IpAddress& address, unsigned short port) {
+        net.reset(new NetClient(world));
+        if (!net->connect(address, port)) {
+            std::cout << "Failed to open a UDP socket\n";
+            net.reset();
+            return false;
+        }
+        state = PLAYING;
+        return true;
+    }
+
     void run() {
+        SFML_TRACE_THREAD_NAME("Main thread");
+
+        sf::Clock frameClock;
         while (window.isOpen()) {
+            SFML_TRACE_ZONE("Game::run");
+            frameClock.restart();
+
+            // Frame boundary: swap in the files reloaded since the last frame
+            hotReload.update();
+
             handleInput();
+
+            // Test hook: in steady state a tick must not allocate (level
+            // loads aside). Only active with ESCAPEOREO_COUNT_ALLOCATIONS.
+            std::size_t allocationsBefore = AllocationCounter::count();
+            int loadsBefore = world.levelLoads;
             update();
+            if (AllocationCounter::enabled() && state == PLAYING && world.levelLoads == loadsBefore) {
+                std::size_t tickAllocations = AllocationCounter::count() - allocationsBefore;
+                if (tickAllocations > 0)
+                    std::cout << "Warning: update() made " << tickAllocations << " heap allocations\n";
+            }
+
             render();
+
+            // Time spent on the frame, buffer swap included; what is left of
+            // the budget is slept away (this replaces setFramerateLimit)
+            sf::Time frameTime = frameClock.getElapsedTime();
+            updateRenderScale(frameTime);
+            if (frameTime < sf::seconds(FRAME_BUDGET))
+                sf::sleep(sf::seconds(FRAME_BUDGET) - frameTime);
         }
+
+        // Keep an offline timeline of the whole session (tracing builds only)
+        SFML_TRACE_DUMP("escapeoreo_trace.json");
     }
 };
 
-int main() {
+namespace {
+    // Build the collision mask of an image from the asset pack or the disk
+    bool loadMask(const AssetPack& assets, const std::string& filename, CollisionMask& mask) {
+        sf::Image image;
+        AssetPack::View data = assets.find(filename);
+        bool decoded = data.data ? image.loadFromMemory(data.data, data.size) : image.loadFromFile(filename);
+        if (!decoded) {
+            std::cout << "Failed to load " << filename << "\n";
+            return false;
+        }
+        mask.build(image);
+        return true;
+    }
+}
+
+// Dedicated LAN server: the simulation only, no window, 60 ticks a second
+int runServer(unsigned short port) {
+    // No window, hence no textures: the collision masks, built from the
+    // images, give the bats, diamonds and hammer the size they have on
+    // the clients so that the server simulates the same level
+    AssetPack assets;
+    assets.open("assets.pak");
+
+    CollisionMask diamondMask, diamondMask2, axeMask;
+    std::vector<CollisionMask> batMasks;
+    for (int i = 1; i <= 9; ++i) {
+        CollisionMask mask;
+        if (!loadMask(assets, "tiles/bat" + std::to_string(i) + ".png", mask))
+            break;
+        batMasks.push_back(mask);
+    }
+
+    LevelTextures levelTextures;
+    levelTextures.diamondMask = loadMask(assets, "tiles/diamond.png", diamondMask) ? &diamondMask : nullptr;
+    levelTextures.diamond2Mask = loadMask(assets, "tiles/diamond2.png", diamondMask2) ? &diamondMask2 : nullptr;
+    levelTextures.axeMask = loadMask(assets, "tiles/axe.png", axeMask) ? &axeMask : nullptr;
+    levelTextures.batMasks = &batMasks;
+
+    World world;
+    world.setTextures(levelTextures);
+    NetServer server(world);
+    if (!server.start(port)) {
+        std::cout << "Failed to listen on UDP port " << port << "\n";
+        return 1;
+    }
+    std::cout << "Server listening on UDP port " << port << "\n";
+
+    const sf::Time tick = sf::seconds(1.f / NET_TICK_RATE);
+    sf::Clock clock;
+    sf::Time next = clock.getElapsedTime();
+    int clients = 0;
+    while (true) {
+        server.update();
+        if (server.clientCount() != clients) {
+            clients = server.clientCount();
+            std::cout << clients << " player(s) connected\n";
+        }
+
+        next += tick;
+        sf::sleep(next - clock.getElapsedTime());
+    }
+}
+
+//   EscapeOreo                      play locally
+//   EscapeOreo --server [port]      run a LAN server
+//   EscapeOreo --connect host[:port]  play on a LAN server
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "--server") {
+        int port = argc > 2 ? std::atoi(argv[2]) : NET_DEFAULT_PORT;
+        return runServer(static_cast<unsigned short>(port));
+    }
+
     Game game;
+    if (mode == "--connect" && argc > 2) {
+        std::string host = argv[2];
+        unsigned short port = NET_DEFAULT_PORT;
+        std::string::size_type colon = host.find(':');
+        if (colon != std::string::npos) {
+            port = static_cast<unsigned short>(std::atoi(host.c_str() + colon + 1));
+            host = host.substr(0, colon);
+        }
+        if (!game.joinServer(sf::IpAddress(host), port))
+            return 1;
+    }
     game.run();
     return 0;
 }
\ No newline at end of file